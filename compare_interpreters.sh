@@ -0,0 +1,103 @@
+#!/bin/bash
+
+# Execution tier parity check
+# Runs compiled test classes from tests/classes under each VM configuration in VARIANTS
+# and compares what their main() prints with the first one (the direct-threaded
+# interpreter). Fails if any output differs or a test reports FAILED.
+#
+# Each class runs from its own JAR (tests/classes with the class as Main-Class): in
+# .class mode java/lang/String comes from the VM's mock class rather than rt.jar, so
+# string concatenation would print empty lines.
+#
+# When the AOT compiler is built, each JAR is also compiled into a module and run with
+# --aot=module= as one more configuration.
+#
+# Usage: ./compare_interpreters.sh [ClassName...]   (default: ArrayStorageTest BytecodeTest ExceptionFastPathTest GcStressTest JitEdgeTest NativeHandleTest PeepholeTest RegisterIRTest)
+# The binaries are build/j2me-vm and build/j2me-aot, or $J2ME_VM and $J2ME_AOT when set.
+
+VM="${J2ME_VM:-build/j2me-vm}"
+AOT="${J2ME_AOT:-build/j2me-aot}"
+if [ ! -x "$VM" ]; then
+    echo "Error: VM binary not found: $VM"
+    echo "Please run ./build.sh first, or set J2ME_VM."
+    exit 1
+fi
+if [ ! -x "$AOT" ]; then
+    echo "Note: AOT compiler not found ($AOT), skipping the aot configuration"
+fi
+
+if [ $# -eq 0 ]; then
+    set -- ArrayStorageTest BytecodeTest ExceptionFastPathTest GcStressTest JitEdgeTest NativeHandleTest PeepholeTest RegisterIRTest
+fi
+
+# name:flags; every variant is compared with the first
+# 名称:参数; 每个配置都与第一个比较
+VARIANTS=(
+    "threaded:--interp threaded --tier2-threshold 0 --jit=off --aot=off"
+    "table:--interp table --tier2-threshold 0 --jit=off --aot=off"
+    "nosuper:--interp threaded --tier2-threshold 0 --jit=off --aot=off --superinstructions=off"
+    "nopeep:--interp threaded --tier2-threshold 0 --jit=off --aot=off --peephole=none"
+    "ir:--interp threaded --tier2-threshold 1 --jit=off --aot=off"
+    "jit:--interp threaded --tier2-threshold 0 --jit=threshold=1 --aot=off"
+)
+
+OUT_DIR="build/interp_compare"
+mkdir -p "$OUT_DIR"
+STATUS=0
+
+for CLASS_NAME in "$@"; do
+    CLASS_FILE="tests/classes/${CLASS_NAME}.class"
+    if [ ! -f "$CLASS_FILE" ]; then
+        echo "Error: Class file not found: $CLASS_FILE"
+        echo "Please run ./build_tests.sh first."
+        STATUS=1
+        continue
+    fi
+    JAR="$OUT_DIR/${CLASS_NAME}.jar"
+    rm -f "$JAR"
+    jar cfe "$JAR" "$CLASS_NAME" -C tests/classes . || { STATUS=1; continue; }
+
+    BASE=""
+    CLASS_STATUS=0
+    CLASS_VARIANTS=("${VARIANTS[@]}")
+    if [ -x "$AOT" ]; then
+        MODULE="$OUT_DIR/${CLASS_NAME}.aot.so"
+        if "$AOT" -o "$MODULE" "$JAR" > "$OUT_DIR/${CLASS_NAME}.aot.log" 2>&1; then
+            CLASS_VARIANTS+=("aot:--interp threaded --tier2-threshold 0 --jit=off --aot=module=$MODULE")
+        else
+            echo "$CLASS_NAME: j2me-aot failed (see $OUT_DIR/${CLASS_NAME}.aot.log)"
+            CLASS_STATUS=1
+        fi
+    fi
+
+    for VARIANT in "${CLASS_VARIANTS[@]}"; do
+        NAME="${VARIANT%%:*}"
+        OUT="$OUT_DIR/${CLASS_NAME}.${NAME}.txt"
+        # Keep the lines between the VM's start and end of main(), without the log timestamp
+        "$VM" ${VARIANT#*:} "$JAR" 2>&1 \
+            | sed -n '/Running main method (headless mode)/,/main method completed\./p' \
+            | sed -E 's/^[0-9]{4}-[0-9]{2}-[0-9]{2} [0-9:]{8} //' > "$OUT"
+
+        if ! grep -q "main method completed\." "$OUT"; then
+            echo "$CLASS_NAME: main() did not complete under $NAME (see $OUT)"
+            CLASS_STATUS=1
+        elif [ -z "$BASE" ]; then
+            BASE="$OUT"
+            if grep -q "FAILED" "$OUT"; then
+                echo "$CLASS_NAME: tests FAILED under $NAME"
+                grep "FAILED" "$OUT"
+                CLASS_STATUS=1
+            fi
+        elif ! diff -u "$BASE" "$OUT"; then
+            echo "$CLASS_NAME: $NAME output differs from ${VARIANTS[0]%%:*}"
+            CLASS_STATUS=1
+        fi
+    done
+    if [ $CLASS_STATUS -eq 0 ]; then
+        echo "$CLASS_NAME: same output under ${#CLASS_VARIANTS[@]} configurations ($(wc -l < "$BASE") lines)"
+    else
+        STATUS=1
+    fi
+done
+
+exit $STATUS
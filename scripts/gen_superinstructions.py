@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Regenerate src/core/Superinstructions.def from superinstruction profiles.
+
+    j2me-vm --profile-opcodes scripts/opcode_profiles/GcStressTest.txt GcStressTest.jar
+    python3 scripts/gen_superinstructions.py scripts/opcode_profiles/*.txt
+
+A profile has one line per candidate superinstruction, "<count> <family> <first opcode>",
+counting the executions of the first instruction where the rest of the sequence follows,
+and a "# instructions <N>" line with the number of instructions the run executed. Each
+candidate is scored by the share of dispatches it saves in each workload (count times
+the number of instructions it folds away, over N), averaged over the profiles so that a
+long run does not outweigh the others. Candidates saving at least --min-saving percent
+become the table, best first, at most MAX_SUPERINSTRUCTIONS of them.
+
+根据超级指令统计文件重新生成 src/core/Superinstructions.def。统计文件每行为一个候选超级指令:
+"<次数> <族> <首条操作码>"，即其后紧跟完整序列的首条指令的执行次数; "# instructions <N>" 行为该次运行
+执行的指令总数。每个候选按其在各工作负载中节省的分派比例 (次数乘以被合并掉的指令数，再除以 N) 评分，
+并在所有统计文件间取平均，避免单个长时间运行主导结果。节省至少 --min-saving 百分比的候选按得分
+从高到低写入表中，最多 MAX_SUPERINSTRUCTIONS 个。
+"""
+
+import argparse
+import os
+import sys
+
+# Free opcodes 0xe6..0xfd (0xfe/0xff are reserved) / 可用操作码 0xe6..0xfd
+MAX_SUPERINSTRUCTIONS = 0xfe - 0xe6
+
+OPCODE_NAMES = {
+    0x15: 'ILOAD', 0x19: 'ALOAD',
+    0x1a: 'ILOAD_0', 0x1b: 'ILOAD_1', 0x1c: 'ILOAD_2', 0x1d: 'ILOAD_3',
+    0x2a: 'ALOAD_0', 0x2b: 'ALOAD_1', 0x2c: 'ALOAD_2', 0x2d: 'ALOAD_3',
+    0x60: 'IADD', 0x64: 'ISUB', 0x68: 'IMUL', 0x78: 'ISHL', 0x7a: 'ISHR', 0x7c: 'IUSHR',
+    0x7e: 'IAND', 0x80: 'IOR', 0x82: 'IXOR', 0x84: 'IINC',
+}
+
+# Instructions after the first one in each family of src/core/instructions/Instructions_Super.cpp
+# Instructions_Super.cpp 中每个族在首条指令之后的指令数
+FAMILY_TAILS = {
+    'LOAD_GETFIELD': 1,
+    'ILOAD_ILOAD_IBIN': 2,
+    'ILOAD_ILOAD_ICMP': 2,
+    'ILOAD_CONST_IBIN': 2,
+    'ILOAD_CONST_ICMP': 2,
+    'ILOAD_IFZ': 1,
+    'ALOAD_ILOAD_XALOAD': 2,
+    'IBIN_ISTORE': 1,
+    'IINC_GOTO': 1,
+}
+
+
+def read_profile(path):
+    counts = {}
+    instructions = 0
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if parts[:2] == ['#', 'instructions'] and len(parts) == 3:
+                instructions = int(parts[2])
+            if len(parts) != 3 or parts[0].startswith('#'):
+                continue
+            count, family, first = int(parts[0]), parts[1], int(parts[2], 16)
+            if family not in FAMILY_TAILS or first not in OPCODE_NAMES:
+                sys.exit('%s: unknown candidate %s %s' % (path, parts[1], parts[2]))
+            counts[(family, first)] = counts.get((family, first), 0) + count
+    if instructions == 0:
+        sys.exit('%s: no "# instructions" line' % path)
+    return counts, instructions
+
+
+def savings(profiles):
+    # candidate -> percentage of dispatches saved, averaged over the profiles
+    # 候选 -> 节省的分派百分比 (各统计文件的平均值)
+    scores = {}
+    for counts, instructions in profiles:
+        for (family, first), count in counts.items():
+            share = 100.0 * count * FAMILY_TAILS[family] / instructions / len(profiles)
+            scores[(family, first)] = scores.get((family, first), 0.0) + share
+    return scores
+
+
+def name_of(family, first):
+    # ALOAD_0 + LOAD_GETFIELD -> ALOAD_0_GETFIELD, ILOAD_1 + ILOAD_ILOAD_IBIN -> ILOAD_1_ILOAD_IBIN
+    rest = family.split('_', 1)[1]
+    return OPCODE_NAMES[first] + '_' + rest
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('profiles', nargs='+', help='profiles written by j2me-vm --profile-opcodes')
+    parser.add_argument('--min-saving', type=float, default=0.5,
+                        help='smallest average percentage of dispatches a superinstruction must save (default: 0.5)')
+    parser.add_argument('-o', '--output', default=os.path.join(os.path.dirname(__file__), '..', 'src', 'core', 'Superinstructions.def'))
+    args = parser.parse_args()
+
+    scores = savings([read_profile(path) for path in args.profiles])
+    ranked = sorted(((score, family, first) for (family, first), score in scores.items() if score >= args.min_saving),
+                    key=lambda c: (-c[0], c[1], c[2]))[:MAX_SUPERINSTRUCTIONS]
+    if not ranked:
+        sys.exit('no candidate superinstruction saves %.2f%% of dispatches' % args.min_saving)
+
+    lines = [
+        '// Superinstructions fused at load time (see instructions/Instructions_Super.cpp), in the',
+        '// order their opcodes are assigned from OP_SUPERINSTRUCTION_FIRST.',
+        '// Generated by scripts/gen_superinstructions.py from %d profiles; do not edit by hand.' % len(args.profiles),
+        '// 加载时融合的超级指令 (见 instructions/Instructions_Super.cpp)，按此顺序从 OP_SUPERINSTRUCTION_FIRST 起分配操作码。',
+        '// 由 scripts/gen_superinstructions.py 生成，请勿手工修改',
+        '//',
+        '// J2ME_SUPERINSTRUCTION(name, family, first opcode) // average share of dispatches saved',
+    ]
+    for score, family, first in ranked:
+        lines.append('J2ME_SUPERINSTRUCTION(%s, %s, OP_%s) // %.2f%%' % (name_of(family, first), family, OPCODE_NAMES[first], score))
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+    print('wrote %d superinstructions to %s' % (len(ranked), os.path.normpath(args.output)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Read heap dumps written by j2me-vm (format: docs/HEAP_DUMP.md).
+
+    python3 scripts/heapdump.py histogram heap-1.j2heap
+    python3 scripts/heapdump.py diff heap-1.j2heap heap-2.j2heap
+
+histogram lists the classes by shallow bytes. diff lists, per class, how the instance
+count and bytes changed between two dumps of the same session, and how many of the
+instances in the second dump are new (object ids are heap offsets, and old objects do
+not move, so an id seen in both dumps is the same object).
+
+读取 j2me-vm 写出的堆转储 (格式见 docs/HEAP_DUMP.md)。histogram 按浅层字节数列出各个类;
+diff 按类列出同一次运行中两次转储之间实例数与字节数的变化，以及第二次转储中新出现的实例数
+(对象 ID 为堆区偏移，老年代对象不会移动，因此两次转储中 ID 相同的即为同一个对象)。
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'J2MEHEAP'
+VERSION = 1
+
+
+class HeapDump:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        self.pos = 0
+        self.data = data
+        if self._take(8) != MAGIC:
+            raise ValueError(path + ': not a j2me-vm heap dump')
+        version, _flags = self._unpack('<II')
+        if version != VERSION:
+            raise ValueError(path + ': unsupported version %d' % version)
+        self.time_ms, self.used_bytes, self.heap_limit = self._unpack('<QQQ')
+        (class_count,) = self._unpack('<I')
+        self.classes = []
+        for _ in range(class_count):
+            (length,) = self._unpack('<I')
+            self.classes.append(self._take(length).decode('utf-8', 'replace'))
+        (object_count,) = self._unpack('<I')
+        # id -> (class index, shallow bytes, refs)
+        self.objects = {}
+        for _ in range(object_count):
+            oid, cls, size, _length, ref_count = self._unpack('<QIIII')
+            refs = struct.unpack_from('<%dQ' % ref_count, data, self.pos)
+            self.pos += 8 * ref_count
+            self.objects[oid] = (cls, size, refs)
+        (root_count,) = self._unpack('<I')
+        self.roots = struct.unpack_from('<%dQ' % root_count, data, self.pos)
+
+    def _take(self, n):
+        chunk = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return chunk
+
+    def _unpack(self, fmt):
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += struct.calcsize(fmt)
+        return values
+
+    def per_class(self, ids=None):
+        """class name -> [instances, bytes], over `ids` (all objects by default)"""
+        stats = {}
+        for oid in (self.objects if ids is None else ids):
+            cls, size, _ = self.objects[oid]
+            entry = stats.setdefault(self.classes[cls], [0, 0])
+            entry[0] += 1
+            entry[1] += size
+        return stats
+
+
+def histogram(args):
+    dump = HeapDump(args.dump)
+    stats = dump.per_class()
+    total = sum(size for _, size in stats.values())
+    print('%d objects, %d KB at %.1f s (%d roots)' % (len(dump.objects), total // 1024, dump.time_ms / 1000.0,
+                                                     len(dump.roots)))
+    print('%11s %12s  %s' % ('instances', 'bytes', 'class'))
+    for name, (count, size) in sorted(stats.items(), key=lambda item: -item[1][1])[:args.top]:
+        print('%11d %12d  %s' % (count, size, name))
+
+
+def diff(args):
+    old = HeapDump(args.old)
+    new = HeapDump(args.new)
+    before = old.per_class()
+    after = new.per_class()
+    fresh = new.per_class([oid for oid in new.objects if oid not in old.objects])
+    rows = []
+    for name in set(before) | set(after):
+        b = before.get(name, [0, 0])
+        a = after.get(name, [0, 0])
+        rows.append((a[1] - b[1], a[0] - b[0], a[0], a[1], fresh.get(name, [0, 0])[0], name))
+    rows.sort(key=lambda row: -abs(row[0]))
+    print('%.1f s -> %.1f s: %+d objects, %+d KB' % (
+        old.time_ms / 1000.0, new.time_ms / 1000.0, len(new.objects) - len(old.objects),
+        (sum(s for _, s in after.values()) - sum(s for _, s in before.values())) // 1024))
+    print('%12s %10s %11s %12s %10s  %s' % ('d bytes', 'd count', 'instances', 'bytes', 'new', 'class'))
+    for delta_bytes, delta_count, count, size, new_count, name in rows[:args.top]:
+        if delta_bytes == 0 and delta_count == 0 and new_count == 0:
+            continue
+        print('%+12d %+10d %11d %12d %10d  %s' % (delta_bytes, delta_count, count, size, new_count, name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--top', type=int, default=30, help='classes to list (default 30)')
+    commands = parser.add_subparsers(dest='command', required=True)
+    p = commands.add_parser('histogram', help='classes of one dump by bytes')
+    p.add_argument('dump')
+    p.set_defaults(run=histogram)
+    p = commands.add_parser('diff', help='per-class growth between two dumps')
+    p.add_argument('old')
+    p.add_argument('new')
+    p.set_defaults(run=diff)
+    args = parser.parse_args()
+    try:
+        args.run(args)
+    except (OSError, ValueError, struct.error) as e:
+        print(e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,441 @@
+#include "AotCompiler.hpp"
+#include "../core/AotModule.hpp"
+#include "../core/ClassParser.hpp"
+#include "../core/RuntimeTypes.hpp"
+#include "../core/Logger.hpp"
+#include "../loader/JarLoader.hpp"
+#include "../util/FileUtils.hpp"
+#include <sstream>
+#include <set>
+#include <cstdio>
+
+namespace j2me {
+namespace aot {
+
+using namespace j2me::core;
+
+namespace {
+
+// Support code at the top of every module. The macros mirror those of executeIR; the
+// functions keep the budget in a local and hand it back on every exit.
+// 每个模块开头的支持代码。宏与 executeIR 中的对应; 函数将预算保存在局部变量中，每次退出时写回
+const char* const PRELUDE = R"(#include "AotModule.hpp"
+#include "RuntimeTypes.hpp"
+#include <cmath>
+#include <cstring>
+
+using namespace j2me::core;
+
+namespace {
+
+inline JavaObject* objectOf(void* ref) { return static_cast<JavaObject*>(ref); }
+
+template <typename T>
+inline int32_t compareFloating(T v1, T v2, int32_t nanResult) {
+    if (std::isnan(v1) || std::isnan(v2)) return nanResult;
+    if (v1 > v2) return 1;
+    if (v1 < v2) return -1;
+    return 0;
+}
+
+inline float rawToF(int64_t raw) { int32_t bits = (int32_t)raw; float f; std::memcpy(&f, &bits, sizeof(f)); return f; }
+inline double rawToD(int64_t raw) { double d; std::memcpy(&d, &raw, sizeof(d)); return d; }
+inline int64_t fToRaw(float f) { int32_t bits; std::memcpy(&bits, &f, sizeof(f)); return (int64_t)bits; }
+inline int64_t dToRaw(double d) { int64_t bits; std::memcpy(&bits, &d, sizeof(d)); return bits; }
+
+inline int32_t lookupSwitch(const int32_t* keys, const int32_t* targets, int32_t count, int32_t key, int32_t defaultTarget) {
+    int32_t lo = 0, hi = count - 1;
+    while (lo <= hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (keys[mid] == key) return targets[mid];
+        if (keys[mid] < key) lo = mid + 1; else hi = mid - 1;
+    }
+    return defaultTarget;
+}
+
+} // namespace
+
+#define W_I(reg, x) do { int32_t v_ = (x); r[reg].i = v_; t[reg] = JavaValue::INT; } while (0)
+#define W_F(reg, x) do { float v_ = (x); r[reg].f = v_; t[reg] = JavaValue::FLOAT; } while (0)
+#define W_A(reg, x) do { void* v_ = (x); r[reg].ref = v_; t[reg] = JavaValue::REFERENCE; } while (0)
+#define W_J(reg, x) do { int64_t v_ = (x); r[reg].l = v_; t[reg] = JavaValue::LONG; t[(reg) + 1] = SLOT_TOP; } while (0)
+#define W_D(reg, x) do { double v_ = (x); r[reg].d = v_; t[reg] = JavaValue::DOUBLE; t[(reg) + 1] = SLOT_TOP; } while (0)
+#define EXIT(at, reason) do { ctx->budget = budget; ctx->insn = (at); return (reason); } while (0)
+#define JUMP(cost, target, index) do { \
+        if ((budget -= (cost)) <= 0) { ctx->budget = budget; ctx->label = (target); return JIT_EXIT_BUDGET; } \
+        goto I##index; \
+    } while (0)
+#define JUMP_TO(cost, labelExpr) do { \
+        int32_t l_ = (labelExpr); \
+        if ((budget -= (cost)) <= 0) { ctx->budget = budget; ctx->label = l_; return JIT_EXIT_BUDGET; } \
+        ip = labelIndex[l_]; \
+        goto enter; \
+    } while (0)
+#define ELEMENT(at, arr, index, checkNull) \
+        if ((checkNull) && !r[arr].ref) EXIT(at, JIT_EXIT_NULL_POINTER); \
+        JavaObject* a_ = objectOf(r[arr].ref); \
+        int32_t x_ = r[index].i; \
+        if (x_ < 0 || x_ >= a_->arrayLength()) EXIT(at, JIT_EXIT_INDEX_BOUNDS)
+#define ALOAD(at, arr, index, checkNull, type, write, dst, conv) do { ELEMENT(at, arr, index, checkNull); type raw = a_->elements<type>()[x_]; write(dst, conv); } while (0)
+#define ASTORE(at, arr, index, checkNull, type, value) do { ELEMENT(at, arr, index, checkNull); a_->elements<type>()[x_] = (value); } while (0)
+)";
+
+std::string hex32(int32_t value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "(int32_t)0x%08xu", (unsigned)(uint32_t)value);
+    return buf;
+}
+
+std::string hexU64(uint64_t value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "0x%016llxull", (unsigned long long)value);
+    return buf;
+}
+
+std::string hex64(int64_t value) { return "(int64_t)" + hexU64((uint64_t)value); }
+
+// C string literal for a method key (modified UTF-8 bytes kept as octal escapes)
+// 方法键的 C 字符串字面量 (修改版 UTF-8 字节以八进制转义保留)
+std::string quote(const std::string& text) {
+    std::string out = "\"";
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20 || c >= 0x7F) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\%03o", c);
+            out += buf;
+        } else {
+            out += (char)c;
+        }
+    }
+    return out + "\"";
+}
+
+// A method whose IR only hands bytecodes to the interpreter gains nothing from native code
+// IR 中只有交给解释器的指令的方法无法从本地代码中获益
+bool worthCompiling(const IRMethod& ir) {
+    for (const IRInsn& in : ir.code) {
+        if (in.op != IR_NOP && in.op != IR_SLOW && (in.op < IR_RETURN || in.op > IR_RETURN_A)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool AotCompiler::emitMethod(const IRMethod& ir, std::string& body) {
+    const size_t n = ir.code.size();
+    std::ostringstream out;
+
+    // Budget charged by a taken branch, as in the JIT: the insns from the start of its block
+    // 跳转扣除的预算，与 JIT 相同: 从所在基本块起点到该指令的指令数
+    std::set<uint32_t> entries;
+    for (const auto& label : ir.labels) entries.insert(label.index);
+    std::vector<uint32_t> cost(n, 1);
+    for (size_t i = 0, start = 0; i < n; i++) {
+        if (entries.count((uint32_t)i)) start = i;
+        cost[i] = (uint32_t)(i - start + 1);
+    }
+
+    if (!ir.switches.empty()) {
+        out << "    static const uint32_t labelIndex[] = {";
+        for (size_t l = 0; l < ir.labels.size(); l++) out << (l ? ", " : " ") << ir.labels[l].index;
+        out << " };\n";
+    }
+    out << "    int32_t budget = ctx->budget;\n";
+    if (!ir.switches.empty()) out << "enter:\n";
+    out << "    switch (ip) {\n";
+    for (uint32_t index : entries) out << "        case " << index << ": goto I" << index << ";\n";
+    out << "        default: EXIT(0, -1);\n    }\n";
+
+    for (size_t i = 0; i < n; i++) {
+        const IRInsn& in = ir.code[i];
+        if (entries.count((uint32_t)i)) out << "I" << i << ":\n";
+        const std::string D = std::to_string(in.dst), A = std::to_string(in.a), B = std::to_string(in.b), C = std::to_string(in.c);
+        const std::string ra = "r[" + A + "]", rb = "r[" + B + "]", rc = "r[" + C + "]";
+        const std::string at = std::to_string(i);
+        const std::string checkNull = (in.flags & IR_NONNULL) ? "false" : "true";
+        auto jump = [&](int32_t label) {
+            return "JUMP(" + std::to_string(cost[i]) + ", " + std::to_string(label) + ", " + std::to_string(ir.labels[label].index) + ")";
+        };
+        auto bin = [&](const char* write, const std::string& expr) { out << "    " << write << "(" << D << ", " << expr << ");\n"; };
+        auto divide = [&](const char* field, const char* write, const std::string& expr) {
+            out << "    if (" << rb << "." << field << " == 0) EXIT(" << at << ", JIT_EXIT_DIVIDE_BY_ZERO);\n";
+            bin(write, expr);
+        };
+        auto branch = [&](const std::string& cond) { out << "    if (" << cond << ") " << jump(in.target) << ";\n"; };
+        auto constant = [&](const char* tag, bool wide) {
+            out << "    r[" << D << "].l = " << hex64(in.imm.l) << "; t[" << D << "] = " << tag << ";";
+            if (wide) out << " t[" << (in.dst + 1) << "] = SLOT_TOP;";
+            out << "\n";
+        };
+        auto arrayLoad = [&](const char* type, const char* write, const char* conv) {
+            out << "    ALOAD(" << at << ", " << A << ", " << B << ", " << checkNull << ", " << type << ", " << write << ", " << D << ", " << conv << ");\n";
+        };
+        auto arrayStore = [&](const char* type, const std::string& value) {
+            out << "    ASTORE(" << at << ", " << A << ", " << B << ", " << checkNull << ", " << type << ", " << value << ");\n";
+        };
+        const std::string k = hex32(in.imm.i);
+        const std::string u1 = "(uint32_t)" + ra + ".i", u2 = "(uint32_t)" + rb + ".i";
+        const std::string q1 = "(uint64_t)" + ra + ".l", q2 = "(uint64_t)" + rb + ".l";
+
+        switch (in.op) {
+            case IR_NOP: break;
+            case IR_SLOW: out << "    EXIT(" << at << ", JIT_EXIT_SLOW);\n"; break;
+
+            case IR_MOV: out << "    r[" << D << "] = " << ra << "; t[" << D << "] = t[" << A << "];\n"; break;
+            case IR_MOV2:
+                out << "    r[" << D << "] = " << ra << "; t[" << D << "] = t[" << A << "]; r[" << (in.dst + 1) << "] = r["
+                    << (in.a + 1) << "]; t[" << (in.dst + 1) << "] = t[" << (in.a + 1) << "];\n";
+                break;
+            case IR_MOV_I: case IR_MOV_F: case IR_MOV_A: case IR_MOV_J: case IR_MOV_D: {
+                static const char* const tag[5] = { "JavaValue::INT", "JavaValue::LONG", "JavaValue::FLOAT", "JavaValue::DOUBLE", "JavaValue::REFERENCE" };
+                int kind = in.op - IR_MOV_I;
+                out << "    r[" << D << "] = " << ra << "; t[" << D << "] = " << tag[kind] << ";";
+                if (kind == 1 || kind == 3) out << " t[" << (in.dst + 1) << "] = SLOT_TOP;";
+                out << "\n";
+                break;
+            }
+            case IR_CONST_I: constant("JavaValue::INT", false); break;
+            case IR_CONST_F: constant("JavaValue::FLOAT", false); break;
+            case IR_CONST_J: constant("JavaValue::LONG", true); break;
+            case IR_CONST_D: constant("JavaValue::DOUBLE", true); break;
+            case IR_CONST_A:
+                // Only null: the IR of unquickened bytecode never holds object pointers
+                // 只可能是 null: 未快速化字节码的 IR 不含对象指针
+                if (in.imm.ref) return false;
+                constant("JavaValue::REFERENCE", false);
+                break;
+
+            // ---- int ----
+            case IR_ADD_I: bin("W_I", "(int32_t)(" + u1 + " + " + u2 + ")"); break;
+            case IR_SUB_I: bin("W_I", "(int32_t)(" + u1 + " - " + u2 + ")"); break;
+            case IR_MUL_I: bin("W_I", "(int32_t)(" + u1 + " * " + u2 + ")"); break;
+            case IR_DIV_I: divide("i", "W_I", "(" + rb + ".i == -1) ? (int32_t)(0u - " + u1 + ") : " + ra + ".i / " + rb + ".i"); break;
+            case IR_REM_I: divide("i", "W_I", "(" + rb + ".i == -1) ? 0 : " + ra + ".i % " + rb + ".i"); break;
+            case IR_AND_I: bin("W_I", ra + ".i & " + rb + ".i"); break;
+            case IR_OR_I: bin("W_I", ra + ".i | " + rb + ".i"); break;
+            case IR_XOR_I: bin("W_I", ra + ".i ^ " + rb + ".i"); break;
+            case IR_SHL_I: bin("W_I", "(int32_t)(" + u1 + " << (" + rb + ".i & 0x1F))"); break;
+            case IR_SHR_I: bin("W_I", ra + ".i >> (" + rb + ".i & 0x1F)"); break;
+            case IR_USHR_I: bin("W_I", "(int32_t)(" + u1 + " >> (" + rb + ".i & 0x1F))"); break;
+            case IR_NEG_I: bin("W_I", "(int32_t)(0u - " + u1 + ")"); break;
+            case IR_ADDK_I: bin("W_I", "(int32_t)(" + u1 + " + (uint32_t)" + k + ")"); break;
+            case IR_MULK_I: bin("W_I", "(int32_t)(" + u1 + " * (uint32_t)" + k + ")"); break;
+            case IR_ANDK_I: bin("W_I", ra + ".i & " + k); break;
+            case IR_ORK_I: bin("W_I", ra + ".i | " + k); break;
+            case IR_XORK_I: bin("W_I", ra + ".i ^ " + k); break;
+            case IR_SHLK_I: bin("W_I", "(int32_t)(" + u1 + " << " + std::to_string(in.imm.i) + ")"); break;
+            case IR_SHRK_I: bin("W_I", ra + ".i >> " + std::to_string(in.imm.i)); break;
+            case IR_USHRK_I: bin("W_I", "(int32_t)(" + u1 + " >> " + std::to_string(in.imm.i) + ")"); break;
+
+            // ---- long ----
+            case IR_ADD_J: bin("W_J", "(int64_t)(" + q1 + " + " + q2 + ")"); break;
+            case IR_SUB_J: bin("W_J", "(int64_t)(" + q1 + " - " + q2 + ")"); break;
+            case IR_MUL_J: bin("W_J", "(int64_t)(" + q1 + " * " + q2 + ")"); break;
+            case IR_DIV_J: divide("l", "W_J", "(" + rb + ".l == -1) ? (int64_t)(0ull - " + q1 + ") : " + ra + ".l / " + rb + ".l"); break;
+            case IR_REM_J: divide("l", "W_J", "(" + rb + ".l == -1) ? 0 : " + ra + ".l % " + rb + ".l"); break;
+            case IR_AND_J: bin("W_J", ra + ".l & " + rb + ".l"); break;
+            case IR_OR_J: bin("W_J", ra + ".l | " + rb + ".l"); break;
+            case IR_XOR_J: bin("W_J", ra + ".l ^ " + rb + ".l"); break;
+            case IR_SHL_J: bin("W_J", "(int64_t)(" + q1 + " << (" + rb + ".i & 0x3F))"); break;
+            case IR_SHR_J: bin("W_J", ra + ".l >> (" + rb + ".i & 0x3F)"); break;
+            case IR_USHR_J: bin("W_J", "(int64_t)(" + q1 + " >> (" + rb + ".i & 0x3F))"); break;
+            case IR_NEG_J: bin("W_J", "(int64_t)(0ull - " + q1 + ")"); break;
+
+            // ---- float / double ----
+            case IR_ADD_F: bin("W_F", ra + ".f + " + rb + ".f"); break;
+            case IR_SUB_F: bin("W_F", ra + ".f - " + rb + ".f"); break;
+            case IR_MUL_F: bin("W_F", ra + ".f * " + rb + ".f"); break;
+            case IR_DIV_F: bin("W_F", ra + ".f / " + rb + ".f"); break;
+            case IR_REM_F: bin("W_F", "std::fmod(" + ra + ".f, " + rb + ".f)"); break;
+            case IR_NEG_F: bin("W_F", "-" + ra + ".f"); break;
+            case IR_ADD_D: bin("W_D", ra + ".d + " + rb + ".d"); break;
+            case IR_SUB_D: bin("W_D", ra + ".d - " + rb + ".d"); break;
+            case IR_MUL_D: bin("W_D", ra + ".d * " + rb + ".d"); break;
+            case IR_DIV_D: bin("W_D", ra + ".d / " + rb + ".d"); break;
+            case IR_REM_D: bin("W_D", "std::fmod(" + ra + ".d, " + rb + ".d)"); break;
+            case IR_NEG_D: bin("W_D", "-" + ra + ".d"); break;
+
+            // ---- Conversions / 类型转换 ----
+            case IR_I2L: bin("W_J", "(int64_t)" + ra + ".i"); break;
+            case IR_I2F: bin("W_F", "(float)" + ra + ".i"); break;
+            case IR_I2D: bin("W_D", "(double)" + ra + ".i"); break;
+            case IR_L2I: bin("W_I", "(int32_t)" + ra + ".l"); break;
+            case IR_L2F: bin("W_F", "(float)" + ra + ".l"); break;
+            case IR_L2D: bin("W_D", "(double)" + ra + ".l"); break;
+            case IR_F2I: bin("W_I", "(int32_t)" + ra + ".f"); break;
+            case IR_F2L: bin("W_J", "(int64_t)" + ra + ".f"); break;
+            case IR_F2D: bin("W_D", "(double)" + ra + ".f"); break;
+            case IR_D2I: bin("W_I", "(int32_t)" + ra + ".d"); break;
+            case IR_D2L: bin("W_J", "(int64_t)" + ra + ".d"); break;
+            case IR_D2F: bin("W_F", "(float)" + ra + ".d"); break;
+            case IR_I2B: bin("W_I", "(int8_t)" + ra + ".i"); break;
+            case IR_I2C: bin("W_I", "(uint16_t)" + ra + ".i"); break;
+            case IR_I2S: bin("W_I", "(int16_t)" + ra + ".i"); break;
+
+            // ---- Comparisons and branches / 比较与跳转 ----
+            case IR_CMP_J: bin("W_I", "(" + ra + ".l > " + rb + ".l) ? 1 : ((" + ra + ".l < " + rb + ".l) ? -1 : 0)"); break;
+            case IR_CMPL_F: bin("W_I", "compareFloating(" + ra + ".f, " + rb + ".f, -1)"); break;
+            case IR_CMPG_F: bin("W_I", "compareFloating(" + ra + ".f, " + rb + ".f, 1)"); break;
+            case IR_CMPL_D: bin("W_I", "compareFloating(" + ra + ".d, " + rb + ".d, -1)"); break;
+            case IR_CMPG_D: bin("W_I", "compareFloating(" + ra + ".d, " + rb + ".d, 1)"); break;
+            case IR_IF_EQ: case IR_IF_NE: case IR_IF_LT: case IR_IF_GE: case IR_IF_GT: case IR_IF_LE: {
+                static const char* const cond[6] = { "==", "!=", "<", ">=", ">", "<=" };
+                branch(ra + ".i " + cond[in.op - IR_IF_EQ] + " " + rb + ".i");
+                break;
+            }
+            case IR_IFK_EQ: case IR_IFK_NE: case IR_IFK_LT: case IR_IFK_GE: case IR_IFK_GT: case IR_IFK_LE: {
+                static const char* const cond[6] = { "==", "!=", "<", ">=", ">", "<=" };
+                branch(ra + ".i " + cond[in.op - IR_IFK_EQ] + " " + k);
+                break;
+            }
+            case IR_IF_ACMPEQ: branch(ra + ".ref == " + rb + ".ref"); break;
+            case IR_IF_ACMPNE: branch(ra + ".ref != " + rb + ".ref"); break;
+            case IR_IF_NULL: branch(ra + ".ref == nullptr"); break;
+            case IR_IF_NONNULL: branch(ra + ".ref != nullptr"); break;
+            case IR_GOTO: out << "    " << jump(in.target) << ";\n"; break;
+            case IR_TABLESWITCH: {
+                const IRSwitch& sw = ir.switches[in.target];
+                out << "    {\n        static const int32_t targets_[] = {";
+                for (size_t j = 0; j < sw.targets.size(); j++) out << (j ? ", " : " ") << sw.targets[j];
+                out << " };\n        int64_t k_ = (int64_t)" << ra << ".i - (int64_t)" << hex32(sw.low) << ";\n";
+                out << "        JUMP_TO(" << cost[i] << ", (k_ >= 0 && k_ < " << sw.targets.size() << ") ? targets_[k_] : "
+                    << sw.defaultTarget << ");\n    }\n";
+                break;
+            }
+            case IR_LOOKUPSWITCH: {
+                const IRSwitch& sw = ir.switches[in.target];
+                if (sw.keys.empty()) {
+                    out << "    JUMP_TO(" << cost[i] << ", " << sw.defaultTarget << ");\n";
+                    break;
+                }
+                out << "    {\n        static const int32_t keys_[] = {";
+                for (size_t j = 0; j < sw.keys.size(); j++) out << (j ? ", " : " ") << hex32(sw.keys[j]);
+                out << " };\n        static const int32_t targets_[] = {";
+                for (size_t j = 0; j < sw.targets.size(); j++) out << (j ? ", " : " ") << sw.targets[j];
+                out << " };\n        JUMP_TO(" << cost[i] << ", lookupSwitch(keys_, targets_, " << sw.keys.size() << ", " << ra
+                    << ".i, " << sw.defaultTarget << "));\n    }\n";
+                break;
+            }
+
+            // ---- Arrays / 数组 ----
+            case IR_ALOAD_I: arrayLoad("int32_t", "W_I", "raw"); break;
+            case IR_ALOAD_J: arrayLoad("int64_t", "W_J", "raw"); break;
+            case IR_ALOAD_F: arrayLoad("int32_t", "W_F", "rawToF(raw)"); break;
+            case IR_ALOAD_D: arrayLoad("int64_t", "W_D", "rawToD(raw)"); break;
+            case IR_ALOAD_A: arrayLoad("HeapRef", "W_A", "(void*)decodeRef(raw)"); break;
+            case IR_ALOAD_B: arrayLoad("int8_t", "W_I", "raw"); break;
+            case IR_ALOAD_C: arrayLoad("uint16_t", "W_I", "raw"); break;
+            case IR_ALOAD_S: arrayLoad("int16_t", "W_I", "raw"); break;
+            case IR_ASTORE_I: arrayStore("int32_t", rc + ".i"); break;
+            case IR_ASTORE_J: arrayStore("int64_t", rc + ".l"); break;
+            case IR_ASTORE_F: arrayStore("int32_t", "(int32_t)fToRaw(" + rc + ".f)"); break;
+            case IR_ASTORE_D: arrayStore("int64_t", "dToRaw(" + rc + ".d)"); break;
+            case IR_ASTORE_A: arrayStore("HeapRef", "(markCard(a_), encodeRef((JavaObject*)" + rc + ".ref))"); break;
+            case IR_ASTORE_B: arrayStore("int8_t", "(int8_t)" + rc + ".i"); break;
+            case IR_ASTORE_C: arrayStore("uint16_t", "(uint16_t)" + rc + ".i"); break;
+            case IR_ASTORE_S: arrayStore("int16_t", "(int16_t)" + rc + ".i"); break;
+            case IR_ARRAYLENGTH:
+                if (!(in.flags & IR_NONNULL)) out << "    if (!" << ra << ".ref) EXIT(" << at << ", JIT_EXIT_NULL_POINTER);\n";
+                bin("W_I", "objectOf(" + ra + ".ref)->arrayLength()");
+                break;
+
+            // ---- Returns / 返回 ----
+            case IR_RETURN: case IR_RETURN_I: case IR_RETURN_J: case IR_RETURN_F: case IR_RETURN_D: case IR_RETURN_A:
+                out << "    EXIT(" << at << ", JIT_EXIT_RETURN);\n";
+                break;
+
+            // Field access and type checks only come from quickened bytecode
+            // 字段访问与类型检查只来自快速化后的字节码
+            default:
+                return false;
+        }
+    }
+    // Falling off the end cannot happen for verified bytecode
+    // 校验过的字节码不会越过方法末尾
+    if (entries.count((uint32_t)n)) out << "I" << n << ":\n";
+    out << "    EXIT(0, -1);\n";
+    body = out.str();
+    return true;
+}
+
+bool AotCompiler::translateJar(const std::string& jarPath) {
+    auto bytes = util::FileUtils::readFile(jarPath);
+    if (!bytes) {
+        LOG_ERROR("Cannot read " + jarPath);
+        return false;
+    }
+    hash = aotHash(bytes->data(), bytes->size());
+
+    loader::JarLoader jar;
+    if (!jar.load(jarPath)) {
+        LOG_ERROR("Cannot open " + jarPath + " as a JAR");
+        return false;
+    }
+    for (const std::string& name : jar.listFiles()) {
+        if (!util::FileUtils::isClassFile(name)) continue;
+        auto data = jar.getFile(name);
+        if (!data) continue;
+        std::shared_ptr<ClassFile> cf;
+        try {
+            ClassParser parser;
+            cf = parser.parse(*data);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Skipping " + name + ": " + e.what());
+            continue;
+        }
+        counters.classes++;
+        for (const auto& info : cf->methods) {
+            RuntimeMethod method(info, *cf);
+            if (method.code.empty()) continue;
+            counters.methods++;
+            Method compiled;
+            compiled.key = aotMethodKey(*cf, info);
+            if (compiled.key.empty()) continue;
+            std::shared_ptr<IRMethod> ir = buildIR(method, *cf, nullptr);
+            if (!ir) {
+                LOG_DEBUG("Cannot translate " + compiled.key + ", leaving it to the interpreter");
+                continue;
+            }
+            if (!worthCompiling(*ir) || !emitMethod(*ir, compiled.body)) continue;
+            compiled.codeHash = aotHash(method.code.data(), method.code.size());
+            compiled.irSize = (uint32_t)ir->code.size();
+            counters.compiled++;
+            counters.irInsns += ir->code.size();
+            methods.push_back(std::move(compiled));
+        }
+    }
+    return true;
+}
+
+void AotCompiler::writeSource(std::ostream& out) const {
+    // The module stores references the way the VM this tool was built with does
+    // 模块按构建本工具时的方式存储引用，与虚拟机一致
+    out << "// Generated by j2me-aot, do not edit.\n// 由 j2me-aot 生成，请勿手工修改\n"
+        << "#define J2ME_COMPRESSED_REFS " << J2ME_COMPRESSED_REFS << "\n"
+        << PRELUDE << "\n";
+    for (size_t m = 0; m < methods.size(); m++) {
+        out << "// " << methods[m].key << "\n";
+        out << "static int32_t m" << m << "(JitContext* ctx, Slot* r, uint8_t* t, uint32_t ip) {\n";
+        out << methods[m].body << "}\n\n";
+    }
+    if (methods.empty()) {
+        out << "static const AotMethod* const methods = nullptr;\n";
+    } else {
+        out << "static const AotMethod methods[] = {\n";
+        for (size_t m = 0; m < methods.size(); m++) {
+            out << "    { " << quote(methods[m].key) << ", " << hexU64(methods[m].codeHash) << ", "
+                << methods[m].irSize << "u, &m" << m << " },\n";
+        }
+        out << "};\n";
+    }
+    out << "\nstatic const AotModule module = {\n"
+        << "    AOT_ABI_VERSION, (uint32_t)sizeof(JavaObject), (uint32_t)sizeof(HeapRef), " << hexU64(hash) << ",\n"
+        << "    " << methods.size() << "u, methods, " << (J2ME_COMPRESSED_REFS ? "&compressedRefBase" : "nullptr") << ", &cardTableBase\n};\n\n"
+        << "extern \"C\" __attribute__((visibility(\"default\"))) const AotModule* j2me_aot_module() { return &module; }\n";
+}
+
+} // namespace aot
+} // namespace j2me
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+#include "../core/RegisterIR.hpp"
+
+namespace j2me {
+namespace aot {
+
+// Offline half of the AOT tier (see core/AotModule.hpp): translates the methods of a
+// JAR to register IR with core::buildIR and writes them out as a C++ module, one
+// function per method with the same entry/exit contract as JIT code.
+// AOT 执行层的离线部分 (见 core/AotModule.hpp): 用 core::buildIR 将 JAR 中的方法翻译为寄存器 IR，
+// 并输出为 C++ 模块，每个方法一个函数，入口/出口约定与 JIT 机器码相同
+class AotCompiler {
+public:
+    struct Stats {
+        size_t classes = 0;      // Classes parsed / 解析的类
+        size_t methods = 0;      // Methods with bytecode / 有字节码的方法
+        size_t compiled = 0;     // Methods emitted / 生成代码的方法
+        size_t irInsns = 0;      // IR insns emitted / 生成的 IR 指令数
+    };
+
+    // Translate every class of the JAR; false if it cannot be read
+    // 翻译 JAR 中的所有类; 无法读取时返回 false
+    bool translateJar(const std::string& jarPath);
+
+    // Write the C++ source of the module / 输出模块的 C++ 源码
+    void writeSource(std::ostream& out) const;
+
+    uint64_t jarHash() const { return hash; }
+    const Stats& stats() const { return counters; }
+
+private:
+    struct Method {
+        std::string key;
+        uint64_t codeHash;
+        std::string body;        // Generated function body / 生成的函数体
+        uint32_t irSize;
+    };
+
+    // C++ body for `ir`; false if the IR refers to runtime objects (only quickened
+    // bytecode does, which a JAR on disk never contains)
+    // 生成 ir 对应的 C++ 函数体; IR 引用运行时对象时返回 false (只有快速化后的字节码会如此，磁盘上的 JAR 不含)
+    static bool emitMethod(const core::IRMethod& ir, std::string& body);
+
+    uint64_t hash = 0;
+    std::vector<Method> methods;
+    Stats counters;
+};
+
+} // namespace aot
+} // namespace j2me
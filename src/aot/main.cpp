@@ -0,0 +1,98 @@
+#include "AotCompiler.hpp"
+#include "../core/AotModule.hpp"
+#include "../core/BytecodeOptimizer.hpp"
+#include "../core/Logger.hpp"
+#include <fstream>
+#include <cstdlib>
+#include <string>
+
+// j2me-aot: ahead-of-time compiler for MIDlet JARs (see core/AotModule.hpp)
+// j2me-aot: MIDlet JAR 的预先编译器 (见 core/AotModule.hpp)
+//
+//   j2me-aot [--debug] [-o MODULE] [--emit-only] [--cxx COMPILER] [--peephole=LIST] <app.jar>
+//
+// Writes MODULE.cpp and compiles it into MODULE, by default the path next to the JAR
+// where j2me-vm looks for it. Methods are compiled from the bytecode as rewritten by the
+// load-time peephole passes; j2me-vm only uses a method when it runs the same passes.
+// 生成 MODULE.cpp 并编译为 MODULE，默认输出到 JAR 旁边 j2me-vm 查找模块的位置。
+// 方法按加载时窥孔优化改写后的字节码编译; 只有 j2me-vm 启用相同的优化时才会使用这些方法
+
+#ifndef J2ME_AOT_CXX
+#define J2ME_AOT_CXX "c++"
+#endif
+#ifndef J2ME_AOT_INCLUDE_DIR
+#define J2ME_AOT_INCLUDE_DIR "src/core"
+#endif
+
+int main(int argc, char* argv[]) {
+    using j2me::core::Logger;
+    using j2me::core::LogLevel;
+
+    std::string jarPath;
+    std::string output;
+    std::string cxx = J2ME_AOT_CXX;
+    bool emitOnly = false;
+    Logger::getInstance().setLevel(LogLevel::INFO);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--debug") {
+            Logger::getInstance().setLevel(LogLevel::DEBUG);
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg.rfind("--peephole=", 0) == 0) {
+            if (!j2me::core::BytecodeOptimizer::getInstance().setPasses(arg.substr(11))) {
+                LOG_ERROR("Invalid peephole passes: " + arg.substr(11));
+                return 1;
+            }
+        } else if (arg == "--emit-only") {
+            emitOnly = true;
+        } else if (arg == "--cxx" && i + 1 < argc) {
+            cxx = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-' && jarPath.empty()) {
+            jarPath = arg;
+        } else {
+            LOG_ERROR("Unknown argument: " + arg);
+            return 1;
+        }
+    }
+    if (jarPath.empty()) {
+        LOG_INFO("Usage: j2me-aot [--debug] [-o MODULE] [--emit-only] [--cxx COMPILER] [--peephole=LIST] <app.jar>");
+        LOG_INFO("  MODULE: shared library to write (default: <app>-<jar hash>.aot.so next to the JAR, where j2me-vm finds it)");
+        LOG_INFO("  --emit-only: only write MODULE.cpp");
+        LOG_INFO("  COMPILER: C++ compiler used to build the module (default: " J2ME_AOT_CXX ")");
+        LOG_INFO("  LIST: load-time peephole passes, as given to j2me-vm --peephole (default: all)");
+        return 1;
+    }
+
+    j2me::aot::AotCompiler compiler;
+    if (!compiler.translateJar(jarPath)) return 1;
+    const auto& stats = compiler.stats();
+    LOG_INFO("Compiled " + std::to_string(stats.compiled) + " of " + std::to_string(stats.methods) + " methods in " +
+             std::to_string(stats.classes) + " classes (" + std::to_string(stats.irInsns) + " IR insns)");
+    LOG_INFO("Peephole: " + j2me::core::BytecodeOptimizer::getInstance().describeStats());
+
+    if (output.empty()) output = j2me::core::aotModulePath(jarPath, compiler.jarHash());
+    std::string source = output + ".cpp";
+    {
+        std::ofstream out(source);
+        if (!out) {
+            LOG_ERROR("Cannot write " + source);
+            return 1;
+        }
+        compiler.writeSource(out);
+    }
+    if (emitOnly) {
+        LOG_INFO("Wrote " + source);
+        return 0;
+    }
+
+    std::string command = cxx + " -std=c++17 -O2 -fPIC -shared -fvisibility=hidden -I\"" J2ME_AOT_INCLUDE_DIR "\" -o \"" +
+                          output + "\" \"" + source + "\"";
+    LOG_DEBUG(command);
+    if (std::system(command.c_str()) != 0) {
+        LOG_ERROR("Compiling " + source + " failed");
+        return 1;
+    }
+    LOG_INFO("Wrote " + output);
+    return 0;
+}
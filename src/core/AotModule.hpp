@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <memory>
+#include "JitX64.hpp"
+
+// -DJ2ME_AOT=0 leaves out loading AOT modules (they are shared libraries opened with dlopen)
+// 可通过 -DJ2ME_AOT=0 去掉 AOT 模块的加载 (模块是通过 dlopen 打开的共享库)
+#ifndef J2ME_AOT
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(__SWITCH__)
+#define J2ME_AOT 1
+#else
+#define J2ME_AOT 0
+#endif
+#endif
+
+namespace j2me {
+namespace core {
+
+// Ahead-of-time compiled MIDlet code.
+//
+// The j2me-aot tool (src/aot) translates every method of a JAR with buildIR, exactly as
+// the second tier would before the method first runs, and emits one C++ function per
+// method that follows the JitCode contract (enter at an IR insn, leave through a
+// JitExit). The functions are compiled into a shared library that exports an AotModule.
+// At startup the VM opens the library that matches the JAR's hash (Interpreter_Aot.cpp),
+// rebuilds the IR of each listed method, and if it matches what the tool compiled, runs
+// the method through the function from its first call on. Anything that does not match
+// stays on the interpreter.
+//
+// 预先编译 (AOT) 的 MIDlet 代码。
+// j2me-aot 工具 (src/aot) 用 buildIR 翻译 JAR 中的每个方法 (与方法首次运行前第二执行层的翻译完全相同)，
+// 并为每个方法生成一个遵循 JitCode 约定的 C++ 函数 (从某条 IR 指令进入，以 JitExit 离开)。
+// 这些函数编译为导出 AotModule 的共享库。虚拟机启动时打开与 JAR 哈希匹配的库 (Interpreter_Aot.cpp)，
+// 重新构建所列方法的 IR，与工具编译时一致则从第一次调用起即通过该函数执行; 不一致的方法仍由解释器执行
+
+// Bumped whenever the IR, JitContext/JitExit or this header change
+// IR、JitContext/JitExit 或本头文件变化时递增
+constexpr uint32_t AOT_ABI_VERSION = 4;
+
+// Exported by every module / 每个模块导出的符号
+#define J2ME_AOT_MODULE_SYMBOL "j2me_aot_module"
+
+struct AotMethod {
+    const char* key;            // aotMethodKey() / 方法键
+    uint64_t codeHash;          // aotHash() of the bytecode it was compiled from / 编译时字节码的哈希
+    uint32_t irSize;            // IR insns the function was generated from / 生成函数时的 IR 指令数
+    CompiledFunction function;
+};
+
+struct AotModule {
+    uint32_t abiVersion;        // AOT_ABI_VERSION
+    uint32_t objectHeaderSize;  // sizeof(JavaObject) of the headers it was built with / 构建时的对象头大小
+    uint32_t referenceSize;     // sizeof(HeapRef): 4 with J2ME_COMPRESSED_REFS / 启用压缩引用时为 4
+    uint64_t jarHash;           // aotHash() of the JAR file / JAR 文件的哈希
+    uint32_t methodCount;
+    const AotMethod* methods;
+    uint8_t** heapBase;         // The module's compressedRefBase, set by the VM; nullptr without compressed references / 模块自身的 compressedRefBase，由虚拟机设置
+    uint8_t** cardTable;        // The module's cardTableBase (write barrier), set by the VM / 模块自身的 cardTableBase (写屏障)，由虚拟机设置
+};
+
+using AotModuleGetter = const AotModule* (*)();
+
+// 64-bit FNV-1a, used for the JAR and for method bytecode
+// 64 位 FNV-1a 哈希，用于 JAR 文件和方法字节码
+inline uint64_t aotHash(const uint8_t* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Where j2me-aot puts, and the VM looks for, the module of a JAR: "game.jar" with hash
+// 0x0123456789abcdef -> "game-0123456789abcdef.aot.so" next to it
+// j2me-aot 输出、虚拟机查找 JAR 对应模块的位置: 与 JAR 同目录，文件名中带有 JAR 的哈希
+inline std::string aotModulePath(const std::string& jarPath, uint64_t jarHash) {
+    std::string base = jarPath;
+    if (base.size() > 4 && base.compare(base.size() - 4, 4, ".jar") == 0) base.resize(base.size() - 4);
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; i--, jarHash >>= 4) hex[i] = digits[jarHash & 0xF];
+    return base + "-" + hex + ".aot.so";
+}
+
+// "class.nameDescriptor", e.g. "com/foo/Game.tick(I)V"; empty if the constant pool is malformed
+// 方法键 "类名.方法名描述符"; 常量池格式错误时返回空串
+inline std::string aotMethodKey(const ClassFile& cf, const MethodInfo& method) {
+    auto utf8 = [&](uint16_t index) -> const std::string* {
+        if (index >= cf.constant_pool.size()) return nullptr;
+        auto entry = std::dynamic_pointer_cast<ConstantUtf8>(cf.constant_pool[index]);
+        return entry ? &entry->bytes : nullptr;
+    };
+    if (cf.this_class >= cf.constant_pool.size()) return std::string();
+    auto cls = std::dynamic_pointer_cast<ConstantClass>(cf.constant_pool[cf.this_class]);
+    const std::string* className = cls ? utf8(cls->name_index) : nullptr;
+    const std::string* name = utf8(method.name_index);
+    const std::string* descriptor = utf8(method.descriptor_index);
+    if (!className || !name || !descriptor) return std::string();
+    return *className + "." + *name + *descriptor;
+}
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,698 @@
+#include "BytecodeOptimizer.hpp"
+#include "Opcodes.hpp"
+#include "Logger.hpp"
+#include "../util/DataReader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace j2me {
+namespace core {
+
+// 加载时窥孔优化
+// 方法体先解码为指令列表 (跳转目标以指令下标表示)，各优化只标记删除或原地改写指令，最后重新排布字节码并修正跳转偏移、
+// 异常表和行号表。被删除指令的跳转目标落到其后第一条保留的指令上，因此只删除那些从该处进入时等价于空操作的指令。
+// 含 jsr/ret/wide 或无法解码的方法保持原样; Code 属性中除 LineNumberTable 外的子属性 (StackMap、
+// LocalVariableTable 等) 虚拟机不使用，改写后不再保留。
+//
+// A method body is decoded into a list of instructions whose branch targets are
+// instruction indices. Passes only mark instructions removed or rewrite them in place;
+// the code is then laid out again and branch offsets, the exception table and the line
+// number table are remapped. A branch to a removed instruction lands on the next kept
+// one, so only instructions that are a no-op when entered there are removed. Methods
+// with jsr/ret/wide or anything undecodable are left alone. Sub-attributes of Code other
+// than LineNumberTable (StackMap, LocalVariableTable...) are not used by the VM and are
+// dropped from rewritten methods.
+
+namespace {
+
+const uint16_t ACC_STATIC = 0x0008;
+const uint16_t ACC_FINAL = 0x0010;
+
+struct Insn {
+    uint32_t pc = 0;                // Original pc / 原始 pc
+    uint8_t op = 0;
+    std::vector<uint8_t> operands;  // Operand bytes of everything but branches and switches
+    int32_t target = -1;            // Branch target or switch default (instruction index)
+    int32_t low = 0;                // TABLESWITCH low key
+    std::vector<int32_t> keys;      // LOOKUPSWITCH keys
+    std::vector<int32_t> targets;   // Switch targets (instruction indices)
+    bool removed = false;
+    bool targeted = false;          // Branch target or handler entry / 跳转目标或异常处理入口
+};
+
+struct ExceptionEntry {
+    uint32_t startPc, endPc, handlerPc; // Instruction indices once decoded / 解码后为指令下标
+    uint16_t catchType;
+};
+
+struct LineEntry {
+    uint32_t startPc; // Instruction index once decoded / 解码后为指令下标
+    uint16_t line;
+};
+
+struct MethodCode {
+    AttributeInfo* attribute = nullptr;
+    bool isStatic = false;
+    uint16_t maxStack = 0;
+    uint16_t maxLocals = 0;
+    uint32_t codeLength = 0;
+    std::vector<Insn> insns;
+    std::vector<ExceptionEntry> exceptions;
+    uint16_t lineTableName = 0; // Constant pool index of "LineNumberTable", 0 if absent
+    std::vector<LineEntry> lines;
+};
+
+bool isBranch(uint8_t op) {
+    return (op >= OP_IFEQ && op <= OP_GOTO) || op == OP_IFNULL || op == OP_IFNONNULL || op == OP_GOTO_W;
+}
+bool isGoto(uint8_t op) { return op == OP_GOTO || op == OP_GOTO_W; }
+bool isSwitch(uint8_t op) { return op == OP_TABLESWITCH || op == OP_LOOKUPSWITCH; }
+
+int32_t readS4(const std::vector<uint8_t>& code, size_t at) {
+    return (int32_t)(((uint32_t)code[at] << 24) | ((uint32_t)code[at + 1] << 16) | ((uint32_t)code[at + 2] << 8) | code[at + 3]);
+}
+void writeU2(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)v);
+}
+void writeU4(std::vector<uint8_t>& out, uint32_t v) {
+    writeU2(out, v >> 16);
+    writeU2(out, v & 0xFFFF);
+}
+
+template <typename T>
+const T* constantAt(const ClassFile& cf, uint32_t index, uint8_t tag) {
+    if (index == 0 || index >= cf.constant_pool.size()) return nullptr;
+    const ConstantPoolInfo* info = cf.constant_pool[index].get();
+    return info && info->tag == tag ? static_cast<const T*>(info) : nullptr;
+}
+
+std::string utf8At(const ClassFile& cf, uint32_t index) {
+    const ConstantUtf8* utf8 = constantAt<ConstantUtf8>(cf, index, CONSTANT_Utf8);
+    return utf8 ? utf8->bytes : std::string();
+}
+
+std::string classNameAt(const ClassFile& cf, uint32_t index) {
+    const ConstantClass* cls = constantAt<ConstantClass>(cf, index, CONSTANT_Class);
+    return cls ? utf8At(cf, cls->name_index) : std::string();
+}
+
+uint16_t operandU2(const Insn& in) { return in.operands.size() >= 2 ? (uint16_t)((in.operands[0] << 8) | in.operands[1]) : 0; }
+
+// "name|descriptor" of a Fieldref into the class itself, empty for other classes
+// 指向本类字段的 Fieldref 的 "名称|描述符"，其他类的字段返回空串
+std::string ownFieldKey(const ClassFile& cf, uint16_t fieldref, const std::string& thisName) {
+    const ConstantRef* ref = constantAt<ConstantRef>(cf, fieldref, CONSTANT_Fieldref);
+    if (!ref || classNameAt(cf, ref->class_index) != thisName) return std::string();
+    const ConstantNameAndType* nt = constantAt<ConstantNameAndType>(cf, ref->name_and_type_index, CONSTANT_NameAndType);
+    if (!nt) return std::string();
+    return utf8At(cf, nt->name_index) + "|" + utf8At(cf, nt->descriptor_index);
+}
+
+// Decode a Code attribute; false if the method has to be left as it is
+// 解码 Code 属性; 方法需保持原样时返回 false
+bool decode(const ClassFile& cf, AttributeInfo& attribute, MethodCode& m) {
+    util::DataReader reader(attribute.info);
+    m.attribute = &attribute;
+    m.maxStack = reader.readU2();
+    m.maxLocals = reader.readU2();
+    m.codeLength = reader.readU4();
+    if (m.codeLength == 0 || m.codeLength > 65535) return false;
+    std::vector<uint8_t> code = reader.readBytes(m.codeLength);
+    uint16_t exceptionCount = reader.readU2();
+    for (int i = 0; i < exceptionCount; i++) {
+        ExceptionEntry entry;
+        entry.startPc = reader.readU2();
+        entry.endPc = reader.readU2();
+        entry.handlerPc = reader.readU2();
+        entry.catchType = reader.readU2();
+        m.exceptions.push_back(entry);
+    }
+    uint16_t subAttributes = reader.readU2();
+    for (int i = 0; i < subAttributes && !reader.hasError(); i++) {
+        uint16_t nameIndex = reader.readU2();
+        uint32_t length = reader.readU4();
+        size_t next = reader.tell() + length;
+        if (utf8At(cf, nameIndex) == "LineNumberTable") {
+            m.lineTableName = nameIndex;
+            uint16_t count = reader.readU2();
+            for (int j = 0; j < count; j++) {
+                LineEntry entry;
+                entry.startPc = reader.readU2();
+                entry.line = reader.readU2();
+                m.lines.push_back(entry);
+            }
+        }
+        reader.seek(next);
+    }
+    if (reader.hasError() || code.size() != m.codeLength) return false;
+
+    // Instructions, with absolute target pcs for now / 指令，跳转目标暂为绝对 pc
+    std::vector<int32_t> indexAt(m.codeLength + 1, -1);
+    for (size_t pc = 0; pc < m.codeLength;) {
+        uint8_t op = code[pc];
+        size_t len = instructionLength(code, pc);
+        // jsr/ret/wide (length 0), and opcodes a class file never contains
+        // jsr/ret/wide (长度为 0)，以及类文件中不会出现的操作码
+        if (len == 0 || pc + len > m.codeLength || op > OP_GOTO_W) return false;
+        Insn in;
+        in.pc = (uint32_t)pc;
+        in.op = op;
+        if (op == OP_GOTO_W) {
+            in.target = (int32_t)pc + readS4(code, pc + 1);
+        } else if (isBranch(op)) {
+            in.target = (int32_t)pc + (int16_t)((code[pc + 1] << 8) | code[pc + 2]);
+        } else if (isSwitch(op)) {
+            size_t base = (pc + 4) & ~(size_t)3;
+            in.target = (int32_t)pc + readS4(code, base);
+            if (op == OP_TABLESWITCH) {
+                in.low = readS4(code, base + 4);
+                int64_t count = (int64_t)readS4(code, base + 8) - in.low + 1;
+                for (int64_t k = 0; k < count; k++) in.targets.push_back((int32_t)pc + readS4(code, base + 12 + 4 * k));
+            } else {
+                int32_t npairs = readS4(code, base + 4);
+                for (int32_t k = 0; k < npairs; k++) {
+                    in.keys.push_back(readS4(code, base + 8 + 8 * k));
+                    in.targets.push_back((int32_t)pc + readS4(code, base + 12 + 8 * k));
+                }
+            }
+        } else {
+            in.operands.assign(code.begin() + pc + 1, code.begin() + pc + len);
+        }
+        indexAt[pc] = (int32_t)m.insns.size();
+        m.insns.push_back(std::move(in));
+        pc += len;
+    }
+    indexAt[m.codeLength] = (int32_t)m.insns.size();
+
+    // Every pc the method refers to has to start an instruction
+    // 方法中引用的每个 pc 都必须位于指令开头
+    bool valid = true;
+    auto toIndex = [&](int64_t pc, bool allowEnd) -> int32_t {
+        if (pc < 0 || pc > (int64_t)m.codeLength || (pc == m.codeLength && !allowEnd) || indexAt[pc] < 0) {
+            valid = false;
+            return 0;
+        }
+        return indexAt[pc];
+    };
+    for (Insn& in : m.insns) {
+        if (isBranch(in.op) || isSwitch(in.op)) {
+            in.target = toIndex(in.target, false);
+            m.insns[in.target].targeted = true;
+        }
+        for (int32_t& t : in.targets) {
+            t = toIndex(t, false);
+            m.insns[t].targeted = true;
+        }
+    }
+    for (ExceptionEntry& entry : m.exceptions) {
+        entry.startPc = toIndex(entry.startPc, false);
+        entry.endPc = toIndex(entry.endPc, true);
+        entry.handlerPc = toIndex(entry.handlerPc, false);
+        if (valid) m.insns[entry.handlerPc].targeted = true;
+    }
+    std::vector<LineEntry> lines;
+    for (LineEntry entry : m.lines) {
+        if (entry.startPc < m.codeLength && indexAt[entry.startPc] >= 0) {
+            entry.startPc = indexAt[entry.startPc];
+            lines.push_back(entry);
+        }
+    }
+    m.lines.swap(lines);
+    return valid;
+}
+
+int32_t nextKept(const MethodCode& m, int32_t i) {
+    while (i < (int32_t)m.insns.size() && m.insns[i].removed) i++;
+    return i;
+}
+int32_t prevKept(const MethodCode& m, int32_t i) {
+    do { i--; } while (i >= 0 && m.insns[i].removed);
+    return i;
+}
+
+void setConstantIndex(Insn& in, uint16_t index, bool wide) {
+    if (wide) {
+        in.op = OP_LDC2_W;
+        in.operands = { (uint8_t)(index >> 8), (uint8_t)index };
+    } else if (index <= 0xFF) {
+        in.op = OP_LDC;
+        in.operands = { (uint8_t)index };
+    } else {
+        in.op = OP_LDC_W;
+        in.operands = { (uint8_t)(index >> 8), (uint8_t)index };
+    }
+}
+
+// Rewrite `in` to push the ConstantValue at `index` for a field of type `descriptor`
+// 将 in 改写为压入 index 处的 ConstantValue (字段类型为 descriptor)
+bool pushConstant(const ClassFile& cf, Insn& in, const std::string& descriptor, uint16_t index) {
+    switch (descriptor.empty() ? 0 : descriptor[0]) {
+        case 'I': case 'S': case 'B': case 'C': case 'Z': {
+            const ConstantInteger* value = constantAt<ConstantInteger>(cf, index, CONSTANT_Integer);
+            if (!value) return false;
+            int32_t v = value->bytes;
+            if (v >= -1 && v <= 5) {
+                in.op = (uint8_t)(OP_ICONST_0 + v);
+                in.operands.clear();
+            } else if (v >= -128 && v <= 127) {
+                in.op = OP_BIPUSH;
+                in.operands = { (uint8_t)(int8_t)v };
+            } else if (v >= -32768 && v <= 32767) {
+                in.op = OP_SIPUSH;
+                in.operands = { (uint8_t)((uint16_t)v >> 8), (uint8_t)v };
+            } else {
+                setConstantIndex(in, index, false);
+            }
+            return true;
+        }
+        case 'F': {
+            const ConstantFloat* value = constantAt<ConstantFloat>(cf, index, CONSTANT_Float);
+            if (!value) return false;
+            setConstantIndex(in, index, false);
+            for (int k = 0; k <= 2; k++) {
+                float f = (float)k;
+                if (std::memcmp(&f, &value->bytes, sizeof(float)) == 0) {
+                    in.op = (uint8_t)(OP_FCONST_0 + k);
+                    in.operands.clear();
+                }
+            }
+            return true;
+        }
+        case 'J': {
+            const ConstantLong* value = constantAt<ConstantLong>(cf, index, CONSTANT_Long);
+            if (!value) return false;
+            setConstantIndex(in, index, true);
+            if (value->bytes == 0 || value->bytes == 1) {
+                in.op = (uint8_t)(OP_LCONST_0 + value->bytes);
+                in.operands.clear();
+            }
+            return true;
+        }
+        case 'D': {
+            const ConstantDouble* value = constantAt<ConstantDouble>(cf, index, CONSTANT_Double);
+            if (!value) return false;
+            setConstantIndex(in, index, true);
+            for (int k = 0; k <= 1; k++) {
+                double d = (double)k;
+                if (std::memcmp(&d, &value->bytes, sizeof(double)) == 0) {
+                    in.op = (uint8_t)(OP_DCONST_0 + k);
+                    in.operands.clear();
+                }
+            }
+            return true;
+        }
+        default:
+            if (descriptor != "Ljava/lang/String;" || !constantAt<ConstantString>(cf, index, CONSTANT_String)) return false;
+            setConstantIndex(in, index, false);
+            return true;
+    }
+}
+
+// ---- Passes / 各项优化 ----
+
+struct PassContext {
+    const ClassFile& cf;
+    const std::string& thisName;
+    const std::string& superName;
+    const std::map<std::string, std::pair<std::string, uint16_t>>& constants; // key -> (descriptor, ConstantValue index)
+};
+
+size_t foldConstants(const PassContext& ctx, MethodCode& m) {
+    size_t rewrites = 0;
+    for (Insn& in : m.insns) {
+        if (in.op != OP_GETSTATIC) continue;
+        auto it = ctx.constants.find(ownFieldKey(ctx.cf, operandU2(in), ctx.thisName));
+        if (it == ctx.constants.end()) continue;
+        Insn folded = in;
+        if (!pushConstant(ctx.cf, folded, it->second.first, it->second.second)) continue;
+        in = std::move(folded);
+        rewrites++;
+    }
+    return rewrites;
+}
+
+// A CHECKCAST that cannot fail: to Object, of null, of a string literal to String, of a
+// repeated cast, or of 'this' (never reassigned) to this class or its superclass
+// 不会失败的 CHECKCAST: 转为 Object、对 null、对字符串常量转为 String、重复的转换，
+// 或将 this (未被重新赋值) 转为本类或其父类
+size_t removeCheckcasts(const PassContext& ctx, MethodCode& m) {
+    bool thisReassigned = m.isStatic;
+    for (const Insn& in : m.insns) {
+        bool indexed = in.op >= OP_ISTORE && in.op <= OP_ASTORE;
+        if ((indexed && in.operands[0] == 0) ||
+            in.op == OP_ISTORE_0 || in.op == OP_LSTORE_0 || in.op == OP_FSTORE_0 || in.op == OP_DSTORE_0 || in.op == OP_ASTORE_0) {
+            thisReassigned = true;
+        }
+    }
+
+    size_t rewrites = 0;
+    for (int32_t i = 0; i < (int32_t)m.insns.size(); i++) {
+        Insn& in = m.insns[i];
+        if (in.op != OP_CHECKCAST || in.removed || in.targeted) continue;
+        std::string type = classNameAt(ctx.cf, operandU2(in));
+        bool known = type == "java/lang/Object";
+        int32_t p = prevKept(m, i);
+        if (!known && p >= 0) {
+            const Insn& prev = m.insns[p];
+            if (prev.op == OP_ACONST_NULL) {
+                known = true;
+            } else if (prev.op == OP_CHECKCAST) {
+                known = classNameAt(ctx.cf, operandU2(prev)) == type;
+            } else if (prev.op == OP_LDC || prev.op == OP_LDC_W) {
+                uint16_t index = prev.op == OP_LDC ? prev.operands[0] : operandU2(prev);
+                known = type == "java/lang/String" && constantAt<ConstantString>(ctx.cf, index, CONSTANT_String);
+            } else if (prev.op == OP_ALOAD_0 || (prev.op == OP_ALOAD && prev.operands[0] == 0)) {
+                known = !thisReassigned && (type == ctx.thisName || (!ctx.superName.empty() && type == ctx.superName));
+            }
+        }
+        if (known) {
+            in.removed = true;
+            rewrites++;
+        }
+    }
+    return rewrites;
+}
+
+bool pushesOneSlot(uint8_t op) {
+    return op == OP_ACONST_NULL || (op >= OP_ICONST_M1 && op <= OP_ICONST_5) || (op >= OP_FCONST_0 && op <= OP_FCONST_2) ||
+           op == OP_BIPUSH || op == OP_SIPUSH || op == OP_ILOAD || op == OP_FLOAD || op == OP_ALOAD ||
+           (op >= OP_ILOAD_0 && op <= OP_ILOAD_3) || (op >= OP_FLOAD_0 && op <= OP_FLOAD_3) || (op >= OP_ALOAD_0 && op <= OP_ALOAD_3);
+}
+bool pushesTwoSlots(uint8_t op) {
+    return op == OP_LCONST_0 || op == OP_LCONST_1 || op == OP_DCONST_0 || op == OP_DCONST_1 || op == OP_LLOAD || op == OP_DLOAD ||
+           (op >= OP_LLOAD_0 && op <= OP_LLOAD_3) || (op >= OP_DLOAD_0 && op <= OP_DLOAD_3);
+}
+
+// DUP;POP, DUP2;POP2 and a side-effect free push followed by a pop of the same size
+// DUP;POP、DUP2;POP2，以及无副作用的压栈后紧跟同样大小的出栈
+size_t collapseDupPop(MethodCode& m) {
+    size_t rewrites = 0;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int32_t i = 0; i < (int32_t)m.insns.size(); i++) {
+            Insn& pop = m.insns[i];
+            if (pop.removed || pop.targeted || (pop.op != OP_POP && pop.op != OP_POP2)) continue;
+            int32_t p = prevKept(m, i);
+            if (p < 0) continue;
+            Insn& push = m.insns[p];
+            bool pair = pop.op == OP_POP ? (push.op == OP_DUP || pushesOneSlot(push.op))
+                                         : (push.op == OP_DUP2 || pushesTwoSlots(push.op));
+            if (!pair) continue;
+            push.removed = true;
+            pop.removed = true;
+            rewrites++;
+            changed = true;
+        }
+    }
+    return rewrites;
+}
+
+// Branches to a GOTO jump to its destination instead; a GOTO to the next instruction is
+// removed and a conditional branch to it becomes a pop of its operands
+// 跳转到 GOTO 的分支直接跳到其目的地; 跳转到下一条指令的 GOTO 被删除，条件跳转改为弹出其操作数
+size_t threadBranches(MethodCode& m) {
+    const int32_t end = (int32_t)m.insns.size();
+    size_t rewrites = 0;
+    auto thread = [&](int32_t& target) {
+        int32_t t = nextKept(m, target);
+        if (t >= end) return;
+        int32_t direct = t;
+        for (int hops = 0; hops < 16 && isGoto(m.insns[t].op); hops++) {
+            int32_t next = nextKept(m, m.insns[t].target);
+            if (next >= end || next == t) break;
+            t = next;
+        }
+        if (t != direct) rewrites++;
+        target = t;
+        m.insns[t].targeted = true;
+    };
+    for (int32_t i = 0; i < end; i++) {
+        Insn& in = m.insns[i];
+        if (in.removed) continue;
+        if (isSwitch(in.op)) {
+            thread(in.target);
+            for (int32_t& t : in.targets) thread(t);
+            continue;
+        }
+        if (!isBranch(in.op)) continue;
+        thread(in.target);
+        if (nextKept(m, in.target) != nextKept(m, i + 1)) continue;
+        if (isGoto(in.op)) {
+            in.removed = true;
+        } else {
+            in.op = (in.op >= OP_IF_ICMPEQ && in.op <= OP_IF_ACMPNE) ? OP_POP2 : OP_POP;
+            in.target = -1;
+        }
+        rewrites++;
+    }
+    return rewrites;
+}
+
+// LOOKUPSWITCH: a dense key set becomes a TABLESWITCH (no larger than the pair list);
+// otherwise the pairs are put in key order so the interpreter can binary search them
+// LOOKUPSWITCH: 键值密集时改为 TABLESWITCH (不大于原键值对表); 否则按键值排序，以便解释器二分查找
+size_t lowerSwitches(MethodCode& m) {
+    size_t rewrites = 0;
+    for (Insn& in : m.insns) {
+        if (in.op != OP_LOOKUPSWITCH || in.removed || in.keys.empty()) continue;
+        std::vector<std::pair<int32_t, int32_t>> pairs;
+        for (size_t k = 0; k < in.keys.size(); k++) pairs.emplace_back(in.keys[k], in.targets[k]);
+        bool sorted = std::is_sorted(in.keys.begin(), in.keys.end());
+        std::sort(pairs.begin(), pairs.end());
+        bool duplicates = false;
+        for (size_t k = 1; k < pairs.size(); k++) duplicates |= pairs[k].first == pairs[k - 1].first;
+        if (duplicates) continue;
+
+        int64_t range = (int64_t)pairs.back().first - pairs.front().first + 1;
+        if (range <= 2 * (int64_t)pairs.size()) {
+            in.op = OP_TABLESWITCH;
+            in.low = pairs.front().first;
+            in.keys.clear();
+            in.targets.assign((size_t)range, in.target);
+            for (const auto& pair : pairs) in.targets[(size_t)((int64_t)pair.first - in.low)] = pair.second;
+            rewrites++;
+        } else if (!sorted) {
+            for (size_t k = 0; k < pairs.size(); k++) {
+                in.keys[k] = pairs[k].first;
+                in.targets[k] = pairs[k].second;
+            }
+            rewrites++;
+        }
+    }
+    return rewrites;
+}
+
+// Lay the code out again and write the Code attribute; false if a branch no longer fits
+// its 16-bit offset (the method then keeps its original code)
+// 重新排布字节码并写回 Code 属性; 若有跳转偏移超出 16 位则返回 false (方法保留原始字节码)
+bool encode(MethodCode& m, size_t& newLength) {
+    const size_t count = m.insns.size();
+    std::vector<uint32_t> newPc(count + 1);
+    uint32_t pc = 0;
+    for (size_t i = 0; i < count; i++) {
+        // A removed instruction gets the pc of the next kept one
+        // 被删除的指令取其后第一条保留指令的 pc
+        newPc[i] = pc;
+        const Insn& in = m.insns[i];
+        if (in.removed) continue;
+        if (isSwitch(in.op)) {
+            uint32_t base = (pc + 4) & ~3u;
+            pc = base + (in.op == OP_TABLESWITCH ? 12 + 4 * (uint32_t)in.targets.size() : 8 + 8 * (uint32_t)in.keys.size());
+        } else if (isBranch(in.op)) {
+            pc += in.op == OP_GOTO_W ? 5 : 3;
+        } else {
+            pc += 1 + (uint32_t)in.operands.size();
+        }
+    }
+    newPc[count] = pc;
+    if (pc > 65535) return false;
+
+    std::vector<uint8_t> code;
+    code.reserve(pc);
+    for (size_t i = 0; i < count; i++) {
+        const Insn& in = m.insns[i];
+        if (in.removed) continue;
+        int64_t at = newPc[i];
+        code.push_back(in.op);
+        if (isSwitch(in.op)) {
+            while (code.size() % 4 != 0) code.push_back(0);
+            writeU4(code, (uint32_t)(newPc[in.target] - at));
+            if (in.op == OP_TABLESWITCH) {
+                writeU4(code, (uint32_t)in.low);
+                writeU4(code, (uint32_t)(int32_t)((int64_t)in.low + (int64_t)in.targets.size() - 1));
+                for (int32_t t : in.targets) writeU4(code, (uint32_t)(newPc[t] - at));
+            } else {
+                writeU4(code, (uint32_t)in.keys.size());
+                for (size_t k = 0; k < in.keys.size(); k++) {
+                    writeU4(code, (uint32_t)in.keys[k]);
+                    writeU4(code, (uint32_t)(newPc[in.targets[k]] - at));
+                }
+            }
+        } else if (isBranch(in.op)) {
+            int64_t offset = (int64_t)newPc[in.target] - at;
+            if (in.op == OP_GOTO_W) {
+                writeU4(code, (uint32_t)offset);
+            } else {
+                if (offset < -32768 || offset > 32767) return false;
+                writeU2(code, (uint16_t)offset);
+            }
+        } else {
+            code.insert(code.end(), in.operands.begin(), in.operands.end());
+        }
+    }
+
+    std::vector<uint8_t> out;
+    writeU2(out, m.maxStack);
+    writeU2(out, m.maxLocals);
+    writeU4(out, (uint32_t)code.size());
+    out.insert(out.end(), code.begin(), code.end());
+    writeU2(out, (uint32_t)m.exceptions.size());
+    for (const ExceptionEntry& entry : m.exceptions) {
+        writeU2(out, newPc[entry.startPc]);
+        writeU2(out, newPc[entry.endPc]);
+        writeU2(out, newPc[entry.handlerPc]);
+        writeU2(out, entry.catchType);
+    }
+    writeU2(out, m.lineTableName ? 1 : 0);
+    if (m.lineTableName) {
+        writeU2(out, m.lineTableName);
+        writeU4(out, 2 + 4 * (uint32_t)m.lines.size());
+        writeU2(out, (uint32_t)m.lines.size());
+        for (const LineEntry& entry : m.lines) {
+            writeU2(out, newPc[entry.startPc]);
+            writeU2(out, entry.line);
+        }
+    }
+    m.attribute->info.swap(out);
+    newLength = code.size();
+    return true;
+}
+
+} // namespace
+
+BytecodeOptimizer& BytecodeOptimizer::getInstance() {
+    static BytecodeOptimizer instance;
+    return instance;
+}
+
+BytecodeOptimizer::BytecodeOptimizer() {
+    for (bool& enabled : passEnabled) enabled = true;
+}
+
+const char* BytecodeOptimizer::passName(Pass pass) {
+    switch (pass) {
+#define J2ME_PEEPHOLE_NAME(id, name) case PASS_##id: return name;
+        J2ME_PEEPHOLE_PASSES(J2ME_PEEPHOLE_NAME)
+#undef J2ME_PEEPHOLE_NAME
+        default: return "?";
+    }
+}
+
+bool BytecodeOptimizer::setPasses(const std::string& list) {
+    bool all = list == "all" || list == "on";
+    for (bool& enabled : passEnabled) enabled = all;
+    if (all || list == "none" || list == "off") return true;
+
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        bool found = false;
+        for (int pass = 0; pass < PASS_COUNT; pass++) {
+            if (name == passName((Pass)pass)) {
+                passEnabled[pass] = true;
+                found = true;
+            }
+        }
+        if (!found) return false;
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return true;
+}
+
+void BytecodeOptimizer::optimize(ClassFile& classFile) {
+    if (std::none_of(passEnabled, passEnabled + PASS_COUNT, [](bool enabled) { return enabled; })) return;
+
+    const std::string thisName = classNameAt(classFile, classFile.this_class);
+    const std::string superName = classNameAt(classFile, classFile.super_class);
+
+    std::vector<MethodCode> methods;
+    bool allDecoded = true;
+    for (MethodInfo& method : classFile.methods) {
+        for (AttributeInfo& attribute : method.attributes) {
+            if (utf8At(classFile, attribute.attribute_name_index) != "Code") continue;
+            MethodCode m;
+            m.isStatic = (method.access_flags & ACC_STATIC) != 0;
+            counters.methods++;
+            if (decode(classFile, attribute, m)) {
+                methods.push_back(std::move(m));
+            } else {
+                allDecoded = false;
+            }
+            break;
+        }
+    }
+
+    // Static finals with a ConstantValue that no method of the class assigns (a method
+    // that could not be decoded might, so then none are folded)
+    // 带 ConstantValue 且本类中没有方法为其赋值的 static final 字段 (存在无法解码的方法时不折叠)
+    std::map<std::string, std::pair<std::string, uint16_t>> constants;
+    if (passEnabled[PASS_CONSTANTS] && allDecoded) {
+        for (const FieldInfo& field : classFile.fields) {
+            if ((field.access_flags & (ACC_STATIC | ACC_FINAL)) != (ACC_STATIC | ACC_FINAL)) continue;
+            for (const AttributeInfo& attribute : field.attributes) {
+                if (attribute.info.size() != 2 || utf8At(classFile, attribute.attribute_name_index) != "ConstantValue") continue;
+                std::string descriptor = utf8At(classFile, field.descriptor_index);
+                constants[utf8At(classFile, field.name_index) + "|" + descriptor] =
+                    { descriptor, (uint16_t)((attribute.info[0] << 8) | attribute.info[1]) };
+            }
+        }
+        for (const MethodCode& m : methods) {
+            for (const Insn& in : m.insns) {
+                if (in.op == OP_PUTSTATIC) constants.erase(ownFieldKey(classFile, operandU2(in), thisName));
+            }
+        }
+    }
+
+    PassContext ctx{ classFile, thisName, superName, constants };
+    uint64_t classRewrites = 0;
+    int64_t classSaved = 0;
+    for (MethodCode& m : methods) {
+        size_t rewrites[PASS_COUNT] = {};
+        if (passEnabled[PASS_CONSTANTS] && !constants.empty()) rewrites[PASS_CONSTANTS] = foldConstants(ctx, m);
+        if (passEnabled[PASS_CHECKCASTS]) rewrites[PASS_CHECKCASTS] = removeCheckcasts(ctx, m);
+        if (passEnabled[PASS_DUP_POP]) rewrites[PASS_DUP_POP] = collapseDupPop(m);
+        if (passEnabled[PASS_BRANCHES]) rewrites[PASS_BRANCHES] = threadBranches(m);
+        if (passEnabled[PASS_SWITCHES]) rewrites[PASS_SWITCHES] = lowerSwitches(m);
+
+        size_t total = 0;
+        for (size_t count : rewrites) total += count;
+        size_t newLength = 0;
+        if (total == 0 || !encode(m, newLength)) continue;
+        counters.methodsChanged++;
+        for (int pass = 0; pass < PASS_COUNT; pass++) counters.rewrites[pass] += rewrites[pass];
+        counters.bytesSaved += (int64_t)m.codeLength - (int64_t)newLength;
+        classRewrites += total;
+        classSaved += (int64_t)m.codeLength - (int64_t)newLength;
+    }
+    if (classRewrites > 0) {
+        LOG_DEBUG("[Peephole] " + thisName + ": " + std::to_string(classRewrites) + " rewrites, " +
+                  std::to_string(classSaved) + " bytes saved");
+    }
+}
+
+std::string BytecodeOptimizer::describeStats() const {
+    std::string text = std::to_string(counters.methodsChanged) + " of " + std::to_string(counters.methods) +
+                       " methods rewritten, " + std::to_string(counters.bytesSaved) + " bytes saved (";
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        if (pass > 0) text += ", ";
+        text += std::string(passName((Pass)pass)) + "=" + std::to_string(counters.rewrites[pass]);
+    }
+    return text + ")";
+}
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ClassFile.hpp"
+#include <cstdint>
+#include <string>
+
+namespace j2me {
+namespace core {
+
+// Load-time peephole passes, run over the Code attribute of every method right after
+// ClassParser::parse (see BytecodeOptimizer.cpp). j2me-aot parses classes the same way,
+// so AOT modules are compiled from the same optimized bytecode the VM executes.
+// 加载时的窥孔优化，在 ClassParser::parse 之后对每个方法的 Code 属性执行 (见 BytecodeOptimizer.cpp)。
+// j2me-aot 以同样方式解析类，因此 AOT 模块与虚拟机执行的是同一份优化后的字节码
+#define J2ME_PEEPHOLE_PASSES(X) \
+    X(CONSTANTS, "constants")  /* GETSTATIC of an own static final with a ConstantValue -> constant push */ \
+    X(CHECKCASTS, "checkcasts") /* CHECKCAST whose operand type is known statically */ \
+    X(DUP_POP, "dup-pop")      /* DUP;POP and side-effect free push;POP pairs */ \
+    X(BRANCHES, "branches")    /* branch-to-GOTO threading, branches to the next instruction */ \
+    X(SWITCHES, "switches")    /* LOOKUPSWITCH -> TABLESWITCH when dense, sorted keys otherwise */
+
+class BytecodeOptimizer {
+public:
+    enum Pass {
+#define J2ME_PEEPHOLE_ENUM(id, name) PASS_##id,
+        J2ME_PEEPHOLE_PASSES(J2ME_PEEPHOLE_ENUM)
+#undef J2ME_PEEPHOLE_ENUM
+        PASS_COUNT
+    };
+
+    struct Stats {
+        uint64_t methods = 0;             // Methods examined / 检查的方法数
+        uint64_t methodsChanged = 0;      // Methods rewritten / 被改写的方法数
+        int64_t bytesSaved = 0;           // Bytecode bytes saved / 减少的字节码字节数
+        uint64_t rewrites[PASS_COUNT] = {}; // Rewrites per pass / 各优化的改写次数
+    };
+
+    static BytecodeOptimizer& getInstance();
+
+    // Comma-separated pass names, "all" or "none"; false on an unknown name
+    // 以逗号分隔的优化名称，或 "all"、"none"; 名称未知时返回 false
+    bool setPasses(const std::string& list);
+    void setPassEnabled(Pass pass, bool enabled) { passEnabled[pass] = enabled; }
+    bool isPassEnabled(Pass pass) const { return passEnabled[pass]; }
+    static const char* passName(Pass pass);
+
+    // Rewrite the Code attributes of every method of a freshly parsed class
+    // 改写刚解析出的类中所有方法的 Code 属性
+    void optimize(ClassFile& classFile);
+
+    const Stats& stats() const { return counters; }
+    std::string describeStats() const;
+
+private:
+    BytecodeOptimizer();
+
+    bool passEnabled[PASS_COUNT];
+    Stats counters;
+};
+
+} // namespace core
+} // namespace j2me
@@ -91,12 +91,17 @@ struct FieldInfo {
     std::vector<AttributeInfo> attributes; // 字段属性表
 };
 
+struct RuntimeMethod;
+
 // 方法信息结构
 struct MethodInfo {
     uint16_t access_flags;     // 访问标志
     uint16_t name_index;       // 方法名称索引
     uint16_t descriptor_index; // 方法描述符索引
     std::vector<AttributeInfo> attributes; // 方法属性表 (如 Code 属性)
+    // Pre-decoded body, built when the class is linked (see RuntimeMethod.hpp)
+    // 预解码的方法体，在类链接时构建 (见 RuntimeMethod.hpp)
+    mutable std::shared_ptr<RuntimeMethod> runtime;
 };
 
 // 类文件结构 (映射 .class 文件格式)
@@ -1,4 +1,5 @@
 #include "ClassParser.hpp"
+#include "BytecodeOptimizer.hpp"
 #include "Logger.hpp"
 #include <iostream>
 
@@ -42,6 +43,10 @@ std::shared_ptr<ClassFile> ClassParser::parse(const std::vector<uint8_t>& data)
     parseMethods(reader, *classFile);
     parseAttributes(reader, classFile->attributes);
 
+    // 加载时窥孔优化 (见 BytecodeOptimizer.cpp)
+    // Load-time peephole passes (see BytecodeOptimizer.cpp)
+    BytecodeOptimizer::getInstance().optimize(*classFile);
+
     return classFile;
 }
 
@@ -49,6 +49,17 @@ void Diagnostics::onUncaughtException(const std::string& exClass) {
     lastUncaughtException = exClass;
 }
 
+void Diagnostics::onHeapUsage(size_t javaBytes, size_t nativeBytes) {
+    uint64_t total = (uint64_t)javaBytes + nativeBytes;
+    heapLiveBytes.store(total, std::memory_order_relaxed);
+    nativeHeapBytes.store(nativeBytes, std::memory_order_relaxed);
+    if (total > heapPeakBytes.load(std::memory_order_relaxed)) heapPeakBytes.store(total, std::memory_order_relaxed);
+}
+
+void Diagnostics::onOutOfMemory() {
+    outOfMemoryCount.fetch_add(1, std::memory_order_relaxed);
+}
+
 uint64_t Diagnostics::getGameCanvasFlushCount() const {
     return gameCanvasFlushCount.load(std::memory_order_relaxed);
 }
@@ -69,6 +80,22 @@ uint64_t Diagnostics::getUncaughtExceptionCount() const {
     return uncaughtExceptionCount.load(std::memory_order_relaxed);
 }
 
+uint64_t Diagnostics::getHeapLiveBytes() const {
+    return heapLiveBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t Diagnostics::getHeapPeakBytes() const {
+    return heapPeakBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t Diagnostics::getNativeHeapBytes() const {
+    return nativeHeapBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t Diagnostics::getOutOfMemoryCount() const {
+    return outOfMemoryCount.load(std::memory_order_relaxed);
+}
+
 int64_t Diagnostics::getLastGameCanvasFlushMs() const {
     return lastGameCanvasFlushMs.load(std::memory_order_relaxed);
 }
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cstdint>
 #include <chrono>
+#include <cstddef>
 #include <mutex>
 #include <string>
 
@@ -18,12 +19,20 @@ public:
     void onResourceNotFound(const std::string& name);
     void onImageDecodeFailed(const std::string& name, const std::string& headerHex);
     void onUncaughtException(const std::string& exClass);
+    // Heap usage as the cap counts it (HeapManager, around each collection) and
+    // OutOfMemoryErrors thrown
+    void onHeapUsage(size_t javaBytes, size_t nativeBytes);
+    void onOutOfMemory();
 
     uint64_t getGameCanvasFlushCount() const;
     uint64_t getPaintCommitCount() const;
     uint64_t getResourceNotFoundCount() const;
     uint64_t getImageDecodeFailedCount() const;
     uint64_t getUncaughtExceptionCount() const;
+    uint64_t getHeapLiveBytes() const;
+    uint64_t getHeapPeakBytes() const;
+    uint64_t getNativeHeapBytes() const;
+    uint64_t getOutOfMemoryCount() const;
 
     int64_t getLastGameCanvasFlushMs() const;
     int64_t getLastPaintCommitMs() const;
@@ -45,6 +54,10 @@ private:
     std::atomic<uint64_t> resourceNotFoundCount{0};
     std::atomic<uint64_t> imageDecodeFailedCount{0};
     std::atomic<uint64_t> uncaughtExceptionCount{0};
+    std::atomic<uint64_t> heapLiveBytes{0};
+    std::atomic<uint64_t> heapPeakBytes{0};
+    std::atomic<uint64_t> nativeHeapBytes{0};
+    std::atomic<uint64_t> outOfMemoryCount{0};
     mutable std::mutex messageMutex;
     std::string lastResourceNotFound;
     std::string lastImageDecodeFailed;
@@ -262,7 +262,7 @@ void EventLoop::dispatchEvents(Interpreter* interpreter) {
                         }
                     }
                     if (found) break;
-                    currentCls = currentCls->superClass;
+                    currentCls = currentCls->superClass.get();
                 }
             }
         }
@@ -295,7 +295,7 @@ void EventLoop::render(Interpreter* interpreter) {
                  auto it = graphicsCls->fieldOffsets.find(name + "|I");
                  if (it == graphicsCls->fieldOffsets.end()) it = graphicsCls->fieldOffsets.find(name);
                  if (it != graphicsCls->fieldOffsets.end()) {
-                     g->fields[it->second] = val;
+                     g->set<int32_t>(it->second, val);
                  }
             };
             
@@ -352,7 +352,7 @@ void EventLoop::render(Interpreter* interpreter) {
                     }
                 }
                 if (found) break;
-                currentCls = currentCls->superClass;
+                currentCls = currentCls->superClass.get();
             }
         }
     }
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "StackFrame.hpp"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace j2me {
+namespace core {
+
+// Per-thread stack arena for frame slots. Frames are strictly LIFO, so slot storage is
+// bump-allocated on push and released back to the saved mark on return; no heap
+// allocation happens on a call once the arena has warmed up.
+// Memory comes in chunks that are kept for the lifetime of the thread, so pointers
+// handed out stay valid until the matching release().
+// 每个线程的栈帧槽位区。栈帧严格后进先出，因此压栈时按指针递增分配，返回时回退到保存的位置；
+// 预热之后方法调用不再进行堆分配。内存按块分配并在线程生命周期内保留，已分配的指针在对应的 release() 前一直有效
+class FrameArena {
+public:
+    struct Block {
+        Slot* slots;
+        uint8_t* tags;
+        size_t mark; // Position to restore in release() // release() 时恢复到的位置
+    };
+
+    // Allocate `count` slots (and their tags) on top of the arena
+    // 在栈区顶部分配 count 个槽位 (及其类型标记)
+    Block allocate(size_t count) {
+        size_t mark = (current << 32) | top;
+        if (chunks.empty() || top + count > chunks[current].capacity) {
+            size_t next = chunks.empty() ? 0 : current + 1;
+            size_t capacity = count > CHUNK_SLOTS ? count : CHUNK_SLOTS;
+            // Chunks above `current` are unused; replace one if it is too small
+            // current 之上的块均未使用，容量不足时直接替换
+            if (next == chunks.size()) {
+                chunks.emplace_back();
+            }
+            if (chunks[next].capacity < count) {
+                chunks[next].slots.reset(new Slot[capacity]);
+                chunks[next].tags.reset(new uint8_t[capacity]);
+                chunks[next].capacity = capacity;
+            }
+            current = next;
+            top = 0;
+        }
+        Chunk& chunk = chunks[current];
+        Block block{chunk.slots.get() + top, chunk.tags.get() + top, mark};
+        top += count;
+        return block;
+    }
+
+    // Give back everything allocated since `mark`
+    // 释放自 mark 以来分配的所有槽位
+    void release(size_t mark) {
+        current = (size_t)(mark >> 32);
+        top = (size_t)(mark & 0xFFFFFFFFu);
+    }
+
+    void reset() {
+        current = 0;
+        top = 0;
+    }
+
+private:
+    static constexpr size_t CHUNK_SLOTS = 16 * 1024;
+
+    struct Chunk {
+        std::unique_ptr<Slot[]> slots;
+        std::unique_ptr<uint8_t[]> tags;
+        size_t capacity = 0;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t current = 0; // 当前使用的块
+    size_t top = 0;     // 当前块内的分配位置
+};
+
+} // namespace core
+} // namespace j2me
@@ -1,54 +1,593 @@
 #include "HeapManager.hpp"
-#include "../native/NativeInputStream.hpp"
+#include "Interpreter.hpp"
+#include "ThreadManager.hpp"
+#include "TimerManager.hpp"
+#include "Logger.hpp"
+#include "Diagnostics.hpp"
+#include "RuntimeExceptions.hpp"
+#include "NativeHandles.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
 
 namespace j2me {
 namespace core {
 
-JavaObject* HeapManager::allocate(std::shared_ptr<JavaClass> cls) {
-    // 简单的对象分配 (存储在 vector 中)
-    // Simple object allocation (stored in vector)
-    objects.emplace_back(cls);
-    return &objects.back();
+namespace {
+
+#if defined(_WIN32)
+// Windows reserves address space and commits it separately, in steps of this size
+// Windows 分别保留和提交地址空间，每次按此大小提交
+constexpr size_t COMMIT_STEP = (size_t)1 << 20;
+#elif !defined(__linux__) && !defined(__APPLE__)
+// Without virtual memory reservation the region is allocated outright, so keep it small
+// 无法只保留地址空间时堆区需要整块分配，因此取较小的大小
+constexpr size_t PLAIN_REGION_BYTES = (size_t)256 << 20;
+#endif
+
+} // namespace
+
+HeapManager::HeapManager() {
+    size = DEFAULT_REGION_BYTES;
+#if defined(__linux__) || defined(__APPLE__)
+    // Address space only: untouched pages cost nothing
+    // 只保留地址空间: 未访问的页不占用内存
+    void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    base = region == MAP_FAILED ? nullptr : static_cast<uint8_t*>(region);
+    committed = size;
+#elif defined(_WIN32)
+    base = static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE));
+#else
+    size = PLAIN_REGION_BYTES;
+    base = static_cast<uint8_t*>(std::malloc(size));
+    committed = size;
+#endif
+    if (!base) throw std::runtime_error("Cannot reserve the Java heap region");
+    // The nursery is used from the start and must read as zero
+    // 新生代从一开始就会使用，且必须为全零
+#if defined(_WIN32)
+    if (!commit(NURSERY_END)) throw std::runtime_error("Cannot commit the nursery");
+#elif !defined(__linux__) && !defined(__APPLE__)
+    std::memset(base, 0, NURSERY_END);
+#endif
+    top = NURSERY_END;
+#if J2ME_COMPRESSED_REFS
+    compressedRefBase = base;
+#endif
+
+    cards = static_cast<uint8_t*>(std::calloc((size >> CARD_SHIFT) + 1, 1));
+    if (!cards) throw std::runtime_error("Cannot allocate the card table");
+    cardTableBase = reinterpret_cast<uint8_t*>(reinterpret_cast<uintptr_t>(cards) -
+                                               (reinterpret_cast<uintptr_t>(base) >> CARD_SHIFT));
+    objectStarts = static_cast<uint64_t*>(std::calloc((size >> CARD_SHIFT) + 1, sizeof(uint64_t)));
+    if (!objectStarts) throw std::runtime_error("Cannot allocate the object start table");
 }
 
-void HeapManager::clear() {
-    objects.clear();
-    streams.clear();
+HeapManager::~HeapManager() {
+    clear();
+#if defined(__linux__) || defined(__APPLE__)
+    munmap(base, size);
+#elif defined(_WIN32)
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    std::free(base);
+#endif
+    std::free(cards);
+    std::free(objectStarts);
+}
+
+bool HeapManager::commit(size_t end) {
+    if (end <= committed) return true;
+    if (end > size) return false;
+#if defined(_WIN32)
+    size_t target = std::min(size, (end + COMMIT_STEP - 1) & ~(COMMIT_STEP - 1));
+    if (!VirtualAlloc(base + committed, target - committed, MEM_COMMIT, PAGE_READWRITE)) return false;
+    committed = target;
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t HeapManager::instanceBlockSize(const JavaClass* cls) {
+    // At least one 8-byte field: natives of field-less library classes (StringBuilder,
+    // StringBuffer) keep their native handle at offset 0
+    // 至少保留一个 8 字节字段: 没有字段的库类 (StringBuilder、StringBuffer) 的本地方法在偏移 0 处保存本地句柄
+    size_t fieldBytes = cls ? cls->instanceSize : 0;
+    // Whole 8-byte units, so fields and elements of any kind stay aligned
+    // 按 8 字节取整，保证各类字段与元素对齐
+    return (sizeof(JavaObject) + std::max(fieldBytes, sizeof(int64_t)) + 7) & ~(size_t)7;
+}
+
+size_t HeapManager::arrayBlockSize(const JavaClass* cls, int32_t length) {
+    return (JavaObject::ARRAY_DATA_OFFSET + (size_t)length * fieldSize(cls->elementKind) + 7) & ~(size_t)7;
+}
+
+size_t HeapManager::blockSize(const JavaObject* obj) {
+    if (obj->cls && obj->cls->isArray) return arrayBlockSize(obj->cls, obj->arrayLength());
+    return instanceBlockSize(obj->cls);
+}
+
+// All Java threads are green threads of one OS thread, so one nursery pointer serves them all.
+// The nursery is cleared in one go after each minor collection, so its blocks are already zero
+// when handed out. Large objects, and anything once the nursery is full, go to the old space.
+// 所有 Java 线程都是同一系统线程上的绿色线程，共用一个新生代指针即可。新生代在每次次要回收后整体清零，
+// 因此分配出的内存块已是零。大对象以及新生代已满时的分配直接进入老年代
+JavaObject* HeapManager::allocateBlock(JavaClass* cls, size_t bytes) {
+    if (bytes <= LARGE_OBJECT_BYTES) {
+        if (bytes <= NURSERY_END - nurseryTop) {
+            // The common case: a pointer increment into memory that is already zero
+            // 常见情形: 在已清零的内存中移动一次指针
+            uint8_t* block = base + nurseryTop;
+            nurseryTop += bytes;
+            nurseryObjects++;
+            if (nurseryTop - NURSERY_START >= (NURSERY_END - NURSERY_START) / 4 * 3) minorRequested = true;
+            return new (block) JavaObject(cls);
+        }
+        // Full until the next safepoint: allocate old meanwhile
+        // 新生代已满，在下一个安全点之前改为在老年代分配
+        minorRequested = true;
+    }
+    uint8_t* block = base + allocateOld(bytes);
+    // Old blocks (free lists, or after clear()) still hold old data
+    // 老年代的内存块 (来自空闲链表或 clear() 之后) 仍有旧数据
+    std::memset(block, 0, bytes);
+    JavaObject* obj = new (block) JavaObject(cls);
+    // Allocated black during an incremental cycle (its fields are all null)
+    // 增量回收周期内分配为黑色 (其字段均为 null)
+    if (marking) obj->gcBits |= JavaObject::GC_MARKED;
+    objects.push_back(obj);
+    recordStart(obj);
+    return obj;
+}
+
+// The next major collection is due after as many bytes as were live after the last one (at
+// least MIN_COLLECT_BYTES)
+// 自上次主要回收以来的分配量达到上次回收后的存活字节数 (至少 MIN_COLLECT_BYTES) 时触发下一次主要回收
+size_t HeapManager::allocateOld(size_t bytes) {
+    size_t offset = freeBytes > 0 ? takeFree(bytes) : 0;
+    if (offset == 0) {
+        if (bytes > size - top || !commit(top + bytes)) throw std::bad_alloc();
+        offset = top;
+        top += bytes;
+    }
+    used += bytes;
+    allocatedSinceCollection += bytes;
+    if (allocatedSinceCollection >= collectThreshold) {
+        // Incremental cycles get until twice the threshold before a full collection takes over
+        // 增量回收周期在分配量达到两倍阈值之前完成，否则改为完整回收
+        if (incrementalBudget.count() == 0 || allocatedSinceCollection >= collectThreshold * 2) collectionRequested = true;
+        else if (!marking) cycleRequested = true;
+    }
+    return offset;
+}
+
+JavaObject* HeapManager::allocate(JavaClass* cls) {
+    size_t bytes = instanceBlockSize(cls);
+    if (heapLimit && accountedBytes() + bytes > heapLimit) overLimit(bytes);
+    if (--sampleCountdown == 0) sampleAllocation(cls, bytes);
+    return allocateBlock(cls, bytes);
+}
+
+JavaObject* HeapManager::allocateArray(JavaClass* cls, int32_t length) {
+    // The collector sizes an array block by its class, so there must be one
+    // 回收器根据数组类计算数组内存块的大小，因此必须提供数组类
+    if (!cls || !cls->isArray) throw std::runtime_error("allocateArray needs an array class");
+    if (length < 0) length = 0;
+    size_t bytes = arrayBlockSize(cls, length);
+    if (heapLimit && accountedBytes() + bytes > heapLimit) overLimit(bytes);
+    if (--sampleCountdown == 0) sampleAllocation(cls, bytes);
+    JavaObject* arr = allocateBlock(cls, bytes);
+    arr->set<int32_t>(JavaObject::ARRAY_LENGTH_OFFSET - sizeof(JavaObject), length);
+    return arr;
+}
+
+// Collections only run at safepoints, so a request that would pass the cap is granted from a
+// reserve of an eighth of the cap while a last-ditch full collection is requested for the next
+// one. A request made while that collection left the heap over the cap, or one the reserve
+// cannot cover, throws java.lang.OutOfMemoryError (JavaThrow) and requests another.
+// 垃圾回收只在安全点进行，因此超过上限的请求先从上限 1/8 大小的预留空间中满足，同时为下一个安全点请求一次最后的完整回收。
+// 若该次回收后仍超过上限，或预留空间不足，请求将抛出 java.lang.OutOfMemoryError (JavaThrow) 并再次请求回收
+void HeapManager::overLimit(size_t bytes) {
+    collectionRequested = true;
+    if (!heapExhausted && accountedBytes() + bytes <= heapLimit + heapLimit / 8) return;
+    Diagnostics::getInstance().onOutOfMemory();
+    LOG_DEBUG("[GC] OutOfMemoryError: " + std::to_string(bytes) + " bytes requested, " +
+              std::to_string(accountedBytes() / 1024) + " KB of " + std::to_string(heapLimit / 1024) + " KB in use");
+    throw JavaThrow(RuntimeExceptionKind::OUT_OF_MEMORY);
+}
+
+void HeapManager::reserveNative(size_t bytes) {
+    if (heapLimit && accountedBytes() + bytes > heapLimit) overLimit(bytes);
+    nativeUsed += bytes;
+}
+
+// Blocks of up to SMALL_BLOCK_LIMIT bytes have one list per 8-byte size; bigger chunks share
+// a first-fit list. A chunk is split on use and a remainder too small for any object is left
+// alone until the next sweep, which rebuilds everything from the gaps between live objects.
+// 不超过 SMALL_BLOCK_LIMIT 字节的内存块按 8 字节一级各有一个链表，更大的空闲块共用一个首次适配链表。空闲块使用时会被切分，
+// 放不下任何对象的剩余部分留到下次清除，届时根据存活对象之间的空隙重新构建所有链表
+size_t HeapManager::takeFree(size_t bytes) {
+    // The smallest non-empty class that fits, then the first large chunk that does
+    // 先取能容纳的最小非空级别，再取第一个足够大的大块
+    if (bytes <= SMALL_BLOCK_LIMIT) {
+        for (size_t sizeClass = bytes / 8; sizeClass <= SMALL_BLOCK_LIMIT / 8; sizeClass++) {
+            std::vector<size_t>& list = freeLists[sizeClass];
+            if (list.empty()) continue;
+            size_t offset = list.back();
+            list.pop_back();
+            freeBytes -= sizeClass * 8;
+            addFree(offset + bytes, sizeClass * 8 - bytes);
+            return offset;
+        }
+    }
+    for (size_t i = 0; i < largeChunks.size(); i++) {
+        if (largeChunks[i].bytes < bytes) continue;
+        FreeChunk chunk = largeChunks[i];
+        largeChunks[i] = largeChunks.back();
+        largeChunks.pop_back();
+        freeBytes -= chunk.bytes;
+        addFree(chunk.offset + bytes, chunk.bytes - bytes);
+        return chunk.offset;
+    }
+    return 0;
+}
+
+bool HeapManager::reserveOld(size_t bytes) {
+    // Only the space above top counts: the free lists may be too fragmented for the blocks
+    // that come
+    // 只计算 top 之上的空间: 空闲链表可能过于零碎，放不下将要分配的内存块
+    return bytes <= size - top && commit(top + bytes);
+}
+
+void HeapManager::addFree(size_t offset, size_t bytes) {
+    if (bytes < MIN_BLOCK_BYTES) return;
+    if (bytes <= SMALL_BLOCK_LIMIT) freeLists[bytes / 8].push_back(offset);
+    else largeChunks.push_back({offset, bytes});
+    freeBytes += bytes;
+}
+
+void HeapManager::visitAllRoots(Interpreter& interpreter, const std::function<JavaObject*(JavaObject*)>& visit) {
+    interpreter.visitRoots(visit);
+    ThreadManager::getInstance().visitReferences(visit);
+    TimerManager::getInstance().visitReferences(visit);
+    for (JavaObject** root : roots) *root = visit(*root);
 }
 
-int HeapManager::allocateStream(const uint8_t* data, size_t size) {
-    // 分配原生输入流 (用于读取资源文件等)
-    // Allocate native input stream (for reading resource files, etc.)
-    auto stream = std::make_unique<natives::NativeInputStream>(data, size);
-    int id = nextStreamId++;
-    streams.push_back(std::move(stream));
-    return id;
+void HeapManager::addRoot(JavaObject** slot) {
+    if (std::find(roots.begin(), roots.end(), slot) == roots.end()) roots.push_back(slot);
 }
 
-int HeapManager::allocateStreamWithPath(const uint8_t* data, size_t size, const std::string& path) {
-    // 分配带路径信息的原生输入流
-    // Allocate native input stream with path information
-    auto stream = std::make_unique<natives::NativeInputStream>(data, size);
-    stream->setFilePath(path);
-    int id = nextStreamId++;
-    streams.push_back(std::move(stream));
-    return id;
+void HeapManager::removeRoot(JavaObject** slot) {
+    roots.erase(std::remove(roots.begin(), roots.end(), slot), roots.end());
 }
 
-natives::NativeInputStream* HeapManager::getStream(int id) {
-    if (id < 1 || id > (int)streams.size()) {
-        return nullptr;
+// The roots are the interpreter's (static fields, preallocated exceptions, held monitors),
+// every thread's frames, the TimerManager tasks and the slots registered with addRoot(). A
+// minor collection copies the live nursery objects into the old space, finding the old
+// objects that point at them through the card table (see markCard), and updates every
+// reference to them; the nursery is then empty again. A major collection follows it when
+// due: a precise mark-sweep of the old space into the size-class free lists. Interpreter::execute
+// runs it between time slices, where no native code holds a reference of its own.
+// 根包括解释器的根 (静态字段、预分配的异常、被持有的监视器)、所有线程的栈帧、TimerManager 中的任务以及通过 addRoot()
+// 登记的槽位。次要回收将新生代中的存活对象复制到老年代 (通过卡表找到指向它们的老年代对象，见 markCard) 并更新所有指向它们的引用，
+// 之后新生代重新为空。需要时随后进行主要回收: 对老年代进行精确的标记-清除，将未标记的内存块放入按大小分级的空闲链表。
+// Interpreter::execute 在时间片之间调用，此时没有本地代码自行持有引用
+size_t HeapManager::collect(Interpreter& interpreter) {
+    size_t freed = collectNursery(interpreter);
+    if (collectionRequested) freed += collectOld(interpreter);
+    if (dumpRequested) {
+        dumpRequested = 0;
+        dumpHeap(interpreter, nextDumpPath());
     }
-    return streams[id - 1].get();
+    return freed;
 }
 
-void HeapManager::removeStream(int id) {
-    if (id < 1 || id > (int)streams.size()) {
-        return;
+void HeapManager::clearObjectStarts() {
+    if (top <= NURSERY_END) return;
+    size_t first = cardOf(base + NURSERY_END);
+    std::memset(objectStarts + first, 0, (cardOf(base + top - 1) - first + 1) * sizeof(uint64_t));
+}
+
+// objectStarts lets a minor collection find the objects on the dirty cards without going over
+// the others. Blocks are 8-byte aligned, so one 64-bit word covers a card; the bits are set
+// as blocks are handed out in the old space and rebuilt by sweep().
+// objectStarts 使次要回收无需遍历其余对象即可找到卡被标记的对象。内存块按 8 字节对齐，因此每张卡一个 64 位字即可;
+// 在老年代分配内存块时置位，由 sweep() 重建
+template <typename Visit>
+void HeapManager::visitDirtyCards(size_t end, Visit&& visit) {
+    if (end <= NURSERY_END) return;
+    size_t last = cardOf(base + end - 1);
+    uintptr_t firstCard = reinterpret_cast<uintptr_t>(base) >> CARD_SHIFT;
+    for (size_t card = cardOf(base + NURSERY_END); card <= last; card++) {
+        if (!cards[card]) continue;
+        uint8_t* cardStart = reinterpret_cast<uint8_t*>((firstCard + card) << CARD_SHIFT);
+        size_t slot = 0;
+        for (uint64_t starts = objectStarts[card]; starts; starts >>= 1, slot++) {
+            if (starts & 1) visit(reinterpret_cast<JavaObject*>(cardStart + slot * 8));
+        }
+    }
+}
+
+size_t HeapManager::collectNursery(Interpreter& interpreter) {
+    auto start = std::chrono::steady_clock::now();
+    // Usage only grows between collections, so this is where it peaks
+    // 两次回收之间用量只增不减，因此回收开始时即为峰值
+    Diagnostics::getInstance().onHeapUsage(usedBytes(), nativeUsed);
+    size_t nurseryBytes = nurseryTop - NURSERY_START;
+    std::vector<JavaObject*> promoted;
+    size_t promotedBytes = 0;
+
+    // Evacuation must not run out of old space halfway, with some objects forwarded and
+    // others not, so room for the whole nursery is made first: a full collection (which
+    // holds the nursery live) when the old space is short, and when even that is not
+    // enough the nursery is left as it is and allocations fail with OutOfMemoryError
+    // 疏散不能在中途耗尽老年代空间 (部分对象已转发而其余未转发)，因此先为整个新生代留出空间: 老年代不足时先进行一次完整回收
+    // (新生代整体视为存活)，仍然不足时新生代保持不变，之后的分配以 OutOfMemoryError 失败
+    if (nurseryBytes > 0 && !reserveOld(nurseryBytes)) {
+        LOG_DEBUG("[GC] Minor: no room to promote " + std::to_string(nurseryBytes / 1024) + " KB, full collection first");
+        collectOld(interpreter);
+        if (!reserveOld(nurseryBytes)) {
+            Diagnostics::getInstance().onOutOfMemory();
+            LOG_DEBUG("[GC] Minor: old space exhausted, nursery kept (" + std::to_string(nurseryBytes / 1024) + " KB)");
+            minorRequested = false;
+            return 0;
+        }
+    }
+
+    // Copy a nursery object into the old space once, leaving its new address behind in the
+    // first bytes of its fields (every block has at least 8); anything else stays put
+    // 将新生代对象复制到老年代 (每个对象只复制一次)，新地址留在原对象字段区的开头 (每个内存块至少有 8 字节); 其他对象不动
+    auto evacuate = [this, &promoted, &promotedBytes](JavaObject* obj) -> JavaObject* {
+        if (!inNursery(obj)) return obj;
+        if (obj->gcBits & JavaObject::GC_FORWARDED) return obj->get<JavaObject*>(0);
+        size_t bytes = blockSize(obj);
+        JavaObject* copy = reinterpret_cast<JavaObject*>(base + allocateOld(bytes));
+        std::memcpy(static_cast<void*>(copy), obj, bytes);
+        obj->gcBits |= JavaObject::GC_FORWARDED;
+        obj->set<JavaObject*>(0, copy);
+        objects.push_back(copy);
+        recordStart(copy);
+        promoted.push_back(copy);
+        promotedBytes += bytes;
+        // Promoted gray during an incremental cycle: it may be all that holds a white object
+        // 增量回收周期内晋升为灰色: 它可能是某个白色对象的唯一持有者
+        if (marking) {
+            copy->gcBits |= JavaObject::GC_MARKED;
+            markStack.push_back(copy);
+        }
+        return copy;
+    };
+
+    size_t oldTop = top;
+    if (nurseryBytes > 0) visitAllRoots(interpreter, evacuate);
+
+    // Old objects stored into since the last minor collection, those with their header on a
+    // dirty card (the clean part of the old space is not touched): their references into the
+    // nursery are evacuated and, the cards being about to be cleared, the black ones go back
+    // to gray during an incremental cycle. Then (breadth first, without a stack) the fields
+    // of whatever has been promoted.
+    // 自上次次要回收以来被写入过引用的老年代对象，即对象头位于被标记的卡上的对象 (不访问老年代中未被标记的部分):
+    // 疏散其指向新生代的引用; 卡即将被清除，因此增量回收周期内其中的黑色对象重新置灰。
+    // 然后 (广度优先，无需栈) 依次处理已晋升对象的字段
+    if (nurseryBytes > 0 || marking) {
+        visitDirtyCards(oldTop, [this, nurseryBytes, &evacuate](JavaObject* obj) {
+            if (nurseryBytes > 0) visitFields(obj, evacuate);
+            if (marking && (obj->gcBits & JavaObject::GC_MARKED)) markStack.push_back(obj);
+        });
+    }
+    for (size_t i = 0; i < promoted.size(); i++) visitFields(promoted[i], evacuate);
+
+    // Native resources of the nursery objects that died go with them; the others follow
+    // their owner to its new address
+    // 死亡的新生代对象的本地资源随之释放; 其余资源的所有者更新为其新地址
+    NativeHandles::getInstance().sweepYoung([this](JavaObject* obj) -> JavaObject* {
+        if (!inNursery(obj)) return obj;
+        return (obj->gcBits & JavaObject::GC_FORWARDED) ? obj->get<JavaObject*>(0) : nullptr;
+    });
+
+    // No old object points into the nursery any more: clean cards, and a zero nursery for
+    // the next allocations
+    // 已没有老年代对象指向新生代: 清除所有卡，并将新生代清零供后续分配使用
+    std::memset(cards, 0, ((reinterpret_cast<uintptr_t>(base) + top) >> CARD_SHIFT) -
+                          (reinterpret_cast<uintptr_t>(base) >> CARD_SHIFT) + 1);
+    std::memset(base + NURSERY_START, 0, nurseryBytes);
+    size_t freed = nurseryObjects - promoted.size();
+    nurseryTop = NURSERY_START;
+    nurseryObjects = 0;
+    minorRequested = false;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    LOG_DEBUG("[GC] Minor: promoted " + std::to_string(promoted.size()) + " objects (" +
+              std::to_string(promotedBytes / 1024) + " KB of " + std::to_string(nurseryBytes / 1024) + " KB), freed " +
+              std::to_string(freed) + " in " + std::to_string(elapsed) + " us");
+    return freed;
+}
+
+// Turns a white old object gray / 将白色的老年代对象置灰
+JavaObject* HeapManager::shade(JavaObject* obj) {
+    // Anything outside the old space (a native handle tagged as a reference) is not an object
+    // 老年代之外的值 (被标记为引用的本地句柄) 不是对象
+    uint8_t* at = reinterpret_cast<uint8_t*>(obj);
+    if (at < base + NURSERY_END || at >= base + top) return obj;
+    if (obj->gcBits & JavaObject::GC_MARKED) return obj;
+    obj->gcBits |= JavaObject::GC_MARKED;
+    markStack.push_back(obj);
+    return obj;
+}
+
+void HeapManager::shadeRoots(Interpreter& interpreter) {
+    visitAllRoots(interpreter, [this](JavaObject* obj) { return shade(obj); });
+}
+
+// Blackens gray objects until the stack is empty (true) or the deadline passes
+// 将灰色对象逐个变黑，直到栈为空 (返回 true) 或超过截止时间
+bool HeapManager::trace(Clock::time_point deadline) {
+    // An explicit stack instead of recursion, so long lists cannot overflow the C++ stack;
+    // the clock is read every few objects
+    // 使用显式栈而非递归，避免长链表耗尽 C++ 栈; 每处理若干个对象读取一次时钟
+    auto visit = [this](JavaObject* obj) { return shade(obj); };
+    for (size_t traced = 1; !markStack.empty(); traced++) {
+        JavaObject* obj = markStack.back();
+        markStack.pop_back();
+        visitFields(obj, visit);
+        if (traced % 64 == 0 && Clock::now() >= deadline) break;
     }
-    // 释放流资源
-    // Release stream resource
-    streams[id - 1].reset();
+    return markStack.empty();
+}
+
+// Tri-color marking of the old space: objects on the mark stack are gray, marked ones off it
+// black. A cycle starts once the allocation threshold is reached (a full collection takes over
+// at twice that, see allocateOld); the slice after the one that empties the mark stack finishes
+// it with a minor collection, a rescan of the roots and the sweep. Stores into black objects
+// are caught by the card table: the next minor collection turns the black objects on dirty
+// cards gray again, and objects promoted or allocated old during the cycle are marked.
+// J2MEVM::vmLoop calls it once per frame, where collect() would be safe too.
+// 对老年代进行三色标记: 标记栈上的对象为灰色，已标记且不在栈上的为黑色。分配量达到阈值后开始一个周期 (达到两倍时改为完整回收，
+// 见 allocateOld); 标记栈清空后的下一个时间片以一次次要回收、根的重新扫描以及清除来结束周期。写入黑色对象的引用由卡表捕获:
+// 下一次次要回收将卡被标记的黑色对象重新置灰，周期内晋升或直接在老年代分配的对象均视为已标记。
+// 由 J2MEVM::vmLoop 每帧调用一次 (该处调用 collect() 同样安全)
+size_t HeapManager::collectStep(Interpreter& interpreter, std::chrono::microseconds budget) {
+    if (!marking && !cycleRequested) return 0;
+    auto start = Clock::now();
+    size_t freed = 0;
+    if (!marking) {
+        marking = true;
+        cycleRequested = false;
+        cycleSteps = 0;
+        longestStep = Clock::duration::zero();
+        shadeRoots(interpreter);
+        trace(start + budget);
+    } else if (!markStack.empty()) {
+        trace(start + budget);
+    } else {
+        // Everything reachable so far is black: finish (this slice may run over the budget)
+        // 目前可达的对象均已变黑: 结束本周期 (该时间片可能超出预算)
+        freed = collectNursery(interpreter) + collectOld(interpreter);
+    }
+    Clock::duration elapsed = Clock::now() - start;
+    cycleSteps++;
+    longestStep = std::max(longestStep, elapsed);
+    if (!marking) {
+        LOG_DEBUG("[GC] Incremental cycle: " + std::to_string(cycleSteps) + " steps, longest " +
+                  std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(longestStep).count()) + " us");
+    }
+    return freed;
+}
+
+size_t HeapManager::collectOld(Interpreter& interpreter) {
+    auto start = std::chrono::steady_clock::now();
+    size_t objectsBefore = objects.size();
+    size_t usedBefore = used;
+
+    // Mark (the nursery has just been emptied). An incremental cycle under way keeps what
+    // it has marked; the roots are scanned again since they may hold new references.
+    // 标记 (新生代刚被清空)。进行中的增量回收周期已做的标记保持有效; 根中可能有新的引用，因此重新扫描
+    marking = true;
+    shadeRoots(interpreter);
+    // A nursery that could not be promoted (see collectNursery) is live as a whole; it is
+    // bump-allocated, so its blocks follow one another
+    // 无法晋升的新生代 (见 collectNursery) 整体视为存活; 新生代顺序分配，其内存块首尾相接
+    for (size_t offset = NURSERY_START; offset < nurseryTop;) {
+        JavaObject* obj = reinterpret_cast<JavaObject*>(base + offset);
+        visitFields(obj, [this](JavaObject* ref) { return shade(ref); });
+        offset += blockSize(obj);
+    }
+    trace(Clock::time_point::max());
+
+    sweep();
+
+    marking = false;
+    cycleRequested = false;
+    collectionRequested = false;
+    allocatedSinceCollection = 0;
+    collectThreshold = std::max(MIN_COLLECT_BYTES, used);
+    heapExhausted = heapLimit && accountedBytes() > heapLimit;
+    if (dumpThreshold && !thresholdDumped && used > dumpThreshold) {
+        thresholdDumped = true;
+        dumpRequested = 1;
+    }
+    Diagnostics::getInstance().onHeapUsage(used, nativeUsed);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    LOG_DEBUG("[GC] Major: freed " + std::to_string(objectsBefore - objects.size()) + " objects (" +
+              std::to_string((usedBefore - used) / 1024) + " KB), " + std::to_string(objects.size()) + " live (" +
+              std::to_string(used / 1024) + " KB) in " + std::to_string(elapsed) + " us");
+    return objectsBefore - objects.size();
+}
+
+void HeapManager::sweep() {
+    // Release the native resources of unmarked owners, then drop the unmarked objects and
+    // clear the mark of the others
+    // 释放未标记的所有者的本地资源，然后移除未标记的对象，并清除其余对象的标记
+    NativeHandles::getInstance().sweepOld([this](JavaObject* obj) {
+        return inNursery(obj) || (obj->gcBits & JavaObject::GC_MARKED) != 0;
+    });
+    auto live = std::remove_if(objects.begin(), objects.end(), [](JavaObject* obj) {
+        if (!(obj->gcBits & JavaObject::GC_MARKED)) return true;
+        obj->gcBits &= ~JavaObject::GC_MARKED;
+        return false;
+    });
+    objects.erase(live, objects.end());
+
+    // Every gap between live objects (adjacent dead blocks merge on their own) becomes a
+    // free chunk; the space after the last live object goes back to the bump pointer
+    // 存活对象之间的每个空隙 (相邻的死对象自然合并) 成为空闲块; 最后一个存活对象之后的空间交还给顺序分配
+    std::sort(objects.begin(), objects.end());
+    for (auto& list : freeLists) list.clear();
+    largeChunks.clear();
+    freeBytes = 0;
+    used = 0;
+    clearObjectStarts();
+    size_t end = NURSERY_END;
+    for (JavaObject* obj : objects) {
+        size_t offset = (size_t)(reinterpret_cast<uint8_t*>(obj) - base);
+        addFree(end, offset - end);
+        size_t bytes = blockSize(obj);
+        used += bytes;
+        end = offset + bytes;
+        recordStart(obj);
+    }
+
+#if defined(__linux__) || defined(__APPLE__)
+    // Hand the pages above the new end back to the system
+    // 将新的分配位置之上的页归还给系统
+    size_t page = 4096;
+    size_t keep = (end + page - 1) & ~(page - 1);
+    size_t touched = (top + page - 1) & ~(page - 1);
+    if (touched > keep) madvise(base + keep, touched - keep, MADV_DONTNEED);
+#endif
+    top = end;
+}
+
+void HeapManager::clear() {
+    clearObjectStarts();
+    objects.clear();
+    markStack.clear();
+    marking = false;
+    cycleRequested = false;
+    std::memset(base + NURSERY_START, 0, nurseryTop - NURSERY_START);
+    nurseryTop = NURSERY_START;
+    nurseryObjects = 0;
+    minorRequested = false;
+    top = NURSERY_END;
+    for (auto& list : freeLists) list.clear();
+    largeChunks.clear();
+    freeBytes = 0;
+    used = 0;
+    allocatedSinceCollection = 0;
+    heapExhausted = false;
 }
 
 } // namespace core
@@ -1,15 +1,30 @@
 #pragma once
 
 #include "RuntimeTypes.hpp"
-#include "../native/NativeInputStream.hpp"
-#include <list>
 #include <memory>
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+// -DJ2ME_NURSERY_KB sets the size of the nursery, where new objects are bump-allocated and
+// from which a minor collection promotes the survivors
+// 可通过 -DJ2ME_NURSERY_KB 设置新生代大小: 新对象在其中顺序分配，次要回收将存活对象从中晋升
+#ifndef J2ME_NURSERY_KB
+#define J2ME_NURSERY_KB 2048
+#endif
 
 namespace j2me {
 namespace core {
 
+class Interpreter;
+class JavaThread;
+struct RuntimeMethod;
+
 class HeapManager {
 public:
     // Singleton for simplicity in Phase 2
@@ -18,28 +33,276 @@ public:
         return instance;
     }
 
-    JavaObject* allocate(std::shared_ptr<JavaClass> cls);
+    // Zeroed instance of `cls`, from the nursery when it fits / 分配 cls 的清零实例，能放下时在新生代中分配
+    JavaObject* allocate(JavaClass* cls);
+    JavaObject* allocate(const std::shared_ptr<JavaClass>& cls) { return allocate(cls.get()); }
+
+    // Zeroed array of `length` elements stored inline at the size of the array class's
+    // element kind
+    // 分配包含 length 个元素的清零数组，元素按数组类的元素类型大小紧凑存放
+    JavaObject* allocateArray(JavaClass* cls, int32_t length);
+    JavaObject* allocateArray(const std::shared_ptr<JavaClass>& cls, int32_t length) { return allocateArray(cls.get(), length); }
+
+    // allocate() exempt from the heap cap, for the VM's preallocated exceptions
+    // 不受堆上限限制的 allocate()，用于虚拟机预分配的异常
+    JavaObject* allocateReserved(JavaClass* cls) { return allocateBlock(cls, instanceBlockSize(cls)); }
     
-    // Very basic "GC" - just clear everything (for shutdown)
-    void clear();
+    // Generational collection from every root; only safe between time slices. Returns the objects freed
+    // 从所有根出发的分代回收; 只能在时间片之间进行。返回释放的对象数
+    size_t collect(Interpreter& interpreter);
+
+    // Whether collect() has work: a full nursery, enough old-space allocation, or a request
+    // collect() 是否有工作: 新生代已满、老年代分配量足够，或有回收请求
+    bool isCollectionDue() const { return minorRequested || collectionRequested || dumpRequested; }
+    void requestCollection() { collectionRequested = true; }
+
+    // One slice of at most `budget` of an incremental major collection. Returns the objects freed
+    // 增量主要回收中不超过 budget 的一个时间片。返回释放的对象数
+    size_t collectStep(Interpreter& interpreter, std::chrono::microseconds budget);
+    bool isMarking() const { return marking; }
+
+    // Per-frame time for collectStep (--gc-budget-us); 0 keeps major collections stop-the-world
+    // 每帧用于 collectStep 的时间 (--gc-budget-us); 为 0 时主要回收保持暂停式
+    void setIncrementalBudget(std::chrono::microseconds budget) { incrementalBudget = budget; }
+    std::chrono::microseconds getIncrementalBudget() const { return incrementalBudget; }
+
+    // Full collection, class histogram in the log, and every live object written to `path`
+    // (docs/HEAP_DUMP.md); only safe where collect() is
+    // 完整回收后在日志中输出类直方图，并将所有存活对象写入 path (docs/HEAP_DUMP.md); 只能在可以调用 collect() 的位置调用
+    bool dumpHeap(Interpreter& interpreter, const std::string& path, size_t topClasses = 20);
+    void requestDump() { dumpRequested = 1; }
+    void setDumpPrefix(const std::string& prefix) { dumpPrefix = prefix; }
+    void setDumpThreshold(size_t bytes) { dumpThreshold = bytes; }
+    // Path of the next triggered dump / 下一次触发的转储的路径
+    std::string nextDumpPath() { return dumpPrefix + "-" + std::to_string(++dumpCount) + ".j2heap"; }
+
+    // Charge every `everyN`th allocation, N times over, to its bytecode site (0 turns sampling off)
+    // 每 everyN 次分配采样一次，按 N 倍计入其字节码位置 (0 表示关闭)
+    void setAllocationSampling(uint32_t everyN);
+    void setMutator(JavaThread* thread) { mutator = thread; }
+    bool reportAllocationSites(size_t topSites = 20, const std::string& path = std::string()) const;
+
+    // A native slot holding a reference outside the Java heap (the current Displayable, the
+    // MIDlet instance); the collector reads it on every collection
+    // 登记一个在 Java 堆之外保存引用的本地槽位 (当前 Displayable、MIDlet 实例)，每次回收时都会读取
+    void addRoot(JavaObject** slot);
+    void removeRoot(JavaObject** slot);
+
+    // Bytes taken by objects not yet found unreachable, and the most the heap can hold
+    // (Runtime.freeMemory/totalMemory)
+    // 尚未被判定为不可达的对象所占字节数，以及堆的容量 (用于 Runtime.freeMemory/totalMemory)
+    size_t usedBytes() const { return used + (nurseryTop - NURSERY_START); }
+    size_t capacityBytes() const { return size - sizeof(JavaObject); }
+
+    // Heap cap on Java and reserveNative() bytes (--heap-max; 0 for none)
+    // 计入 Java 堆与 reserveNative() 字节数的堆上限 (--heap-max，0 表示不限制)
+    void setHeapLimit(size_t bytes) { heapLimit = bytes; }
+    size_t getHeapLimit() const { return heapLimit; }
+    size_t accountedBytes() const { return usedBytes() + nativeUsed; }
+
+    // Native memory held on behalf of Java objects, counted against the cap
+    // 代表 Java 对象持有的本地内存，计入堆上限
+    void reserveNative(size_t bytes);
+    void releaseNative(size_t bytes) { nativeUsed -= std::min(bytes, nativeUsed); }
+    size_t nativeBytes() const { return nativeUsed; }
     
-    // Stream management for NativeInputStream
-    int allocateStream(const uint8_t* data, size_t size);
-    int allocateStreamWithPath(const uint8_t* data, size_t size, const std::string& path);
-    natives::NativeInputStream* getStream(int id);
-    void removeStream(int id);
+    // Release every object at once (shutdown)
+    // 一次性释放所有对象 (关闭时)
+    void clear();
+    ~HeapManager();
+
+    // The Java heap is one region reserved up front (address space only; pages are backed
+    // as allocation reaches them). With compressed references it is at most 4 GB and its
+    // base is what the 32-bit offsets are relative to.
+    // Java 堆是预先保留的一整块区域 (只占地址空间，分配到的页才实际占用内存)。
+    // 启用压缩引用时不超过 4 GB，其起始地址即 32 位偏移的基址
+#if J2ME_COMPRESSED_REFS
+    static constexpr size_t DEFAULT_REGION_BYTES = (size_t)4 << 30;
+#else
+    static constexpr size_t DEFAULT_REGION_BYTES = (size_t)1 << 30;
+#endif
+    uint8_t* regionBase() const { return base; }
+    size_t regionUsed() const { return top; }
+    size_t regionSize() const { return size; }
+
 
 private:
-    HeapManager() = default;
-    
-    // We store raw pointers in a list to own them. 
-    // In a real GC, we'd need a more complex structure (e.g., arenas).
-    // Using list to avoid pointer invalidation on resize.
-    std::list<JavaObject> objects;
+    HeapManager();
+
+    // Calls visit(JavaObject*) on every non-null reference stored in `obj` and stores back what
+    // it returns when that differs (an object that moved); the card is left alone
+    // 对 obj 中保存的每个非空引用调用 visit(JavaObject*)，返回值不同时 (对象已移动) 写回; 不改变卡的状态
+    template <typename Visit>
+    static void visitFields(JavaObject* obj, Visit&& visit) {
+        const JavaClass* cls = obj->cls;
+        if (!cls) return;
+        if (cls->isArray) {
+            if (cls->elementKind != FIELD_A) return;
+            HeapRef* elements = obj->elements<HeapRef>();
+            for (int32_t i = 0, n = obj->arrayLength(); i < n; i++) {
+                JavaObject* ref = decodeRef(elements[i]);
+                if (!ref) continue;
+                JavaObject* moved = visit(ref);
+                if (moved != ref) elements[i] = encodeRef(moved);
+            }
+        } else {
+            for (uint32_t offset : cls->referenceOffsets) {
+                JavaObject* ref = obj->getRef(offset);
+                if (!ref) continue;
+                JavaObject* moved = visit(ref);
+                if (moved != ref) obj->set(offset, encodeRef(moved));
+            }
+        }
+    }
+
+    // Calls visit on every root and stores back what it returns
+    // 对每个根调用 visit 并写回其返回值
+    void visitAllRoots(Interpreter& interpreter, const std::function<JavaObject*(JavaObject*)>& visit);
     
-    // Stream storage
-    std::vector<std::unique_ptr<j2me::natives::NativeInputStream>> streams;
-    int nextStreamId = 1;
+    JavaObject* allocateBlock(JavaClass* cls, size_t bytes);
+    // Region offset of a block of the old space (accounted, not cleared)
+    // 老年代中一块内存的堆区偏移 (计入统计，不清零)
+    size_t allocateOld(size_t bytes);
+    // Whether `bytes` more can be bump-allocated in the old space (committing them)
+    // 老年代能否再顺序分配 bytes 字节 (并提交这些内存)
+    bool reserveOld(size_t bytes);
+    // Past the heap cap: grant from the reserve or throw OutOfMemoryError
+    // 超过堆上限: 从预留空间中满足，或抛出 OutOfMemoryError
+    void overLimit(size_t bytes);
+
+    // Size of the block holding `obj`, from its class (and length for arrays)
+    // 由对象的类 (数组另加长度) 计算其内存块大小
+    static size_t blockSize(const JavaObject* obj);
+    static size_t instanceBlockSize(const JavaClass* cls);
+    static size_t arrayBlockSize(const JavaClass* cls, int32_t length);
+
+    // Free space found by the last sweep: one list per 8-byte size class, then first-fit chunks
+    // 上次清除得到的空闲空间: 每个 8 字节大小级别一个链表，更大的块使用首次适配
+    static constexpr size_t MIN_BLOCK_BYTES = sizeof(JavaObject) + sizeof(int64_t);
+    static constexpr size_t SMALL_BLOCK_LIMIT = 256;
+    struct FreeChunk {
+        size_t offset;
+        size_t bytes;
+    };
+    std::vector<size_t> freeLists[SMALL_BLOCK_LIMIT / 8 + 1]; // Region offsets, by bytes / 8 / 堆区偏移，按 字节数/8 索引
+    std::vector<FreeChunk> largeChunks;
+    size_t freeBytes = 0;
+    size_t takeFree(size_t bytes);
+    void addFree(size_t offset, size_t bytes);
+    size_t collectNursery(Interpreter& interpreter);
+    // Calls visit(JavaObject*) on every old object below region offset `end` whose header
+    // is on a dirty card / 对堆区偏移 end 之下、对象头位于被标记的卡上的每个老年代对象调用 visit(JavaObject*)
+    template <typename Visit>
+    void visitDirtyCards(size_t end, Visit&& visit);
+    size_t collectOld(Interpreter& interpreter);
+    void sweep();
+
+    // Tri-color marking state, kept across collectStep slices / 三色标记的状态，在 collectStep 的各时间片之间保留
+    using Clock = std::chrono::steady_clock;
+    bool marking = false;
+    bool cycleRequested = false;
+    std::vector<JavaObject*> markStack;
+    std::chrono::microseconds incrementalBudget{0};
+    size_t cycleSteps = 0;
+    Clock::duration longestStep{0};
+    JavaObject* shade(JavaObject* obj);
+    void shadeRoots(Interpreter& interpreter);
+    bool trace(Clock::time_point deadline);
+
+    // The nursery, [NURSERY_START, NURSERY_END), bump-allocated from nurseryTop; the old space follows it
+    // 新生代 [NURSERY_START, NURSERY_END)，从 nurseryTop 顺序分配; 其后为老年代
+    static constexpr size_t NURSERY_START = sizeof(JavaObject);
+    static constexpr size_t NURSERY_END = (size_t)J2ME_NURSERY_KB << 10;
+    static constexpr size_t LARGE_OBJECT_BYTES = (size_t)64 << 10; // Allocated old / 直接在老年代分配
+    size_t nurseryTop = NURSERY_START;
+    size_t nurseryObjects = 0;
+    bool minorRequested = false;
+    bool inNursery(const JavaObject* obj) const {
+        const uint8_t* at = reinterpret_cast<const uint8_t*>(obj);
+        return at >= base + NURSERY_START && at < base + nurseryTop;
+    }
+
+    // Backing store of cardTableBase, one byte per card of the region
+    // cardTableBase 的实际存储，堆区每张卡一个字节
+    uint8_t* cards = nullptr;
+    size_t cardOf(const void* at) const {
+        return (reinterpret_cast<uintptr_t>(at) >> CARD_SHIFT) - (reinterpret_cast<uintptr_t>(base) >> CARD_SHIFT);
+    }
+
+    // Bit i of a card's word: an old object's header is at the card's i-th 8 bytes
+    // 每张卡一个字: 老年代对象头位于该卡第 i 个 8 字节处时第 i 位置位
+    static_assert((1u << CARD_SHIFT) / 8 == 64, "one 64-bit word of object starts per card");
+    uint64_t* objectStarts = nullptr;
+    void recordStart(const JavaObject* obj) {
+        objectStarts[cardOf(obj)] |= (uint64_t)1 << ((reinterpret_cast<uintptr_t>(obj) >> 3) & 63);
+    }
+    // Forget every start in the old space (below top) / 清除老年代 (top 之下) 的所有起始位置
+    void clearObjectStarts();
+
+    // Old-space accounting (promotions included) and the major collection trigger
+    // 老年代分配统计 (含晋升) 与主要回收的触发条件
+    static constexpr size_t MIN_COLLECT_BYTES = (size_t)4 << 20;
+    size_t used = 0;
+    size_t allocatedSinceCollection = 0;
+    size_t collectThreshold = MIN_COLLECT_BYTES;
+    bool collectionRequested = false;
+
+    // Heap cap state; heapExhausted when the last full collection left the heap over it
+    // 堆上限的状态; 上次完整回收后仍超过上限时 heapExhausted 为 true
+    size_t heapLimit = 0;
+    size_t nativeUsed = 0;
+    bool heapExhausted = false;
+
+    std::vector<JavaObject**> roots;
+
+    // Heap dump triggers / 堆转储的触发条件
+    volatile std::sig_atomic_t dumpRequested = 0;
+    std::string dumpPrefix = "heap";
+    size_t dumpThreshold = 0;
+    bool thresholdDumped = false;
+    int dumpCount = 0;
+
+    // Allocation sampling: the countdown to the next sample, and the sites by (method, pc,
+    // class); a null method is the "<vm>" site
+    // 分配采样: 距下一次采样的分配次数，以及按 (方法, pc, 类) 汇总的分配点; 方法为空表示 "<vm>"
+    struct SiteKey {
+        const RuntimeMethod* method;
+        uint32_t pc;
+        const JavaClass* cls;
+        bool operator==(const SiteKey& other) const {
+            return method == other.method && pc == other.pc && cls == other.cls;
+        }
+    };
+    struct SiteKeyHash {
+        size_t operator()(const SiteKey& key) const {
+            return std::hash<const void*>()(key.method) ^ (key.pc * 0x9E3779B1u) ^
+                   (std::hash<const void*>()(key.cls) << 1);
+        }
+    };
+    struct AllocationSite {
+        std::string method;   // Class.method / 类名.方法名
+        int line = -1;
+        uint64_t samples = 0;
+        uint64_t bytes = 0;   // Estimated: sampled bytes times the interval / 估计值: 采样字节数乘以采样间隔
+    };
+    uint32_t sampleInterval = 0;
+    uint32_t sampleCountdown = UINT32_MAX;
+    JavaThread* mutator = nullptr;
+    std::unordered_map<SiteKey, AllocationSite, SiteKeyHash> allocationSites;
+    Clock::time_point samplingStart{};
+    uint64_t samplingStartFrames = 0;
+    void sampleAllocation(const JavaClass* cls, size_t bytes);
+
+    // The region; the old space is bump-allocated from `top`, and offset 0 stays unused (null)
+    // 堆区，老年代从 top 处顺序分配; 偏移 0 不使用 (表示 null)
+    uint8_t* base = nullptr;
+    size_t size = 0;
+    size_t top = 0;
+    size_t committed = 0; // Bytes usable without committing more (Windows) / 无需再提交即可使用的字节数 (Windows)
+    bool commit(size_t end);
+
+    // Every old-space object not yet found unreachable / 老年代中所有尚未被判定为不可达的对象
+    std::vector<JavaObject*> objects;
 };
 
 } // namespace core
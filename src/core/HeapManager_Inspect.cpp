@@ -0,0 +1,192 @@
+#include "HeapManager.hpp"
+#include "Interpreter.hpp"
+#include "Diagnostics.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+// 堆检查: 类直方图与堆转储 (Heap inspection: class histogram and heap dump)
+//
+// 转储前先进行一次完整回收，此后所有存活对象都位于老年代且 objects 按地址排序，因此对象图可以按下标建立。
+// 保留字节数按类计算: 从根出发、跳过该类的所有实例后仍可达的字节数与存活总字节数之差，
+// 即该类的实例全部消失时能够释放的字节数。转储格式见 docs/HEAP_DUMP.md。
+//
+// A full collection comes first: afterwards every live object is in the old space and
+// `objects` is sorted by address, so the object graph can be built over indices. Retained
+// bytes are per class: the live bytes minus what is still reachable from the roots when
+// every instance of the class is skipped, i.e. what would be freed if they all went away.
+// The dump format is described in docs/HEAP_DUMP.md.
+
+namespace j2me {
+namespace core {
+
+namespace {
+
+constexpr char DUMP_MAGIC[8] = {'J', '2', 'M', 'E', 'H', 'E', 'A', 'P'};
+constexpr uint32_t DUMP_VERSION = 1;
+constexpr uint32_t NO_INDEX = UINT32_MAX;
+
+// Little-endian, whatever the host / 与主机无关，统一为小端序
+void put32(std::ostream& out, uint32_t value) {
+    char bytes[4];
+    for (int i = 0; i < 4; i++) bytes[i] = (char)(value >> (8 * i));
+    out.write(bytes, 4);
+}
+
+void put64(std::ostream& out, uint64_t value) {
+    char bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (char)(value >> (8 * i));
+    out.write(bytes, 8);
+}
+
+struct ClassStats {
+    std::string name;
+    uint64_t instances = 0;
+    uint64_t shallowBytes = 0;
+    uint64_t retainedBytes = 0;
+};
+
+} // namespace
+
+// The histogram lists the classes with the most live bytes (instances, shallow and retained
+// bytes); the dump holds every live object, its references and the roots, and
+// scripts/heapdump.py reads and diffs dumps. The other triggers take a dump named
+// `<prefix>-<n>.j2heap` at the next safepoint: requestDump() (safe from a signal handler,
+// SIGUSR1), and the first major collection to leave more than the threshold live.
+// 直方图列出存活字节数最多的若干个类 (实例数、浅层字节数与保留字节数); 转储包含所有存活对象、其引用以及根，
+// scripts/heapdump.py 用于读取和比较转储。其他触发方式在下一个安全点生成名为 <prefix>-<n>.j2heap 的转储:
+// requestDump() (可在信号处理函数中调用，对应 SIGUSR1)，以及第一次在回收后存活量超过阈值的主要回收
+bool HeapManager::dumpHeap(Interpreter& interpreter, const std::string& path, size_t topClasses) {
+    auto start = std::chrono::steady_clock::now();
+    collectionRequested = true;
+    collectNursery(interpreter);
+    collectOld(interpreter);
+
+    // The graph by index: the references of object i are edges[edgeStart[i], edgeStart[i + 1])
+    // 按下标表示的对象图: 对象 i 的引用为 edges[edgeStart[i], edgeStart[i + 1])
+    size_t count = objects.size();
+    auto indexOf = [this](JavaObject* obj) -> uint32_t {
+        auto it = std::lower_bound(objects.begin(), objects.end(), obj);
+        return (it != objects.end() && *it == obj) ? (uint32_t)(it - objects.begin()) : NO_INDEX;
+    };
+    std::vector<uint32_t> edgeStart(count + 1);
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> bytes(count);
+    std::vector<uint32_t> classOf(count);
+    std::vector<ClassStats> classes;
+    std::unordered_map<const JavaClass*, uint32_t> classIndex;
+    uint64_t liveBytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        JavaObject* obj = objects[i];
+        edgeStart[i] = (uint32_t)edges.size();
+        visitFields(obj, [&](JavaObject* ref) {
+            uint32_t at = indexOf(ref);
+            if (at != NO_INDEX) edges.push_back(at);
+            return ref;
+        });
+        auto found = classIndex.emplace(obj->cls, (uint32_t)classes.size());
+        if (found.second) {
+            classes.emplace_back();
+            classes.back().name = obj->cls ? obj->cls->name : "<unknown>";
+        }
+        classOf[i] = found.first->second;
+        bytes[i] = (uint32_t)blockSize(obj);
+        classes[classOf[i]].instances++;
+        classes[classOf[i]].shallowBytes += bytes[i];
+        liveBytes += bytes[i];
+    }
+    edgeStart[count] = (uint32_t)edges.size();
+
+    std::vector<uint32_t> rootIndices;
+    visitAllRoots(interpreter, [&](JavaObject* obj) {
+        uint32_t at = obj ? indexOf(obj) : NO_INDEX;
+        if (at != NO_INDEX) rootIndices.push_back(at);
+        return obj;
+    });
+    std::sort(rootIndices.begin(), rootIndices.end());
+    rootIndices.erase(std::unique(rootIndices.begin(), rootIndices.end()), rootIndices.end());
+
+    // Retained bytes of the classes with the most shallow bytes, one traversal each
+    // 浅层字节数最多的若干个类的保留字节数，每个类遍历一次
+    std::vector<uint32_t> order(classes.size());
+    for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b) { return classes[a].shallowBytes > classes[b].shallowBytes; });
+    if (order.size() > topClasses) order.resize(topClasses);
+    std::vector<uint32_t> seen(count, 0);
+    std::vector<uint32_t> pending;
+    for (uint32_t rank = 0; rank < order.size(); rank++) {
+        uint32_t skipped = order[rank];
+        uint32_t stamp = rank + 1;
+        uint64_t reached = 0;
+        auto reach = [&](uint32_t at) {
+            if (seen[at] == stamp || classOf[at] == skipped) return;
+            seen[at] = stamp;
+            reached += bytes[at];
+            pending.push_back(at);
+        };
+        for (uint32_t root : rootIndices) reach(root);
+        while (!pending.empty()) {
+            uint32_t at = pending.back();
+            pending.pop_back();
+            for (uint32_t e = edgeStart[at]; e < edgeStart[at + 1]; e++) reach(edges[e]);
+        }
+        classes[skipped].retainedBytes = liveBytes - reached;
+    }
+
+    LOG_INFO("[Heap] Histogram: " + std::to_string(count) + " objects, " + std::to_string(liveBytes / 1024) +
+             " KB live, " + std::to_string(nativeUsed / 1024) + " KB native");
+    LOG_INFO("[Heap]  instances   shallow KB  retained KB  class");
+    for (uint32_t at : order) {
+        const ClassStats& stats = classes[at];
+        char line[64];
+        std::snprintf(line, sizeof(line), "%11llu %12llu %12llu  ", (unsigned long long)stats.instances,
+                      (unsigned long long)(stats.shallowBytes / 1024), (unsigned long long)(stats.retainedBytes / 1024));
+        LOG_INFO("[Heap] " + std::string(line) + stats.name);
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("[Heap] Cannot write heap dump " + path);
+        return false;
+    }
+    auto idOf = [this](uint32_t at) { return (uint64_t)(reinterpret_cast<uint8_t*>(objects[at]) - base); };
+    out.write(DUMP_MAGIC, sizeof(DUMP_MAGIC));
+    put32(out, DUMP_VERSION);
+    put32(out, 0);
+    put64(out, (uint64_t)Diagnostics::getInstance().getNowMs());
+    put64(out, accountedBytes());
+    put64(out, heapLimit);
+    put32(out, (uint32_t)classes.size());
+    for (const ClassStats& stats : classes) {
+        put32(out, (uint32_t)stats.name.size());
+        out.write(stats.name.data(), (std::streamsize)stats.name.size());
+    }
+    put32(out, (uint32_t)count);
+    for (uint32_t at = 0; at < count; at++) {
+        JavaObject* obj = objects[at];
+        put64(out, idOf(at));
+        put32(out, classOf[at]);
+        put32(out, bytes[at]);
+        put32(out, (obj->cls && obj->cls->isArray) ? (uint32_t)obj->arrayLength() : UINT32_MAX);
+        put32(out, edgeStart[at + 1] - edgeStart[at]);
+        for (uint32_t e = edgeStart[at]; e < edgeStart[at + 1]; e++) put64(out, idOf(edges[e]));
+    }
+    put32(out, (uint32_t)rootIndices.size());
+    for (uint32_t root : rootIndices) put64(out, idOf(root));
+    if (!out.good()) {
+        LOG_ERROR("[Heap] Cannot write heap dump " + path);
+        return false;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("[Heap] Dump of " + std::to_string(count) + " objects written to " + path + " in " +
+             std::to_string(elapsed) + " ms");
+    return true;
+}
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,142 @@
+#include "HeapManager.hpp"
+#include "JavaThread.hpp"
+#include "Diagnostics.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+// 分配点采样 (Allocation-site sampling)
+//
+// 每 N 次分配采样一次: 分配计数倒数到 0 时，将该次分配按 N 倍计入运行中线程栈顶栈帧的 (方法, pc)。
+// 所有执行层 (线程化解释器、分派表、寄存器 IR、JIT、AOT) 在执行可能分配的指令之前都会同步 frame->pc，
+// 本地方法不压入栈帧，因此本地方法中的分配落在调用它的指令上。分配点第一次被采样时才解析方法名与行号，
+// 之后的采样只是一次哈希表查找。
+//
+// One allocation in N is sampled: when the countdown reaches 0 the allocation is charged,
+// N times over, to the (method, pc) of the top frame of the running thread. Every tier
+// (threaded, table, register IR, JIT, AOT) syncs frame->pc before running an instruction
+// that may allocate, and natives push no frame, so what a native allocates lands on the
+// instruction that invoked it. A site's method name and line are looked up the first time
+// it is sampled; later samples are one hash lookup.
+
+namespace j2me {
+namespace core {
+
+namespace {
+
+// "Class.method" of a frame, as describeStack prints it / 栈帧的 "类名.方法名"，与 describeStack 的输出一致
+std::string methodName(const StackFrame& frame) {
+    std::string cName = "Unknown";
+    std::string mName = "Unknown";
+    if (frame.classFile) {
+        const auto& pool = frame.classFile->constant_pool;
+        auto cls = std::dynamic_pointer_cast<ConstantClass>(pool[frame.classFile->this_class]);
+        if (cls) {
+            auto utf8 = std::dynamic_pointer_cast<ConstantUtf8>(pool[cls->name_index]);
+            if (utf8) cName = utf8->bytes;
+        }
+        if (frame.method.name_index < pool.size()) {
+            auto mUtf8 = std::dynamic_pointer_cast<ConstantUtf8>(pool[frame.method.name_index]);
+            if (mUtf8) mName = mUtf8->bytes;
+        }
+    }
+    return cName + "." + mName;
+}
+
+} // namespace
+
+// The site is the NEW/NEWARRAY/ANEWARRAY/MULTIANEWARRAY itself, or the invoke of the native
+// that allocated (createJavaString, StringBuffer.toString, Image.createImage...).
+// Interpreter::execute names the running thread with setMutator(); allocations made outside a
+// time slice (painting setup, startup) go to a "<vm>" site. reportAllocationSites() logs the
+// top sites by bytes with their line, bytes/s and bytes per painted frame, and writes every
+// site to `path` when given.
+// 分配点即 NEW/NEWARRAY/ANEWARRAY/MULTIANEWARRAY 本身，或进行分配的本地方法的调用指令 (createJavaString、StringBuffer.toString、
+// Image.createImage 等)。Interpreter::execute 通过 setMutator() 指明运行中的线程; 时间片之外的分配 (绘制准备、启动) 计入 "<vm>"。
+// reportAllocationSites() 在日志中按字节数输出前若干个分配点 (行号、字节/秒、每绘制帧字节数)，给出 path 时将全部分配点写入该文件
+void HeapManager::setAllocationSampling(uint32_t everyN) {
+    sampleInterval = everyN;
+    sampleCountdown = everyN ? everyN : UINT32_MAX;
+    allocationSites.clear();
+    samplingStart = Clock::now();
+    samplingStartFrames = Diagnostics::getInstance().getPaintCommitCount();
+}
+
+void HeapManager::sampleAllocation(const JavaClass* cls, size_t bytes) {
+    if (sampleInterval == 0) {
+        sampleCountdown = UINT32_MAX;
+        return;
+    }
+    sampleCountdown = sampleInterval;
+
+    StackFrame* frame = (mutator && !mutator->frames.empty()) ? mutator->frames.back().get() : nullptr;
+    SiteKey key{frame ? frame->runtime : nullptr, frame ? frame->pc : 0, cls};
+    auto found = allocationSites.emplace(key, AllocationSite());
+    AllocationSite& site = found.first->second;
+    if (found.second) {
+        site.method = frame ? methodName(*frame) : "<vm>";
+        site.line = frame ? frame->getLineNumber(frame->pc) : -1;
+    }
+    site.samples++;
+    site.bytes += (uint64_t)bytes * sampleInterval;
+}
+
+bool HeapManager::reportAllocationSites(size_t topSites, const std::string& path) const {
+    if (sampleInterval == 0) return false;
+
+    struct Row {
+        const SiteKey* key;
+        const AllocationSite* site;
+    };
+    std::vector<Row> rows;
+    uint64_t totalBytes = 0;
+    for (const auto& entry : allocationSites) {
+        rows.push_back({&entry.first, &entry.second});
+        totalBytes += entry.second.bytes;
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.site->bytes > b.site->bytes; });
+
+    double seconds = std::chrono::duration<double>(Clock::now() - samplingStart).count();
+    if (seconds <= 0) seconds = 1e-3;
+    uint64_t frames = Diagnostics::getInstance().getPaintCommitCount() - samplingStartFrames;
+
+    // One line per site: estimated bytes, allocations, bytes/s, bytes per painted frame, then
+    // where / 每个分配点一行: 估计字节数、分配次数、字节/秒、每绘制帧字节数，然后是位置
+    auto describe = [&](const Row& row) {
+        const AllocationSite& site = *row.site;
+        char numbers[96];
+        std::snprintf(numbers, sizeof(numbers), "%12llu %10llu %11.0f %10.0f  ", (unsigned long long)site.bytes,
+                      (unsigned long long)(site.samples * sampleInterval), site.bytes / seconds,
+                      frames ? (double)site.bytes / frames : 0.0);
+        std::string where = site.method;
+        if (row.key->method) {
+            where += " pc " + std::to_string(row.key->pc);
+            if (site.line >= 0) where += " line " + std::to_string(site.line);
+        }
+        return std::string(numbers) + where + " (" + (row.key->cls ? row.key->cls->name : "<unknown>") + ")";
+    };
+    const char* header = "       bytes     allocs     bytes/s    B/frame  site (class)";
+
+    char summary[160];
+    std::snprintf(summary, sizeof(summary), "[Alloc] ~%llu KB in %.1f s (%.0f KB/s, %llu painted frames), 1 in %u sampled, %zu sites",
+                  (unsigned long long)(totalBytes / 1024), seconds, totalBytes / 1024.0 / seconds,
+                  (unsigned long long)frames, sampleInterval, rows.size());
+    LOG_INFO(summary);
+    LOG_INFO(std::string("[Alloc] ") + header);
+    for (size_t i = 0; i < rows.size() && i < topSites; i++) LOG_INFO("[Alloc] " + describe(rows[i]));
+
+    if (path.empty()) return true;
+    std::ofstream out(path);
+    if (!out) {
+        LOG_ERROR("[Alloc] Cannot write allocation profile " + path);
+        return false;
+    }
+    out << "# " << (summary + 8) << "\n# " << header << "\n";
+    for (const Row& row : rows) out << describe(row) << "\n";
+    LOG_INFO("[Alloc] Wrote " + std::to_string(rows.size()) + " allocation sites to " + path);
+    return true;
+}
+
+} // namespace core
+} // namespace j2me
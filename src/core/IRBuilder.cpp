@@ -0,0 +1,538 @@
+#include "RegisterIR.hpp"
+#include "Opcodes.hpp"
+#include "RuntimeTypes.hpp"
+#include "Logger.hpp"
+
+// Bytecode -> register IR translation (see RegisterIR.hpp)
+//
+// Works on a RuntimeMethod and its class file only, so besides the second tier it also
+// serves the AOT compiler (src/aot), which translates a whole JAR offline. Quickened
+// instructions name interpreter caches; those are looked up through IRQuickening.
+//
+// 字节码 -> 寄存器 IR 的翻译 (见 RegisterIR.hpp)。
+// 只依赖 RuntimeMethod 与类文件，因此除第二执行层外，AOT 编译器 (src/aot) 也用它离线翻译整个 JAR。
+// 快速化指令引用解释器的缓存，通过 IRQuickening 查询
+
+namespace j2me {
+namespace core {
+
+namespace {
+
+// Value kinds of the typed opcode groups, in the order of Interpreter::QuickKind
+// 带类型指令组的值类型，顺序与 Interpreter::QuickKind 一致
+enum ValueKind : uint8_t { KIND_I, KIND_J, KIND_F, KIND_D, KIND_A };
+
+inline int kindWidth(int kind) { return (kind == KIND_J || kind == KIND_D) ? 2 : 1; }
+
+inline int16_t readS2(const uint8_t* p) { return (int16_t)((p[0] << 8) | p[1]); }
+inline int32_t readS4(const uint8_t* p) { return (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]); }
+inline uint16_t readU2(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+
+// Slots taken by a value of the given field descriptor / return type (after ')')
+// 字段描述符 (或返回类型) 对应数值占用的槽位数
+int valueSlots(char type) {
+    if (type == 'V') return 0;
+    return (type == 'J' || type == 'D') ? 2 : 1;
+}
+
+// Descriptor of the field or method named by a Fieldref/Methodref constant
+// 字段/方法引用常量所指成员的描述符
+bool refDescriptor(const ClassFile& cf, uint16_t index, std::string& descriptor) {
+    if (index >= cf.constant_pool.size()) return false;
+    auto ref = std::dynamic_pointer_cast<ConstantRef>(cf.constant_pool[index]);
+    if (!ref || ref->name_and_type_index >= cf.constant_pool.size()) return false;
+    auto nat = std::dynamic_pointer_cast<ConstantNameAndType>(cf.constant_pool[ref->name_and_type_index]);
+    if (!nat || nat->descriptor_index >= cf.constant_pool.size()) return false;
+    auto utf8 = std::dynamic_pointer_cast<ConstantUtf8>(cf.constant_pool[nat->descriptor_index]);
+    if (!utf8 || utf8->bytes.empty()) return false;
+    descriptor = utf8->bytes;
+    return true;
+}
+
+// Operand stack effect of a call: -(arguments [+ this]) + return value
+// 方法调用对操作数栈的影响: -(参数 [+ this]) + 返回值
+bool invokeEffect(const ClassFile& cf, uint16_t cpIndex, bool hasReceiver, int& delta) {
+    std::string desc;
+    if (!refDescriptor(cf, cpIndex, desc)) return false;
+    size_t close = desc.find(')');
+    if (close == std::string::npos || close + 1 >= desc.size()) return false;
+    delta = valueSlots(desc[close + 1]) - RuntimeMethod::countArgSlots(desc) - (hasReceiver ? 1 : 0);
+    return true;
+}
+
+// Operand stack effect of the bytecode at pc; false if it cannot be determined
+// pc 处字节码对操作数栈深度的影响; 无法确定时返回 false
+bool stackEffect(const std::vector<uint8_t>& code, const ClassFile& cf, size_t pc, const IRQuickening* quick, int& delta) {
+    uint8_t op = baseOpcode(code[pc]);
+    static const int8_t fixedEffect[] = {
+        // 0x00 nop, aconst_null, iconst_m1..5, lconst_0/1, fconst_0..2, dconst_0/1
+        0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 1, 1, 1, 2, 2,
+        // 0x10 bipush, sipush, (ldc x3), iload, lload, fload, dload, aload, iload_0..3, lload_0/1
+        1, 1, 0, 0, 0, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 2,
+        // 0x20 lload_2/3, fload_0..3, dload_0..3, aload_0..3, iaload, laload
+        2, 2, 1, 1, 1, 1, 2, 2, 2, 2, 1, 1, 1, 1, -1, 0,
+        // 0x30 faload, daload, aaload, baload, caload, saload, istore, lstore, fstore, dstore, astore, istore_0..3, lstore_0
+        -1, 0, -1, -1, -1, -1, -1, -2, -1, -2, -1, -1, -1, -1, -1, -2,
+        // 0x40 lstore_1..3, fstore_0..3, dstore_0..3, astore_0..3, iastore
+        -2, -2, -2, -1, -1, -1, -1, -2, -2, -2, -2, -1, -1, -1, -1, -3,
+        // 0x50 lastore, fastore, dastore, aastore, bastore, castore, sastore, pop, pop2, dup, dup_x1, dup_x2, dup2, dup2_x1, dup2_x2, swap
+        -4, -3, -4, -3, -3, -3, -3, -1, -2, 1, 1, 1, 2, 2, 2, 0,
+        // 0x60 iadd, ladd, fadd, dadd, isub, lsub, fsub, dsub, imul, lmul, fmul, dmul, idiv, ldiv, fdiv, ddiv
+        -1, -2, -1, -2, -1, -2, -1, -2, -1, -2, -1, -2, -1, -2, -1, -2,
+        // 0x70 irem, lrem, frem, drem, ineg, lneg, fneg, dneg, ishl, lshl, ishr, lshr, iushr, lushr, iand, land
+        -1, -2, -1, -2, 0, 0, 0, 0, -1, -1, -1, -1, -1, -1, -1, -2,
+        // 0x80 ior, lor, ixor, lxor, iinc, i2l, i2f, i2d, l2i, l2f, l2d, f2i, f2l, f2d, d2i, d2l
+        -1, -2, -1, -2, 0, 1, 0, 1, -1, -1, 0, 0, 1, 1, -1, 0,
+        // 0x90 d2f, i2b, i2c, i2s, lcmp, fcmpl, fcmpg, dcmpl, dcmpg, ifeq..ifle (6)
+        -1, 0, 0, 0, -3, -1, -1, -3, -3, -1, -1, -1, -1, -1, -1,
+        // 0x9f if_icmpeq..if_acmpne (8), goto
+        -2, -2, -2, -2, -2, -2, -2, -2, 0,
+    };
+    if (op < sizeof(fixedEffect) && op != OP_LDC && op != OP_LDC_W && op != OP_LDC2_W) {
+        delta = fixedEffect[op];
+        return true;
+    }
+    switch (op) {
+        case OP_LDC: case OP_LDC_W: delta = 1; return true;
+        case OP_LDC2_W: delta = 2; return true;
+        case OP_TABLESWITCH: case OP_LOOKUPSWITCH: delta = -1; return true;
+        case OP_IRETURN: case OP_FRETURN: case OP_ARETURN: delta = -1; return true;
+        case OP_LRETURN: case OP_DRETURN: delta = -2; return true;
+        case OP_RETURN: case OP_GOTO_W: delta = 0; return true;
+        case OP_NEW: delta = 1; return true;
+        case OP_NEWARRAY: case OP_ANEWARRAY: case OP_ARRAYLENGTH: case OP_CHECKCAST: case OP_INSTANCEOF:
+        case OP_CHECKCAST_QUICK: case OP_INSTANCEOF_QUICK:
+            delta = 0; return true;
+        case OP_ATHROW: case OP_MONITORENTER: case OP_MONITOREXIT: case OP_IFNULL: case OP_IFNONNULL:
+            delta = -1; return true;
+        case OP_MULTIANEWARRAY: delta = 1 - code[pc + 3]; return true;
+        case OP_GETSTATIC: case OP_PUTSTATIC: case OP_GETFIELD: case OP_PUTFIELD: {
+            std::string desc;
+            if (!refDescriptor(cf, readU2(&code[pc + 1]), desc)) return false;
+            int width = valueSlots(desc[0]);
+            if (op == OP_GETSTATIC) delta = width;
+            else if (op == OP_PUTSTATIC) delta = -width;
+            else if (op == OP_GETFIELD) delta = width - 1;
+            else delta = -width - 1;
+            return true;
+        }
+        case OP_INVOKEVIRTUAL: case OP_INVOKESPECIAL: case OP_INVOKEINTERFACE:
+            return invokeEffect(cf, readU2(&code[pc + 1]), true, delta);
+        case OP_INVOKESTATIC:
+            return invokeEffect(cf, readU2(&code[pc + 1]), false, delta);
+        case OP_INVOKEVIRTUAL_QUICK: case OP_INVOKEINTERFACE_QUICK: case OP_INVOKESPECIAL_QUICK: {
+            uint16_t cpIndex;
+            if (!quick || !quick->invokeRef(readU2(&code[pc + 1]), cpIndex)) return false;
+            return invokeEffect(cf, cpIndex, true, delta);
+        }
+        case OP_GETSTATIC_INIT_BARRIER: case OP_PUTSTATIC_INIT_BARRIER: {
+            void* slot;
+            uint8_t kind;
+            if (!quick || !quick->staticField(readU2(&code[pc + 1]), slot, kind)) return false;
+            int width = kindWidth(kind);
+            delta = (op == OP_GETSTATIC_INIT_BARRIER) ? width : -width;
+            return true;
+        }
+        default: break;
+    }
+    if (op >= OP_GETFIELD_QUICK_I && op <= OP_PUTSTATIC_QUICK_A) {
+        uint8_t group = (op - OP_GETFIELD_QUICK_I) / 5;
+        uint8_t kind = (op - OP_GETFIELD_QUICK_I) % 5;
+        int width = kindWidth(kind);
+        static const int receiver[4] = { 1, 1, 0, 0 }; // GETFIELD, PUTFIELD, GETSTATIC, PUTSTATIC
+        delta = ((group % 2 == 0) ? width : -width) - receiver[group];
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+std::shared_ptr<IRMethod> buildIR(const RuntimeMethod& method, const ClassFile& cf, const IRQuickening* quick) {
+    const std::vector<uint8_t>& code = method.code;
+    const size_t n = code.size();
+    if (n == 0) return nullptr;
+
+    // ---- Decode instruction boundaries / 解码指令边界 ----
+    std::vector<uint32_t> length(n, 0);
+    for (size_t pc = 0; pc < n;) {
+        size_t len = instructionLength(code, pc);
+        if (len == 0 || pc + len > n) return nullptr;
+        length[pc] = (uint32_t)len;
+        pc += len;
+    }
+
+    // Branch targets of the instruction at pc (switch default first)
+    // pc 处指令的跳转目标 (switch 的默认目标在前)
+    auto branchTargets = [&](size_t pc, std::vector<size_t>& targets) {
+        targets.clear();
+        uint8_t op = baseOpcode(code[pc]);
+        if ((op >= OP_IFEQ && op <= OP_GOTO) || op == OP_IFNULL || op == OP_IFNONNULL) {
+            targets.push_back(pc + readS2(&code[pc + 1]));
+        } else if (op == OP_GOTO_W) {
+            targets.push_back(pc + readS4(&code[pc + 1]));
+        } else if (op == OP_TABLESWITCH || op == OP_LOOKUPSWITCH) {
+            size_t base = (pc + 4) & ~(size_t)3;
+            targets.push_back(pc + readS4(&code[base]));
+            if (op == OP_TABLESWITCH) {
+                int32_t low = readS4(&code[base + 4]);
+                int32_t high = readS4(&code[base + 8]);
+                for (int64_t k = 0; k <= (int64_t)high - low; k++) targets.push_back(pc + readS4(&code[base + 12 + 4 * k]));
+            } else {
+                int32_t npairs = readS4(&code[base + 4]);
+                for (int32_t k = 0; k < npairs; k++) targets.push_back(pc + readS4(&code[base + 12 + 8 * k]));
+            }
+        }
+    };
+    auto endsFlow = [](uint8_t op) {
+        return op == OP_GOTO || op == OP_GOTO_W || op == OP_TABLESWITCH || op == OP_LOOKUPSWITCH ||
+               op == OP_ATHROW || (op >= OP_IRETURN && op <= OP_RETURN);
+    };
+
+    // ---- Operand stack depth at every reachable instruction / 每条可达指令处的操作数栈深度 ----
+    std::vector<int32_t> depthAt(n, -1);
+    std::vector<uint8_t> leader(n, 0);
+    std::vector<size_t> work;
+    bool consistent = true;
+    auto reach = [&](size_t pc, int32_t depth) {
+        if (pc >= n || length[pc] == 0) { consistent = false; return; }
+        if (depthAt[pc] < 0) {
+            depthAt[pc] = depth;
+            work.push_back(pc);
+        } else if (depthAt[pc] != depth) {
+            consistent = false;
+        }
+    };
+    leader[0] = 1;
+    reach(0, 0);
+    for (const auto& entry : method.exceptionTable) {
+        // The handler starts with the exception on an otherwise empty stack
+        // 异常处理器入口处操作数栈上只有异常对象
+        reach(entry.handlerPc, 1);
+        if (entry.handlerPc < n) leader[entry.handlerPc] = 1;
+    }
+    std::vector<size_t> targets;
+    while (!work.empty() && consistent) {
+        size_t pc = work.back();
+        work.pop_back();
+        int delta;
+        if (!stackEffect(code, cf, pc, quick, delta)) return nullptr;
+        int32_t out = depthAt[pc] + delta;
+        if (out < 0 || out > method.maxStack) return nullptr;
+        branchTargets(pc, targets);
+        for (size_t target : targets) {
+            reach(target, out);
+            if (target < n) leader[target] = 1;
+        }
+        uint8_t op = baseOpcode(code[pc]);
+        if (!endsFlow(op)) {
+            reach(pc + length[pc], out);
+            if (!targets.empty() && pc + length[pc] < n) leader[pc + length[pc]] = 1;
+        }
+    }
+    if (!consistent) return nullptr;
+
+    auto ir = std::make_shared<IRMethod>();
+    ir->maxLocals = method.maxLocals;
+    ir->maxStack = method.maxStack;
+    ir->entryLabel.assign(n, -1);
+    std::vector<int32_t>& labelOf = ir->entryLabel;
+    auto labelAt = [&](size_t pc) -> int32_t {
+        if (labelOf[pc] < 0) {
+            labelOf[pc] = (int32_t)ir->labels.size();
+            ir->labels.push_back(IRLabel{0, (uint32_t)pc, (uint16_t)depthAt[pc]});
+        }
+        return labelOf[pc];
+    };
+    for (size_t pc = 0; pc < n; pc++) {
+        if (leader[pc] && depthAt[pc] >= 0) labelAt(pc);
+    }
+
+    // ---- Translate / 翻译 ----
+    const uint16_t L = method.maxLocals;
+    bool localZeroWritten = false;
+    int32_t pendingSlow = -1;   // SLOW waiting for the label of the next pc / 等待下一条指令标签的 SLOW
+    size_t pendingNextPc = 0;
+    for (size_t pc = 0; pc < n; pc++) {
+        if (length[pc] == 0 || depthAt[pc] < 0) continue;
+        const int d = depthAt[pc];
+        const uint8_t op = baseOpcode(code[pc]);
+        ir->bytecodeCount++;
+
+        if (pendingSlow >= 0) {
+            if (pendingNextPc == pc) ir->code[pendingSlow].target = labelAt(pc);
+            pendingSlow = -1;
+        }
+        if (labelOf[pc] >= 0) ir->labels[labelOf[pc]].index = (uint32_t)ir->code.size();
+
+        auto S = [&](int depth) { return (uint16_t)(L + depth); };
+        auto emit = [&](uint8_t irOp, uint16_t dst, uint16_t a = 0, uint16_t b = 0) -> IRInsn& {
+            IRInsn in;
+            in.op = irOp; in.dst = dst; in.a = a; in.b = b;
+            in.pc = (uint32_t)pc; in.depth = (uint16_t)d;
+            ir->code.push_back(in);
+            return ir->code.back();
+        };
+        auto emitConst = [&](uint8_t irOp, Slot value) { emit(irOp, S(d)).imm = value; };
+        auto branchTo = [&](int32_t offset) { return labelAt(pc + offset); };
+        Slot v{};
+
+        switch (op) {
+            case OP_NOP: case OP_POP: case OP_POP2:
+                break;
+            case OP_ACONST_NULL: v.ref = nullptr; emitConst(IR_CONST_A, v); break;
+            case OP_ICONST_M1: case OP_ICONST_0: case OP_ICONST_1: case OP_ICONST_2:
+            case OP_ICONST_3: case OP_ICONST_4: case OP_ICONST_5:
+                v.i = (int32_t)op - OP_ICONST_0; emitConst(IR_CONST_I, v); break;
+            case OP_LCONST_0: case OP_LCONST_1: v.l = op - OP_LCONST_0; emitConst(IR_CONST_J, v); break;
+            case OP_FCONST_0: case OP_FCONST_1: case OP_FCONST_2: v.f = (float)(op - OP_FCONST_0); emitConst(IR_CONST_F, v); break;
+            case OP_DCONST_0: case OP_DCONST_1: v.d = (double)(op - OP_DCONST_0); emitConst(IR_CONST_D, v); break;
+            case OP_BIPUSH: v.i = (int8_t)code[pc + 1]; emitConst(IR_CONST_I, v); break;
+            case OP_SIPUSH: v.i = readS2(&code[pc + 1]); emitConst(IR_CONST_I, v); break;
+            case OP_LDC: case OP_LDC_W: case OP_LDC2_W: {
+                uint16_t index = (op == OP_LDC) ? code[pc + 1] : readU2(&code[pc + 1]);
+                auto constant = index < cf.constant_pool.size() ? cf.constant_pool[index] : nullptr;
+                if (auto k = std::dynamic_pointer_cast<ConstantInteger>(constant)) { v.i = k->bytes; emitConst(IR_CONST_I, v); }
+                else if (auto k = std::dynamic_pointer_cast<ConstantFloat>(constant)) { v.f = k->bytes; emitConst(IR_CONST_F, v); }
+                else if (auto k = std::dynamic_pointer_cast<ConstantLong>(constant)) { v.l = k->bytes; emitConst(IR_CONST_J, v); }
+                else if (auto k = std::dynamic_pointer_cast<ConstantDouble>(constant)) { v.d = k->bytes; emitConst(IR_CONST_D, v); }
+                else goto slow; // strings and classes allocate / 字符串和类常量需要分配对象
+                break;
+            }
+
+            // Loads and stores: typed moves between locals and the stack. ASTORE also stores
+            // returnAddress values, so it keeps the tag like the bytecode tiers do.
+            // 局部变量与操作数栈之间的带类型传送; ASTORE 与字节码层一样沿用栈上的类型标记
+            case OP_ILOAD: case OP_LLOAD: case OP_FLOAD: case OP_DLOAD: case OP_ALOAD:
+                emit((uint8_t)(IR_MOV_I + (op - OP_ILOAD)), S(d), code[pc + 1]);
+                break;
+            case OP_ISTORE: case OP_LSTORE: case OP_FSTORE: case OP_DSTORE: case OP_ASTORE: {
+                int kind = op - OP_ISTORE;
+                uint16_t index = code[pc + 1];
+                localZeroWritten |= (index == 0);
+                emit(kind == KIND_A ? (uint8_t)IR_MOV : (uint8_t)(IR_MOV_I + kind), index, S(d - kindWidth(kind)));
+                break;
+            }
+            // Short forms: four per kind, local index in the opcode / 短格式: 每种类型四个，局部变量下标编码在操作码中
+            case OP_ILOAD_0: case OP_ILOAD_1: case OP_ILOAD_2: case OP_ILOAD_3:
+            case OP_LLOAD_0: case OP_LLOAD_1: case OP_LLOAD_2: case OP_LLOAD_3:
+            case OP_FLOAD_0: case OP_FLOAD_1: case OP_FLOAD_2: case OP_FLOAD_3:
+            case OP_DLOAD_0: case OP_DLOAD_1: case OP_DLOAD_2: case OP_DLOAD_3:
+            case OP_ALOAD_0: case OP_ALOAD_1: case OP_ALOAD_2: case OP_ALOAD_3:
+                emit((uint8_t)(IR_MOV_I + (op - OP_ILOAD_0) / 4), S(d), (uint16_t)((op - OP_ILOAD_0) % 4));
+                break;
+            case OP_ISTORE_0: case OP_ISTORE_1: case OP_ISTORE_2: case OP_ISTORE_3:
+            case OP_LSTORE_0: case OP_LSTORE_1: case OP_LSTORE_2: case OP_LSTORE_3:
+            case OP_FSTORE_0: case OP_FSTORE_1: case OP_FSTORE_2: case OP_FSTORE_3:
+            case OP_DSTORE_0: case OP_DSTORE_1: case OP_DSTORE_2: case OP_DSTORE_3:
+            case OP_ASTORE_0: case OP_ASTORE_1: case OP_ASTORE_2: case OP_ASTORE_3: {
+                int kind = (op - OP_ISTORE_0) / 4;
+                uint16_t index = (uint16_t)((op - OP_ISTORE_0) % 4);
+                localZeroWritten |= (index == 0);
+                emit(kind == KIND_A ? (uint8_t)IR_MOV : (uint8_t)(IR_MOV_I + kind), index, S(d - kindWidth(kind)));
+                break;
+            }
+            case OP_IINC:
+                localZeroWritten |= (code[pc + 1] == 0);
+                emit(IR_ADDK_I, code[pc + 1], code[pc + 1]).imm.i = (int8_t)code[pc + 2];
+                break;
+
+            case OP_IALOAD: case OP_LALOAD: case OP_FALOAD: case OP_DALOAD:
+            case OP_AALOAD: case OP_BALOAD: case OP_CALOAD: case OP_SALOAD:
+                emit((uint8_t)(IR_ALOAD_I + (op - OP_IALOAD)), S(d - 2), S(d - 2), S(d - 1));
+                break;
+            case OP_IASTORE: case OP_LASTORE: case OP_FASTORE: case OP_DASTORE:
+            case OP_AASTORE: case OP_BASTORE: case OP_CASTORE: case OP_SASTORE: {
+                int width = (op == OP_LASTORE || op == OP_DASTORE) ? 2 : 1;
+                emit((uint8_t)(IR_ASTORE_I + (op - OP_IASTORE)), 0, S(d - width - 2), S(d - width - 1)).c = S(d - width);
+                break;
+            }
+
+            // DUP family and SWAP as slot moves, in the order dupInsert uses
+            // DUP 系列与 SWAP 翻译为槽位传送，顺序与 dupInsert 一致
+            case OP_DUP: case OP_DUP_X1: case OP_DUP_X2: case OP_DUP2: case OP_DUP2_X1: case OP_DUP2_X2: {
+                static const int shape[6][2] = { {1, 0}, {1, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2} };
+                int count = shape[op - OP_DUP][0], below = shape[op - OP_DUP][1];
+                for (int i = -1; i >= -(count + below); i--) emit(IR_MOV, S(d + i + count), S(d + i));
+                for (int j = 0; j < count; j++) emit(IR_MOV, S(d + j - count - below), S(d + j));
+                break;
+            }
+            case OP_SWAP:
+                emit(IR_MOV, S(d), S(d - 1));
+                emit(IR_MOV, S(d - 1), S(d - 2));
+                emit(IR_MOV, S(d - 2), S(d));
+                break;
+
+            case OP_IADD: case OP_LADD: case OP_FADD: case OP_DADD: case OP_ISUB: case OP_LSUB: case OP_FSUB: case OP_DSUB:
+            case OP_IMUL: case OP_LMUL: case OP_FMUL: case OP_DMUL: case OP_IDIV: case OP_LDIV: case OP_FDIV: case OP_DDIV:
+            case OP_IREM: case OP_LREM: case OP_FREM: case OP_DREM: {
+                static const uint8_t arith[5][4] = {
+                    { IR_ADD_I, IR_ADD_J, IR_ADD_F, IR_ADD_D }, { IR_SUB_I, IR_SUB_J, IR_SUB_F, IR_SUB_D },
+                    { IR_MUL_I, IR_MUL_J, IR_MUL_F, IR_MUL_D }, { IR_DIV_I, IR_DIV_J, IR_DIV_F, IR_DIV_D },
+                    { IR_REM_I, IR_REM_J, IR_REM_F, IR_REM_D },
+                };
+                int type = (op - OP_IADD) % 4;
+                int width = (type == 1 || type == 3) ? 2 : 1;
+                emit(arith[(op - OP_IADD) / 4][type], S(d - 2 * width), S(d - 2 * width), S(d - width));
+                break;
+            }
+            case OP_INEG: case OP_LNEG: case OP_FNEG: case OP_DNEG: {
+                static const uint8_t neg[4] = { IR_NEG_I, IR_NEG_J, IR_NEG_F, IR_NEG_D };
+                int type = op - OP_INEG;
+                int width = (type == 1 || type == 3) ? 2 : 1;
+                emit(neg[type], S(d - width), S(d - width));
+                break;
+            }
+            case OP_ISHL: case OP_ISHR: case OP_IUSHR: {
+                uint8_t irOp = op == OP_ISHL ? IR_SHL_I : (op == OP_ISHR ? IR_SHR_I : IR_USHR_I);
+                emit(irOp, S(d - 2), S(d - 2), S(d - 1));
+                break;
+            }
+            case OP_LSHL: case OP_LSHR: case OP_LUSHR: {
+                uint8_t irOp = op == OP_LSHL ? IR_SHL_J : (op == OP_LSHR ? IR_SHR_J : IR_USHR_J);
+                emit(irOp, S(d - 3), S(d - 3), S(d - 1));
+                break;
+            }
+            case OP_IAND: emit(IR_AND_I, S(d - 2), S(d - 2), S(d - 1)); break;
+            case OP_IOR: emit(IR_OR_I, S(d - 2), S(d - 2), S(d - 1)); break;
+            case OP_IXOR: emit(IR_XOR_I, S(d - 2), S(d - 2), S(d - 1)); break;
+            case OP_LAND: emit(IR_AND_J, S(d - 4), S(d - 4), S(d - 2)); break;
+            case OP_LOR: emit(IR_OR_J, S(d - 4), S(d - 4), S(d - 2)); break;
+            case OP_LXOR: emit(IR_XOR_J, S(d - 4), S(d - 4), S(d - 2)); break;
+
+            case OP_I2L: case OP_I2F: case OP_I2D: case OP_L2I: case OP_L2F: case OP_L2D:
+            case OP_F2I: case OP_F2L: case OP_F2D: case OP_D2I: case OP_D2L: case OP_D2F:
+            case OP_I2B: case OP_I2C: case OP_I2S: {
+                static const uint8_t conv[15] = {
+                    IR_I2L, IR_I2F, IR_I2D, IR_L2I, IR_L2F, IR_L2D, IR_F2I, IR_F2L, IR_F2D,
+                    IR_D2I, IR_D2L, IR_D2F, IR_I2B, IR_I2C, IR_I2S,
+                };
+                bool wideIn = (op >= OP_L2I && op <= OP_L2D) || (op >= OP_D2I && op <= OP_D2F);
+                uint16_t reg = S(d - (wideIn ? 2 : 1));
+                emit(conv[op - OP_I2L], reg, reg);
+                break;
+            }
+
+            case OP_LCMP: emit(IR_CMP_J, S(d - 4), S(d - 4), S(d - 2)); break;
+            case OP_FCMPL: emit(IR_CMPL_F, S(d - 2), S(d - 2), S(d - 1)); break;
+            case OP_FCMPG: emit(IR_CMPG_F, S(d - 2), S(d - 2), S(d - 1)); break;
+            case OP_DCMPL: emit(IR_CMPL_D, S(d - 4), S(d - 4), S(d - 2)); break;
+            case OP_DCMPG: emit(IR_CMPG_D, S(d - 4), S(d - 4), S(d - 2)); break;
+
+            case OP_IFEQ: case OP_IFNE: case OP_IFLT: case OP_IFGE: case OP_IFGT: case OP_IFLE: {
+                IRInsn& in = emit((uint8_t)(IR_IFK_EQ + (op - OP_IFEQ)), 0, S(d - 1));
+                in.imm.i = 0;
+                in.target = branchTo(readS2(&code[pc + 1]));
+                break;
+            }
+            case OP_IF_ICMPEQ: case OP_IF_ICMPNE: case OP_IF_ICMPLT: case OP_IF_ICMPGE: case OP_IF_ICMPGT: case OP_IF_ICMPLE:
+                emit((uint8_t)(IR_IF_EQ + (op - OP_IF_ICMPEQ)), 0, S(d - 2), S(d - 1)).target = branchTo(readS2(&code[pc + 1]));
+                break;
+            case OP_IF_ACMPEQ: case OP_IF_ACMPNE:
+                emit(op == OP_IF_ACMPEQ ? IR_IF_ACMPEQ : IR_IF_ACMPNE, 0, S(d - 2), S(d - 1)).target = branchTo(readS2(&code[pc + 1]));
+                break;
+            case OP_IFNULL: case OP_IFNONNULL:
+                emit(op == OP_IFNULL ? IR_IF_NULL : IR_IF_NONNULL, 0, S(d - 1)).target = branchTo(readS2(&code[pc + 1]));
+                break;
+            case OP_GOTO: emit(IR_GOTO, 0).target = branchTo(readS2(&code[pc + 1])); break;
+            case OP_GOTO_W: emit(IR_GOTO, 0).target = branchTo(readS4(&code[pc + 1])); break;
+            case OP_TABLESWITCH: case OP_LOOKUPSWITCH: {
+                size_t base = (pc + 4) & ~(size_t)3;
+                IRSwitch sw;
+                sw.defaultTarget = branchTo(readS4(&code[base]));
+                if (op == OP_TABLESWITCH) {
+                    sw.low = readS4(&code[base + 4]);
+                    int32_t high = readS4(&code[base + 8]);
+                    for (int64_t k = 0; k <= (int64_t)high - sw.low; k++) sw.targets.push_back(branchTo(readS4(&code[base + 12 + 4 * k])));
+                } else {
+                    // Keys are sorted (JVMS 6.5) so the IR can binary search them
+                    // 键值按升序排列 (JVMS 6.5)，IR 执行时可二分查找
+                    int32_t npairs = readS4(&code[base + 4]);
+                    for (int32_t k = 0; k < npairs; k++) {
+                        int32_t key = readS4(&code[base + 8 + 8 * k]);
+                        if (!sw.keys.empty() && key <= sw.keys.back()) return nullptr;
+                        sw.keys.push_back(key);
+                        sw.targets.push_back(branchTo(readS4(&code[base + 12 + 8 * k])));
+                    }
+                }
+                emit(op == OP_TABLESWITCH ? IR_TABLESWITCH : IR_LOOKUPSWITCH, 0, S(d - 1)).target = (int32_t)ir->switches.size();
+                ir->switches.push_back(std::move(sw));
+                break;
+            }
+            case OP_IRETURN: case OP_LRETURN: case OP_FRETURN: case OP_DRETURN: case OP_ARETURN: {
+                int kind = op - OP_IRETURN;
+                emit((uint8_t)(IR_RETURN_I + kind), 0, S(d - kindWidth(kind)));
+                break;
+            }
+            case OP_RETURN: emit(IR_RETURN, 0); break;
+
+            case OP_ARRAYLENGTH: emit(IR_ARRAYLENGTH, S(d - 1), S(d - 1)); break;
+
+            case OP_GETFIELD_QUICK_I: case OP_GETFIELD_QUICK_J: case OP_GETFIELD_QUICK_F:
+            case OP_GETFIELD_QUICK_D: case OP_GETFIELD_QUICK_A: {
+                // The operand carries the field's storage kind (byte/char/short share _I)
+                // 操作数中带有字段的存储类型 (byte/char/short 共用 _I 操作码)
+                uint16_t operand = readU2(&code[pc + 1]);
+                emit((uint8_t)(IR_GETFIELD_I + quickFieldKind(operand)), S(d - 1), S(d - 1)).imm.i = (int32_t)quickFieldOffset(operand);
+                break;
+            }
+            case OP_PUTFIELD_QUICK_I: case OP_PUTFIELD_QUICK_J: case OP_PUTFIELD_QUICK_F:
+            case OP_PUTFIELD_QUICK_D: case OP_PUTFIELD_QUICK_A: {
+                uint16_t operand = readU2(&code[pc + 1]);
+                int width = kindWidth(op - OP_PUTFIELD_QUICK_I);
+                IRInsn& in = emit((uint8_t)(IR_PUTFIELD_I + quickFieldKind(operand)), 0, S(d - width - 1));
+                in.c = S(d - width);
+                in.imm.i = (int32_t)quickFieldOffset(operand);
+                break;
+            }
+            // Static field storage never moves, so the IR holds the slot pointer itself
+            // 静态字段存储位置不会移动，IR 直接保存槽位指针
+            case OP_GETSTATIC_QUICK_I: case OP_GETSTATIC_QUICK_J: case OP_GETSTATIC_QUICK_F:
+            case OP_GETSTATIC_QUICK_D: case OP_GETSTATIC_QUICK_A: {
+                uint8_t kind;
+                if (!quick || !quick->staticField(readU2(&code[pc + 1]), v.ref, kind)) return nullptr;
+                emit((uint8_t)(IR_GETSTATIC_I + (op - OP_GETSTATIC_QUICK_I)), S(d)).imm = v;
+                break;
+            }
+            case OP_PUTSTATIC_QUICK_I: case OP_PUTSTATIC_QUICK_J: case OP_PUTSTATIC_QUICK_F:
+            case OP_PUTSTATIC_QUICK_D: case OP_PUTSTATIC_QUICK_A: {
+                int kind = op - OP_PUTSTATIC_QUICK_I;
+                uint8_t cachedKind;
+                if (!quick || !quick->staticField(readU2(&code[pc + 1]), v.ref, cachedKind)) return nullptr;
+                IRInsn& in = emit((uint8_t)(IR_PUTSTATIC_I + kind), 0);
+                in.c = S(d - kindWidth(kind));
+                in.imm = v;
+                break;
+            }
+            case OP_CHECKCAST_QUICK: case OP_INSTANCEOF_QUICK:
+                if (!quick || !quick->classRef(readU2(&code[pc + 1]), v.ref)) return nullptr;
+                if (op == OP_CHECKCAST_QUICK) emit(IR_CHECKCAST, 0, S(d - 1)).imm = v;
+                else emit(IR_INSTANCEOF, S(d - 1), S(d - 1)).imm = v;
+                break;
+
+            default:
+            slow: {
+                // Handed to instructionTable with the frame synced; the IR resumes at the
+                // next pc if the same frame is still running there
+                // 同步栈帧后交给 instructionTable 执行; 若该栈帧仍在运行且停在下一条指令，IR 从那里继续
+                ir->labels[labelAt(pc)].index = (uint32_t)ir->code.size();
+                emit(IR_SLOW, 0);
+                if (!endsFlow(op)) {
+                    pendingSlow = (int32_t)ir->code.size() - 1;
+                    pendingNextPc = pc + length[pc];
+                }
+                break;
+            }
+        }
+    }
+
+    ir->thisNonNull = !method.isStatic && !localZeroWritten;
+    size_t translated = ir->code.size();
+    optimizeIR(*ir);
+    LOG_DEBUG("[IR] Compiled method with " + std::to_string(ir->bytecodeCount) + " bytecodes into " +
+              std::to_string(ir->code.size()) + " IR insns (" + std::to_string(translated) + " before optimization)");
+    return ir;
+}
+
+} // namespace core
+} // namespace j2me
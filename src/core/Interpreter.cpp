@@ -6,6 +6,7 @@
 #include "Logger.hpp"
 #include "EventLoop.hpp"
 #include "Diagnostics.hpp"
+#include "../native/java_lang_String.hpp"
 #include <sstream>
 #include <cmath>
 #include <cstring>
@@ -24,6 +25,37 @@ int Interpreter::execute(std::shared_ptr<JavaThread> thread, int instructions) {
     if (!thread || thread->isFinished()) return 0;
     if (thread->state != JavaThread::RUNNABLE) return 0;
 
+    // Between time slices every reference is in a frame or another root, so this is
+    // where a pending collection runs
+    // 时间片之间所有引用都位于栈帧或其他根中，因此待执行的垃圾回收在此进行
+    HeapManager& heap = HeapManager::getInstance();
+    if (heap.isCollectionDue()) heap.collect(*this);
+
+    // Allocations of this slice are sampled against this thread's frames
+    // 本时间片内的分配按该线程的栈帧进行采样
+    heap.setMutator(thread.get());
+    int executed = dispatchMode == DispatchMode::TABLE ? executeTable(thread, instructions)
+                                                      : executeThreaded(thread, instructions);
+    heap.setMutator(nullptr);
+    return executed;
+}
+
+void Interpreter::visitRoots(const std::function<JavaObject*(JavaObject*)>& visit) {
+    for (const auto& entry : loadedClasses) {
+        if (!entry.second) continue;
+        JavaClass& cls = *entry.second;
+        for (uint32_t slot : cls.staticReferenceSlots) {
+            int64_t& value = cls.staticSlots[slot];
+            value = (int64_t)(intptr_t)visit(reinterpret_cast<JavaObject*>((intptr_t)value));
+        }
+    }
+    for (JavaObject*& exception : preallocatedExceptions) exception = visit(exception);
+    std::map<JavaObject*, std::shared_ptr<JavaThread>> owners;
+    for (auto& owner : monitorOwners) owners.emplace(visit(owner.first), std::move(owner.second));
+    monitorOwners.swap(owners);
+}
+
+int Interpreter::executeTable(std::shared_ptr<JavaThread> thread, int instructions) {
     int executed = 0;
     while (executed < instructions && !thread->isFinished()) {
         if (thread->state != JavaThread::RUNNABLE) break;
@@ -48,56 +80,119 @@ int Interpreter::execute(std::shared_ptr<JavaThread> thread, int instructions) {
         util::DataReader codeReader(frame->code);
         codeReader.seek(frame->pc);
         
-        uint8_t opcode = 0;
-        if (frame->pc < frame->code.size()) opcode = frame->code[frame->pc];
-        
         try {
             // 执行单条指令
             // executeInstruction now modifies thread state directly (pushes/pops frames)
             // It returns false if we should stop execution immediately (error), otherwise true
+            uint32_t startPc = frame->pc;
             bool continueExec = executeInstruction(thread, frame, codeReader);
             
             // 更新 PC (程序计数器)
             // Update PC
             frame->pc = codeReader.tell();
             executed++;
+            if (!sequenceCounts.empty()) countSequences(*frame, startPc);
             
             if (!continueExec) {
                 break;
             }
+        } catch (const JavaThrow& e) {
+            if (!raiseRuntimeException(thread, e.kind, e.what())) break;
         } catch (const std::exception& e) {
             std::string msg = e.what() ? std::string(e.what()) : std::string();
-            std::string exClass = "java/lang/RuntimeException";
-            if (msg.find("NullPointerException") != std::string::npos) exClass = "java/lang/NullPointerException";
-            else if (msg.find("ArrayIndexOutOfBoundsException") != std::string::npos) exClass = "java/lang/ArrayIndexOutOfBoundsException";
-            else if (msg.find("StringIndexOutOfBoundsException") != std::string::npos) exClass = "java/lang/StringIndexOutOfBoundsException";
-            else if (msg.find("ArithmeticException") != std::string::npos) exClass = "java/lang/ArithmeticException";
-            else if (msg.find("ClassCastException") != std::string::npos) exClass = "java/lang/ClassCastException";
-            else if (msg.find("NegativeArraySizeException") != std::string::npos) exClass = "java/lang/NegativeArraySizeException";
-
-            auto exCls = resolveClass(exClass);
-            if (!exCls) {
-                LOG_ERROR("Runtime Exception: " + msg);
-                Diagnostics::getInstance().onUncaughtException(exClass);
-                EventLoop::getInstance().requestExit("uncaught exception: " + exClass);
-                thread->frames.clear();
-                thread->state = JavaThread::TERMINATED;
-                break;
-            }
+            if (!throwFromRuntimeError(thread, msg)) break;
+        }
+    }
+    return executed;
+}
 
-            JavaObject* exObj = HeapManager::getInstance().allocate(exCls);
-            bool handled = handleException(thread, exObj);
-            if (!handled) {
-                LOG_ERROR("VM terminated due to uncaught exception: " + exClass);
-                Diagnostics::getInstance().onUncaughtException(exClass);
-                EventLoop::getInstance().requestExit("uncaught exception: " + exClass);
-                thread->frames.clear();
-                thread->state = JavaThread::TERMINATED;
-                break;
+bool Interpreter::throwFromRuntimeError(std::shared_ptr<JavaThread> thread, const std::string& msg) {
+    return raiseRuntimeException(thread, runtimeExceptionFromMessage(msg), msg);
+}
+
+bool Interpreter::raiseRuntimeException(const std::shared_ptr<JavaThread>& thread, RuntimeExceptionKind kind,
+                                        const std::string& detail) {
+    JavaObject*& shared = preallocatedExceptions[static_cast<size_t>(kind)];
+    if (!shared) {
+        // Like the string-matched path before it, the instance is not constructed: the
+        // Throwable fields stay null
+        // 与之前按字符串匹配的做法相同，实例不调用构造函数: Throwable 的字段保持为 null
+        std::string exClass = runtimeExceptionClass(kind);
+        auto exCls = resolveClass(exClass);
+        if (!exCls) {
+            LOG_ERROR("Runtime Exception: " + (detail.empty() ? exClass : detail));
+            Diagnostics::getInstance().onUncaughtException(exClass);
+            EventLoop::getInstance().requestExit("uncaught exception: " + exClass);
+            thread->clearFrames();
+            thread->state = JavaThread::TERMINATED;
+            return false;
+        }
+        // Exempt from the heap cap, or the OutOfMemoryError could not be raised
+        // 不受堆上限限制，否则无法抛出 OutOfMemoryError
+        shared = HeapManager::getInstance().allocateReserved(exCls.get());
+    }
+
+    // A Java handler gets an instance of its own, since it may keep the exception. The
+    // shared one is for OutOfMemoryError and for exceptions that end the thread.
+    // Java 处理器会得到单独的实例，因为它可能保留该异常。共享实例只用于 OutOfMemoryError 和导致线程结束的异常
+    size_t handlerFrame = 0;
+    int handlerPc = -1;
+    if (kind == RuntimeExceptionKind::OUT_OF_MEMORY || !findHandler(*thread, shared->cls, handlerFrame, handlerPc)) {
+        return throwJavaException(thread, shared, detail);
+    }
+    enterHandler(*thread, handlerFrame, handlerPc, HeapManager::getInstance().allocateReserved(shared->cls));
+    return true;
+}
+
+bool Interpreter::throwJavaException(const std::shared_ptr<JavaThread>& thread, JavaObject* exception,
+                                     const std::string& detail) {
+    if (handleException(thread, exception)) return true;
+
+    // Uncaught: only now is the stack trace worth building
+    // 未被捕获: 此时才需要生成栈回溯
+    std::string exClass = "Unknown";
+    std::string message = detail;
+    if (exception && exception->cls) {
+        exClass = exception->cls->name;
+        auto it = exception->cls->fieldOffsets.find("detailMessage|Ljava/lang/String;");
+        if (message.empty() && it != exception->cls->fieldOffsets.end() && exception->hasField(it->second, FIELD_A) &&
+            exception->getRef(it->second) != nullptr) {
+            message = j2me::natives::getJavaString(exception->getRef(it->second));
+        }
+    }
+    if (message == exClass) message.clear();
+    LOG_ERROR("Exception thrown: " + exClass + (message.empty() ? std::string() : " (" + message + ")") + "\n" +
+              describeStack(*thread));
+    LOG_ERROR("VM terminated due to uncaught exception: " + exClass);
+    Diagnostics::getInstance().onUncaughtException(exClass);
+    EventLoop::getInstance().requestExit("uncaught exception: " + exClass);
+    thread->clearFrames();
+    thread->state = JavaThread::TERMINATED;
+    return false;
+}
+
+std::string Interpreter::describeStack(const JavaThread& thread) const {
+    std::stringstream out;
+    out << "Stack Trace:" << std::endl;
+    for (auto it = thread.frames.rbegin(); it != thread.frames.rend(); ++it) {
+        const auto& f = *it;
+        std::string cName = "Unknown";
+        std::string mName = "Unknown";
+        if (f->classFile) {
+            auto cls = std::dynamic_pointer_cast<ConstantClass>(f->classFile->constant_pool[f->classFile->this_class]);
+            if (cls) {
+                auto utf8 = std::dynamic_pointer_cast<ConstantUtf8>(f->classFile->constant_pool[cls->name_index]);
+                if (utf8) cName = utf8->bytes;
+            }
+            if (f->method.name_index < f->classFile->constant_pool.size()) {
+                auto mUtf8 = std::dynamic_pointer_cast<ConstantUtf8>(f->classFile->constant_pool[f->method.name_index]);
+                if (mUtf8) mName = mUtf8->bytes;
             }
         }
+        int lineNum = f->getLineNumber(f->pc);
+        out << "  at " << cName << "." << mName << " (PC: " << f->pc << ", Line: " << lineNum << ")" << std::endl;
     }
-    return executed;
+    return out.str();
 }
 
 bool Interpreter::initializeClass(std::shared_ptr<JavaThread> thread, std::shared_ptr<JavaClass> cls) {
@@ -113,8 +208,10 @@ bool Interpreter::initializeClass(std::shared_ptr<JavaThread> thread, std::share
     
     cls->initializing = true;
     LOG_DEBUG("[Interpreter] Initializing class: " + cls->name);
+    applyStaticConstants(*cls);
     
     bool pushed = false;
+    bool hasClinit = false;
 
     // 首先初始化父类 (如果存在)
     // First, initialize superclass if exists
@@ -131,18 +228,49 @@ bool Interpreter::initializeClass(std::shared_ptr<JavaThread> thread, std::share
         if (name && name->bytes == "<clinit>") {
             LOG_DEBUG("[Interpreter] Pushing <clinit> for: " + cls->name);
             auto frame = std::make_shared<StackFrame>(method, cls->rawFile);
+            frame->initializingClass = cls.get();
             thread->pushFrame(frame);
             pushed = true;
+            hasClinit = true;
             break;
         }
     }
     
+    if (!hasClinit) cls->clinitDone = true;
     cls->initialized = true;
     cls->initializing = false; 
     
     return pushed;
 }
 
+void Interpreter::applyStaticConstants(JavaClass& cls) {
+    const auto& pool = cls.rawFile->constant_pool;
+    for (const auto& constant : cls.staticConstants) {
+        if (constant.valueIndex >= pool.size()) continue;
+        const auto& value = pool[constant.valueIndex];
+        int64_t& slot = cls.staticSlots[constant.slot];
+        // Same encodings as PUTSTATIC: floats as their 32-bit pattern, doubles as 64 bits
+        // 与 PUTSTATIC 相同的编码: float 存 32 位位模式，double 存 64 位位模式
+        if (auto integer = std::dynamic_pointer_cast<ConstantInteger>(value)) {
+            slot = (int64_t)integer->bytes;
+        } else if (auto lng = std::dynamic_pointer_cast<ConstantLong>(value)) {
+            slot = lng->bytes;
+        } else if (auto flt = std::dynamic_pointer_cast<ConstantFloat>(value)) {
+            int32_t bits;
+            memcpy(&bits, &flt->bytes, sizeof(float));
+            slot = (int64_t)bits;
+        } else if (auto dbl = std::dynamic_pointer_cast<ConstantDouble>(value)) {
+            int64_t bits;
+            memcpy(&bits, &dbl->bytes, sizeof(double));
+            slot = bits;
+        } else if (auto str = std::dynamic_pointer_cast<ConstantString>(value)) {
+            if (str->string_index >= pool.size()) continue;
+            auto utf8 = std::dynamic_pointer_cast<ConstantUtf8>(pool[str->string_index]);
+            if (utf8) slot = (int64_t)j2me::natives::createJavaString(this, utf8->bytes);
+        }
+    }
+}
+
 bool Interpreter::executeInstruction(std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader) {
     static uint64_t instructionCount = 0;
     instructionCount++;
@@ -162,137 +290,86 @@ bool Interpreter::executeInstruction(std::shared_ptr<JavaThread> thread, std::sh
 
 bool Interpreter::handleException(std::shared_ptr<JavaThread> thread, JavaObject* exception) {
     if (!thread || !exception) return false;
-    
-    // First, verify if we can handle this exception
-    // We do a dry run of stack unwinding to find a handler without modifying the thread state yet.
-    // However, our logic modifies thread state (popFrame).
-    // So we should capture the stack trace first, but only print it if UNCAUGHT.
-    
-    std::string exName = "Unknown";
-    if (exception->cls) exName = exception->cls->name;
 
-    std::stringstream stackTraceBuffer;
-    stackTraceBuffer << "Exception thrown: " << exName << std::endl;
-    stackTraceBuffer << "Stack Trace:" << std::endl;
-    
-    for (auto it = thread->frames.rbegin(); it != thread->frames.rend(); ++it) {
-        auto f = *it;
-        std::string cName = "Unknown";
-        std::string mName = "Unknown";
-        if (f->classFile) {
-            auto cls = std::dynamic_pointer_cast<ConstantClass>(f->classFile->constant_pool[f->classFile->this_class]);
-            if (cls) {
-                auto utf8 = std::dynamic_pointer_cast<ConstantUtf8>(f->classFile->constant_pool[cls->name_index]);
-                if (utf8) cName = utf8->bytes;
-            }
-            if (f->method.name_index < f->classFile->constant_pool.size()) {
-                auto mUtf8 = std::dynamic_pointer_cast<ConstantUtf8>(f->classFile->constant_pool[f->method.name_index]);
-                if (mUtf8) mName = mUtf8->bytes;
-            }
-        }
-        int lineNum = f->getLineNumber(f->pc);
-        stackTraceBuffer << "  at " << cName << "." << mName << " (PC: " << f->pc << ", Line: " << lineNum << ")" << std::endl;
-    }
-
-    bool isTopFrame = true;
-    while (true) {
-        auto frame = thread->currentFrame();
-        if (!frame) {
-             // Uncaught! Print buffered stack trace and return false
-             LOG_ERROR(stackTraceBuffer.str());
-             return false; 
-        }
+    size_t handlerFrame = 0;
+    int handlerPc = -1;
+    // Uncaught: leave the stack as it is for the caller's stack trace
+    // 未被捕获: 保持栈不变，供调用者生成栈回溯
+    if (!findHandler(*thread, exception->cls, handlerFrame, handlerPc)) return false;
+    enterHandler(*thread, handlerFrame, handlerPc, exception);
+    return true;
+}
 
+bool Interpreter::findHandler(JavaThread& thread, const JavaClass* exceptionClass, size_t& handlerFrame, int& handlerPc) {
+    // Phase 1: find the handler without touching the thread, innermost frame first
+    // 第一阶段: 在不修改线程状态的情况下查找处理器，从最内层栈帧开始
+    for (size_t depth = thread.frames.size(); depth-- > 0;) {
+        const auto& frame = thread.frames[depth];
         int searchPc = frame->pc;
-        if (!isTopFrame) {
+        if (depth + 1 != thread.frames.size()) {
             // For caller frames, pc is the return address (next instruction).
             // We need the pc of the invoke instruction, which is definitely before current pc.
             // Using pc - 1 is sufficient to find the correct range.
             if (searchPc > 0) searchPc--;
         }
 
-        // Search for exception handler in current frame
-        int handlerPc = -1;
-        
-        for (const auto& entry : frame->exceptionTable) {
-            // Check if PC is within range [startPc, endPc)
-            
-            if (searchPc >= entry.startPc && searchPc < entry.endPc) {
-                // Check catch type
-                if (entry.catchType == 0) {
-                    // catch_type 0 means finally (matches any exception)
-                    handlerPc = entry.handlerPc;
-                    break;
-                } else {
-                    // Resolve catch type class
-                    auto classRef = std::dynamic_pointer_cast<ConstantClass>(frame->classFile->constant_pool[entry.catchType]);
-                    if (classRef) {
-                        auto className = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[classRef->name_index]);
-                        if (className) {
-                            // Check if exception is instance of catch type
-                            // We need to resolve the catch class first
-                            auto catchClass = resolveClass(className->bytes);
-                            if (catchClass) {
-                                // Manual instanceof check
-                                bool isInstance = false;
-                                if (exception->cls) {
-                                     std::function<bool(std::shared_ptr<JavaClass>, const std::string&)> isAssignable = 
-                                         [&](std::shared_ptr<JavaClass> sub, const std::string& target) -> bool {
-                                             if (!sub) return false;
-                                             if (sub->name == target) return true;
-                                             if (isAssignable(sub->superClass, target)) return true;
-                                             for (auto& iface : sub->interfaces) {
-                                                  if (isAssignable(iface, target)) return true;
-                                             }
-                                             return false;
-                                         };
-                    
-                                     if (isAssignable(exception->cls, catchClass->name)) {
-                                         isInstance = true;
-                                     }
-                                }
-                                
-                                if (isInstance) {
-                                    handlerPc = entry.handlerPc;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
+        const RuntimeMethod::HandlerRange* range = frame->runtime->findHandlers((uint32_t)searchPc);
+        if (!range) continue;
+        for (uint16_t i = 0; i < range->count; i++) {
+            RuntimeMethod::Handler& handler = frame->runtime->handlers[frame->runtime->handlerOrder[range->first + i]];
+            if (handler.kind == RuntimeMethod::CatchKind::UNRESOLVED) resolveCatchType(*frame, handler);
+            if (handler.kind == RuntimeMethod::CatchKind::ANY ||
+                (handler.kind == RuntimeMethod::CatchKind::CLASS && exceptionClass &&
+                 exceptionClass->isAssignableTo(handler.catchClass))) {
+                handlerFrame = depth;
+                handlerPc = handler.handlerPc;
+                return true;
             }
         }
+    }
+    return false;
+}
 
-        if (handlerPc != -1) {
-            // Found handler
-            
-            // Only log at debug level since it's caught
-            // LOG_DEBUG("Exception handled: " + exName + " at PC " + std::to_string(handlerPc));
-            
-            // Clear operand stack
-            while (!frame->isStackEmpty()) {
-                frame->pop();
-            }
-            // Push exception object
-            JavaValue val;
-            val.type = JavaValue::REFERENCE;
-            val.val.ref = exception;
-            frame->push(val);
-            
-            // Jump to handler
-            frame->pc = handlerPc;
-            return true;
-        }
+void Interpreter::enterHandler(JavaThread& thread, size_t handlerFrame, int handlerPc, JavaObject* exception) {
+    // Phase 2: unwind to the handler's frame, then enter the handler
+    // 第二阶段: 展开到处理器所在的栈帧，然后进入处理器
+    while (thread.frames.size() > handlerFrame + 1) {
+        thread.popFrame();
+    }
+    auto frame = thread.currentFrame();
 
-        // No handler in current frame, pop and continue in caller
-        thread->popFrame();
-        isTopFrame = false;
-        if (thread->isFinished()) {
-             // Uncaught! Print the buffered stack trace
-             LOG_ERROR(stackTraceBuffer.str());
-             return false; 
-        }
+    // Clear operand stack
+    while (!frame->isStackEmpty()) {
+        frame->pop();
+    }
+    // Push exception object
+    JavaValue val;
+    val.type = JavaValue::REFERENCE;
+    val.val.ref = exception;
+    frame->push(val);
+
+    // Jump to handler
+    frame->pc = handlerPc;
+}
+
+void Interpreter::resolveCatchType(const StackFrame& frame, RuntimeMethod::Handler& handler) {
+    handler.kind = RuntimeMethod::CatchKind::NONE;
+    const auto& pool = frame.classFile->constant_pool;
+    if (handler.catchType >= pool.size()) return;
+    auto classRef = std::dynamic_pointer_cast<ConstantClass>(pool[handler.catchType]);
+    if (!classRef || classRef->name_index >= pool.size()) return;
+    auto className = std::dynamic_pointer_cast<ConstantUtf8>(pool[classRef->name_index]);
+    if (!className) return;
+    // Every exception is a Throwable: no need to load the class or check the type
+    // 所有异常都是 Throwable: 无需加载该类，也无需类型检查
+    if (className->bytes == "java/lang/Throwable") {
+        handler.kind = RuntimeMethod::CatchKind::ANY;
+        return;
     }
+    auto catchClass = resolveClass(className->bytes);
+    if (!catchClass) return;
+    handler.kind = RuntimeMethod::CatchKind::CLASS;
+    handler.catchClass = catchClass.get();
 }
 
 void Interpreter::initInstructionTable() {
@@ -313,6 +390,8 @@ void Interpreter::initInstructionTable() {
     initControl();
     initReferences();
     initExtended();
+    initQuick();
+    initSuperinstructions();
 }
 
 } // namespace core
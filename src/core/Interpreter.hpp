@@ -6,9 +6,12 @@
 #include "RuntimeTypes.hpp"
 #include "NativeRegistry.hpp"
 #include "JavaThread.hpp"
+#include "RuntimeExceptions.hpp"
 #include <memory>
 #include <map>
+#include <deque>
 #include <optional>
+#include <functional>
 #include <mutex>
 
 
@@ -19,8 +22,18 @@ namespace natives {
 
 namespace core {
 
+struct IRInsn;
+struct AotMethod;
+
 class Interpreter {
 public:
+    // Bytecode dispatch strategy
+    // 字节码分派方式
+    enum class DispatchMode {
+        THREADED, // Direct-threaded loop (computed goto / switch) / 直接线索化循环 (默认)
+        TABLE     // Legacy std::function table, kept for A/B comparison / 旧的分派表，用于对比
+    };
+
     Interpreter(j2me::loader::JarLoader& loader);
     
     // Execute instructions for a thread
@@ -41,13 +54,57 @@ public:
     // 设置系统库加载器 (rt.jar)
     void setLibraryLoader(std::shared_ptr<j2me::loader::JarLoader> loader) { libraryLoader = loader; }
 
+    // Select the dispatch loop used by execute()
+    // 选择 execute() 使用的分派循环
+    void setDispatchMode(DispatchMode mode) { dispatchMode = mode; }
+    DispatchMode getDispatchMode() const { return dispatchMode; }
+
+    // Invocations + backward branches after which a method moves to the register IR
+    // tier (threaded dispatch only); 0 disables the tier
+    // 方法调用次数与向后跳转次数之和达到该值后，方法进入寄存器 IR 层 (仅限线索化分派); 0 表示禁用
+    void setTier2Threshold(uint32_t threshold);
+
+    // Hotness after which a method runs as x86-64 machine code (baseline JIT, see JitX64.hpp);
+    // 0 turns the JIT off, which is the default
+    // 方法热度达到该值后以 x86-64 机器码执行 (基线 JIT，见 JitX64.hpp); 0 表示关闭 JIT (默认)
+    void setJitThreshold(uint32_t threshold);
+
+    // Use the AOT module at `path` (AotModule.hpp) for the application classes if it was
+    // built for a JAR with hash `jarHash`; classes loaded from then on get its code bound
+    // 若 path 处的 AOT 模块 (AotModule.hpp) 是为哈希为 jarHash 的 JAR 构建的，则将其用于应用类;
+    // 此后加载的类会绑定模块中的代码
+    bool loadAotModule(const std::string& path, uint64_t jarHash);
+
+    // Fuse frequent bytecode sequences of newly loaded classes into superinstructions
+    // (Instructions_Super.cpp); on by default
+    // 将新加载类中的高频字节码序列融合为超级指令 (见 Instructions_Super.cpp); 默认开启
+    void setSuperinstructions(bool enabled) { superinstructionsEnabled = enabled; }
+
+    // Count how often each candidate superinstruction (a family and a first opcode) would
+    // run: executions of its first instruction where the rest of the sequence follows (table
+    // dispatch, unfused code). Written out as the input of scripts/gen_superinstructions.py
+    // 统计每个候选超级指令 (族 + 首条操作码) 的执行次数: 其后紧跟完整序列的首条指令的执行次数
+    // (指令表分派，未融合的代码)，并输出为 scripts/gen_superinstructions.py 的输入
+    void setOpcodeProfiling(bool enabled);
+    bool writeOpcodeProfile(const std::string& path) const;
+
+    // Garbage collector roots owned by the interpreter: reference static fields of every
+    // loaded class, the preallocated exceptions and the objects whose monitor is held. Each
+    // is replaced by what visit returns (its address after a collection that moved it).
+    // 解释器持有的垃圾回收根: 所有已加载类的引用类型静态字段、预分配的异常对象以及监视器被持有的对象。
+    // 每个根都替换为 visit 的返回值 (回收移动对象后的新地址)
+    void visitRoots(const std::function<JavaObject*(JavaObject*)>& visit);
+
 private:
+    DispatchMode dispatchMode = DispatchMode::THREADED;
+    uint32_t tier2Threshold = 500;
+    uint32_t jitThreshold = UINT32_MAX;
+    uint32_t tierUpThreshold = 500; // min(tier2Threshold, jitThreshold): when the threaded loop hands a method up / 线索化循环转交方法的阈值
+
     j2me::loader::JarLoader& jarLoader; // Application loader / 应用加载器
     std::shared_ptr<j2me::loader::JarLoader> libraryLoader; // Library loader / 库加载器
     std::map<std::string, std::shared_ptr<JavaClass>> loadedClasses; // Loaded classes cache / 已加载类的缓存
-    std::map<JavaObject*, std::unique_ptr<std::recursive_mutex>> objectMonitors; // Object monitors for synchronized blocks / 对象监视器，用于同步块
-    std::map<JavaObject*, int> monitorCounts; // Count of how many times an object's monitor is held by the same thread / 记录同一线程持有对象监视器的次数
-    std::map<JavaObject*, std::shared_ptr<JavaThread>> monitorOwners; // Track which thread owns each monitor / 跟踪哪个线程拥有每个监视器
+    std::map<JavaObject*, std::shared_ptr<JavaThread>> monitorOwners; // Owner of each held monitor, the entry count is JavaObject::lock / 每个被持有监视器的持有者，重入计数为 JavaObject::lock
     
     // Method cache for faster method resolution
     // 方法缓存，用于加速方法解析
@@ -71,6 +128,215 @@ private:
     
     std::map<MethodKey, MethodInfoCache> methodCache; // Method resolution cache / 方法解析缓存
 
+    // Resolved static field, referenced by index from *STATIC_QUICK instructions
+    // 已解析的静态字段，*STATIC_QUICK 指令的操作数即为该表的索引
+    struct StaticFieldEntry {
+        int64_t* slot;      // Storage of the field / 字段存储位置
+        JavaClass* cls;     // Class named by the field reference (for the init barrier) / 字段引用所指的类 (用于初始化屏障)
+        uint8_t kind;       // QuickKind / 值类型
+    };
+    std::vector<StaticFieldEntry> staticFieldCache;
+    std::map<int64_t*, uint16_t> staticFieldCacheIndex; // slot -> index, so sites sharing a field share an entry
+
+    // Resolved INVOKEVIRTUAL/INVOKEINTERFACE/INVOKESPECIAL site, referenced by index from
+    // the *_QUICK instructions. A site whose target can only be one method calls it
+    // directly; otherwise a small polymorphic inline cache keyed by the receiver's class
+    // sits in front of the vtable (or itable) lookup.
+    // 已解析的 INVOKEVIRTUAL/INVOKEINTERFACE/INVOKESPECIAL 调用点，*_QUICK 指令的操作数即为该表的索引。
+    // 目标方法唯一的调用点直接调用；否则先查以接收者类为键的多态内联缓存，未命中再查 vtable (或 itable)
+    static constexpr int INLINE_CACHE_SIZE = 4;
+    struct VirtualCallEntry {
+        JavaClass* cls = nullptr; // Class or interface named by the method reference / 方法引用所指的类或接口
+        uint16_t index = 0;       // Index in cls->vtable / 在 cls->vtable 中的索引
+        uint16_t argSlots = 0;    // Argument slots, without 'this' / 参数槽位数 (不含 this)
+        uint16_t cpIndex = 0;     // Original operand, to revert the site / 原始常量池索引，用于恢复调用点
+
+        // Devirtualized target: a final or private method, a constructor or super call, or
+        // a method no loaded subclass overrides (class hierarchy analysis). In the last case
+        // loading an overriding class turns the site back into a dispatched one.
+        // 去虚化的目标: final/private 方法、构造方法或 super 调用，或没有已加载子类重写的方法 (类层次分析)。
+        // 后一种情况下，加载了重写该方法的类后调用点恢复为虚分派
+        bool devirtualized = false;
+        bool assumesNoOverride = false;
+        JavaClass::VTableEntry direct;
+
+        // Polymorphic inline cache: receiver class -> selected method (vtables never change after link)
+        // 多态内联缓存: 接收者类 -> 选中的方法 (vtable 在链接后不再变化)
+        uint8_t cachedCount = 0;
+        JavaClass* cachedClass[INLINE_CACHE_SIZE];
+        const JavaClass::VTableEntry* cachedTarget[INLINE_CACHE_SIZE];
+    };
+    // A deque so entries stay in place while a call made through one of them runs
+    // 使用 deque，保证通过某一项发起的调用执行期间该项地址不变
+    std::deque<VirtualCallEntry> virtualCallCache;
+    std::map<std::pair<const ClassFile*, uint16_t>, uint16_t> virtualCallCacheIndex; // (class file, cp index) -> index
+
+    // Classes named by CHECKCAST_QUICK/INSTANCEOF_QUICK, referenced by index
+    // CHECKCAST_QUICK/INSTANCEOF_QUICK 所引用的类，操作数即为该表的索引
+    std::vector<JavaClass*> classRefCache;
+    std::map<JavaClass*, uint16_t> classRefCacheIndex;
+
+    // Array classes of NEWARRAY, by atype (T_BOOLEAN = 4 ... T_LONG = 11), resolved on first use
+    // NEWARRAY 的数组类，按 atype (T_BOOLEAN = 4 ... T_LONG = 11) 索引，首次使用时解析
+    JavaClass* primitiveArrayClasses[12] = {};
+    JavaClass* primitiveArrayClass(uint8_t atype);
+    // Target class of CHECKCAST/INSTANCEOF, nullptr if no object can be an instance of it
+    // CHECKCAST/INSTANCEOF 的目标类，不可能有对象是其实例时返回 nullptr
+    JavaClass* typeCheckTarget(const std::string& className);
+
+    // Value kinds encoded in the quick opcodes (offset from the *_QUICK_I opcode)
+    // 快速指令中编码的值类型 (相对于 *_QUICK_I 的偏移)
+    enum QuickKind : uint8_t { QUICK_I = 0, QUICK_J = 1, QUICK_F = 2, QUICK_D = 3, QUICK_A = 4 };
+    static uint8_t quickKindOf(const std::string& descriptor);
+
+    // Rewrite the instruction at pc in place (frame copy and the method's shared bytecode)
+    // 原地改写 pc 处的指令 (同时改写栈帧副本和方法共享的字节码)
+    void quickenInstruction(StackFrame& frame, size_t pc, uint8_t opcode, uint16_t operand);
+
+    // Rewrite a GETFIELD/PUTFIELD site to its quick form when the offset found on the
+    // receiver is also the offset of the field in the class named by the field reference.
+    // `fieldKind` is the FieldKind of the field, kept in the operand.
+    // 若接收者上找到的偏移与字段引用所指类中的偏移一致，则将 GETFIELD/PUTFIELD 改写为快速指令 (fieldKind 记录在操作数中)
+    void quickenFieldAccess(StackFrame& frame, size_t pc, uint8_t quickBase, uint16_t classIndex,
+                            const JavaClass* objCls, const std::string& key,
+                            size_t offset, uint8_t fieldKind);
+
+    // Register a class for CHECKCAST_QUICK/INSTANCEOF_QUICK; returns its cache index or -1 if the cache is full
+    // 登记 CHECKCAST_QUICK/INSTANCEOF_QUICK 引用的类，返回缓存索引 (缓存已满时返回 -1)
+    int registerClassRef(JavaClass* cls);
+
+    // Find the storage of a static field, searching superclasses and interfaces
+    // 查找静态字段的存储位置 (依次搜索父类和接口)
+    int64_t* findStaticField(const std::shared_ptr<JavaClass>& cls, const std::string& key);
+
+    // Register a resolved static field; returns its cache index or -1 if the cache is full
+    // 登记已解析的静态字段，返回缓存索引 (缓存已满时返回 -1)
+    int registerStaticField(int64_t* slot, JavaClass* cls, uint8_t kind);
+
+    // Rewrite an INVOKEVIRTUAL/INVOKEINTERFACE site to its quick form if the method is
+    // in the vtable of the referenced class and the current receiver dispatches through it
+    // 若方法位于引用类的 vtable 中且当前接收者可以据此分派，则将调用点改写为快速指令
+    bool quickenInvoke(StackFrame& frame, size_t pc, uint8_t quickOpcode, uint16_t cpIndex,
+                       const std::string& className, const std::string& key, uint16_t argSlots,
+                       JavaObject* receiver);
+
+    // Rewrite an INVOKESPECIAL site (constructor, private method, super call) to a direct call of `method`
+    // 将 INVOKESPECIAL 调用点 (构造方法、私有方法、super 调用) 改写为对 method 的直接调用
+    void quickenInvokeSpecial(StackFrame& frame, size_t pc, uint16_t cpIndex, JavaClass* cls,
+                              const MethodInfo& method, const std::string& name, const std::string& descriptor);
+
+    // Find or create the cache entry of a site
+    // 查找或创建调用点的缓存项
+    int registerCallSite(const ClassFile* classFile, uint16_t cpIndex, const VirtualCallEntry& entry);
+
+    // Pick the method a receiver runs for a resolved site; nullptr if the receiver is
+    // outside the linked hierarchy (mock classes, Object methods) or the method is abstract
+    // 为已解析的调用点选择接收者实际执行的方法; 接收者不在已链接的类层次中或方法为抽象方法时返回 nullptr
+    const JavaClass::VTableEntry* selectVirtual(JavaObject* receiver, const VirtualCallEntry& entry, bool isInterface);
+
+    // Drop the devirtualization of sites whose method `cls` overrides (called once `cls` is linked)
+    // 类链接完成后调用: 撤销被 cls 重写的方法所在调用点的去虚化
+    void invalidateDevirtualizedCalls(const JavaClass* cls);
+
+    // Call a selected method; its receiver and arguments are on top of frame's operand stack
+    // 调用选中的方法，接收者和参数位于调用者操作数栈顶
+    void invokeSelected(std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame,
+                        const JavaClass::VTableEntry& target, uint16_t argSlots);
+
+    // Legacy loop: one DataReader + std::function call per instruction
+    // 旧的执行循环: 每条指令构造 DataReader 并通过 std::function 分派
+    int executeTable(std::shared_ptr<JavaThread> thread, int instructions);
+
+    // Direct-threaded loop, implemented in Interpreter_Threaded.cpp
+    // 直接线索化执行循环 (实现见 Interpreter_Threaded.cpp)
+    int executeThreaded(std::shared_ptr<JavaThread> thread, int instructions);
+
+    // Register IR tier, implemented in Interpreter_IR.cpp
+    // 寄存器 IR 层 (实现见 Interpreter_IR.cpp)
+
+    // Translate and optimize the method of `frame` (buildIR with this interpreter's caches)
+    // 翻译并优化 frame 所属方法 (使用本解释器缓存的 buildIR)
+    std::shared_ptr<IRMethod> compileIR(const StackFrame& frame);
+
+    // Run the top frame on the IR tier for at most `budget` instructions. Returns the
+    // instructions executed, or -1 if the frame cannot enter the IR at its current pc.
+    // keepRunning is false when the thread must stop (as for a handler returning false).
+    // 在 IR 层执行栈顶栈帧，最多 budget 条指令。返回执行的指令数; 当前 pc 无法进入 IR 时返回 -1。
+    // 线程需要停止时 (与指令处理函数返回 false 相同) keepRunning 为 false
+    int runTier2(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                 int budget, bool& keepRunning);
+
+    // IR interpreter loop; returns false if an instruction handler asked to stop
+    // IR 解释循环; 指令处理函数要求停止时返回 false
+    bool executeIR(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                   const IRMethod& ir, uint32_t ip, int budget, int& executed);
+
+    // Run the bytecode of a SLOW insn through the instruction table. Returns the handler's
+    // result; resume tells whether the compiled code may continue at the insn's target.
+    // 通过指令表执行 SLOW 指令对应的字节码。返回处理函数的结果; resume 表示编译后的代码能否在其后继处继续执行
+    bool runSlowInsn(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                     const IRMethod& ir, const IRInsn& in, bool canResume, bool& resume);
+
+    // Pop the frame for a RETURN* insn and push its value on the caller
+    // 执行 RETURN* 指令: 弹出栈帧并将返回值压入调用者
+    void returnFromIR(JavaThread* thread, const IRInsn& in, const Slot* registers);
+
+    // Baseline JIT, implemented in Interpreter_Jit.cpp
+    // 基线 JIT (实现见 Interpreter_Jit.cpp)
+    std::shared_ptr<JitCode> compileJit(const IRMethod& ir);
+    bool executeJit(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                    const IRMethod& ir, const JitCode& jit, uint32_t ip, int budget, int& executed);
+
+    // AOT code, implemented in Interpreter_Aot.cpp: bind the module's functions to the
+    // methods of a freshly loaded application class
+    // AOT 代码 (实现见 Interpreter_Aot.cpp): 将模块中的函数绑定到刚加载的应用类的方法
+    void bindAotCode(const JavaClass& cls);
+    std::shared_ptr<void> aotLibrary;                        // dlopen handle / 共享库句柄
+    std::map<std::string, const AotMethod*> aotMethods;      // aotMethodKey -> entry / 方法键 -> 模块条目
+
+    // Superinstructions, implemented in instructions/Instructions_Super.cpp
+    // 超级指令 (实现见 instructions/Instructions_Super.cpp)
+    bool superinstructionsEnabled = true;
+    void fuseSuperinstructions(const JavaClass& cls);
+    std::vector<uint64_t> sequenceCounts; // [family * 256 + first opcode]; empty unless profiling / 未开启统计时为空
+    uint64_t profiledInstructions = 0;
+    void countSequences(const StackFrame& frame, size_t pc);
+
+    // Discard the IR and machine code of every method of a class that is being replaced
+    // 丢弃被替换类的所有方法的 IR 和机器码
+    void dropCompiledCode(const JavaClass& cls);
+
+    // Raise a VM runtime exception in the current frame of a thread; frame->pc must point at
+    // the faulting instruction. Returns false if it was not caught and the thread has been
+    // terminated.
+    // 在线程的当前栈帧中抛出虚拟机运行时异常; frame->pc 须指向出错的指令。
+    // 如果异常未被捕获 (线程已终止)，返回 false
+    bool raiseRuntimeException(const std::shared_ptr<JavaThread>& thread, RuntimeExceptionKind kind,
+                               const std::string& detail = std::string());
+
+    // Throw a Java exception object (ATHROW, raiseRuntimeException); terminates the thread
+    // and returns false if no frame catches it
+    // 抛出 Java 异常对象 (ATHROW、raiseRuntimeException); 没有栈帧捕获时终止线程并返回 false
+    bool throwJavaException(const std::shared_ptr<JavaThread>& thread, JavaObject* exception,
+                            const std::string& detail = std::string());
+
+    // Turn a std::runtime_error raised by an instruction or native into a Java exception.
+    // Returns false if it was not caught and the thread has been terminated.
+    // 将指令或本地方法抛出的 std::runtime_error 转换为 Java 异常
+    // 如果异常未被捕获 (线程已终止)，返回 false
+    bool throwFromRuntimeError(std::shared_ptr<JavaThread> thread, const std::string& msg);
+
+    // Shared instances of the VM runtime exceptions, created on first use: thrown for
+    // OutOfMemoryError and for exceptions nothing catches. They carry no message or stack
+    // trace (the Throwable stub keeps neither per throw).
+    // 虚拟机运行时异常的共享实例，首次使用时创建: 用于 OutOfMemoryError 和无人捕获的异常。
+    // 实例不带消息和栈回溯 (Throwable 桩类本就不按抛出记录这些)
+    JavaObject* preallocatedExceptions[static_cast<size_t>(RuntimeExceptionKind::COUNT)] = {};
+
+    // Stack trace of a thread, innermost frame first; only built for uncaught exceptions
+    // 线程的栈回溯 (最内层栈帧在前); 仅在异常未被捕获时生成
+    std::string describeStack(const JavaThread& thread) const;
+
     // Execute a single instruction
     // 执行单条指令
     bool executeInstruction(std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader);
@@ -80,17 +346,32 @@ private:
     // 执行类的静态初始化器 (<clinit>)
     // 如果触发了初始化 (调用者需要回退 PC 并重试)，则返回 true
     bool initializeClass(std::shared_ptr<JavaThread> thread, std::shared_ptr<JavaClass> cls);
+
+    // Store the ConstantValue attributes of a class's static fields (before <clinit> runs)
+    // 写入类中静态字段的 ConstantValue 属性 (在 <clinit> 执行之前)
+    void applyStaticConstants(JavaClass& cls);
     
     // Validate that a string is actually a class name, not a descriptor
     // 验证字符串是否为有效的类名 (不是描述符)
     bool isValidClassName(const std::string& name);
 
-    // Handle exception throwing
-    // 处理异常抛出
+    // Handle exception throwing: find the handler first, then unwind to it. An uncaught
+    // exception leaves the frames untouched so the caller can still describe the stack.
+    // 处理异常抛出: 先查找处理器，再展开到该处理器。未被捕获时栈帧保持不变，调用者仍可生成栈回溯
     // Returns true if exception was handled (caught in current or caller frame), false otherwise
     // 如果异常被处理 (在当前或调用者栈帧中捕获)，返回 true；否则返回 false
     bool handleException(std::shared_ptr<JavaThread> thread, JavaObject* exception);
 
+    // The two phases of handleException: the frame index and handler pc that catch an
+    // exception of the given class (false if none does), and the unwind into that handler
+    // handleException 的两个阶段: 查找捕获该类异常的栈帧下标和处理器 pc (没有则返回 false)，以及展开并进入该处理器
+    bool findHandler(JavaThread& thread, const JavaClass* exceptionClass, size_t& handlerFrame, int& handlerPc);
+    void enterHandler(JavaThread& thread, size_t handlerFrame, int handlerPc, JavaObject* exception);
+
+    // Decide how a handler's catch_type matches, on the first throw that reaches it
+    // 在第一次有异常到达处理器时确定其 catch_type 的匹配方式
+    void resolveCatchType(const StackFrame& frame, RuntimeMethod::Handler& handler);
+
     // Make friends for native access
     friend class j2me::core::NativeRegistry;
     friend void j2me::natives::registerMediaNatives(j2me::core::NativeRegistry& registry);
@@ -119,6 +400,8 @@ private:
     void initControl();      // 控制流指令 (跳转, 返回)
     void initReferences();   // 对象引用指令 (NEW, INVOKE 等)
     void initExtended();     // 扩展指令 (WIDE 等)
+    void initQuick();        // 快速化字段访问、方法调用与类型检查指令 (*_QUICK)
+    void initSuperinstructions(); // 超级指令 (在其他指令组之后初始化)
 };
 
 } // namespace core
@@ -0,0 +1,104 @@
+#include "Interpreter.hpp"
+#include "RegisterIR.hpp"
+#include "AotModule.hpp"
+#include "HeapManager.hpp"
+#include "Logger.hpp"
+#include <vector>
+
+#if J2ME_AOT
+#include <dlfcn.h>
+#endif
+
+// AOT 代码的运行时部分 (Runtime side of AOT compiled code)
+//
+// j2me-aot 为某个 JAR 生成的共享库 (AotModule.hpp) 在启动时由 J2MEVM 交给 loadAotModule。
+// 之后每个从应用 JAR 加载的类都在这里绑定: 按方法键找到模块条目，检查字节码哈希，重新构建 IR
+// 并确认与工具编译时的指令数一致，然后把函数包装成 JitCode 挂到 RuntimeMethod 上。
+// 执行与 JIT 机器码完全相同 (runTier2 -> executeJit)，不匹配的方法照常解释执行。
+//
+// J2MEVM hands the shared library j2me-aot built for the JAR (AotModule.hpp) to
+// loadAotModule at startup. Every class loaded from the application JAR afterwards is
+// bound here: look the method up by key, check the bytecode hash, rebuild the IR and
+// make sure it has the insn count the tool compiled, then hang the function on the
+// RuntimeMethod wrapped as JitCode. It runs exactly like JIT code (runTier2 ->
+// executeJit); methods that do not match are interpreted as usual.
+
+namespace j2me {
+namespace core {
+
+bool Interpreter::loadAotModule(const std::string& path, uint64_t jarHash) {
+#if J2ME_AOT
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* error = dlerror();
+        LOG_ERROR("[AOT] Cannot open " + path + ": " + (error ? error : "unknown error"));
+        return false;
+    }
+    std::shared_ptr<void> library(handle, [](void* h) { dlclose(h); });
+    auto getter = reinterpret_cast<AotModuleGetter>(dlsym(handle, J2ME_AOT_MODULE_SYMBOL));
+    const AotModule* module = getter ? getter() : nullptr;
+    if (!module) {
+        LOG_ERROR("[AOT] " + path + " is not an AOT module");
+        return false;
+    }
+    if (module->abiVersion != AOT_ABI_VERSION || module->objectHeaderSize != sizeof(JavaObject) ||
+        module->referenceSize != sizeof(HeapRef)) {
+        LOG_ERROR("[AOT] " + path + " was built by an incompatible j2me-aot, ignoring it");
+        return false;
+    }
+    if (module->jarHash != jarHash) {
+        LOG_ERROR("[AOT] " + path + " was built for a different JAR, ignoring it");
+        return false;
+    }
+
+    HeapManager& heap = HeapManager::getInstance();
+    if (module->heapBase) *module->heapBase = heap.regionBase();
+    *module->cardTable = cardTableBase;
+
+    aotMethods.clear();
+    for (uint32_t i = 0; i < module->methodCount; i++) {
+        aotMethods[module->methods[i].key] = &module->methods[i];
+    }
+    aotLibrary = library;
+    LOG_INFO("[AOT] Loaded " + std::to_string(module->methodCount) + " compiled methods from " + path);
+    return true;
+#else
+    (void)jarHash;
+    LOG_ERROR("[AOT] This build cannot load AOT modules, ignoring " + path);
+    return false;
+#endif
+}
+
+void Interpreter::bindAotCode(const JavaClass& cls) {
+    if (aotMethods.empty() || !cls.rawFile) return;
+    const ClassFile& cf = *cls.rawFile;
+    size_t bound = 0;
+    for (const auto& method : cf.methods) {
+        auto it = aotMethods.find(aotMethodKey(cf, method));
+        if (it == aotMethods.end()) continue;
+        const AotMethod& entry = *it->second;
+        if (!method.runtime) method.runtime = std::make_shared<RuntimeMethod>(method, cf);
+        RuntimeMethod& runtime = *method.runtime;
+
+        // The function is only valid for the IR it was generated from
+        // 函数只对生成它的那份 IR 有效
+        if (runtime.code.empty() || aotHash(runtime.code.data(), runtime.code.size()) != entry.codeHash) {
+            LOG_DEBUG("[AOT] Bytecode of " + it->first + " changed, interpreting it");
+            continue;
+        }
+        std::shared_ptr<IRMethod> ir = buildIR(runtime, cf, nullptr);
+        if (!ir || ir->code.size() != entry.irSize) {
+            LOG_DEBUG("[AOT] IR of " + it->first + " does not match the module, interpreting it");
+            continue;
+        }
+        runtime.ir = ir;
+        runtime.jit = JitCode::wrap(entry.function, aotLibrary);
+        bound++;
+    }
+    if (bound > 0) {
+        LOG_DEBUG("[AOT] Bound " + std::to_string(bound) + " methods of " + cls.name);
+    }
+}
+
+} // namespace core
+} // namespace j2me
@@ -45,6 +45,21 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
                             LOG_DEBUG("[Interpreter] Loaded StringBuilder from rt.jar, methods=" + std::to_string(rawFile->methods.size()));
                         }
                         
+                        // Resolve interfaces first: link() builds the itables from them
+                        // 先解析接口: link() 需要据此构建 itable
+                        for (uint16_t interfaceIndex : rawFile->interfaces) {
+                            if (interfaceIndex > 0 && interfaceIndex < rawFile->constant_pool.size()) {
+                                auto interfaceInfo = std::dynamic_pointer_cast<ConstantClass>(rawFile->constant_pool[interfaceIndex]);
+                                if (interfaceInfo) {
+                                    auto interfaceNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[interfaceInfo->name_index]);
+                                    if (interfaceNameInfo) {
+                                        auto interfaceClass = resolveClass(interfaceNameInfo->bytes);
+                                        javaClass->interfaces.push_back(interfaceClass);
+                                    }
+                                }
+                            }
+                        }
+                
                         if (rawFile->super_class != 0) {
                             auto superInfo = std::dynamic_pointer_cast<ConstantClass>(rawFile->constant_pool[rawFile->super_class]);
                             auto superNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[superInfo->name_index]);
@@ -60,22 +75,9 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
                             javaClass->link(nullptr);
                         }
 
-                        // Resolve interfaces
-                        // 解析接口
-                        for (uint16_t interfaceIndex : rawFile->interfaces) {
-                            if (interfaceIndex > 0 && interfaceIndex < rawFile->constant_pool.size()) {
-                                auto interfaceInfo = std::dynamic_pointer_cast<ConstantClass>(rawFile->constant_pool[interfaceIndex]);
-                                if (interfaceInfo) {
-                                    auto interfaceNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[interfaceInfo->name_index]);
-                                    if (interfaceNameInfo) {
-                                        auto interfaceClass = resolveClass(interfaceNameInfo->bytes);
-                                        javaClass->interfaces.push_back(interfaceClass);
-                                    }
-                                }
-                            }
-                        }
-                
                         loadedClasses[className] = javaClass;
+                        invalidateDevirtualizedCalls(javaClass.get());
+                        fuseSuperinstructions(*javaClass);
                         return javaClass;
                     } catch (const std::exception& e) {
                         LOG_ERROR("Failed to parse library class " + className + ": " + e.what());
@@ -126,6 +128,7 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              // 我们需要构造一个最小有效的 JavaClass
              auto javaClass = std::make_shared<JavaClass>(dummy);
              javaClass->name = "java/lang/Object";
+             javaClass->isObjectClass = true;
              javaClass->instanceSize = 0;
              loadedClasses[className] = javaClass;
              return javaClass;
@@ -138,7 +141,7 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              auto dummy = std::make_shared<ClassFile>();
              auto javaClass = std::make_shared<JavaClass>(dummy);
              javaClass->name = "java/lang/AbstractStringBuilder";
-             javaClass->instanceSize = 1; // ID for native map
+             javaClass->instanceSize = 8; // Native handle (std::string*) / 本地句柄
              
              auto addMethod = [&](const std::string& name, const std::string& desc) {
                  MethodInfo m;
@@ -176,7 +179,7 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              auto dummy = std::make_shared<ClassFile>();
              auto javaClass = std::make_shared<JavaClass>(dummy);
              javaClass->name = "java/lang/StringBuffer";
-             javaClass->instanceSize = 1; // ID for native map
+             javaClass->instanceSize = 8; // Native handle (std::string*) / 本地句柄
              
              // Helper to add method
              auto addMethod = [&](const std::string& name, const std::string& desc) {
@@ -213,7 +216,7 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              auto dummy = std::make_shared<ClassFile>();
              auto javaClass = std::make_shared<JavaClass>(dummy);
              javaClass->name = "java/lang/StringBuilder";
-             javaClass->instanceSize = 0; // We use fields vector dynamically
+             javaClass->instanceSize = 8; // Native handle (std::string*) / 本地句柄
              
              // Helper to add method
              auto addMethod = [&](const std::string& name, const std::string& desc) {
@@ -249,7 +252,7 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              auto dummy = std::make_shared<ClassFile>();
              auto javaClass = std::make_shared<JavaClass>(dummy);
              javaClass->name = "java/io/InputStream";
-             javaClass->instanceSize = 1; // One field for native stream ID
+             javaClass->instanceSize = 8; // One field for native stream ID
              
              // Helper to add method
              auto addMethod = [&](const std::string& name, const std::string& desc) {
@@ -287,7 +290,7 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              auto dummy = std::make_shared<ClassFile>();
              auto javaClass = std::make_shared<JavaClass>(dummy);
              javaClass->name = "java/lang/String";
-             javaClass->instanceSize = 3; // Three fields: value, offset, count
+             javaClass->instanceSize = 16; // Three fields: value, offset, count
              
              // Helper to add field
              auto addField = [&](const std::string& name, const std::string& desc, uint16_t access_flags) {
@@ -314,8 +317,8 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              // Manually set fieldOffsets since we're not calling link()
              // 手动设置 fieldOffsets，因为我们不调用 link()
              javaClass->fieldOffsets["value|[B"] = 0;
-             javaClass->fieldOffsets["offset|I"] = 1;
-             javaClass->fieldOffsets["count|I"] = 2;
+             javaClass->fieldOffsets["offset|I"] = 8;
+             javaClass->fieldOffsets["count|I"] = 12;
              
              LOG_DEBUG("[Mock String] Created mock String class with fieldOffsets size=" + std::to_string(javaClass->fieldOffsets.size()) + " rawFile->fields.size()=" + std::to_string(dummy->fields.size()));
              
@@ -390,7 +393,27 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
              auto dummy = std::make_shared<ClassFile>();
              auto javaClass = std::make_shared<JavaClass>(dummy);
              javaClass->name = className;
-             javaClass->instanceSize = 0; // Arrays use dynamic field storage
+             // Arrays inherit Object's methods (hashCode, equals, ...)
+             // 数组继承 Object 的方法 (hashCode、equals 等)
+             javaClass->link(resolveClass("java/lang/Object"));
+             javaClass->instanceSize = 0; // Arrays are sized by HeapManager::allocateArray
+             javaClass->isArray = true;
+             javaClass->elementKind = fieldKindOf(className.substr(1));
+
+             // The component class of a reference array; a component that cannot be loaded
+             // only makes the array non-covariant
+             // 引用数组的元素类; 元素类无法加载时数组只是不再协变
+             if (javaClass->elementKind == FIELD_A) {
+                 std::string component = className.substr(1);
+                 if (component.size() > 2 && component[0] == 'L' && component.back() == ';') {
+                     component = component.substr(1, component.size() - 2);
+                 }
+                 try {
+                     javaClass->componentClass = resolveClass(component).get();
+                 } catch (const std::exception& e) {
+                     LOG_DEBUG("[Interpreter] No component class for " + className + ": " + e.what());
+                 }
+             }
              
              loadedClasses[className] = javaClass;
              return javaClass;
@@ -409,6 +432,21 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
             auto rawFile = parser.parse(*data);
             auto javaClass = std::make_shared<JavaClass>(rawFile);
             
+            // Resolve interfaces first: link() builds the itables from them
+            // 先解析接口: link() 需要据此构建 itable
+            for (uint16_t interfaceIndex : rawFile->interfaces) {
+                if (interfaceIndex > 0 && interfaceIndex < rawFile->constant_pool.size()) {
+                    auto interfaceInfo = std::dynamic_pointer_cast<ConstantClass>(rawFile->constant_pool[interfaceIndex]);
+                    if (interfaceInfo) {
+                        auto interfaceNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[interfaceInfo->name_index]);
+                        if (interfaceNameInfo) {
+                            auto interfaceClass = resolveClass(interfaceNameInfo->bytes);
+                            javaClass->interfaces.push_back(interfaceClass);
+                        }
+                    }
+                }
+            }
+
             // Link with superclass (recursive load)
             // 链接父类 (递归加载)
             if (rawFile->super_class != 0) {
@@ -427,22 +465,12 @@ std::shared_ptr<JavaClass> Interpreter::resolveClass(const std::string& classNam
                 javaClass->link(nullptr);
             }
 
-            // Resolve interfaces
-            // 解析接口
-            for (uint16_t interfaceIndex : rawFile->interfaces) {
-                if (interfaceIndex > 0 && interfaceIndex < rawFile->constant_pool.size()) {
-                    auto interfaceInfo = std::dynamic_pointer_cast<ConstantClass>(rawFile->constant_pool[interfaceIndex]);
-                    if (interfaceInfo) {
-                        auto interfaceNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[interfaceInfo->name_index]);
-                        if (interfaceNameInfo) {
-                            auto interfaceClass = resolveClass(interfaceNameInfo->bytes);
-                            javaClass->interfaces.push_back(interfaceClass);
-                        }
-                    }
-                }
-            }
-
             loadedClasses[className] = javaClass;
+            // A new subclass may override methods that call sites were devirtualized to
+            // 新加载的子类可能重写了已去虚化调用点的目标方法
+            invalidateDevirtualizedCalls(javaClass.get());
+            bindAotCode(*javaClass);
+            fuseSuperinstructions(*javaClass);
             return javaClass;
         } catch (const std::exception& e) {
             LOG_ERROR("Failed to parse class " + className + ": " + e.what());
@@ -467,7 +495,16 @@ bool Interpreter::isValidClassName(const std::string& name) {
 }
 
 void Interpreter::registerClass(const std::string& className, std::shared_ptr<JavaClass> cls) {
+    auto existing = loadedClasses.find(className);
+    if (existing != loadedClasses.end() && existing->second && existing->second != cls) {
+        // A redefined class must not keep running IR built from the old bytecode
+        // 被重新定义的类不能继续执行由旧字节码翻译的 IR
+        dropCompiledCode(*existing->second);
+    }
     loadedClasses[className] = cls;
+    invalidateDevirtualizedCalls(cls.get());
+    bindAotCode(*cls);
+    fuseSuperinstructions(*cls);
 }
 
 }
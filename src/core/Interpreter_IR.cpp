@@ -0,0 +1,558 @@
+#include "Interpreter.hpp"
+#include "RegisterIR.hpp"
+#include "JitX64.hpp"
+#include "Opcodes.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// 第二执行层: 寄存器 IR 解释器 (Second execution tier: register IR interpreter)
+//
+// 方法的调用次数与回边次数之和 (RuntimeMethod::hotness) 达到阈值后，将其字节码翻译为寄存器 IR
+// (RegisterIR.hpp)，经过常量折叠、复写传播、冗余空检查消除和死存储消除后由 executeIR 执行。
+// IR 无法处理的字节码 (方法调用、对象创建、未快速化的字段访问等) 仍交给 instructionTable 执行;
+// 异常、调用、预算用尽时栈帧状态已与字节码一致，直接回到 executeThreaded 继续执行 (去优化)。
+//
+// Once a method's invocation + back-edge count (RuntimeMethod::hotness) crosses the
+// threshold its bytecode is translated to register IR (RegisterIR.hpp), optimized and
+// run by executeIR. Bytecodes the IR does not model (calls, allocation, unresolved field
+// access...) still go through instructionTable. Exceptions, calls and an exhausted budget
+// leave the frame in exactly the state the bytecode tier expects, so executeThreaded
+// simply carries on from there.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define J2ME_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define J2ME_UNLIKELY(x) (x)
+#endif
+
+namespace j2me {
+namespace core {
+
+namespace {
+
+template <typename T>
+inline int32_t compareFloating(T v1, T v2, int32_t nanResult) {
+    if (std::isnan(v1) || std::isnan(v2)) return nanResult;
+    if (v1 > v2) return 1;
+    if (v1 < v2) return -1;
+    return 0;
+}
+
+} // namespace
+
+void Interpreter::setTier2Threshold(uint32_t threshold) {
+    tier2Threshold = threshold ? threshold : UINT32_MAX;
+    tierUpThreshold = std::min(tier2Threshold, jitThreshold);
+}
+
+void Interpreter::setJitThreshold(uint32_t threshold) {
+    jitThreshold = threshold ? threshold : UINT32_MAX;
+    tierUpThreshold = std::min(tier2Threshold, jitThreshold);
+}
+
+std::shared_ptr<IRMethod> Interpreter::compileIR(const StackFrame& frame) {
+    // Operands of quickened instructions are indices into this interpreter's caches
+    // 快速化指令的操作数是本解释器缓存的索引
+    struct Caches : IRQuickening {
+        const Interpreter& interp;
+        explicit Caches(const Interpreter& owner) : interp(owner) {}
+        bool invokeRef(uint16_t operand, uint16_t& cpIndex) const override {
+            if (operand >= interp.virtualCallCache.size()) return false;
+            cpIndex = interp.virtualCallCache[operand].cpIndex;
+            return true;
+        }
+        bool staticField(uint16_t operand, void*& slot, uint8_t& kind) const override {
+            if (operand >= interp.staticFieldCache.size()) return false;
+            slot = interp.staticFieldCache[operand].slot;
+            kind = interp.staticFieldCache[operand].kind;
+            return true;
+        }
+        bool classRef(uint16_t operand, void*& cls) const override {
+            if (operand >= interp.classRefCache.size()) return false;
+            cls = interp.classRefCache[operand];
+            return true;
+        }
+    } caches(*this);
+    return buildIR(*frame.runtime, *frame.classFile, &caches);
+}
+
+int Interpreter::runTier2(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                          int budget, bool& keepRunning) {
+    StackFrame* frame = framePtr.get();
+    RuntimeMethod* method = frame->runtime;
+    if (!method->ir) {
+        if (method->irFailed) return -1;
+        method->ir = compileIR(*frame);
+        if (!method->ir) {
+            method->irFailed = true;
+            return -1;
+        }
+    }
+    // Keep the IR (and machine code) alive even if the class gets redefined while it runs
+    // 持有引用，保证执行期间类被重新定义时 IR (及机器码) 仍然有效
+    std::shared_ptr<IRMethod> ir = method->ir;
+    if (frame->localCount != ir->maxLocals || frame->pc >= ir->entryLabel.size()) return -1;
+    int32_t label = ir->entryLabel[frame->pc];
+    if (label < 0 || ir->labels[label].depth != frame->stackTop) return -1;
+
+    // AOT code is bound before the method first runs; JIT code once it is hot enough
+    // AOT 代码在方法首次运行前绑定; JIT 机器码在方法足够热后编译
+    std::shared_ptr<JitCode> jit = method->jit;
+    if (!jit && method->hotness >= jitThreshold && !method->jitFailed) {
+        method->jit = compileJit(*ir);
+        if (!method->jit) method->jitFailed = true;
+        jit = method->jit;
+    }
+    if (!jit && method->hotness < tier2Threshold) return -1;
+
+    int executed = 0;
+    keepRunning = true;
+    try {
+        if (jit) keepRunning = executeJit(threadPtr, framePtr, *ir, *jit, ir->labels[label].index, budget, executed);
+        else keepRunning = executeIR(threadPtr, framePtr, *ir, ir->labels[label].index, budget, executed);
+    } catch (const JavaThrow& e) {
+        // Raised by a slow instruction or native / 由慢速指令或本地方法抛出
+        executed++;
+        keepRunning = raiseRuntimeException(threadPtr, e.kind, e.what());
+    } catch (const std::exception& e) {
+        // frame->pc points at the faulting bytecode: unwind exactly like the bytecode tiers
+        // frame->pc 已指向出错的字节码，按字节码层的方式展开异常
+        executed++;
+        std::string msg = e.what() ? std::string(e.what()) : std::string();
+        keepRunning = throwFromRuntimeError(threadPtr, msg);
+    }
+    return executed > 0 ? executed : 1;
+}
+
+bool Interpreter::runSlowInsn(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                              const IRMethod& ir, const IRInsn& in, bool canResume, bool& resume) {
+    JavaThread* thread = threadPtr.get();
+    StackFrame* frame = framePtr.get();
+    frame->pc = in.pc;
+    frame->stackTop = in.depth;
+    uint8_t opcode = frame->code[in.pc];
+    util::DataReader codeReader(frame->code);
+    codeReader.seek(in.pc + 1);
+    bool continueExec = instructionTable[opcode](threadPtr, framePtr, codeReader, opcode);
+    frame->pc = (uint32_t)codeReader.tell();
+    // Same frame still on top and at the next bytecode: the compiled code can go on
+    // 栈帧未变化且停在下一条字节码处: 编译后的代码可以继续执行
+    resume = continueExec && canResume && in.target >= 0 && thread->state == JavaThread::RUNNABLE &&
+             !thread->frames.empty() && thread->frames.back().get() == frame &&
+             frame->pc == ir.labels[in.target].pc && frame->stackTop == ir.labels[in.target].depth;
+    return continueExec;
+}
+
+void Interpreter::returnFromIR(JavaThread* thread, const IRInsn& in, const Slot* registers) {
+    static const JavaValue::Type returnType[5] = {
+        JavaValue::INT, JavaValue::LONG, JavaValue::FLOAT, JavaValue::DOUBLE, JavaValue::REFERENCE
+    };
+    JavaValue retVal;
+    bool hasValue = in.op != IR_RETURN;
+    if (hasValue) {
+        retVal.type = returnType[in.op - IR_RETURN_I];
+        retVal.val = registers[in.a];
+    }
+    thread->popFrame();
+    if (hasValue && !thread->frames.empty()) thread->frames.back()->push(retVal);
+}
+
+bool Interpreter::executeIR(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                            const IRMethod& ir, uint32_t ip, int budget, int& executed) {
+    JavaThread* thread = threadPtr.get();
+    StackFrame* frame = framePtr.get();
+    const IRInsn* const code = ir.code.data();
+    const IRLabel* const labels = ir.labels.data();
+    Slot* r;        // 寄存器 (栈帧槽位)
+    uint8_t* t;     // 寄存器的类型标记
+
+// (Re)load the register file; a handler may have moved the frame's slots
+// (重新) 加载寄存器指针; 指令处理函数可能迁移了栈帧槽位
+#define IR_LOAD() do { frame->reserveMaxStack(); r = frame->slots; t = frame->tags; } while (0)
+// Unwinding discards the operand stack, and the slots of stores removed as dead may
+// hold stale values, so it is dropped right away
+// 异常展开会丢弃操作数栈，且被消除的死存储对应槽位可能是旧值，因此直接清空
+// The exception is raised right here (no C++ throw); its handler, if any, runs on the bytecode tier
+// 异常在此处直接抛出 (不经过 C++ 异常); 处理器 (如有) 在字节码层执行
+#define IR_THROW(kind) do { \
+            frame->pc = in.pc; \
+            frame->stackTop = 0; \
+            executed++; \
+            return raiseRuntimeException(threadPtr, RuntimeExceptionKind::kind); \
+        } while (0)
+// Taken branch: leave for the bytecode tier at the target once the budget is used up
+// 跳转: 预算用尽时在目标位置回到字节码层
+// A backward branch that makes the method hot enough for the JIT also leaves, so runTier2 can compile it
+// 使方法达到 JIT 阈值的向后跳转同样离开 IR，由 runTier2 编译为机器码
+#define IR_JUMP(labelIndex) do { \
+            const IRLabel& l_ = labels[(labelIndex)]; \
+            if (J2ME_UNLIKELY(executed >= budget) || \
+                (J2ME_UNLIKELY(l_.pc <= in.pc) && J2ME_UNLIKELY(++frame->runtime->hotness == jitThreshold))) { \
+                frame->pc = l_.pc; \
+                frame->stackTop = l_.depth; \
+                return true; \
+            } \
+            ip = l_.index; \
+        } while (0)
+#define W_I(reg, x) do { int32_t v_ = (x); r[reg].i = v_; t[reg] = JavaValue::INT; } while (0)
+#define W_F(reg, x) do { float v_ = (x); r[reg].f = v_; t[reg] = JavaValue::FLOAT; } while (0)
+#define W_A(reg, x) do { void* v_ = (x); r[reg].ref = v_; t[reg] = JavaValue::REFERENCE; } while (0)
+#define W_J(reg, x) do { int64_t v_ = (x); r[reg].l = v_; t[reg] = JavaValue::LONG; t[(reg) + 1] = SLOT_TOP; } while (0)
+#define W_D(reg, x) do { double v_ = (x); r[reg].d = v_; t[reg] = JavaValue::DOUBLE; t[(reg) + 1] = SLOT_TOP; } while (0)
+#define IR_BIN(field, write, expr) do { auto v1 = r[in.a].field; auto v2 = r[in.b].field; write(in.dst, expr); } while (0)
+#define IR_SHIFT(field, write, expr) do { auto v1 = r[in.a].field; int32_t v2 = r[in.b].i; write(in.dst, expr); } while (0)
+#define IR_UN(field, write, expr) do { auto v = r[in.a].field; write(in.dst, expr); } while (0)
+#define IR_IF(cond) do { if (r[in.a].i cond r[in.b].i) IR_JUMP(in.target); } while (0)
+#define IR_IFK(cond) do { if (r[in.a].i cond in.imm.i) IR_JUMP(in.target); } while (0)
+#define IR_BASE(var) \
+            JavaObject* var = (JavaObject*)r[in.a].ref; \
+            if (!(in.flags & IR_NONNULL) && J2ME_UNLIKELY(var == nullptr)) IR_THROW(NULL_POINTER)
+#define IR_ARRAY_LOAD(type, write, conv) do { \
+            IR_BASE(arr); \
+            int32_t index = r[in.b].i; \
+            if (J2ME_UNLIKELY(index < 0 || index >= arr->arrayLength())) IR_THROW(ARRAY_INDEX); \
+            type raw = arr->elements<type>()[index]; \
+            write(in.dst, conv); \
+        } while (0)
+#define IR_ARRAY_STORE(type, expr) do { \
+            IR_BASE(arr); \
+            int32_t index = r[in.b].i; \
+            if (J2ME_UNLIKELY(index < 0 || index >= arr->arrayLength())) IR_THROW(ARRAY_INDEX); \
+            const Slot& value = r[in.c]; \
+            arr->elements<type>()[index] = (expr); \
+        } while (0)
+#define IR_GETFIELD(kind, write, conv) do { \
+            IR_BASE(obj); \
+            size_t offset = (uint32_t)in.imm.i; \
+            if (J2ME_UNLIKELY(!obj->hasField(offset, (kind)))) IR_THROW(RUNTIME); \
+            int64_t raw = obj->loadField(offset, (kind)); \
+            write(in.dst, conv); \
+        } while (0)
+#define IR_PUTFIELD(kind, rawExpr) do { \
+            IR_BASE(obj); \
+            size_t offset = (uint32_t)in.imm.i; \
+            if (J2ME_UNLIKELY(!obj->hasField(offset, (kind)))) IR_THROW(RUNTIME); \
+            const Slot& value = r[in.c]; \
+            obj->storeField(offset, (kind), (rawExpr)); \
+        } while (0)
+#define IR_GETSTATIC(write, conv) do { int64_t raw = *(int64_t*)in.imm.ref; write(in.dst, conv); } while (0)
+#define IR_PUTSTATIC(rawExpr) do { const Slot& value = r[in.c]; *(int64_t*)in.imm.ref = (rawExpr); } while (0)
+    IR_LOAD();
+    for (;;) {
+        const IRInsn& in = code[ip++];
+        executed++;
+        switch (in.op) {
+            case IR_NOP: break;
+
+            case IR_SLOW: {
+                bool resume = false;
+                if (!runSlowInsn(threadPtr, framePtr, ir, in, executed < budget, resume)) return false;
+                if (!resume) return true;
+                IR_LOAD();
+                ip = labels[in.target].index;
+                break;
+            }
+
+            case IR_MOV: r[in.dst] = r[in.a]; t[in.dst] = t[in.a]; break;
+            case IR_MOV2:
+                r[in.dst] = r[in.a]; t[in.dst] = t[in.a];
+                r[in.dst + 1] = r[in.a + 1]; t[in.dst + 1] = t[in.a + 1];
+                break;
+            case IR_MOV_I: r[in.dst] = r[in.a]; t[in.dst] = JavaValue::INT; break;
+            case IR_MOV_F: r[in.dst] = r[in.a]; t[in.dst] = JavaValue::FLOAT; break;
+            case IR_MOV_A: r[in.dst] = r[in.a]; t[in.dst] = JavaValue::REFERENCE; break;
+            case IR_MOV_J: r[in.dst] = r[in.a]; t[in.dst] = JavaValue::LONG; t[in.dst + 1] = SLOT_TOP; break;
+            case IR_MOV_D: r[in.dst] = r[in.a]; t[in.dst] = JavaValue::DOUBLE; t[in.dst + 1] = SLOT_TOP; break;
+            case IR_CONST_I: r[in.dst] = in.imm; t[in.dst] = JavaValue::INT; break;
+            case IR_CONST_F: r[in.dst] = in.imm; t[in.dst] = JavaValue::FLOAT; break;
+            case IR_CONST_A: r[in.dst] = in.imm; t[in.dst] = JavaValue::REFERENCE; break;
+            case IR_CONST_J: r[in.dst] = in.imm; t[in.dst] = JavaValue::LONG; t[in.dst + 1] = SLOT_TOP; break;
+            case IR_CONST_D: r[in.dst] = in.imm; t[in.dst] = JavaValue::DOUBLE; t[in.dst + 1] = SLOT_TOP; break;
+
+            // ---- int ----
+            case IR_ADD_I: IR_BIN(i, W_I, (int32_t)((uint32_t)v1 + (uint32_t)v2)); break;
+            case IR_SUB_I: IR_BIN(i, W_I, (int32_t)((uint32_t)v1 - (uint32_t)v2)); break;
+            case IR_MUL_I: IR_BIN(i, W_I, (int32_t)((uint32_t)v1 * (uint32_t)v2)); break;
+            case IR_DIV_I:
+                if (J2ME_UNLIKELY(r[in.b].i == 0)) IR_THROW(ARITHMETIC);
+                IR_BIN(i, W_I, (v2 == -1) ? (int32_t)(0u - (uint32_t)v1) : v1 / v2);
+                break;
+            case IR_REM_I:
+                if (J2ME_UNLIKELY(r[in.b].i == 0)) IR_THROW(ARITHMETIC);
+                IR_BIN(i, W_I, (v2 == -1) ? 0 : v1 % v2);
+                break;
+            case IR_AND_I: IR_BIN(i, W_I, v1 & v2); break;
+            case IR_OR_I: IR_BIN(i, W_I, v1 | v2); break;
+            case IR_XOR_I: IR_BIN(i, W_I, v1 ^ v2); break;
+            case IR_SHL_I: IR_SHIFT(i, W_I, (int32_t)((uint32_t)v1 << (v2 & 0x1F))); break;
+            case IR_SHR_I: IR_SHIFT(i, W_I, v1 >> (v2 & 0x1F)); break;
+            case IR_USHR_I: IR_SHIFT(i, W_I, (int32_t)((uint32_t)v1 >> (v2 & 0x1F))); break;
+            case IR_NEG_I: IR_UN(i, W_I, (int32_t)(0u - (uint32_t)v)); break;
+            case IR_ADDK_I: IR_UN(i, W_I, (int32_t)((uint32_t)v + (uint32_t)in.imm.i)); break;
+            case IR_MULK_I: IR_UN(i, W_I, (int32_t)((uint32_t)v * (uint32_t)in.imm.i)); break;
+            case IR_ANDK_I: IR_UN(i, W_I, v & in.imm.i); break;
+            case IR_ORK_I: IR_UN(i, W_I, v | in.imm.i); break;
+            case IR_XORK_I: IR_UN(i, W_I, v ^ in.imm.i); break;
+            case IR_SHLK_I: IR_UN(i, W_I, (int32_t)((uint32_t)v << in.imm.i)); break;
+            case IR_SHRK_I: IR_UN(i, W_I, v >> in.imm.i); break;
+            case IR_USHRK_I: IR_UN(i, W_I, (int32_t)((uint32_t)v >> in.imm.i)); break;
+
+            // ---- long ----
+            case IR_ADD_J: IR_BIN(l, W_J, (int64_t)((uint64_t)v1 + (uint64_t)v2)); break;
+            case IR_SUB_J: IR_BIN(l, W_J, (int64_t)((uint64_t)v1 - (uint64_t)v2)); break;
+            case IR_MUL_J: IR_BIN(l, W_J, (int64_t)((uint64_t)v1 * (uint64_t)v2)); break;
+            case IR_DIV_J:
+                if (J2ME_UNLIKELY(r[in.b].l == 0)) IR_THROW(ARITHMETIC);
+                IR_BIN(l, W_J, (v2 == -1) ? (int64_t)(0ull - (uint64_t)v1) : v1 / v2);
+                break;
+            case IR_REM_J:
+                if (J2ME_UNLIKELY(r[in.b].l == 0)) IR_THROW(ARITHMETIC);
+                IR_BIN(l, W_J, (v2 == -1) ? 0 : v1 % v2);
+                break;
+            case IR_AND_J: IR_BIN(l, W_J, v1 & v2); break;
+            case IR_OR_J: IR_BIN(l, W_J, v1 | v2); break;
+            case IR_XOR_J: IR_BIN(l, W_J, v1 ^ v2); break;
+            case IR_SHL_J: IR_SHIFT(l, W_J, (int64_t)((uint64_t)v1 << (v2 & 0x3F))); break;
+            case IR_SHR_J: IR_SHIFT(l, W_J, v1 >> (v2 & 0x3F)); break;
+            case IR_USHR_J: IR_SHIFT(l, W_J, (int64_t)((uint64_t)v1 >> (v2 & 0x3F))); break;
+            case IR_NEG_J: IR_UN(l, W_J, (int64_t)(0ull - (uint64_t)v)); break;
+
+            // ---- float / double ----
+            case IR_ADD_F: IR_BIN(f, W_F, v1 + v2); break;
+            case IR_SUB_F: IR_BIN(f, W_F, v1 - v2); break;
+            case IR_MUL_F: IR_BIN(f, W_F, v1 * v2); break;
+            case IR_DIV_F: IR_BIN(f, W_F, v1 / v2); break;
+            case IR_REM_F: IR_BIN(f, W_F, std::fmod(v1, v2)); break;
+            case IR_NEG_F: IR_UN(f, W_F, -v); break;
+            case IR_ADD_D: IR_BIN(d, W_D, v1 + v2); break;
+            case IR_SUB_D: IR_BIN(d, W_D, v1 - v2); break;
+            case IR_MUL_D: IR_BIN(d, W_D, v1 * v2); break;
+            case IR_DIV_D: IR_BIN(d, W_D, v1 / v2); break;
+            case IR_REM_D: IR_BIN(d, W_D, std::fmod(v1, v2)); break;
+            case IR_NEG_D: IR_UN(d, W_D, -v); break;
+
+            // ---- Conversions / 类型转换 ----
+            case IR_I2L: IR_UN(i, W_J, (int64_t)v); break;
+            case IR_I2F: IR_UN(i, W_F, (float)v); break;
+            case IR_I2D: IR_UN(i, W_D, (double)v); break;
+            case IR_L2I: IR_UN(l, W_I, (int32_t)v); break;
+            case IR_L2F: IR_UN(l, W_F, (float)v); break;
+            case IR_L2D: IR_UN(l, W_D, (double)v); break;
+            case IR_F2I: IR_UN(f, W_I, (int32_t)v); break;
+            case IR_F2L: IR_UN(f, W_J, (int64_t)v); break;
+            case IR_F2D: IR_UN(f, W_D, (double)v); break;
+            case IR_D2I: IR_UN(d, W_I, (int32_t)v); break;
+            case IR_D2L: IR_UN(d, W_J, (int64_t)v); break;
+            case IR_D2F: IR_UN(d, W_F, (float)v); break;
+            case IR_I2B: IR_UN(i, W_I, (int8_t)v); break;
+            case IR_I2C: IR_UN(i, W_I, (uint16_t)v); break;
+            case IR_I2S: IR_UN(i, W_I, (int16_t)v); break;
+
+            // ---- Comparisons and branches / 比较与跳转 ----
+            case IR_CMP_J: IR_BIN(l, W_I, (v1 > v2) ? 1 : ((v1 < v2) ? -1 : 0)); break;
+            case IR_CMPL_F: IR_BIN(f, W_I, compareFloating(v1, v2, -1)); break;
+            case IR_CMPG_F: IR_BIN(f, W_I, compareFloating(v1, v2, 1)); break;
+            case IR_CMPL_D: IR_BIN(d, W_I, compareFloating(v1, v2, -1)); break;
+            case IR_CMPG_D: IR_BIN(d, W_I, compareFloating(v1, v2, 1)); break;
+            case IR_IF_EQ: IR_IF(==); break;
+            case IR_IF_NE: IR_IF(!=); break;
+            case IR_IF_LT: IR_IF(<); break;
+            case IR_IF_GE: IR_IF(>=); break;
+            case IR_IF_GT: IR_IF(>); break;
+            case IR_IF_LE: IR_IF(<=); break;
+            case IR_IFK_EQ: IR_IFK(==); break;
+            case IR_IFK_NE: IR_IFK(!=); break;
+            case IR_IFK_LT: IR_IFK(<); break;
+            case IR_IFK_GE: IR_IFK(>=); break;
+            case IR_IFK_GT: IR_IFK(>); break;
+            case IR_IFK_LE: IR_IFK(<=); break;
+            case IR_IF_ACMPEQ: if (r[in.a].ref == r[in.b].ref) IR_JUMP(in.target); break;
+            case IR_IF_ACMPNE: if (r[in.a].ref != r[in.b].ref) IR_JUMP(in.target); break;
+            case IR_IF_NULL: if (r[in.a].ref == nullptr) IR_JUMP(in.target); break;
+            case IR_IF_NONNULL: if (r[in.a].ref != nullptr) IR_JUMP(in.target); break;
+            case IR_GOTO: IR_JUMP(in.target); break;
+            case IR_TABLESWITCH: {
+                const IRSwitch& sw = ir.switches[in.target];
+                int64_t index = (int64_t)r[in.a].i - sw.low;
+                IR_JUMP((index >= 0 && index < (int64_t)sw.targets.size()) ? sw.targets[index] : sw.defaultTarget);
+                break;
+            }
+            case IR_LOOKUPSWITCH: {
+                const IRSwitch& sw = ir.switches[in.target];
+                auto it = std::lower_bound(sw.keys.begin(), sw.keys.end(), r[in.a].i);
+                bool found = it != sw.keys.end() && *it == r[in.a].i;
+                IR_JUMP(found ? sw.targets[it - sw.keys.begin()] : sw.defaultTarget);
+                break;
+            }
+
+            // ---- Arrays / 数组 ----
+            case IR_ALOAD_I: IR_ARRAY_LOAD(int32_t, W_I, raw); break;
+            case IR_ALOAD_J: IR_ARRAY_LOAD(int64_t, W_J, raw); break;
+            case IR_ALOAD_F: {
+                float f;
+                IR_ARRAY_LOAD(int32_t, W_F, (std::memcpy(&f, &raw, sizeof(float)), f));
+                break;
+            }
+            case IR_ALOAD_D: {
+                double dv;
+                IR_ARRAY_LOAD(int64_t, W_D, (std::memcpy(&dv, &raw, sizeof(double)), dv));
+                break;
+            }
+            case IR_ALOAD_A: IR_ARRAY_LOAD(HeapRef, W_A, decodeRef(raw)); break;
+            case IR_ALOAD_B: IR_ARRAY_LOAD(int8_t, W_I, raw); break;
+            case IR_ALOAD_C: IR_ARRAY_LOAD(uint16_t, W_I, raw); break;
+            case IR_ALOAD_S: IR_ARRAY_LOAD(int16_t, W_I, raw); break;
+            case IR_ASTORE_I: IR_ARRAY_STORE(int32_t, value.i); break;
+            case IR_ASTORE_J: IR_ARRAY_STORE(int64_t, value.l); break;
+            case IR_ASTORE_F: {
+                int32_t bits;
+                IR_ARRAY_STORE(int32_t, (std::memcpy(&bits, &value.f, sizeof(float)), bits));
+                break;
+            }
+            case IR_ASTORE_D: {
+                int64_t bits;
+                IR_ARRAY_STORE(int64_t, (std::memcpy(&bits, &value.d, sizeof(double)), bits));
+                break;
+            }
+            case IR_ASTORE_A: IR_ARRAY_STORE(HeapRef, (markCard(arr), encodeRef((JavaObject*)value.ref))); break; // With the write barrier / 带写屏障
+            case IR_ASTORE_B: IR_ARRAY_STORE(int8_t, (int8_t)value.i); break;
+            case IR_ASTORE_C: IR_ARRAY_STORE(uint16_t, (uint16_t)value.i); break;
+            case IR_ASTORE_S: IR_ARRAY_STORE(int16_t, (int16_t)value.i); break;
+            case IR_ARRAYLENGTH: {
+                IR_BASE(arr);
+                W_I(in.dst, arr->arrayLength());
+                break;
+            }
+
+            // ---- Type checks / 类型检查 ----
+            case IR_CHECKCAST: {
+                JavaObject* obj = (JavaObject*)r[in.a].ref;
+                if (obj && obj->cls) {
+                    JavaClass* target = (JavaClass*)in.imm.ref;
+                    if (J2ME_UNLIKELY(!obj->cls->isAssignableTo(target))) {
+                        LOG_ERROR("ClassCastException: " + obj->cls->name + " cannot be cast to " + target->name);
+                        IR_THROW(CLASS_CAST);
+                    }
+                }
+                break;
+            }
+            case IR_INSTANCEOF: {
+                JavaObject* obj = (JavaObject*)r[in.a].ref;
+                JavaClass* target = (JavaClass*)in.imm.ref;
+                bool isInstance = obj && (obj->cls ? obj->cls->isAssignableTo(target) : target->isObjectClass);
+                W_I(in.dst, isInstance ? 1 : 0);
+                break;
+            }
+
+            // ---- Fields / 字段 ----
+            case IR_GETFIELD_I: IR_GETFIELD(FIELD_I, W_I, (int32_t)raw); break;
+            case IR_GETFIELD_J: IR_GETFIELD(FIELD_J, W_J, raw); break;
+            case IR_GETFIELD_F: {
+                float f; int32_t bits;
+                IR_GETFIELD(FIELD_F, W_F, (bits = (int32_t)raw, std::memcpy(&f, &bits, sizeof(float)), f));
+                break;
+            }
+            case IR_GETFIELD_D: {
+                double dv;
+                IR_GETFIELD(FIELD_D, W_D, (std::memcpy(&dv, &raw, sizeof(double)), dv));
+                break;
+            }
+            case IR_GETFIELD_A: IR_GETFIELD(FIELD_A, W_A, (void*)raw); break;
+            case IR_GETFIELD_B: IR_GETFIELD(FIELD_B, W_I, (int32_t)raw); break;
+            case IR_GETFIELD_C: IR_GETFIELD(FIELD_C, W_I, (int32_t)raw); break;
+            case IR_GETFIELD_S: IR_GETFIELD(FIELD_S, W_I, (int32_t)raw); break;
+            case IR_PUTFIELD_I: IR_PUTFIELD(FIELD_I, (int64_t)value.i); break;
+            case IR_PUTFIELD_J: IR_PUTFIELD(FIELD_J, value.l); break;
+            case IR_PUTFIELD_F: {
+                int32_t bits;
+                IR_PUTFIELD(FIELD_F, (std::memcpy(&bits, &value.f, sizeof(float)), (int64_t)bits));
+                break;
+            }
+            case IR_PUTFIELD_D: {
+                int64_t bits;
+                IR_PUTFIELD(FIELD_D, (std::memcpy(&bits, &value.d, sizeof(double)), bits));
+                break;
+            }
+            case IR_PUTFIELD_A: IR_PUTFIELD(FIELD_A, (int64_t)value.ref); break;
+            case IR_PUTFIELD_B: IR_PUTFIELD(FIELD_B, (int64_t)value.i); break;
+            case IR_PUTFIELD_C: IR_PUTFIELD(FIELD_C, (int64_t)value.i); break;
+            case IR_PUTFIELD_S: IR_PUTFIELD(FIELD_S, (int64_t)value.i); break;
+            case IR_GETSTATIC_I: IR_GETSTATIC(W_I, (int32_t)raw); break;
+            case IR_GETSTATIC_J: IR_GETSTATIC(W_J, raw); break;
+            case IR_GETSTATIC_F: {
+                float f; int32_t bits;
+                IR_GETSTATIC(W_F, (bits = (int32_t)raw, std::memcpy(&f, &bits, sizeof(float)), f));
+                break;
+            }
+            case IR_GETSTATIC_D: {
+                double dv;
+                IR_GETSTATIC(W_D, (std::memcpy(&dv, &raw, sizeof(double)), dv));
+                break;
+            }
+            case IR_GETSTATIC_A: IR_GETSTATIC(W_A, (void*)raw); break;
+            case IR_PUTSTATIC_I: IR_PUTSTATIC((int64_t)value.i); break;
+            case IR_PUTSTATIC_J: IR_PUTSTATIC(value.l); break;
+            case IR_PUTSTATIC_F: {
+                int32_t bits;
+                IR_PUTSTATIC((std::memcpy(&bits, &value.f, sizeof(float)), (int64_t)bits));
+                break;
+            }
+            case IR_PUTSTATIC_D: {
+                int64_t bits;
+                IR_PUTSTATIC((std::memcpy(&bits, &value.d, sizeof(double)), bits));
+                break;
+            }
+            case IR_PUTSTATIC_A: IR_PUTSTATIC((int64_t)value.ref); break;
+
+            // ---- Returns / 返回 ----
+            case IR_RETURN: case IR_RETURN_I: case IR_RETURN_J: case IR_RETURN_F: case IR_RETURN_D: case IR_RETURN_A:
+                returnFromIR(thread, in, r);
+                return true;
+
+            default:
+                frame->pc = in.pc;
+                frame->stackTop = 0;
+                throw std::runtime_error("Invalid IR instruction");
+        }
+    }
+
+#undef IR_LOAD
+#undef IR_THROW
+#undef IR_JUMP
+#undef W_I
+#undef W_F
+#undef W_A
+#undef W_J
+#undef W_D
+#undef IR_BIN
+#undef IR_SHIFT
+#undef IR_UN
+#undef IR_IF
+#undef IR_IFK
+#undef IR_BASE
+#undef IR_ARRAY_LOAD
+#undef IR_ARRAY_STORE
+#undef IR_GETFIELD
+#undef IR_PUTFIELD
+#undef IR_GETSTATIC
+#undef IR_PUTSTATIC
+}
+
+void Interpreter::dropCompiledCode(const JavaClass& cls) {
+    if (!cls.rawFile) return;
+    for (const auto& method : cls.rawFile->methods) {
+        if (!method.runtime) continue;
+        // Frames already running the IR or its machine code hold their own reference (see runTier2)
+        // 正在执行 IR 或其机器码的栈帧持有自己的引用 (见 runTier2)
+        method.runtime->ir.reset();
+        method.runtime->irFailed = false;
+        method.runtime->jit.reset();
+        method.runtime->jitFailed = false;
+        method.runtime->hotness = 0;
+    }
+}
+
+} // namespace core
+} // namespace j2me
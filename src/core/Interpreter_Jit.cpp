@@ -0,0 +1,123 @@
+#include "Interpreter.hpp"
+#include "RegisterIR.hpp"
+#include "JitX64.hpp"
+#include "HeapManager.hpp"
+#include "Logger.hpp"
+
+// 基线 JIT 的运行时部分 (Runtime side of the baseline JIT)
+//
+// 热度达到 JIT 阈值的方法由 JitCode 将其寄存器 IR 编译为 x86-64 机器码。机器码遇到调用、对象分配、
+// 类初始化或异常时返回 (JitExit)，这里负责处理这些退出并在可能时重新进入机器码。
+// 机器码直接读写解释器的栈帧，因此 handleException 的栈回溯、GC 扫描等均无需改动。
+//
+// Methods past the JIT threshold have their register IR compiled to x86-64 code by
+// JitCode. The code returns (JitExit) for calls, allocation, class initialization and
+// exceptions; this file handles those exits and re-enters the code where it can. The
+// code runs on the interpreter's own frames, so stack traces in handleException, GC
+// scanning etc. need no changes.
+
+namespace j2me {
+namespace core {
+
+namespace {
+
+// Type check helpers called from machine code; they never throw
+// 机器码调用的类型检查辅助函数，不会抛出异常
+int32_t jitIsInstance(void* object, void* cls) {
+    JavaObject* obj = (JavaObject*)object;
+    JavaClass* target = (JavaClass*)cls;
+    return (obj && (obj->cls ? obj->cls->isAssignableTo(target) : target->isObjectClass)) ? 1 : 0;
+}
+
+int32_t jitCanCast(void* object, void* cls) {
+    JavaObject* obj = (JavaObject*)object;
+    return (!obj->cls || obj->cls->isAssignableTo((JavaClass*)cls)) ? 1 : 0;
+}
+
+} // namespace
+
+std::shared_ptr<JitCode> Interpreter::compileJit(const IRMethod& ir) {
+    static const JitRuntime runtime = [] {
+        JitRuntime r;
+        JavaClass probe(std::make_shared<ClassFile>());
+        r.instanceSizeOffset = (size_t)((const char*)&probe.instanceSize - (const char*)&probe);
+        r.isInstance = &jitIsInstance;
+        r.canCast = &jitCanCast;
+        r.heapBase = HeapManager::getInstance().regionBase();
+        r.cardTable = cardTableBase;
+        return r;
+    }();
+    std::shared_ptr<JitCode> jit = JitCode::compile(ir, runtime);
+    if (jit) {
+        LOG_DEBUG("[JIT] Compiled " + std::to_string(ir.code.size()) + " IR insns into " +
+                  std::to_string(jit->codeSize()) + " bytes");
+    } else {
+        LOG_DEBUG("[JIT] Machine code unavailable, staying on the IR tier");
+    }
+    return jit;
+}
+
+bool Interpreter::executeJit(const std::shared_ptr<JavaThread>& threadPtr, const std::shared_ptr<StackFrame>& framePtr,
+                             const IRMethod& ir, const JitCode& jit, uint32_t ip, int budget, int& executed) {
+    JavaThread* thread = threadPtr.get();
+    StackFrame* frame = framePtr.get();
+    JitContext context;
+    for (;;) {
+        frame->reserveMaxStack();
+        int allowed = budget - executed;
+        context.budget = allowed;
+        int32_t reason = jit.run(context, frame->slots, frame->tags, ip);
+        executed += allowed - context.budget;
+
+        if (reason == JIT_EXIT_BUDGET) {
+            const IRLabel& label = ir.labels[context.label];
+            frame->pc = label.pc;
+            frame->stackTop = label.depth;
+            return true;
+        }
+
+        const IRInsn& in = ir.code[context.insn];
+        executed++;
+        switch (reason) {
+            case JIT_EXIT_SLOW: {
+                bool resume = false;
+                if (!runSlowInsn(threadPtr, framePtr, ir, in, executed < budget, resume)) return false;
+                if (!resume) return true;
+                ip = ir.labels[in.target].index;
+                break;
+            }
+            case JIT_EXIT_RETURN:
+                returnFromIR(thread, in, frame->slots);
+                return true;
+            default: {
+                // Same exceptions as the other tiers, raised without a C++ throw; the
+                // operand stack is discarded by the unwind
+                // 与其他执行层相同的异常，不经过 C++ 异常直接抛出; 操作数栈会在异常展开时丢弃
+                RuntimeExceptionKind kind;
+                switch (reason) {
+                    case JIT_EXIT_NULL_POINTER: kind = RuntimeExceptionKind::NULL_POINTER; break;
+                    case JIT_EXIT_INDEX_BOUNDS: kind = RuntimeExceptionKind::ARRAY_INDEX; break;
+                    case JIT_EXIT_DIVIDE_BY_ZERO: kind = RuntimeExceptionKind::ARITHMETIC; break;
+                    case JIT_EXIT_FIELD_BOUNDS: kind = RuntimeExceptionKind::RUNTIME; break;
+                    case JIT_EXIT_CLASS_CAST: {
+                        JavaObject* obj = (JavaObject*)frame->slots[in.a].ref;
+                        JavaClass* target = (JavaClass*)in.imm.ref;
+                        LOG_ERROR("ClassCastException: " + obj->cls->name + " cannot be cast to " + target->name);
+                        kind = RuntimeExceptionKind::CLASS_CAST;
+                        break;
+                    }
+                    default:
+                        frame->pc = in.pc;
+                        frame->stackTop = 0;
+                        throw std::runtime_error("Invalid JIT exit");
+                }
+                frame->pc = in.pc;
+                frame->stackTop = 0;
+                return raiseRuntimeException(threadPtr, kind);
+            }
+        }
+    }
+}
+
+} // namespace core
+} // namespace j2me
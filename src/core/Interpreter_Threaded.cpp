@@ -0,0 +1,926 @@
+#include "Interpreter.hpp"
+#include "Opcodes.hpp"
+#include "EventLoop.hpp"
+#include "Logger.hpp"
+#include <cmath>
+#include <cstring>
+
+// 直接线索化解释器 (Direct-threaded interpreter)
+//
+// 与 executeTable 不同，这里的热点指令直接内联在一个函数中执行:
+//   - pc / 栈顶指针 / 局部变量表指针保存在局部变量 (寄存器) 中
+//   - GCC/Clang 下使用 computed goto (标签地址表)，其他编译器退化为 switch
+//   - 热路径上没有 shared_ptr 引用计数，也没有 std::function 调用
+// 其余指令 (调用、字段访问、对象创建等) 回落到 instructionTable 中的原有实现，
+// 调用前后同步 frame->pc 和栈顶。
+//
+// Hot opcodes are executed inline with pc, stack pointer and locals cached in
+// locals of this function. Everything else falls back to the instructionTable
+// handlers with the frame state synced before and reloaded after the call.
+
+// -DJ2ME_COMPUTED_GOTO=0 forces the portable switch loop
+// 可通过 -DJ2ME_COMPUTED_GOTO=0 强制使用 switch 版本
+#ifndef J2ME_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define J2ME_COMPUTED_GOTO 1
+#else
+#define J2ME_COMPUTED_GOTO 0
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define J2ME_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define J2ME_UNLIKELY(x) (x)
+#endif
+
+namespace j2me {
+namespace core {
+
+// Opcodes executed inline by the threaded loop. Anything not listed here goes
+// through instructionTable.
+// 快速循环内联执行的指令列表，未列出的指令通过 instructionTable 执行
+#define J2ME_THREADED_OPCODES(X) \
+    X(OP_NOP) X(OP_ACONST_NULL) \
+    X(OP_ICONST_M1) X(OP_ICONST_0) X(OP_ICONST_1) X(OP_ICONST_2) X(OP_ICONST_3) X(OP_ICONST_4) X(OP_ICONST_5) \
+    X(OP_LCONST_0) X(OP_LCONST_1) X(OP_FCONST_0) X(OP_FCONST_1) X(OP_FCONST_2) X(OP_DCONST_0) X(OP_DCONST_1) \
+    X(OP_BIPUSH) X(OP_SIPUSH) \
+    X(OP_ILOAD) X(OP_LLOAD) X(OP_FLOAD) X(OP_DLOAD) X(OP_ALOAD) \
+    X(OP_ILOAD_0) X(OP_ILOAD_1) X(OP_ILOAD_2) X(OP_ILOAD_3) \
+    X(OP_LLOAD_0) X(OP_LLOAD_1) X(OP_LLOAD_2) X(OP_LLOAD_3) \
+    X(OP_FLOAD_0) X(OP_FLOAD_1) X(OP_FLOAD_2) X(OP_FLOAD_3) \
+    X(OP_DLOAD_0) X(OP_DLOAD_1) X(OP_DLOAD_2) X(OP_DLOAD_3) \
+    X(OP_ALOAD_0) X(OP_ALOAD_1) X(OP_ALOAD_2) X(OP_ALOAD_3) \
+    X(OP_IALOAD) X(OP_LALOAD) X(OP_FALOAD) X(OP_DALOAD) X(OP_AALOAD) X(OP_BALOAD) X(OP_CALOAD) X(OP_SALOAD) \
+    X(OP_ISTORE) X(OP_LSTORE) X(OP_FSTORE) X(OP_DSTORE) X(OP_ASTORE) \
+    X(OP_ISTORE_0) X(OP_ISTORE_1) X(OP_ISTORE_2) X(OP_ISTORE_3) \
+    X(OP_LSTORE_0) X(OP_LSTORE_1) X(OP_LSTORE_2) X(OP_LSTORE_3) \
+    X(OP_FSTORE_0) X(OP_FSTORE_1) X(OP_FSTORE_2) X(OP_FSTORE_3) \
+    X(OP_DSTORE_0) X(OP_DSTORE_1) X(OP_DSTORE_2) X(OP_DSTORE_3) \
+    X(OP_ASTORE_0) X(OP_ASTORE_1) X(OP_ASTORE_2) X(OP_ASTORE_3) \
+    X(OP_IASTORE) X(OP_LASTORE) X(OP_FASTORE) X(OP_DASTORE) X(OP_AASTORE) X(OP_BASTORE) X(OP_CASTORE) X(OP_SASTORE) \
+    X(OP_POP) X(OP_POP2) X(OP_DUP) X(OP_DUP_X1) X(OP_DUP_X2) X(OP_DUP2) X(OP_DUP2_X1) X(OP_DUP2_X2) X(OP_SWAP) \
+    X(OP_IADD) X(OP_LADD) X(OP_FADD) X(OP_DADD) X(OP_ISUB) X(OP_LSUB) X(OP_FSUB) X(OP_DSUB) \
+    X(OP_IMUL) X(OP_LMUL) X(OP_FMUL) X(OP_DMUL) X(OP_IDIV) X(OP_LDIV) X(OP_FDIV) X(OP_DDIV) \
+    X(OP_IREM) X(OP_LREM) X(OP_FREM) X(OP_DREM) X(OP_INEG) X(OP_LNEG) X(OP_FNEG) X(OP_DNEG) \
+    X(OP_ISHL) X(OP_LSHL) X(OP_ISHR) X(OP_LSHR) X(OP_IUSHR) X(OP_LUSHR) \
+    X(OP_IAND) X(OP_LAND) X(OP_IOR) X(OP_LOR) X(OP_IXOR) X(OP_LXOR) X(OP_IINC) \
+    X(OP_I2L) X(OP_I2F) X(OP_I2D) X(OP_L2I) X(OP_L2F) X(OP_L2D) X(OP_F2I) X(OP_F2L) X(OP_F2D) \
+    X(OP_D2I) X(OP_D2L) X(OP_D2F) X(OP_I2B) X(OP_I2C) X(OP_I2S) \
+    X(OP_LCMP) X(OP_FCMPL) X(OP_FCMPG) X(OP_DCMPL) X(OP_DCMPG) \
+    X(OP_IFEQ) X(OP_IFNE) X(OP_IFLT) X(OP_IFGE) X(OP_IFGT) X(OP_IFLE) \
+    X(OP_IF_ICMPEQ) X(OP_IF_ICMPNE) X(OP_IF_ICMPLT) X(OP_IF_ICMPGE) X(OP_IF_ICMPGT) X(OP_IF_ICMPLE) \
+    X(OP_IF_ACMPEQ) X(OP_IF_ACMPNE) X(OP_IFNULL) X(OP_IFNONNULL) \
+    X(OP_GOTO) X(OP_GOTO_W) X(OP_TABLESWITCH) X(OP_LOOKUPSWITCH) \
+    X(OP_IRETURN) X(OP_LRETURN) X(OP_FRETURN) X(OP_DRETURN) X(OP_ARETURN) X(OP_RETURN) \
+    X(OP_ARRAYLENGTH) \
+    X(OP_GETFIELD_QUICK_I) X(OP_GETFIELD_QUICK_J) X(OP_GETFIELD_QUICK_F) X(OP_GETFIELD_QUICK_D) X(OP_GETFIELD_QUICK_A) \
+    X(OP_PUTFIELD_QUICK_I) X(OP_PUTFIELD_QUICK_J) X(OP_PUTFIELD_QUICK_F) X(OP_PUTFIELD_QUICK_D) X(OP_PUTFIELD_QUICK_A) \
+    X(OP_GETSTATIC_QUICK_I) X(OP_GETSTATIC_QUICK_J) X(OP_GETSTATIC_QUICK_F) X(OP_GETSTATIC_QUICK_D) X(OP_GETSTATIC_QUICK_A) \
+    X(OP_PUTSTATIC_QUICK_I) X(OP_PUTSTATIC_QUICK_J) X(OP_PUTSTATIC_QUICK_F) X(OP_PUTSTATIC_QUICK_D) X(OP_PUTSTATIC_QUICK_A) \
+    X(OP_CHECKCAST_QUICK) X(OP_INSTANCEOF_QUICK)
+
+namespace {
+
+inline int16_t readS2(const uint8_t* p) { return (int16_t)((p[0] << 8) | p[1]); }
+inline int32_t readS4(const uint8_t* p) { return (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]); }
+
+// Duplicate the top N slots and insert the copies K slots further down
+// (DUP = <1,0>, DUP_X1 = <1,1>, DUP2_X2 = <2,2> ...). Works on raw slots, so the
+// long/double forms of the DUP2 family need no special casing.
+// 复制栈顶 N 个槽位并插入到其下方 K 个槽位处; 按槽位操作，DUP2 系列无需区分 long/double
+template <int N, int K>
+inline void dupInsert(Slot* sp, uint8_t* tp) {
+    for (int i = -1; i >= -(N + K); i--) { sp[i + N] = sp[i]; tp[i + N] = tp[i]; }
+    for (int j = 0; j < N; j++) { sp[j - N - K] = sp[j]; tp[j - N - K] = tp[j]; }
+}
+
+template <typename T>
+inline int32_t compareFloating(T v1, T v2, int32_t nanResult) {
+    if (std::isnan(v1) || std::isnan(v2)) return nanResult;
+    if (v1 > v2) return 1;
+    if (v1 < v2) return -1;
+    return 0;
+}
+
+// Operands of the instructions inside a superinstruction (see Instructions_Super.cpp).
+// For the replaced first instruction `op` is a constant, so these fold away.
+// 超级指令内部各条指令的操作数 (见 Instructions_Super.cpp); 对被替换的首条指令 op 为常量，可在编译期求值
+
+// Local of an xLOAD/xSTORE, indexed form or one of the _0.._3 forms
+// xLOAD/xSTORE 访问的局部变量 (带下标形式或 _0.._3 形式)
+inline uint32_t localIndex(const uint8_t* p, uint8_t op, uint8_t indexed, uint8_t form0) {
+    return op == indexed ? p[1] : (uint32_t)(op - form0);
+}
+inline int localLength(uint8_t op, uint8_t indexed) { return op == indexed ? 2 : 1; }
+
+// ICONST_M1..ICONST_5, BIPUSH or SIPUSH
+inline int32_t intConstant(const uint8_t* p, int& length) {
+    switch (*p) {
+        case OP_BIPUSH: length = 2; return (int8_t)p[1];
+        case OP_SIPUSH: length = 3; return readS2(p + 1);
+        default: length = 1; return (int32_t)*p - OP_ICONST_0;
+    }
+}
+
+// The int operations that may be fused (none of them can throw)
+// 可参与融合的 int 运算 (均不会抛出异常)
+inline int32_t intBinary(uint8_t op, int32_t v1, int32_t v2) {
+    switch (op) {
+        case OP_IADD: return (int32_t)((uint32_t)v1 + (uint32_t)v2);
+        case OP_ISUB: return (int32_t)((uint32_t)v1 - (uint32_t)v2);
+        case OP_IMUL: return (int32_t)((uint32_t)v1 * (uint32_t)v2);
+        case OP_IAND: return v1 & v2;
+        case OP_IOR: return v1 | v2;
+        case OP_ISHL: return (int32_t)((uint32_t)v1 << (v2 & 0x1F));
+        case OP_ISHR: return v1 >> (v2 & 0x1F);
+        case OP_IUSHR: return (int32_t)((uint32_t)v1 >> (v2 & 0x1F));
+        default: return v1 ^ v2; // OP_IXOR
+    }
+}
+
+// Condition of IF_ICMPxx / IFxx, as an offset from IF_ICMPEQ / IFEQ (EQ NE LT GE GT LE)
+// IF_ICMPxx / IFxx 的条件，以相对 IF_ICMPEQ / IFEQ 的偏移表示
+inline bool intCondition(int cond, int32_t v1, int32_t v2) {
+    switch (cond) {
+        case 0: return v1 == v2;
+        case 1: return v1 != v2;
+        case 2: return v1 < v2;
+        case 3: return v1 >= v2;
+        case 4: return v1 > v2;
+        default: return v1 <= v2;
+    }
+}
+
+} // namespace
+
+int Interpreter::executeThreaded(std::shared_ptr<JavaThread> threadPtr, int instructions) {
+    JavaThread* thread = threadPtr.get();
+    int executed = 0;
+    RuntimeExceptionKind pendingException = RuntimeExceptionKind::RUNTIME;
+
+#if J2ME_COMPUTED_GOTO
+    static void* labels[256];
+    static bool labelsReady = false;
+    if (!labelsReady) {
+        for (int i = 0; i < 256; i++) labels[i] = &&L_SLOW;
+#define J2ME_REGISTER_LABEL(op) labels[op] = &&L_##op;
+        J2ME_THREADED_OPCODES(J2ME_REGISTER_LABEL)
+#undef J2ME_REGISTER_LABEL
+#define J2ME_SUPERINSTRUCTION(name, family, first) labels[OP_SI_##name] = &&L_OP_SI_##name;
+#include "Superinstructions.def"
+#undef J2ME_SUPERINSTRUCTION
+        labelsReady = true;
+    }
+#endif
+
+    while (executed < instructions && !thread->isFinished()) {
+        if (thread->state != JavaThread::RUNNABLE) break;
+
+        if (EventLoop::getInstance().shouldExit()) {
+            // 处理退出请求
+            // Handle exit
+            return executed;
+        }
+
+        // Hold a reference for as long as the cached pointers below are in use
+        // 持有引用，保证下面缓存的裸指针在使用期间有效
+        std::shared_ptr<StackFrame> framePtr = thread->currentFrame();
+        if (!framePtr) break;
+        StackFrame* frame = framePtr.get();
+
+        if (frame->code.empty()) {
+            // 如果代码为空 (例如 native 或 abstract 方法)，弹出栈帧
+            thread->popFrame();
+            continue;
+        }
+
+        // Hot methods run on the register IR tier (or as JIT code) while they are at a point it can enter;
+        // methods with AOT code do so from the first call
+        // 热点方法在 IR 可进入的位置交给寄存器 IR 层 (或 JIT 机器码) 执行; 有 AOT 代码的方法从第一次调用起即如此
+        if (frame->runtime->hotness >= tierUpThreshold || frame->runtime->jit) {
+            bool keepRunning = true;
+            int ran = runTier2(threadPtr, framePtr, instructions - executed, keepRunning);
+            if (ran >= 0) {
+                executed += ran;
+                if (!keepRunning) return executed;
+                continue;
+            }
+        }
+
+        // max_stack bounds the operand stack depth, so the inline pushes below
+        // never need to check for overflow.
+        // max_stack 是操作数栈深度的上界，因此内联的压栈操作无需检查溢出
+        frame->reserveMaxStack();
+
+        const uint8_t* const code = frame->code.data();
+        const uint8_t* pc = code + frame->pc;
+        Slot* locals;           // 局部变量槽位
+        uint8_t* localTags;     // 局部变量类型标记
+        Slot* stackBase;        // 操作数栈底
+        Slot* sp;               // 栈顶 (下一个空闲槽位)
+        uint8_t* tp;            // 与 sp 对应的类型标记指针
+        int budget = instructions - executed;
+
+// (Re)load the cached registers from the frame
+// 从栈帧加载缓存的寄存器状态
+#define LOAD_STATE() do { \
+            locals = frame->slots; \
+            localTags = frame->tags; \
+            stackBase = locals + frame->localCount; \
+            sp = stackBase + frame->stackTop; \
+            tp = localTags + frame->localCount + frame->stackTop; \
+        } while (0)
+// Write the cached registers back into the frame
+// 将缓存的寄存器状态写回栈帧
+#define SYNC_STATE() do { frame->pc = (uint32_t)(pc - code); frame->stackTop = (size_t)(sp - stackBase); } while (0)
+
+        LOAD_STATE();
+
+#if J2ME_COMPUTED_GOTO
+#define CASE(op) L_##op:
+#define DISPATCH_NEXT() goto *labels[*pc]
+#else
+#define CASE(op) case op:
+#define DISPATCH_NEXT() goto dispatch
+#endif
+
+// Finish the current instruction (length n) and dispatch the next one
+// 完成当前指令 (长度为 n) 并分派下一条
+#define NEXT(n) do { pc += (n); if (J2ME_UNLIKELY(--budget <= 0)) goto leave_frame; DISPATCH_NEXT(); } while (0)
+// Backward branches count towards the method's hotness (see tier_up below)
+// 向后跳转计入方法热度 (见下方 tier_up)
+#define BRANCH(off) do { \
+            int32_t o_ = (off); \
+            pc += o_; \
+            if (J2ME_UNLIKELY(o_ <= 0) && J2ME_UNLIKELY(++frame->runtime->hotness == tierUpThreshold)) goto tier_up; \
+            if (J2ME_UNLIKELY(--budget <= 0)) goto leave_frame; \
+            DISPATCH_NEXT(); \
+        } while (0)
+// Runtime exceptions leave through raise_exception below, without a C++ throw
+// 运行时异常经由下方的 raise_exception 抛出，不使用 C++ 异常
+#define THROW(kind) do { SYNC_STATE(); pendingException = RuntimeExceptionKind::kind; goto raise_exception; } while (0)
+
+// Push a typed value; long/double take two slots (value + SLOT_TOP)
+// 压入带类型的值; long/double 占两个槽位 (值 + SLOT_TOP)
+#define PUSH_I(x) do { int32_t v_ = (x); sp->i = v_; *tp = JavaValue::INT; sp++; tp++; } while (0)
+#define PUSH_F(x) do { float v_ = (x); sp->f = v_; *tp = JavaValue::FLOAT; sp++; tp++; } while (0)
+#define PUSH_A(x) do { void* v_ = (x); sp->ref = v_; *tp = JavaValue::REFERENCE; sp++; tp++; } while (0)
+#define PUSH_J(x) do { int64_t v_ = (x); sp->l = v_; tp[0] = JavaValue::LONG; tp[1] = SLOT_TOP; sp += 2; tp += 2; } while (0)
+#define PUSH_D(x) do { double v_ = (x); sp->d = v_; tp[0] = JavaValue::DOUBLE; tp[1] = SLOT_TOP; sp += 2; tp += 2; } while (0)
+#define DROP(n) do { sp -= (n); tp -= (n); } while (0)
+
+// Array access helpers: sp[-2] = arrayref, sp[-1] = index (loads);
+// stores take a value of `width` slots on top. `type` is the element storage type.
+// 数组访问辅助宏 (存储时栈顶为 width 个槽位的值)，type 为元素的存储类型
+#define ARRAY_LOAD(type, push, conv) do { \
+            int32_t index = sp[-1].i; \
+            JavaObject* arr = (JavaObject*)sp[-2].ref; \
+            if (J2ME_UNLIKELY(arr == nullptr)) THROW(NULL_POINTER); \
+            if (J2ME_UNLIKELY(index < 0 || index >= arr->arrayLength())) THROW(ARRAY_INDEX); \
+            type raw = arr->elements<type>()[index]; \
+            DROP(2); \
+            push(conv); \
+            NEXT(1); \
+        } while (0)
+#define ARRAY_STORE(type, width, expr) do { \
+            int32_t index = sp[-(width) - 1].i; \
+            JavaObject* arr = (JavaObject*)sp[-(width) - 2].ref; \
+            if (J2ME_UNLIKELY(arr == nullptr)) THROW(NULL_POINTER); \
+            if (J2ME_UNLIKELY(index < 0 || index >= arr->arrayLength())) THROW(ARRAY_INDEX); \
+            const Slot& value = sp[-(width)]; \
+            arr->elements<type>()[index] = (expr); \
+            DROP((width) + 2); \
+            NEXT(1); \
+        } while (0)
+// width = slots per operand (1 for int/float, 2 for long/double)
+// width 为每个操作数占用的槽位数
+#define BINARY_OP(field, width, push, expr) do { \
+            auto v2 = sp[-(width)].field; auto v1 = sp[-2 * (width)].field; \
+            DROP(2 * (width)); push(expr); \
+            NEXT(1); \
+        } while (0)
+#define SHIFT_OP(field, width, push, expr) do { \
+            int32_t v2 = sp[-1].i; auto v1 = sp[-1 - (width)].field; \
+            DROP(1 + (width)); push(expr); \
+            NEXT(1); \
+        } while (0)
+#define UNARY_OP(field, width, push, expr) do { auto v = sp[-(width)].field; DROP(width); push(expr); NEXT(1); } while (0)
+#define IF_CMP0(cond) do { int32_t v = sp[-1].i; DROP(1); if (v cond 0) BRANCH(readS2(pc + 1)); NEXT(3); } while (0)
+#define IF_ICMP(cond) do { int32_t v2 = sp[-1].i; int32_t v1 = sp[-2].i; DROP(2); if (v1 cond v2) BRANCH(readS2(pc + 1)); NEXT(3); } while (0)
+#define LOAD_LOCAL(push, field, idx, len) do { push(locals[(idx)].field); NEXT(len); } while (0)
+#define STORE_LOCAL(tag, idx, len) do { \
+            uint8_t t_ = (tag); size_t i_ = (idx); DROP(1); locals[i_] = *sp; localTags[i_] = t_; \
+            NEXT(len); \
+        } while (0)
+#define STORE_LOCAL2(tag, idx, len) do { \
+            size_t i_ = (idx); DROP(2); locals[i_] = *sp; localTags[i_] = (tag); localTags[i_ + 1] = SLOT_TOP; \
+            NEXT(len); \
+        } while (0)
+// Quick field access: the operand is the field's byte offset and FieldKind (instance,
+// `kindExpr` is the kind, constant except for the _I forms; bounds-checked by
+// JavaObject::hasField) or the staticFieldCache index (static)
+// 快速字段访问: 操作数为实例字段的字节偏移与 FieldKind (kindExpr 为存储类型，仅 _I 形式需从操作数读取;
+// 由 JavaObject::hasField 检查边界)，或静态字段缓存索引
+#define QUICK_GETFIELD(kindExpr, push, conv) do { \
+            uint16_t operand = (uint16_t)((pc[1] << 8) | pc[2]); \
+            size_t offset = quickFieldOffset(operand); \
+            uint8_t fieldKind = (kindExpr); \
+            JavaObject* obj = (JavaObject*)sp[-1].ref; \
+            if (J2ME_UNLIKELY(obj == nullptr)) THROW(NULL_POINTER); \
+            if (J2ME_UNLIKELY(!obj->hasField(offset, fieldKind))) THROW(RUNTIME); \
+            int64_t raw = obj->loadField(offset, fieldKind); \
+            DROP(1); \
+            push(conv); \
+            NEXT(3); \
+        } while (0)
+#define QUICK_PUTFIELD(kindExpr, width, rawExpr) do { \
+            uint16_t operand = (uint16_t)((pc[1] << 8) | pc[2]); \
+            size_t offset = quickFieldOffset(operand); \
+            uint8_t fieldKind = (kindExpr); \
+            JavaObject* obj = (JavaObject*)sp[-(width) - 1].ref; \
+            if (J2ME_UNLIKELY(obj == nullptr)) THROW(NULL_POINTER); \
+            if (J2ME_UNLIKELY(!obj->hasField(offset, fieldKind))) THROW(RUNTIME); \
+            const Slot& value = sp[-(width)]; \
+            obj->storeField(offset, fieldKind, (rawExpr)); \
+            DROP((width) + 1); \
+            NEXT(3); \
+        } while (0)
+#define QUICK_GETSTATIC(push, conv) do { \
+            int64_t raw = *staticFieldCache[(pc[1] << 8) | pc[2]].slot; \
+            push(conv); \
+            NEXT(3); \
+        } while (0)
+#define QUICK_PUTSTATIC(width, rawExpr) do { \
+            const Slot& value = sp[-(width)]; \
+            *staticFieldCache[(pc[1] << 8) | pc[2]].slot = (rawExpr); \
+            DROP(width); \
+            NEXT(3); \
+        } while (0)
+
+// Superinstructions (see Instructions_Super.cpp). `first` is the constant opcode the
+// superinstruction replaced and q walks the instructions after it. A fused sequence
+// counts as all of its instructions against the budget, and a fault inside it is raised
+// at the pc of the instruction that caused it, with that instruction's operands pushed.
+// 超级指令 (见 Instructions_Super.cpp)。first 为被替换的首条操作码 (常量)，q 依次指向其后的指令。
+// 融合序列按其包含的指令数计入预算; 序列内部出错时，在出错指令的 pc 处抛出，栈上为该指令的操作数
+#define NEXT_FUSED(n, count) do { budget -= (count) - 1; NEXT(n); } while (0)
+#define FUSED_LOAD_GETFIELD(first) do { \
+            const uint8_t* q = pc + localLength((first), OP_ALOAD); \
+            JavaObject* obj = (JavaObject*)locals[localIndex(pc, (first), OP_ALOAD, OP_ALOAD_0)].ref; \
+            uint8_t getOp = *q; \
+            if (getOp == OP_GETFIELD_QUICK_I || getOp == OP_GETFIELD_QUICK_A) { \
+                uint16_t operand = (uint16_t)((q[1] << 8) | q[2]); \
+                size_t offset = quickFieldOffset(operand); \
+                uint8_t fieldKind = getOp == OP_GETFIELD_QUICK_I ? quickFieldKind(operand) : (uint8_t)FIELD_A; \
+                if (J2ME_UNLIKELY(obj == nullptr || !obj->hasField(offset, fieldKind))) { \
+                    PUSH_A(obj); pc = q; \
+                    if (obj) THROW(RUNTIME); \
+                    THROW(NULL_POINTER); \
+                } \
+                int64_t raw = obj->loadField(offset, fieldKind); \
+                if (getOp == OP_GETFIELD_QUICK_I) PUSH_I((int32_t)raw); else PUSH_A((void*)raw); \
+                NEXT_FUSED(q + 3 - pc, 2); \
+            } \
+            /* GETFIELD not quickened yet, or of another kind: it runs on its own */ \
+            PUSH_A(obj); \
+            NEXT(q - pc); \
+        } while (0)
+// ILOAD first; second int operand (ILOAD or constant); q left at the third instruction
+// 首条为 ILOAD; 第二个 int 操作数 (ILOAD 或常量); q 停在第三条指令处
+#define FUSED_INT_OPERANDS(first, constant) \
+            const uint8_t* q = pc + localLength((first), OP_ILOAD); \
+            int32_t v1 = locals[localIndex(pc, (first), OP_ILOAD, OP_ILOAD_0)].i; \
+            int32_t v2; \
+            if (constant) { int len_; v2 = intConstant(q, len_); q += len_; } \
+            else { v2 = locals[localIndex(q, *q, OP_ILOAD, OP_ILOAD_0)].i; q += localLength(*q, OP_ILOAD); }
+#define FUSED_INT_BINARY(first, constant) do { \
+            FUSED_INT_OPERANDS(first, constant) \
+            PUSH_I(intBinary(*q, v1, v2)); \
+            NEXT_FUSED(q + 1 - pc, 3); \
+        } while (0)
+#define FUSED_INT_COMPARE(first, constant) do { \
+            FUSED_INT_OPERANDS(first, constant) \
+            if (intCondition(*q - OP_IF_ICMPEQ, v1, v2)) { budget -= 2; pc = q; BRANCH(readS2(q + 1)); } \
+            NEXT_FUSED(q + 3 - pc, 3); \
+        } while (0)
+#define FUSED_ILOAD_ILOAD_IBIN(first) FUSED_INT_BINARY(first, false)
+#define FUSED_ILOAD_CONST_IBIN(first) FUSED_INT_BINARY(first, true)
+#define FUSED_ILOAD_ILOAD_ICMP(first) FUSED_INT_COMPARE(first, false)
+#define FUSED_ILOAD_CONST_ICMP(first) FUSED_INT_COMPARE(first, true)
+#define FUSED_ILOAD_IFZ(first) do { \
+            const uint8_t* q = pc + localLength((first), OP_ILOAD); \
+            int32_t v = locals[localIndex(pc, (first), OP_ILOAD, OP_ILOAD_0)].i; \
+            if (intCondition(*q - OP_IFEQ, v, 0)) { budget -= 1; pc = q; BRANCH(readS2(q + 1)); } \
+            NEXT_FUSED(q + 3 - pc, 2); \
+        } while (0)
+#define FUSED_ALOAD_ILOAD_XALOAD(first) do { \
+            const uint8_t* q = pc + localLength((first), OP_ALOAD); \
+            JavaObject* arr = (JavaObject*)locals[localIndex(pc, (first), OP_ALOAD, OP_ALOAD_0)].ref; \
+            int32_t index = locals[localIndex(q, *q, OP_ILOAD, OP_ILOAD_0)].i; \
+            q += localLength(*q, OP_ILOAD); \
+            if (J2ME_UNLIKELY(arr == nullptr || index < 0 || index >= arr->arrayLength())) { \
+                PUSH_A(arr); PUSH_I(index); pc = q; \
+                if (arr) THROW(ARRAY_INDEX); \
+                THROW(NULL_POINTER); \
+            } \
+            switch (*q) { \
+                case OP_IALOAD: PUSH_I(arr->elements<int32_t>()[index]); break; \
+                case OP_BALOAD: PUSH_I(arr->elements<int8_t>()[index]); break; \
+                case OP_CALOAD: PUSH_I(arr->elements<uint16_t>()[index]); break; \
+                case OP_SALOAD: PUSH_I(arr->elements<int16_t>()[index]); break; \
+                default: PUSH_A(decodeRef(arr->elements<HeapRef>()[index])); break; \
+            } \
+            NEXT_FUSED(q + 1 - pc, 3); \
+        } while (0)
+#define FUSED_IBIN_ISTORE(first) do { \
+            int32_t v = intBinary((first), sp[-2].i, sp[-1].i); \
+            DROP(2); \
+            const uint8_t* q = pc + 1; \
+            uint32_t i_ = localIndex(q, *q, OP_ISTORE, OP_ISTORE_0); \
+            locals[i_].i = v; localTags[i_] = JavaValue::INT; \
+            NEXT_FUSED(1 + localLength(*q, OP_ISTORE), 2); \
+        } while (0)
+#define FUSED_IINC_GOTO(first) do { \
+            Slot& local = locals[pc[1]]; \
+            local.i = (int32_t)((uint32_t)local.i + (uint32_t)(int8_t)pc[2]); \
+            budget -= 1; pc += 3; \
+            BRANCH(readS2(pc + 1)); \
+        } while (0)
+
+        try {
+#if J2ME_COMPUTED_GOTO
+            DISPATCH_NEXT();
+#else
+        dispatch:
+            switch (*pc) {
+#endif
+            // ---- Constants / 常量 ----
+            CASE(OP_NOP) NEXT(1);
+            CASE(OP_ACONST_NULL) PUSH_A(nullptr); NEXT(1);
+            CASE(OP_ICONST_M1) PUSH_I(-1); NEXT(1);
+            CASE(OP_ICONST_0) PUSH_I(0); NEXT(1);
+            CASE(OP_ICONST_1) PUSH_I(1); NEXT(1);
+            CASE(OP_ICONST_2) PUSH_I(2); NEXT(1);
+            CASE(OP_ICONST_3) PUSH_I(3); NEXT(1);
+            CASE(OP_ICONST_4) PUSH_I(4); NEXT(1);
+            CASE(OP_ICONST_5) PUSH_I(5); NEXT(1);
+            CASE(OP_LCONST_0) PUSH_J(0); NEXT(1);
+            CASE(OP_LCONST_1) PUSH_J(1); NEXT(1);
+            CASE(OP_FCONST_0) PUSH_F(0.0f); NEXT(1);
+            CASE(OP_FCONST_1) PUSH_F(1.0f); NEXT(1);
+            CASE(OP_FCONST_2) PUSH_F(2.0f); NEXT(1);
+            CASE(OP_DCONST_0) PUSH_D(0.0); NEXT(1);
+            CASE(OP_DCONST_1) PUSH_D(1.0); NEXT(1);
+            CASE(OP_BIPUSH) PUSH_I((int8_t)pc[1]); NEXT(2);
+            CASE(OP_SIPUSH) PUSH_I(readS2(pc + 1)); NEXT(3);
+
+            // ---- Loads / 加载 ----
+            CASE(OP_ILOAD) LOAD_LOCAL(PUSH_I, i, pc[1], 2);
+            CASE(OP_LLOAD) LOAD_LOCAL(PUSH_J, l, pc[1], 2);
+            CASE(OP_FLOAD) LOAD_LOCAL(PUSH_F, f, pc[1], 2);
+            CASE(OP_DLOAD) LOAD_LOCAL(PUSH_D, d, pc[1], 2);
+            CASE(OP_ALOAD) LOAD_LOCAL(PUSH_A, ref, pc[1], 2);
+            CASE(OP_ILOAD_0) LOAD_LOCAL(PUSH_I, i, 0, 1);
+            CASE(OP_ILOAD_1) LOAD_LOCAL(PUSH_I, i, 1, 1);
+            CASE(OP_ILOAD_2) LOAD_LOCAL(PUSH_I, i, 2, 1);
+            CASE(OP_ILOAD_3) LOAD_LOCAL(PUSH_I, i, 3, 1);
+            CASE(OP_LLOAD_0) LOAD_LOCAL(PUSH_J, l, 0, 1);
+            CASE(OP_LLOAD_1) LOAD_LOCAL(PUSH_J, l, 1, 1);
+            CASE(OP_LLOAD_2) LOAD_LOCAL(PUSH_J, l, 2, 1);
+            CASE(OP_LLOAD_3) LOAD_LOCAL(PUSH_J, l, 3, 1);
+            CASE(OP_FLOAD_0) LOAD_LOCAL(PUSH_F, f, 0, 1);
+            CASE(OP_FLOAD_1) LOAD_LOCAL(PUSH_F, f, 1, 1);
+            CASE(OP_FLOAD_2) LOAD_LOCAL(PUSH_F, f, 2, 1);
+            CASE(OP_FLOAD_3) LOAD_LOCAL(PUSH_F, f, 3, 1);
+            CASE(OP_DLOAD_0) LOAD_LOCAL(PUSH_D, d, 0, 1);
+            CASE(OP_DLOAD_1) LOAD_LOCAL(PUSH_D, d, 1, 1);
+            CASE(OP_DLOAD_2) LOAD_LOCAL(PUSH_D, d, 2, 1);
+            CASE(OP_DLOAD_3) LOAD_LOCAL(PUSH_D, d, 3, 1);
+            CASE(OP_ALOAD_0) LOAD_LOCAL(PUSH_A, ref, 0, 1);
+            CASE(OP_ALOAD_1) LOAD_LOCAL(PUSH_A, ref, 1, 1);
+            CASE(OP_ALOAD_2) LOAD_LOCAL(PUSH_A, ref, 2, 1);
+            CASE(OP_ALOAD_3) LOAD_LOCAL(PUSH_A, ref, 3, 1);
+
+            CASE(OP_IALOAD) ARRAY_LOAD(int32_t, PUSH_I, raw);
+            CASE(OP_LALOAD) ARRAY_LOAD(int64_t, PUSH_J, raw);
+            CASE(OP_FALOAD) {
+                float f;
+                ARRAY_LOAD(int32_t, PUSH_F, (std::memcpy(&f, &raw, sizeof(float)), f));
+            }
+            CASE(OP_DALOAD) {
+                double d;
+                ARRAY_LOAD(int64_t, PUSH_D, (std::memcpy(&d, &raw, sizeof(double)), d));
+            }
+            CASE(OP_AALOAD) ARRAY_LOAD(HeapRef, PUSH_A, decodeRef(raw));
+            CASE(OP_BALOAD) ARRAY_LOAD(int8_t, PUSH_I, raw);
+            CASE(OP_CALOAD) ARRAY_LOAD(uint16_t, PUSH_I, raw);
+            CASE(OP_SALOAD) ARRAY_LOAD(int16_t, PUSH_I, raw);
+
+            // ---- Stores / 存储 ----
+            // ASTORE also stores returnAddress values, so it keeps whatever tag is on the stack
+            // ASTORE 也可能存储 returnAddress，因此沿用栈上的类型标记
+            CASE(OP_ISTORE) STORE_LOCAL(JavaValue::INT, pc[1], 2);
+            CASE(OP_LSTORE) STORE_LOCAL2(JavaValue::LONG, pc[1], 2);
+            CASE(OP_FSTORE) STORE_LOCAL(JavaValue::FLOAT, pc[1], 2);
+            CASE(OP_DSTORE) STORE_LOCAL2(JavaValue::DOUBLE, pc[1], 2);
+            CASE(OP_ASTORE) STORE_LOCAL(tp[-1], pc[1], 2);
+            CASE(OP_ISTORE_0) STORE_LOCAL(JavaValue::INT, 0, 1);
+            CASE(OP_ISTORE_1) STORE_LOCAL(JavaValue::INT, 1, 1);
+            CASE(OP_ISTORE_2) STORE_LOCAL(JavaValue::INT, 2, 1);
+            CASE(OP_ISTORE_3) STORE_LOCAL(JavaValue::INT, 3, 1);
+            CASE(OP_LSTORE_0) STORE_LOCAL2(JavaValue::LONG, 0, 1);
+            CASE(OP_LSTORE_1) STORE_LOCAL2(JavaValue::LONG, 1, 1);
+            CASE(OP_LSTORE_2) STORE_LOCAL2(JavaValue::LONG, 2, 1);
+            CASE(OP_LSTORE_3) STORE_LOCAL2(JavaValue::LONG, 3, 1);
+            CASE(OP_FSTORE_0) STORE_LOCAL(JavaValue::FLOAT, 0, 1);
+            CASE(OP_FSTORE_1) STORE_LOCAL(JavaValue::FLOAT, 1, 1);
+            CASE(OP_FSTORE_2) STORE_LOCAL(JavaValue::FLOAT, 2, 1);
+            CASE(OP_FSTORE_3) STORE_LOCAL(JavaValue::FLOAT, 3, 1);
+            CASE(OP_DSTORE_0) STORE_LOCAL2(JavaValue::DOUBLE, 0, 1);
+            CASE(OP_DSTORE_1) STORE_LOCAL2(JavaValue::DOUBLE, 1, 1);
+            CASE(OP_DSTORE_2) STORE_LOCAL2(JavaValue::DOUBLE, 2, 1);
+            CASE(OP_DSTORE_3) STORE_LOCAL2(JavaValue::DOUBLE, 3, 1);
+            CASE(OP_ASTORE_0) STORE_LOCAL(tp[-1], 0, 1);
+            CASE(OP_ASTORE_1) STORE_LOCAL(tp[-1], 1, 1);
+            CASE(OP_ASTORE_2) STORE_LOCAL(tp[-1], 2, 1);
+            CASE(OP_ASTORE_3) STORE_LOCAL(tp[-1], 3, 1);
+
+            CASE(OP_IASTORE) ARRAY_STORE(int32_t, 1, value.i);
+            CASE(OP_LASTORE) ARRAY_STORE(int64_t, 2, value.l);
+            CASE(OP_FASTORE) {
+                int32_t bits;
+                ARRAY_STORE(int32_t, 1, (std::memcpy(&bits, &value.f, sizeof(float)), bits));
+            }
+            CASE(OP_DASTORE) {
+                int64_t bits;
+                ARRAY_STORE(int64_t, 2, (std::memcpy(&bits, &value.d, sizeof(double)), bits));
+            }
+            // The card mark is the generational write barrier (see markCard) / 标记卡即分代回收的写屏障 (见 markCard)
+            CASE(OP_AASTORE) ARRAY_STORE(HeapRef, 1, (markCard(arr), encodeRef((JavaObject*)value.ref)));
+            CASE(OP_BASTORE) ARRAY_STORE(int8_t, 1, (int8_t)value.i);
+            CASE(OP_CASTORE) ARRAY_STORE(uint16_t, 1, (uint16_t)value.i);
+            CASE(OP_SASTORE) ARRAY_STORE(int16_t, 1, (int16_t)value.i);
+
+            // ---- Stack / 栈操作 (slot based) ----
+            CASE(OP_POP) DROP(1); NEXT(1);
+            CASE(OP_POP2) DROP(2); NEXT(1);
+            CASE(OP_DUP) dupInsert<1, 0>(sp, tp); sp += 1; tp += 1; NEXT(1);
+            CASE(OP_DUP_X1) dupInsert<1, 1>(sp, tp); sp += 1; tp += 1; NEXT(1);
+            CASE(OP_DUP_X2) dupInsert<1, 2>(sp, tp); sp += 1; tp += 1; NEXT(1);
+            CASE(OP_DUP2) dupInsert<2, 0>(sp, tp); sp += 2; tp += 2; NEXT(1);
+            CASE(OP_DUP2_X1) dupInsert<2, 1>(sp, tp); sp += 2; tp += 2; NEXT(1);
+            CASE(OP_DUP2_X2) dupInsert<2, 2>(sp, tp); sp += 2; tp += 2; NEXT(1);
+            CASE(OP_SWAP) std::swap(sp[-1], sp[-2]); std::swap(tp[-1], tp[-2]); NEXT(1);
+
+            // ---- Math / 算术 ----
+            CASE(OP_IADD) BINARY_OP(i, 1, PUSH_I, (int32_t)((uint32_t)v1 + (uint32_t)v2));
+            CASE(OP_LADD) BINARY_OP(l, 2, PUSH_J, (int64_t)((uint64_t)v1 + (uint64_t)v2));
+            CASE(OP_FADD) BINARY_OP(f, 1, PUSH_F, v1 + v2);
+            CASE(OP_DADD) BINARY_OP(d, 2, PUSH_D, v1 + v2);
+            CASE(OP_ISUB) BINARY_OP(i, 1, PUSH_I, (int32_t)((uint32_t)v1 - (uint32_t)v2));
+            CASE(OP_LSUB) BINARY_OP(l, 2, PUSH_J, (int64_t)((uint64_t)v1 - (uint64_t)v2));
+            CASE(OP_FSUB) BINARY_OP(f, 1, PUSH_F, v1 - v2);
+            CASE(OP_DSUB) BINARY_OP(d, 2, PUSH_D, v1 - v2);
+            CASE(OP_IMUL) BINARY_OP(i, 1, PUSH_I, (int32_t)((uint32_t)v1 * (uint32_t)v2));
+            CASE(OP_LMUL) BINARY_OP(l, 2, PUSH_J, (int64_t)((uint64_t)v1 * (uint64_t)v2));
+            CASE(OP_FMUL) BINARY_OP(f, 1, PUSH_F, v1 * v2);
+            CASE(OP_DMUL) BINARY_OP(d, 2, PUSH_D, v1 * v2);
+            CASE(OP_IDIV) {
+                if (J2ME_UNLIKELY(sp[-1].i == 0)) THROW(ARITHMETIC);
+                // INT_MIN / -1 overflows in C++ but is defined as INT_MIN in Java
+                BINARY_OP(i, 1, PUSH_I, (v2 == -1) ? (int32_t)(0u - (uint32_t)v1) : v1 / v2);
+            }
+            CASE(OP_LDIV) {
+                if (J2ME_UNLIKELY(sp[-2].l == 0)) THROW(ARITHMETIC);
+                BINARY_OP(l, 2, PUSH_J, (v2 == -1) ? (int64_t)(0ull - (uint64_t)v1) : v1 / v2);
+            }
+            CASE(OP_FDIV) BINARY_OP(f, 1, PUSH_F, v1 / v2);
+            CASE(OP_DDIV) BINARY_OP(d, 2, PUSH_D, v1 / v2);
+            CASE(OP_IREM) {
+                if (J2ME_UNLIKELY(sp[-1].i == 0)) THROW(ARITHMETIC);
+                BINARY_OP(i, 1, PUSH_I, (v2 == -1) ? 0 : v1 % v2);
+            }
+            CASE(OP_LREM) {
+                if (J2ME_UNLIKELY(sp[-2].l == 0)) THROW(ARITHMETIC);
+                BINARY_OP(l, 2, PUSH_J, (v2 == -1) ? 0 : v1 % v2);
+            }
+            CASE(OP_FREM) BINARY_OP(f, 1, PUSH_F, std::fmod(v1, v2));
+            CASE(OP_DREM) BINARY_OP(d, 2, PUSH_D, std::fmod(v1, v2));
+            CASE(OP_INEG) UNARY_OP(i, 1, PUSH_I, (int32_t)(0u - (uint32_t)v));
+            CASE(OP_LNEG) UNARY_OP(l, 2, PUSH_J, (int64_t)(0ull - (uint64_t)v));
+            CASE(OP_FNEG) UNARY_OP(f, 1, PUSH_F, -v);
+            CASE(OP_DNEG) UNARY_OP(d, 2, PUSH_D, -v);
+            CASE(OP_ISHL) SHIFT_OP(i, 1, PUSH_I, (int32_t)((uint32_t)v1 << (v2 & 0x1F)));
+            CASE(OP_LSHL) SHIFT_OP(l, 2, PUSH_J, (int64_t)((uint64_t)v1 << (v2 & 0x3F)));
+            CASE(OP_ISHR) SHIFT_OP(i, 1, PUSH_I, v1 >> (v2 & 0x1F));
+            CASE(OP_LSHR) SHIFT_OP(l, 2, PUSH_J, v1 >> (v2 & 0x3F));
+            CASE(OP_IUSHR) SHIFT_OP(i, 1, PUSH_I, (int32_t)((uint32_t)v1 >> (v2 & 0x1F)));
+            CASE(OP_LUSHR) SHIFT_OP(l, 2, PUSH_J, (int64_t)((uint64_t)v1 >> (v2 & 0x3F)));
+            CASE(OP_IAND) BINARY_OP(i, 1, PUSH_I, v1 & v2);
+            CASE(OP_LAND) BINARY_OP(l, 2, PUSH_J, v1 & v2);
+            CASE(OP_IOR) BINARY_OP(i, 1, PUSH_I, v1 | v2);
+            CASE(OP_LOR) BINARY_OP(l, 2, PUSH_J, v1 | v2);
+            CASE(OP_IXOR) BINARY_OP(i, 1, PUSH_I, v1 ^ v2);
+            CASE(OP_LXOR) BINARY_OP(l, 2, PUSH_J, v1 ^ v2);
+            CASE(OP_IINC) {
+                Slot& local = locals[pc[1]];
+                local.i = (int32_t)((uint32_t)local.i + (uint32_t)(int8_t)pc[2]);
+                NEXT(3);
+            }
+
+            // ---- Conversions / 类型转换 ----
+            CASE(OP_I2L) UNARY_OP(i, 1, PUSH_J, (int64_t)v);
+            CASE(OP_I2F) UNARY_OP(i, 1, PUSH_F, (float)v);
+            CASE(OP_I2D) UNARY_OP(i, 1, PUSH_D, (double)v);
+            CASE(OP_L2I) UNARY_OP(l, 2, PUSH_I, (int32_t)v);
+            CASE(OP_L2F) UNARY_OP(l, 2, PUSH_F, (float)v);
+            CASE(OP_L2D) UNARY_OP(l, 2, PUSH_D, (double)v);
+            CASE(OP_F2I) UNARY_OP(f, 1, PUSH_I, (int32_t)v);
+            CASE(OP_F2L) UNARY_OP(f, 1, PUSH_J, (int64_t)v);
+            CASE(OP_F2D) UNARY_OP(f, 1, PUSH_D, (double)v);
+            CASE(OP_D2I) UNARY_OP(d, 2, PUSH_I, (int32_t)v);
+            CASE(OP_D2L) UNARY_OP(d, 2, PUSH_J, (int64_t)v);
+            CASE(OP_D2F) UNARY_OP(d, 2, PUSH_F, (float)v);
+            CASE(OP_I2B) UNARY_OP(i, 1, PUSH_I, (int8_t)v);
+            CASE(OP_I2C) UNARY_OP(i, 1, PUSH_I, (uint16_t)v);
+            CASE(OP_I2S) UNARY_OP(i, 1, PUSH_I, (int16_t)v);
+
+            // ---- Comparisons / 比较 ----
+            CASE(OP_LCMP) BINARY_OP(l, 2, PUSH_I, (v1 > v2) ? 1 : ((v1 < v2) ? -1 : 0));
+            CASE(OP_FCMPL) BINARY_OP(f, 1, PUSH_I, compareFloating(v1, v2, -1));
+            CASE(OP_FCMPG) BINARY_OP(f, 1, PUSH_I, compareFloating(v1, v2, 1));
+            CASE(OP_DCMPL) BINARY_OP(d, 2, PUSH_I, compareFloating(v1, v2, -1));
+            CASE(OP_DCMPG) BINARY_OP(d, 2, PUSH_I, compareFloating(v1, v2, 1));
+            CASE(OP_IFEQ) IF_CMP0(==);
+            CASE(OP_IFNE) IF_CMP0(!=);
+            CASE(OP_IFLT) IF_CMP0(<);
+            CASE(OP_IFGE) IF_CMP0(>=);
+            CASE(OP_IFGT) IF_CMP0(>);
+            CASE(OP_IFLE) IF_CMP0(<=);
+            CASE(OP_IF_ICMPEQ) IF_ICMP(==);
+            CASE(OP_IF_ICMPNE) IF_ICMP(!=);
+            CASE(OP_IF_ICMPLT) IF_ICMP(<);
+            CASE(OP_IF_ICMPGE) IF_ICMP(>=);
+            CASE(OP_IF_ICMPGT) IF_ICMP(>);
+            CASE(OP_IF_ICMPLE) IF_ICMP(<=);
+            CASE(OP_IF_ACMPEQ) {
+                void* v2 = sp[-1].ref; void* v1 = sp[-2].ref; DROP(2);
+                if (v1 == v2) BRANCH(readS2(pc + 1));
+                NEXT(3);
+            }
+            CASE(OP_IF_ACMPNE) {
+                void* v2 = sp[-1].ref; void* v1 = sp[-2].ref; DROP(2);
+                if (v1 != v2) BRANCH(readS2(pc + 1));
+                NEXT(3);
+            }
+            CASE(OP_IFNULL) {
+                void* v = sp[-1].ref; DROP(1);
+                if (v == nullptr) BRANCH(readS2(pc + 1));
+                NEXT(3);
+            }
+            CASE(OP_IFNONNULL) {
+                void* v = sp[-1].ref; DROP(1);
+                if (v != nullptr) BRANCH(readS2(pc + 1));
+                NEXT(3);
+            }
+
+            // ---- Control / 控制流 ----
+            CASE(OP_GOTO) BRANCH(readS2(pc + 1));
+            CASE(OP_GOTO_W) BRANCH(readS4(pc + 1));
+            // Switch operands are aligned to 4 bytes from the start of the method
+            // switch 的操作数相对方法起始按 4 字节对齐
+            CASE(OP_TABLESWITCH) {
+                const uint8_t* table = code + (((size_t)(pc - code) + 4) & ~(size_t)3);
+                int32_t index = sp[-1].i; DROP(1);
+                int32_t low = readS4(table + 4);
+                int32_t high = readS4(table + 8);
+                if (index < low || index > high) BRANCH(readS4(table));
+                BRANCH(readS4(table + 12 + 4 * (size_t)((int64_t)index - low)));
+            }
+            CASE(OP_LOOKUPSWITCH) {
+                const uint8_t* table = code + (((size_t)(pc - code) + 4) & ~(size_t)3);
+                int32_t key = sp[-1].i; DROP(1);
+                // Binary search over the sorted pairs / 在有序键值对中二分查找
+                int32_t lo = 0, hi = readS4(table + 4) - 1;
+                while (lo <= hi) {
+                    int32_t mid = lo + (hi - lo) / 2;
+                    int32_t match = readS4(table + 8 + 8 * (size_t)mid);
+                    if (match == key) BRANCH(readS4(table + 12 + 8 * (size_t)mid));
+                    if (match < key) lo = mid + 1; else hi = mid - 1;
+                }
+                BRANCH(readS4(table));
+            }
+
+            CASE(OP_IRETURN) CASE(OP_LRETURN) CASE(OP_FRETURN) CASE(OP_DRETURN) CASE(OP_ARETURN) {
+                SYNC_STATE();
+                JavaValue retVal = frame->pop();
+                thread->popFrame();
+                // Push return value to caller's stack
+                // 将返回值压入调用者的操作数栈
+                if (!thread->frames.empty()) {
+                    thread->frames.back()->push(retVal);
+                }
+                executed = instructions - budget + 1;
+                continue;
+            }
+            CASE(OP_RETURN) {
+                SYNC_STATE();
+                thread->popFrame();
+                executed = instructions - budget + 1;
+                continue;
+            }
+
+            // ---- References / 引用 ----
+            CASE(OP_ARRAYLENGTH) {
+                JavaObject* arr = (JavaObject*)sp[-1].ref;
+                if (J2ME_UNLIKELY(arr == nullptr)) THROW(NULL_POINTER);
+                DROP(1);
+                PUSH_I(arr->arrayLength());
+                NEXT(1);
+            }
+
+            // ---- Quickened field access / 快速字段访问 ----
+            CASE(OP_GETFIELD_QUICK_I) QUICK_GETFIELD(quickFieldKind(operand), PUSH_I, (int32_t)raw);
+            CASE(OP_GETFIELD_QUICK_J) QUICK_GETFIELD(FIELD_J, PUSH_J, raw);
+            CASE(OP_GETFIELD_QUICK_F) {
+                float f; int32_t bits;
+                QUICK_GETFIELD(FIELD_F, PUSH_F, (bits = (int32_t)raw, std::memcpy(&f, &bits, sizeof(float)), f));
+            }
+            CASE(OP_GETFIELD_QUICK_D) {
+                double d;
+                QUICK_GETFIELD(FIELD_D, PUSH_D, (std::memcpy(&d, &raw, sizeof(double)), d));
+            }
+            CASE(OP_GETFIELD_QUICK_A) QUICK_GETFIELD(FIELD_A, PUSH_A, (void*)raw);
+
+            CASE(OP_PUTFIELD_QUICK_I) QUICK_PUTFIELD(quickFieldKind(operand), 1, (int64_t)value.i);
+            CASE(OP_PUTFIELD_QUICK_J) QUICK_PUTFIELD(FIELD_J, 2, value.l);
+            CASE(OP_PUTFIELD_QUICK_F) {
+                int32_t bits;
+                QUICK_PUTFIELD(FIELD_F, 1, (std::memcpy(&bits, &value.f, sizeof(float)), (int64_t)bits));
+            }
+            CASE(OP_PUTFIELD_QUICK_D) {
+                int64_t bits;
+                QUICK_PUTFIELD(FIELD_D, 2, (std::memcpy(&bits, &value.d, sizeof(double)), bits));
+            }
+            CASE(OP_PUTFIELD_QUICK_A) QUICK_PUTFIELD(FIELD_A, 1, (int64_t)value.ref);
+
+            CASE(OP_GETSTATIC_QUICK_I) QUICK_GETSTATIC(PUSH_I, (int32_t)raw);
+            CASE(OP_GETSTATIC_QUICK_J) QUICK_GETSTATIC(PUSH_J, raw);
+            CASE(OP_GETSTATIC_QUICK_F) {
+                float f; int32_t bits;
+                QUICK_GETSTATIC(PUSH_F, (bits = (int32_t)raw, std::memcpy(&f, &bits, sizeof(float)), f));
+            }
+            CASE(OP_GETSTATIC_QUICK_D) {
+                double d;
+                QUICK_GETSTATIC(PUSH_D, (std::memcpy(&d, &raw, sizeof(double)), d));
+            }
+            CASE(OP_GETSTATIC_QUICK_A) QUICK_GETSTATIC(PUSH_A, (void*)raw);
+
+            CASE(OP_PUTSTATIC_QUICK_I) QUICK_PUTSTATIC(1, (int64_t)value.i);
+            CASE(OP_PUTSTATIC_QUICK_J) QUICK_PUTSTATIC(2, value.l);
+            CASE(OP_PUTSTATIC_QUICK_F) {
+                int32_t bits;
+                QUICK_PUTSTATIC(1, (std::memcpy(&bits, &value.f, sizeof(float)), (int64_t)bits));
+            }
+            CASE(OP_PUTSTATIC_QUICK_D) {
+                int64_t bits;
+                QUICK_PUTSTATIC(2, (std::memcpy(&bits, &value.d, sizeof(double)), bits));
+            }
+            CASE(OP_PUTSTATIC_QUICK_A) QUICK_PUTSTATIC(1, (int64_t)value.ref);
+
+            // ---- Quick type checks / 快速类型检查 ----
+            CASE(OP_CHECKCAST_QUICK) {
+                JavaObject* obj = (JavaObject*)sp[-1].ref;
+                if (obj && obj->cls) {
+                    JavaClass* target = classRefCache[(pc[1] << 8) | pc[2]];
+                    if (J2ME_UNLIKELY(!obj->cls->isAssignableTo(target))) {
+                        LOG_ERROR("ClassCastException: " + obj->cls->name + " cannot be cast to " + target->name);
+                        THROW(CLASS_CAST);
+                    }
+                }
+                NEXT(3);
+            }
+            CASE(OP_INSTANCEOF_QUICK) {
+                JavaObject* obj = (JavaObject*)sp[-1].ref;
+                JavaClass* target = classRefCache[(pc[1] << 8) | pc[2]];
+                bool isInstance = obj && (obj->cls ? obj->cls->isAssignableTo(target) : target->isObjectClass);
+                DROP(1);
+                PUSH_I(isInstance ? 1 : 0);
+                NEXT(3);
+            }
+
+            // ---- Superinstructions / 超级指令 ----
+#define J2ME_SUPERINSTRUCTION(name, family, first) CASE(OP_SI_##name) FUSED_##family(first);
+#include "Superinstructions.def"
+#undef J2ME_SUPERINSTRUCTION
+
+#if !J2ME_COMPUTED_GOTO
+            default:
+                goto L_SLOW;
+            }
+#endif
+
+        L_SLOW: {
+                // Everything else runs through the instruction table. The handler may
+                // push or pop frames, change the thread state or grow the frame's arrays.
+                // 其他指令通过指令表执行。处理函数可能压入/弹出栈帧、改变线程状态或扩容数组
+                SYNC_STATE();
+                uint8_t opcode = *pc;
+                util::DataReader codeReader(frame->code);
+                codeReader.seek(frame->pc + 1);
+                bool continueExec = instructionTable[opcode](threadPtr, framePtr, codeReader, opcode);
+                frame->pc = (uint32_t)codeReader.tell();
+                executed = instructions - budget + 1;
+                if (!continueExec) return executed;
+
+                // Common case (field access, native calls...): same frame still on top,
+                // just reload the cached registers and keep going.
+                // 常见情况 (字段访问、本地方法调用等): 栈帧未变化，重新加载寄存器后继续执行
+                if (--budget > 0 && thread->state == JavaThread::RUNNABLE &&
+                    !thread->frames.empty() && thread->frames.back().get() == frame) {
+                    frame->reserveMaxStack();
+                    pc = code + frame->pc;
+                    LOAD_STATE();
+                    DISPATCH_NEXT();
+                }
+                continue;
+            }
+
+        leave_frame:
+            SYNC_STATE();
+            executed = instructions;
+            continue;
+
+        tier_up:
+            // The loop just became hot: restart at the branch target so the outer loop
+            // hands the frame to the IR tier
+            // 循环刚刚变热: 在跳转目标处重新进入外层循环，由其交给 IR 层执行
+            SYNC_STATE();
+            executed = instructions - budget + 1;
+            continue;
+
+        raise_exception:
+            // THROW has synced the state; frame->pc points at the faulting instruction
+            // THROW 已同步状态; frame->pc 指向出错的指令
+            executed = instructions - budget + 1;
+            if (!raiseRuntimeException(threadPtr, pendingException)) break;
+        } catch (const JavaThrow& e) {
+            // Same, with the kind already known / 同上，异常种类已知
+            executed = instructions - budget + 1;
+            if (!raiseRuntimeException(threadPtr, e.kind, e.what())) break;
+        } catch (const std::exception& e) {
+            // Raised by an instruction table handler or native; frame->pc still points at
+            // the faulting instruction (synced by L_SLOW)
+            // 由指令表处理函数或本地方法抛出; frame->pc 仍指向出错的指令 (已由 L_SLOW 同步)
+            executed = instructions - budget + 1;
+            std::string msg = e.what() ? std::string(e.what()) : std::string();
+            if (!throwFromRuntimeError(threadPtr, msg)) break;
+        }
+
+#undef LOAD_STATE
+#undef SYNC_STATE
+#undef CASE
+#undef DISPATCH_NEXT
+#undef NEXT
+#undef BRANCH
+#undef THROW
+#undef ARRAY_LOAD
+#undef ARRAY_STORE
+#undef BINARY_OP
+#undef SHIFT_OP
+#undef UNARY_OP
+#undef IF_CMP0
+#undef IF_ICMP
+#undef LOAD_LOCAL
+#undef STORE_LOCAL
+#undef STORE_LOCAL2
+#undef PUSH_I
+#undef PUSH_F
+#undef PUSH_A
+#undef PUSH_J
+#undef PUSH_D
+#undef DROP
+#undef QUICK_GETFIELD
+#undef QUICK_PUTFIELD
+#undef QUICK_GETSTATIC
+#undef QUICK_PUTSTATIC
+#undef NEXT_FUSED
+#undef FUSED_LOAD_GETFIELD
+#undef FUSED_INT_OPERANDS
+#undef FUSED_INT_BINARY
+#undef FUSED_INT_COMPARE
+#undef FUSED_ILOAD_ILOAD_IBIN
+#undef FUSED_ILOAD_CONST_IBIN
+#undef FUSED_ILOAD_ILOAD_ICMP
+#undef FUSED_ILOAD_CONST_ICMP
+#undef FUSED_ILOAD_IFZ
+#undef FUSED_ALOAD_ILOAD_XALOAD
+#undef FUSED_IBIN_ISTORE
+#undef FUSED_IINC_GOTO
+    }
+    return executed;
+}
+
+} // namespace core
+} // namespace j2me
@@ -7,6 +7,8 @@
 #include "ThreadManager.hpp"
 #include "TimerManager.hpp"
 #include "Diagnostics.hpp"
+#include "AotModule.hpp"
+#include "BytecodeOptimizer.hpp"
 #include "../native/javax_microedition_lcdui_Display.hpp"
 #include "../native/java_lang_String.hpp"
 #include "../platform/GraphicsContext.hpp"
@@ -15,6 +17,7 @@
 #include <algorithm>
 #include <thread>
 #include <chrono>
+#include <fstream>
 
 namespace j2me {
 namespace core {
@@ -25,7 +28,9 @@ static void abortOnUnhandledException(const std::string& where, const std::strin
 }
 
 J2MEVM::J2MEVM() {}
-J2MEVM::~J2MEVM() {}
+J2MEVM::~J2MEVM() {
+    HeapManager::getInstance().removeRoot(&midletInstance);
+}
 
 int J2MEVM::run(const VMConfig& config) {
     currentConfig = config;
@@ -38,14 +43,7 @@ int J2MEVM::run(const VMConfig& config) {
 
     // 设置 Loader 和 Interpreter
     // Setup Loaders & Interpreter
-    j2me::loader::JarLoader& baseLoader = config.isClass ? *config.libraryLoader : *config.appLoader;
-    interpreter = std::make_unique<Interpreter>(baseLoader);
-    interpreter->setLibraryLoader(config.libraryLoader);
-    
-    NativeRegistry::getInstance().setInterpreter(interpreter.get());
-    if (!config.isClass && config.appLoader) {
-        NativeRegistry::getInstance().setJarLoader(config.appLoader.get());
-    }
+    setupLoaders(config);
 
     if (!loadMainClass(config)) {
         return 1;
@@ -91,6 +89,25 @@ int J2MEVM::run(const VMConfig& config) {
         return 1;
     }
 
+    if (!config.opcodeProfilePath.empty()) {
+        interpreter->writeOpcodeProfile(config.opcodeProfilePath);
+    }
+    if (config.heapDumpOnExit) {
+        HeapManager& heap = HeapManager::getInstance();
+        heap.dumpHeap(*interpreter, heap.nextDumpPath());
+    }
+    if (config.allocSampleInterval > 0) {
+        HeapManager::getInstance().reportAllocationSites(20, config.allocProfilePath);
+    }
+    LOG_INFO("[Peephole] " + BytecodeOptimizer::getInstance().describeStats());
+    {
+        auto& diag = Diagnostics::getInstance();
+        LOG_INFO("[Heap] peak " + std::to_string(diag.getHeapPeakBytes() / 1024) + " KB, live " +
+                 std::to_string(diag.getHeapLiveBytes() / 1024) + " KB (native " +
+                 std::to_string(diag.getNativeHeapBytes() / 1024) + " KB), OutOfMemoryError x" +
+                 std::to_string(diag.getOutOfMemoryCount()));
+    }
+
     if (Diagnostics::getInstance().getUncaughtExceptionCount() > 0) {
         LOG_ERROR("VM exiting due to uncaught exception: " + Diagnostics::getInstance().getLastUncaughtException());
         NativeRegistry::getInstance().setInterpreter(nullptr);
@@ -102,6 +119,52 @@ int J2MEVM::run(const VMConfig& config) {
     return 0;
 }
 
+void J2MEVM::setupLoaders(const VMConfig& config) {
+    j2me::loader::JarLoader& baseLoader = config.isClass ? *config.libraryLoader : *config.appLoader;
+    interpreter = std::make_unique<Interpreter>(baseLoader);
+    interpreter->setLibraryLoader(config.libraryLoader);
+    interpreter->setDispatchMode(config.useDispatchTable ? Interpreter::DispatchMode::TABLE : Interpreter::DispatchMode::THREADED);
+    interpreter->setTier2Threshold(config.tier2Threshold);
+    interpreter->setJitThreshold(config.jitThreshold);
+    interpreter->setSuperinstructions(config.superinstructions);
+    BytecodeOptimizer::getInstance().setPasses(config.peepholePasses);
+    HeapManager::getInstance().setIncrementalBudget(std::chrono::microseconds(config.gcBudgetUs));
+    HeapManager::getInstance().setHeapLimit(config.heapMaxBytes);
+    HeapManager::getInstance().setDumpPrefix(config.heapDumpPrefix);
+    HeapManager::getInstance().setAllocationSampling(config.allocSampleInterval);
+    HeapManager::getInstance().setDumpThreshold(config.heapDumpThreshold);
+    if (!config.opcodeProfilePath.empty()) {
+        // Sequences are counted by the table loop on unfused code, so every method has to stay there
+        // 序列由分派表循环在未融合的代码上统计，因此所有方法都须留在该循环中执行
+        interpreter->setDispatchMode(Interpreter::DispatchMode::TABLE);
+        interpreter->setTier2Threshold(0);
+        interpreter->setJitThreshold(0);
+        interpreter->setSuperinstructions(false);
+        interpreter->setOpcodeProfiling(true);
+        LOG_INFO("Profiling superinstruction candidates into " + config.opcodeProfilePath + " (table dispatch, no higher tiers, no fusion)");
+    }
+
+    NativeRegistry::getInstance().setInterpreter(interpreter.get());
+    if (!config.isClass && config.appLoader) {
+        NativeRegistry::getInstance().setJarLoader(config.appLoader.get());
+    }
+
+    // AOT module built by j2me-aot for exactly this JAR (keyed by its hash), if there is one
+    // 由 j2me-aot 为该 JAR 构建的 AOT 模块 (以 JAR 哈希为键)，如果存在
+    if (!config.isClass && config.aotEnabled && config.opcodeProfilePath.empty() && J2ME_AOT) {
+        auto jarBytes = j2me::util::FileUtils::readFile(config.filePath);
+        if (jarBytes) {
+            uint64_t jarHash = aotHash(jarBytes->data(), jarBytes->size());
+            std::string modulePath = config.aotModulePath.empty() ? aotModulePath(config.filePath, jarHash) : config.aotModulePath;
+            if (!config.aotModulePath.empty() || std::ifstream(modulePath).good()) {
+                interpreter->loadAotModule(modulePath, jarHash);
+            } else {
+                LOG_DEBUG("[AOT] No module at " + modulePath + ", interpreting the JAR");
+            }
+        }
+    }
+}
+
 bool J2MEVM::loadMainClass(const VMConfig& config) {
     if (config.isClass) {
         // 加载单个 .class 文件
@@ -176,16 +239,15 @@ void J2MEVM::runHeadless() {
             // Create args array and populate with arguments
             auto arrayCls = interpreter->resolveClass("[Ljava/lang/String;");
             if (arrayCls) {
-                auto arrayObj = HeapManager::getInstance().allocate(arrayCls);
                 size_t argCount = currentConfig.mainMethodArgs.size();
-                arrayObj->fields.resize(argCount);
+                auto arrayObj = HeapManager::getInstance().allocateArray(arrayCls, (int32_t)argCount);
                 
                 // 将每个参数转换为 Java String 对象
                 // Convert each argument to Java String object
                 auto stringCls = interpreter->resolveClass("java/lang/String");
                 for (size_t i = 0; i < argCount && stringCls; i++) {
                     auto stringObj = j2me::natives::createJavaString(interpreter.get(), currentConfig.mainMethodArgs[i]);
-                    arrayObj->fields[i] = reinterpret_cast<int64_t>(stringObj);
+                    arrayObj->setRefElement((int32_t)i, stringObj);
                 }
                 
                 JavaValue vArgs;
@@ -234,6 +296,7 @@ void J2MEVM::runMIDlet() {
     // Allocate instance
     LOG_INFO("Allocating MIDlet instance");
     midletInstance = HeapManager::getInstance().allocate(mainClass);
+    HeapManager::getInstance().addRoot(&midletInstance);
     LOG_INFO("MIDlet instance allocated: " + std::to_string(reinterpret_cast<uintptr_t>(midletInstance)));
 
     // 运行构造函数 <init>
@@ -359,6 +422,7 @@ void J2MEVM::findAndRunStartApp() {
 void J2MEVM::vmLoop() {
     LOG_INFO("Entering VM Event Loop...");
     EventLoop& eventLoop = EventLoop::getInstance();
+    HeapManager& heap = HeapManager::getInstance();
     
     using clock = std::chrono::steady_clock;
     auto lastFrameTime = clock::now();
@@ -386,6 +450,7 @@ void J2MEVM::vmLoop() {
             
             // 限制渲染、输入轮询和事件分发的频率为 30 FPS
             // Limit Rendering, Input Polling AND Event Dispatch to 30 FPS
+            bool frameStarted = false;
             if (now - lastFrameTime >= FRAME_INTERVAL) {
                 eventLoop.pollSDL();
                 // 将 dispatchEvents 移至此处以限制按键事件频率
@@ -393,9 +458,18 @@ void J2MEVM::vmLoop() {
                 eventLoop.dispatchEvents(interpreter.get());
                 eventLoop.render(interpreter.get());
                 lastFrameTime = now;
+                frameStarted = true;
             }
 
             eventLoop.checkPaintFinished();
+
+            // One slice of incremental garbage collection per frame, in what is left of the
+            // frame after rendering, up to the configured budget
+            // 每帧进行一次增量垃圾回收，使用渲染后该帧剩余的时间，不超过配置的预算
+            if (frameStarted && heap.getIncrementalBudget().count() > 0) {
+                auto idle = std::chrono::duration_cast<std::chrono::microseconds>(FRAME_INTERVAL - (clock::now() - now));
+                if (idle.count() > 0) heap.collectStep(*interpreter, std::min(idle, heap.getIncrementalBudget()));
+            }
             TimerManager::getInstance().tick(interpreter.get());
 
             if (j2me::core::Logger::getInstance().getLevel() == j2me::core::LogLevel::DEBUG) {
@@ -455,6 +529,10 @@ void J2MEVM::vmLoop() {
                     uint64_t imgDecFail = diag.getImageDecodeFailedCount();
                     std::string lastResMiss = diag.getLastResourceNotFound();
                     std::string lastImgDecFail = diag.getLastImageDecodeFailed();
+                    uint64_t heapLive = diag.getHeapLiveBytes();
+                    uint64_t heapPeak = diag.getHeapPeakBytes();
+                    uint64_t heapNative = diag.getNativeHeapBytes();
+                    uint64_t oomCount = diag.getOutOfMemoryCount();
 
                     LOG_DEBUG("[Watchdog] displayable=" + displayableName +
                               " threads=" + std::to_string(stats.total) +
@@ -496,6 +574,10 @@ void J2MEVM::vmLoop() {
                               " imgDecFail=" + std::to_string(imgDecFail) +
                               " lastResMiss=" + lastResMiss +
                               " lastImgDecFail=" + lastImgDecFail +
+                              " heapLive=" + std::to_string(heapLive) +
+                              " heapPeak=" + std::to_string(heapPeak) +
+                              " heapNative=" + std::to_string(heapNative) +
+                              " oom=" + std::to_string(oomCount) +
                               " backFmt=" + std::to_string(backFmt) +
                               " frontFmt=" + std::to_string(frontFmt) +
                               " backHash=" + std::to_string(backHash) +
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "StackFrame.hpp"
+#include "FrameArena.hpp"
+#include "RuntimeTypes.hpp"
 #include <vector>
 #include <memory>
 #include <string>
@@ -21,19 +23,40 @@ public:
 
     JavaThread(std::shared_ptr<StackFrame> initialFrame) 
         : state(RUNNABLE), wakeTime(0) {
-        frames.push_back(initialFrame);
+        pushFrame(initialFrame);
     }
 
+    // The frame's slots are carved out of this thread's arena, right above its caller
+    // 栈帧的槽位从本线程的栈区中分配，紧邻调用者之上
     void pushFrame(std::shared_ptr<StackFrame> frame) {
+        size_t count = frame->footprint();
+        FrameArena::Block block = arena.allocate(count);
+        frame->bindStorage(block.slots, block.tags, count, block.mark);
         frames.push_back(frame);
     }
 
     void popFrame() {
         if (!frames.empty()) {
+            StackFrame* frame = frames.back().get();
+            // Leaving a <clinit> frame completes that class's initialization
+            // 弹出 <clinit> 栈帧即表示该类初始化完成
+            if (frame->initializingClass) {
+                frame->initializingClass->clinitDone = true;
+            }
+            if (frame->inArena) arena.release(frame->arenaMark);
+            frame->unbindStorage();
             frames.pop_back();
         }
     }
 
+    // Drop every frame at once (uncaught exception, thread termination)
+    // 一次性丢弃所有栈帧 (未捕获异常、线程终止)
+    void clearFrames() {
+        for (auto& frame : frames) frame->unbindStorage();
+        frames.clear();
+        arena.reset();
+    }
+
     std::shared_ptr<StackFrame> currentFrame() {
         if (frames.empty()) return nullptr;
         return frames.back();
@@ -43,11 +66,22 @@ public:
         return frames.empty();
     }
 
+    // Every reference held by this thread: its frames and the objects it is tied to (each
+    // replaced by what visit returns, see StackFrame::visitReferences)
+    // 本线程持有的所有引用: 各栈帧中的引用以及与线程关联的对象 (均替换为 visit 的返回值，见 StackFrame::visitReferences)
+    template <typename Visit>
+    void visitReferences(Visit&& visit) {
+        for (const auto& frame : frames) frame->visitReferences(visit);
+        waitingOn = visit(static_cast<JavaObject*>(waitingOn));
+        javaThreadObject = visit(static_cast<JavaObject*>(javaThreadObject));
+    }
+
     State state;
     long long wakeTime; // For sleep/wait
     void* waitingOn = nullptr; // Object address being waited on
     void* javaThreadObject = nullptr; // Associated java.lang.Thread object address
     std::vector<std::shared_ptr<StackFrame>> frames;
+    FrameArena arena; // Slot storage of the frames above // 上述栈帧的槽位存储
     
     // Associated Java Thread Object (optional for now, but good for future)
     // JavaObject* javaThreadObj = nullptr; 
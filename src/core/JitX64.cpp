@@ -0,0 +1,739 @@
+#include "JitX64.hpp"
+#include "RuntimeTypes.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <algorithm>
+#include <initializer_list>
+
+#if J2ME_JIT
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace j2me {
+namespace core {
+
+#if J2ME_JIT
+
+namespace {
+
+enum Reg : uint8_t { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+enum Cond : uint8_t { CC_O, CC_NO, CC_B, CC_AE, CC_E, CC_NE, CC_BE, CC_A, CC_S, CC_NS, CC_P, CC_NP, CC_L, CC_GE, CC_LE, CC_G };
+
+// Fixed register assignment of the generated code (all callee-saved, so helper calls keep them)
+// 机器码中固定的寄存器分配 (均为被调用者保存寄存器，调用辅助函数后仍然有效)
+constexpr Reg CTX = RBX;     // JitContext*
+constexpr Reg SLOTS = R12;   // Slot* (registers) / 寄存器 (栈帧槽位)
+constexpr Reg TAGS = R13;    // uint8_t* (tags) / 类型标记
+constexpr Reg BUDGET = R14;  // Remaining budget / 剩余预算
+
+constexpr uint8_t SSE_F = 0xF3; // Scalar single prefix / 单精度前缀
+constexpr uint8_t SSE_D = 0xF2; // Scalar double prefix / 双精度前缀
+
+// Minimal x86-64 encoder: just the forms the templates use
+// 最小的 x86-64 编码器: 只包含模板用到的指令形式
+class Assembler {
+public:
+    std::vector<uint8_t> code;
+
+    size_t pos() const { return code.size(); }
+    void byte(uint8_t b) { code.push_back(b); }
+    void imm32(int32_t v) { for (int i = 0; i < 4; i++) byte((uint8_t)((uint32_t)v >> (8 * i))); }
+    void imm64(int64_t v) { for (int i = 0; i < 8; i++) byte((uint8_t)((uint64_t)v >> (8 * i))); }
+
+    // [prefix] [REX] opcode modrm(reg, [base + disp])
+    void mem(uint8_t prefix, bool w, std::initializer_list<uint8_t> op, int reg, int base, int32_t disp) {
+        if (prefix) byte(prefix);
+        rex(w, reg, base);
+        for (uint8_t b : op) byte(b);
+        int mod = (disp == 0 && (base & 7) != RBP) ? 0 : ((disp >= -128 && disp <= 127) ? 1 : 2);
+        byte((uint8_t)((mod << 6) | ((reg & 7) << 3) | (base & 7)));
+        if ((base & 7) == RSP) byte(0x24);
+        if (mod == 1) byte((uint8_t)(int8_t)disp);
+        else if (mod == 2) imm32(disp);
+    }
+    // [prefix] [REX] opcode modrm(reg, rm) with a register operand
+    void rr(uint8_t prefix, bool w, std::initializer_list<uint8_t> op, int reg, int rm) {
+        if (prefix) byte(prefix);
+        rex(w, reg, rm);
+        for (uint8_t b : op) byte(b);
+        byte((uint8_t)(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+    }
+
+    void push(Reg r) { if (r & 8) byte(0x41); byte((uint8_t)(0x50 + (r & 7))); }
+    void pop(Reg r) { if (r & 8) byte(0x41); byte((uint8_t)(0x58 + (r & 7))); }
+    void movImm64(Reg r, int64_t v) { rex(true, 0, r); byte((uint8_t)(0xB8 + (r & 7))); imm64(v); }
+    void movImm32(Reg r, int32_t v) { rex(false, 0, r); byte((uint8_t)(0xB8 + (r & 7))); imm32(v); }
+    void callReg(Reg r) { rr(0, false, {0xFF}, 2, r); }
+
+    // Branches with a rel32 to be patched; return the offset of the rel32
+    // 带 rel32 的跳转 (稍后回填)，返回 rel32 所在偏移
+    size_t jcc(Cond cc) { byte(0x0F); byte((uint8_t)(0x80 + cc)); size_t at = pos(); imm32(0); return at; }
+    size_t jmp() { byte(0xE9); size_t at = pos(); imm32(0); return at; }
+    void patch(size_t at, size_t target) {
+        int32_t rel = (int32_t)((int64_t)target - (int64_t)(at + 4));
+        std::memcpy(&code[at], &rel, sizeof(rel));
+    }
+
+private:
+    void rex(bool w, int reg, int rm) {
+        uint8_t r = (uint8_t)(0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0));
+        if (r != 0x40) byte(r);
+    }
+};
+
+// Helpers called from generated code; none of them can throw
+// 机器码调用的辅助函数，均不会抛出异常
+float remFloat(float a, float b) { return std::fmod(a, b); }
+double remDouble(double a, double b) { return std::fmod(a, b); }
+
+int32_t tableSwitchTarget(const IRSwitch* sw, int32_t key) {
+    int64_t index = (int64_t)key - sw->low;
+    return (index >= 0 && index < (int64_t)sw->targets.size()) ? sw->targets[index] : sw->defaultTarget;
+}
+
+int32_t lookupSwitchTarget(const IRSwitch* sw, int32_t key) {
+    auto it = std::lower_bound(sw->keys.begin(), sw->keys.end(), key);
+    return (it != sw->keys.end() && *it == key) ? sw->targets[it - sw->keys.begin()] : sw->defaultTarget;
+}
+
+// Exception exit not yet emitted / 尚未生成的异常退出
+struct PendingExit {
+    size_t at;
+    int32_t reason;
+    uint32_t insn;
+};
+
+// Compiles one IRMethod / 编译单个 IRMethod
+class Compiler {
+public:
+    Compiler(const IRMethod& ir, const JitRuntime& runtime, const IRSwitch* switches, const void* const* labelTable)
+        : ir(ir), runtime(runtime), switches(switches), labelTable(labelTable) {}
+
+    bool compile(std::vector<uint8_t>& out, std::vector<uint32_t>& insnOffset);
+
+private:
+    const IRMethod& ir;
+    const JitRuntime& runtime;
+    const IRSwitch* switches;
+    const void* const* labelTable;
+    Assembler a;
+    size_t epilogue = 0;
+    size_t switchBudgetExit = 0;
+    std::vector<PendingExit> exits;
+    std::vector<std::pair<size_t, int32_t>> labelJumps;   // rel32 -> label
+    std::vector<std::pair<size_t, int32_t>> budgetJumps;  // rel32 -> budget exit of label
+    std::vector<uint32_t> cost;                           // Insns since the block start / 基本块起点至此的指令数
+
+    static int32_t slot(uint32_t reg) { return (int32_t)(reg * sizeof(Slot)); }
+
+    // ---- Register file access / 寄存器访问 ----
+    void load32(Reg r, uint16_t reg) { a.mem(0, false, {0x8B}, r, SLOTS, slot(reg)); }
+    void load64(Reg r, uint16_t reg) { a.mem(0, true, {0x8B}, r, SLOTS, slot(reg)); }
+    void store32(uint16_t reg, Reg r) { a.mem(0, false, {0x89}, r, SLOTS, slot(reg)); }
+    void store64(uint16_t reg, Reg r) { a.mem(0, true, {0x89}, r, SLOTS, slot(reg)); }
+    void tag(uint16_t reg, uint8_t value) { a.mem(0, false, {0xC6}, 0, TAGS, reg); a.byte(value); }
+    void tagWide(uint16_t reg, uint8_t value) { tag(reg, value); tag((uint16_t)(reg + 1), SLOT_TOP); }
+    void loadSse(uint8_t prefix, int xmm, uint16_t reg) { a.mem(prefix, false, {0x0F, 0x10}, xmm, SLOTS, slot(reg)); }
+    void storeSse(uint8_t prefix, uint16_t reg, int xmm) { a.mem(prefix, false, {0x0F, 0x11}, xmm, SLOTS, slot(reg)); }
+
+    void writeI(uint16_t dst) { store32(dst, RAX); tag(dst, JavaValue::INT); }
+    void writeJ(uint16_t dst) { store64(dst, RAX); tagWide(dst, JavaValue::LONG); }
+    void writeA(uint16_t dst) { store64(dst, RAX); tag(dst, JavaValue::REFERENCE); }
+    void writeF(uint16_t dst) { storeSse(SSE_F, dst, 0); tag(dst, JavaValue::FLOAT); }
+    void writeD(uint16_t dst) { storeSse(SSE_D, dst, 0); tagWide(dst, JavaValue::DOUBLE); }
+
+    // ---- Control / 控制流 ----
+    void exitNow(uint32_t insn, int32_t reason) {
+        a.mem(0, false, {0xC7}, 0, CTX, (int32_t)offsetof(JitContext, insn));
+        a.imm32((int32_t)insn);
+        a.movImm32(RAX, reason);
+        a.patch(a.jmp(), epilogue);
+    }
+    void exitIf(Cond cc, uint32_t insn, int32_t reason) { exits.push_back({a.jcc(cc), reason, insn}); }
+    // Taken branch: charge the block, leave if the budget is used up, else jump
+    // 跳转: 扣除基本块的开销，预算用尽则退出，否则跳转到目标
+    void takeBranch(uint32_t insn, int32_t label) {
+        a.rr(0, false, {0x81}, 5, BUDGET); a.imm32((int32_t)cost[insn]);
+        budgetJumps.push_back({a.jcc(CC_LE), label});
+        labelJumps.push_back({a.jmp(), label});
+    }
+    void branchIf(Cond cc, uint32_t insn, int32_t label) {
+        size_t skip = a.jcc((Cond)(cc ^ 1));
+        takeBranch(insn, label);
+        a.patch(skip, a.pos());
+    }
+    void callHelper(const void* fn) { a.movImm64(RAX, (int64_t)(intptr_t)fn); a.callReg(RAX); }
+
+    // Object in RDX, null-checked unless known non-null
+    // 对象存于 RDX (除非已知非空，否则检查空指针)
+    void loadObject(const IRInsn& in, uint32_t insn) {
+        load64(RDX, in.a);
+        if (!(in.flags & IR_NONNULL)) {
+            a.rr(0, true, {0x85}, RDX, RDX);
+            exitIf(CC_E, insn, JIT_EXIT_NULL_POINTER);
+        }
+    }
+    // R8 = &elements[index] - ARRAY_DATA_OFFSET after the bounds check (elements of the
+    // given kind's size); returns the displacement of the element from R8
+    // 边界检查后 R8 = &elements[index] - ARRAY_DATA_OFFSET (元素大小由类型决定)，返回元素相对 R8 的偏移
+    int32_t arrayElement(const IRInsn& in, uint32_t insn, uint8_t kind) {
+        loadObject(in, insn);
+        a.mem(0, true, {0x63}, R9, RDX, (int32_t)JavaObject::ARRAY_LENGTH_OFFSET); // movsxd r9, length
+        a.mem(0, true, {0x63}, RAX, SLOTS, slot(in.b));        // movsxd rax, index
+        a.rr(0, true, {0x3B}, RAX, R9);                         // cmp rax, r9 (negative -> huge)
+        exitIf(CC_AE, insn, JIT_EXIT_INDEX_BOUNDS);
+        uint8_t shift = fieldSize(kind) == 8 ? 3 : fieldSize(kind) == 4 ? 2 : fieldSize(kind) == 2 ? 1 : 0;
+        if (shift > 0) { a.rr(0, true, {0xC1}, 4, RAX); a.byte(shift); } // shl rax, log2(size)
+        a.rr(0, true, {0x8B}, R8, RDX);                         // mov r8, rdx
+        a.rr(0, true, {0x03}, R8, RAX);                         // add r8, rax
+        return (int32_t)JavaObject::ARRAY_DATA_OFFSET;
+    }
+    // R8 = object after the JavaObject::hasField bounds check for byte offset imm.i;
+    // returns the field's displacement from R8
+    // 按 JavaObject::hasField 检查字节偏移 imm.i 的边界后 R8 = 对象，返回字段相对 R8 的偏移
+    int32_t fieldAddress(const IRInsn& in, uint32_t insn, uint8_t kind) {
+        loadObject(in, insn);
+        int32_t offset = in.imm.i;
+        a.mem(0, true, {0x8B}, RCX, RDX, 0);                    // mov rcx, [rdx] (cls)
+        a.rr(0, true, {0x85}, RCX, RCX);
+        exitIf(CC_E, insn, JIT_EXIT_FIELD_BOUNDS);
+        a.mem(0, true, {0x81}, 7, RCX, (int32_t)runtime.instanceSizeOffset); // cmp [rcx + instanceSize], end
+        a.imm32(offset + (int32_t)fieldSize(kind));
+        exitIf(CC_B, insn, JIT_EXIT_FIELD_BOUNDS);
+        a.rr(0, true, {0x8B}, R8, RDX);
+        return (int32_t)sizeof(JavaObject) + offset;
+    }
+
+    // Reference stored at [R8 + disp] into RAX as a pointer; RAX (a pointer) into its
+    // stored form (see encodeRef/decodeRef). The heap region never moves, so its base is
+    // an immediate.
+    // 将 [R8 + disp] 处存储的引用以指针形式读入 RAX; 将 RAX (指针) 转为存储形式 (见 encodeRef/decodeRef)。
+    // 堆区不会移动，因此基址直接作为立即数
+    void loadRef(int32_t disp) {
+#if J2ME_COMPRESSED_REFS
+        a.mem(0, false, {0x8B}, RAX, R8, disp);                 // mov eax, [r8 + disp] (zero-extends)
+        a.rr(0, false, {0x85}, RAX, RAX);
+        size_t isNull = a.jcc(CC_E);
+        a.movImm64(RCX, (int64_t)(intptr_t)runtime.heapBase);
+        a.rr(0, true, {0x03}, RAX, RCX);                        // add rax, rcx
+        a.patch(isNull, a.pos());
+#else
+        a.mem(0, true, {0x8B}, RAX, R8, disp);
+#endif
+    }
+    void encodeRef() {
+#if J2ME_COMPRESSED_REFS
+        a.rr(0, true, {0x85}, RAX, RAX);
+        size_t isNull = a.jcc(CC_E);
+        a.movImm64(RCX, (int64_t)(intptr_t)runtime.heapBase);
+        a.rr(0, true, {0x2B}, RAX, RCX);                        // sub rax, rcx
+        a.patch(isNull, a.pos());
+#endif
+    }
+    // Write barrier after a reference store into the object in RDX: marks its card (see
+    // markCard); the card table, like the region, never moves
+    // 向 RDX 中的对象写入引用后的写屏障: 标记其所在的卡 (见 markCard); 卡表与堆区一样不会移动
+    void markCard() {
+        a.rr(0, true, {0x8B}, RAX, RDX);                        // mov rax, rdx
+        a.rr(0, true, {0xC1}, 5, RAX); a.byte(CARD_SHIFT);      // shr rax, CARD_SHIFT
+        a.movImm64(RCX, (int64_t)(intptr_t)runtime.cardTable);
+        a.rr(0, true, {0x03}, RAX, RCX);                        // add rax, rcx
+        a.mem(0, false, {0xC6}, 0, RAX, 0); a.byte(1);          // mov byte [rax], 1
+    }
+
+    // Element/field value at [R8 + disp] into the destination register, by kind
+    // 按类型将 [R8 + disp] 处的值写入目标寄存器
+    void loadRaw(uint8_t kind, uint16_t dst, int32_t disp) {
+        switch (kind) {
+            case 0: a.mem(0, false, {0x8B}, RAX, R8, disp); writeI(dst); break;                       // I
+            case 1: a.mem(0, true, {0x8B}, RAX, R8, disp); writeJ(dst); break;                        // J
+            case 2: a.mem(0, false, {0x8B}, RAX, R8, disp); store32(dst, RAX); tag(dst, JavaValue::FLOAT); break; // F
+            case 3: a.mem(0, true, {0x8B}, RAX, R8, disp); store64(dst, RAX); tagWide(dst, JavaValue::DOUBLE); break; // D
+            case 4: loadRef(disp); writeA(dst); break;                                                // A
+            case 5: a.mem(0, false, {0x0F, 0xBE}, RAX, R8, disp); writeI(dst); break;                 // B
+            case 6: a.mem(0, false, {0x0F, 0xB7}, RAX, R8, disp); writeI(dst); break;                 // C
+            case 7: a.mem(0, false, {0x0F, 0xBF}, RAX, R8, disp); writeI(dst); break;                 // S
+        }
+    }
+    // Raw 64-bit form of register `reg` into RAX, by kind (same conversions as the interpreters)
+    // 按类型将寄存器 reg 转为 64 位原始值存入 RAX (与解释器的转换一致)
+    void rawValue(uint8_t kind, uint16_t reg) {
+        switch (kind) {
+            case 0: case 2: a.mem(0, true, {0x63}, RAX, SLOTS, slot(reg)); break;          // I, F: sign-extended bits
+            case 1: case 3: case 4: load64(RAX, reg); break;                             // J, D, A
+            case 5: a.mem(0, true, {0x0F, 0xBE}, RAX, SLOTS, slot(reg)); break;           // B
+            case 6: a.mem(0, false, {0x0F, 0xB7}, RAX, SLOTS, slot(reg)); break;          // C
+            case 7: a.mem(0, true, {0x0F, 0xBF}, RAX, SLOTS, slot(reg)); break;           // S
+        }
+    }
+
+    // RAX (raw form) into the field at [R8 + disp], at the field's own width
+    // 将 RAX (原始形式) 按字段自身宽度写入 [R8 + disp]
+    void storeRaw(uint8_t kind, int32_t disp) {
+        switch (fieldSize(kind)) {
+            case 1: a.mem(0, false, {0x88}, RAX, R8, disp); break;
+            case 2: a.mem(0x66, false, {0x89}, RAX, R8, disp); break;
+            case 4: a.mem(0, false, {0x89}, RAX, R8, disp); break;
+            default: a.mem(0, true, {0x89}, RAX, R8, disp); break;
+        }
+    }
+
+    void emit(const IRInsn& in, uint32_t i);
+    void intDivide(const IRInsn& in, uint32_t i, bool wide, bool remainder);
+    void floatCompare(const IRInsn& in, bool isDouble, int32_t nanResult);
+};
+
+void Compiler::intDivide(const IRInsn& in, uint32_t i, bool wide, bool remainder) {
+    if (wide) load64(RAX, in.a); else load32(RAX, in.a);
+    if (wide) load64(RCX, in.b); else load32(RCX, in.b);
+    a.rr(0, wide, {0x85}, RCX, RCX);
+    exitIf(CC_E, i, JIT_EXIT_DIVIDE_BY_ZERO);
+    // x / -1 overflows idiv for MIN_VALUE: it is -x (and the remainder is 0)
+    // MIN_VALUE / -1 会使 idiv 溢出: 结果为 -x (余数为 0)
+    a.rr(0, wide, {0x83}, 7, RCX); a.byte(0xFF);
+    size_t general = a.jcc(CC_NE);
+    if (remainder) a.rr(0, false, {0x33}, RAX, RAX);
+    else a.rr(0, wide, {0xF7}, 3, RAX);
+    size_t done = a.jmp();
+    a.patch(general, a.pos());
+    if (wide) { a.byte(0x48); a.byte(0x99); } else a.byte(0x99);   // cqo / cdq
+    a.rr(0, wide, {0xF7}, 7, RCX);                                  // idiv rcx
+    if (remainder) a.rr(0, wide, {0x8B}, RAX, RDX);
+    a.patch(done, a.pos());
+    if (wide) writeJ(in.dst); else writeI(in.dst);
+}
+
+void Compiler::floatCompare(const IRInsn& in, bool isDouble, int32_t nanResult) {
+    loadSse(isDouble ? SSE_D : SSE_F, 0, in.a);
+    a.mem(isDouble ? 0x66 : 0, false, {0x0F, 0x2E}, 0, SLOTS, slot(in.b));  // ucomis[sd] xmm0, b
+    a.movImm32(RAX, nanResult);
+    size_t unordered = a.jcc(CC_P);
+    a.rr(0, false, {0x0F, 0x97}, 0, RAX);        // seta al
+    a.rr(0, false, {0x0F, 0x92}, 0, RCX);        // setb cl
+    a.rr(0, false, {0x0F, 0xB6}, RAX, RAX);      // movzx eax, al
+    a.rr(0, false, {0x0F, 0xB6}, RCX, RCX);      // movzx ecx, cl
+    a.rr(0, false, {0x2B}, RAX, RCX);            // sub eax, ecx
+    a.patch(unordered, a.pos());
+    writeI(in.dst);
+}
+
+void Compiler::emit(const IRInsn& in, uint32_t i) {
+    // Opcode bytes of the int/long ALU forms, indexed from ADD: add, sub, imul, -, -, and, or, xor
+    // 整数运算的操作码 (从 ADD 起): add, sub, imul, -, -, and, or, xor
+    static const uint8_t aluOp[8] = { 0x03, 0x2B, 0xAF, 0, 0, 0x23, 0x0B, 0x33 };
+    static const uint8_t shiftExt[3] = { 4, 7, 5 };            // shl, sar, shr
+    static const uint8_t kExt[8] = { 0, 0, 4, 1, 6, 4, 7, 5 }; // ADDK, MULK, ANDK, ORK, XORK, SHLK, SHRK, USHRK
+    static const Cond ifCond[6] = { CC_E, CC_NE, CC_L, CC_GE, CC_G, CC_LE };
+    static const uint8_t sseArith[4] = { 0x58, 0x5C, 0x59, 0x5E };  // add, sub, mul, div
+
+    switch (in.op) {
+        case IR_NOP: break;
+        case IR_SLOW: exitNow(i, JIT_EXIT_SLOW); break;
+
+        case IR_MOV: case IR_MOV2:
+            for (int w = 0; w < (in.op == IR_MOV2 ? 2 : 1); w++) {
+                load64(RAX, (uint16_t)(in.a + w));
+                store64((uint16_t)(in.dst + w), RAX);
+                a.mem(0, false, {0x0F, 0xB6}, RAX, TAGS, in.a + w);     // movzx eax, byte tag
+                a.mem(0, false, {0x88}, RAX, TAGS, in.dst + w);        // mov byte tag, al
+            }
+            break;
+        case IR_MOV_I: case IR_MOV_F: case IR_MOV_A:
+            load64(RAX, in.a); store64(in.dst, RAX);
+            tag(in.dst, in.op == IR_MOV_I ? JavaValue::INT : (in.op == IR_MOV_F ? JavaValue::FLOAT : JavaValue::REFERENCE));
+            break;
+        case IR_MOV_J: case IR_MOV_D:
+            load64(RAX, in.a); store64(in.dst, RAX);
+            tagWide(in.dst, in.op == IR_MOV_J ? JavaValue::LONG : JavaValue::DOUBLE);
+            break;
+        case IR_CONST_I: case IR_CONST_F:
+            a.mem(0, false, {0xC7}, 0, SLOTS, slot(in.dst)); a.imm32(in.imm.i);
+            tag(in.dst, in.op == IR_CONST_I ? JavaValue::INT : JavaValue::FLOAT);
+            break;
+        case IR_CONST_J: case IR_CONST_D: case IR_CONST_A:
+            a.movImm64(RAX, in.imm.l); store64(in.dst, RAX);
+            if (in.op == IR_CONST_A) tag(in.dst, JavaValue::REFERENCE);
+            else tagWide(in.dst, in.op == IR_CONST_J ? JavaValue::LONG : JavaValue::DOUBLE);
+            break;
+
+        // ---- int / long ----
+        case IR_ADD_I: case IR_SUB_I: case IR_MUL_I: case IR_AND_I: case IR_OR_I: case IR_XOR_I:
+        case IR_ADD_J: case IR_SUB_J: case IR_MUL_J: case IR_AND_J: case IR_OR_J: case IR_XOR_J: {
+            bool wide = in.op >= IR_ADD_J;
+            uint8_t op = aluOp[in.op - (wide ? IR_ADD_J : IR_ADD_I)];
+            if (wide) load64(RAX, in.a); else load32(RAX, in.a);
+            if (op == 0xAF) a.mem(0, wide, {0x0F, 0xAF}, RAX, SLOTS, slot(in.b));
+            else a.mem(0, wide, {op}, RAX, SLOTS, slot(in.b));
+            if (wide) writeJ(in.dst); else writeI(in.dst);
+            break;
+        }
+        case IR_DIV_I: intDivide(in, i, false, false); break;
+        case IR_REM_I: intDivide(in, i, false, true); break;
+        case IR_DIV_J: intDivide(in, i, true, false); break;
+        case IR_REM_J: intDivide(in, i, true, true); break;
+        case IR_SHL_I: case IR_SHR_I: case IR_USHR_I:
+        case IR_SHL_J: case IR_SHR_J: case IR_USHR_J: {
+            // The hardware masks the count to 5 (6) bits, like Java
+            // 硬件将移位数截断为 5 (6) 位，与 Java 一致
+            bool wide = in.op >= IR_SHL_J;
+            if (wide) load64(RAX, in.a); else load32(RAX, in.a);
+            load32(RCX, in.b);
+            a.rr(0, wide, {0xD3}, shiftExt[in.op - (wide ? IR_SHL_J : IR_SHL_I)], RAX);
+            if (wide) writeJ(in.dst); else writeI(in.dst);
+            break;
+        }
+        case IR_NEG_I: load32(RAX, in.a); a.rr(0, false, {0xF7}, 3, RAX); writeI(in.dst); break;
+        case IR_NEG_J: load64(RAX, in.a); a.rr(0, true, {0xF7}, 3, RAX); writeJ(in.dst); break;
+        case IR_ADDK_I: case IR_ANDK_I: case IR_ORK_I: case IR_XORK_I:
+            load32(RAX, in.a);
+            a.rr(0, false, {0x81}, kExt[in.op - IR_ADDK_I], RAX); a.imm32(in.imm.i);
+            writeI(in.dst);
+            break;
+        case IR_MULK_I:
+            load32(RAX, in.a);
+            a.rr(0, false, {0x69}, RAX, RAX); a.imm32(in.imm.i);
+            writeI(in.dst);
+            break;
+        case IR_SHLK_I: case IR_SHRK_I: case IR_USHRK_I:
+            load32(RAX, in.a);
+            a.rr(0, false, {0xC1}, kExt[in.op - IR_ADDK_I], RAX); a.byte((uint8_t)(in.imm.i & 0x1F));
+            writeI(in.dst);
+            break;
+
+        // ---- float / double ----
+        case IR_ADD_F: case IR_SUB_F: case IR_MUL_F: case IR_DIV_F:
+            loadSse(SSE_F, 0, in.a);
+            a.mem(SSE_F, false, {0x0F, sseArith[in.op - IR_ADD_F]}, 0, SLOTS, slot(in.b));
+            writeF(in.dst);
+            break;
+        case IR_ADD_D: case IR_SUB_D: case IR_MUL_D: case IR_DIV_D:
+            loadSse(SSE_D, 0, in.a);
+            a.mem(SSE_D, false, {0x0F, sseArith[in.op - IR_ADD_D]}, 0, SLOTS, slot(in.b));
+            writeD(in.dst);
+            break;
+        case IR_REM_F:
+            loadSse(SSE_F, 0, in.a); loadSse(SSE_F, 1, in.b);
+            callHelper((const void*)&remFloat);
+            writeF(in.dst);
+            break;
+        case IR_REM_D:
+            loadSse(SSE_D, 0, in.a); loadSse(SSE_D, 1, in.b);
+            callHelper((const void*)&remDouble);
+            writeD(in.dst);
+            break;
+        case IR_NEG_F:
+            load32(RAX, in.a);
+            a.rr(0, false, {0x81}, 6, RAX); a.imm32(INT32_MIN);        // flip the sign bit / 翻转符号位
+            store32(in.dst, RAX); tag(in.dst, JavaValue::FLOAT);
+            break;
+        case IR_NEG_D:
+            load64(RAX, in.a);
+            a.rr(0, true, {0x0F, 0xBA}, 7, RAX); a.byte(63);            // btc rax, 63
+            store64(in.dst, RAX); tagWide(in.dst, JavaValue::DOUBLE);
+            break;
+
+        // ---- Conversions / 类型转换 ----
+        case IR_I2L: a.mem(0, true, {0x63}, RAX, SLOTS, slot(in.a)); writeJ(in.dst); break;
+        case IR_I2F: a.mem(SSE_F, false, {0x0F, 0x2A}, 0, SLOTS, slot(in.a)); writeF(in.dst); break;
+        case IR_I2D: a.mem(SSE_D, false, {0x0F, 0x2A}, 0, SLOTS, slot(in.a)); writeD(in.dst); break;
+        case IR_L2I: load32(RAX, in.a); writeI(in.dst); break;
+        case IR_L2F: a.mem(SSE_F, true, {0x0F, 0x2A}, 0, SLOTS, slot(in.a)); writeF(in.dst); break;
+        case IR_L2D: a.mem(SSE_D, true, {0x0F, 0x2A}, 0, SLOTS, slot(in.a)); writeD(in.dst); break;
+        case IR_F2I: a.mem(SSE_F, false, {0x0F, 0x2C}, RAX, SLOTS, slot(in.a)); writeI(in.dst); break;
+        case IR_F2L: a.mem(SSE_F, true, {0x0F, 0x2C}, RAX, SLOTS, slot(in.a)); writeJ(in.dst); break;
+        case IR_F2D: a.mem(SSE_F, false, {0x0F, 0x5A}, 0, SLOTS, slot(in.a)); writeD(in.dst); break;
+        case IR_D2I: a.mem(SSE_D, false, {0x0F, 0x2C}, RAX, SLOTS, slot(in.a)); writeI(in.dst); break;
+        case IR_D2L: a.mem(SSE_D, true, {0x0F, 0x2C}, RAX, SLOTS, slot(in.a)); writeJ(in.dst); break;
+        case IR_D2F: a.mem(SSE_D, false, {0x0F, 0x5A}, 0, SLOTS, slot(in.a)); writeF(in.dst); break;
+        case IR_I2B: a.mem(0, false, {0x0F, 0xBE}, RAX, SLOTS, slot(in.a)); writeI(in.dst); break;
+        case IR_I2C: a.mem(0, false, {0x0F, 0xB7}, RAX, SLOTS, slot(in.a)); writeI(in.dst); break;
+        case IR_I2S: a.mem(0, false, {0x0F, 0xBF}, RAX, SLOTS, slot(in.a)); writeI(in.dst); break;
+
+        // ---- Comparisons and branches / 比较与跳转 ----
+        case IR_CMP_J:
+            load64(RAX, in.a);
+            a.mem(0, true, {0x3B}, RAX, SLOTS, slot(in.b));
+            a.rr(0, false, {0x0F, 0x9F}, 0, RAX);        // setg al
+            a.rr(0, false, {0x0F, 0x9C}, 0, RCX);        // setl cl
+            a.rr(0, false, {0x0F, 0xB6}, RAX, RAX);
+            a.rr(0, false, {0x0F, 0xB6}, RCX, RCX);
+            a.rr(0, false, {0x2B}, RAX, RCX);
+            writeI(in.dst);
+            break;
+        case IR_CMPL_F: floatCompare(in, false, -1); break;
+        case IR_CMPG_F: floatCompare(in, false, 1); break;
+        case IR_CMPL_D: floatCompare(in, true, -1); break;
+        case IR_CMPG_D: floatCompare(in, true, 1); break;
+        case IR_IF_EQ: case IR_IF_NE: case IR_IF_LT: case IR_IF_GE: case IR_IF_GT: case IR_IF_LE:
+            load32(RAX, in.a);
+            a.mem(0, false, {0x3B}, RAX, SLOTS, slot(in.b));
+            branchIf(ifCond[in.op - IR_IF_EQ], i, in.target);
+            break;
+        case IR_IFK_EQ: case IR_IFK_NE: case IR_IFK_LT: case IR_IFK_GE: case IR_IFK_GT: case IR_IFK_LE:
+            a.mem(0, false, {0x81}, 7, SLOTS, slot(in.a)); a.imm32(in.imm.i);
+            branchIf(ifCond[in.op - IR_IFK_EQ], i, in.target);
+            break;
+        case IR_IF_ACMPEQ: case IR_IF_ACMPNE:
+            load64(RAX, in.a);
+            a.mem(0, true, {0x3B}, RAX, SLOTS, slot(in.b));
+            branchIf(in.op == IR_IF_ACMPEQ ? CC_E : CC_NE, i, in.target);
+            break;
+        case IR_IF_NULL: case IR_IF_NONNULL:
+            a.mem(0, true, {0x83}, 7, SLOTS, slot(in.a)); a.byte(0);
+            branchIf(in.op == IR_IF_NULL ? CC_E : CC_NE, i, in.target);
+            break;
+        case IR_GOTO: takeBranch(i, in.target); break;
+        case IR_TABLESWITCH: case IR_LOOKUPSWITCH:
+            // The helper picks the label; jump through the label address table
+            // 由辅助函数选出目标标签，再经标签地址表跳转
+            a.movImm64(RDI, (int64_t)(intptr_t)&switches[in.target]);
+            load32(RSI, in.a);
+            callHelper(in.op == IR_TABLESWITCH ? (const void*)&tableSwitchTarget : (const void*)&lookupSwitchTarget);
+            a.rr(0, false, {0x89}, RAX, RAX);            // mov eax, eax (zero the upper half) / 清零高 32 位
+            a.rr(0, false, {0x81}, 5, BUDGET); a.imm32((int32_t)cost[i]);
+            a.patch(a.jcc(CC_LE), switchBudgetExit);
+            a.movImm64(RCX, (int64_t)(intptr_t)labelTable);
+            a.byte(0xFF); a.byte(0x24); a.byte(0xC1);    // jmp [rcx + rax*8]
+            break;
+
+        // ---- Arrays / 数组 ----
+        case IR_ALOAD_I: case IR_ALOAD_J: case IR_ALOAD_F: case IR_ALOAD_D:
+        case IR_ALOAD_A: case IR_ALOAD_B: case IR_ALOAD_C: case IR_ALOAD_S:
+        {
+            uint8_t kind = (uint8_t)(in.op - IR_ALOAD_I);
+            loadRaw(kind, in.dst, arrayElement(in, i, kind));
+            break;
+        }
+        case IR_ASTORE_I: case IR_ASTORE_J: case IR_ASTORE_F: case IR_ASTORE_D:
+        case IR_ASTORE_A: case IR_ASTORE_B: case IR_ASTORE_C: case IR_ASTORE_S:
+        {
+            uint8_t kind = (uint8_t)(in.op - IR_ASTORE_I);
+            int32_t disp = arrayElement(in, i, kind);
+            rawValue(kind, in.c);
+            if (kind == FIELD_A) encodeRef();
+            storeRaw(kind, disp);
+            if (kind == FIELD_A) markCard();
+            break;
+        }
+        case IR_ARRAYLENGTH:
+            loadObject(in, i);
+            a.mem(0, false, {0x8B}, RAX, RDX, (int32_t)JavaObject::ARRAY_LENGTH_OFFSET);
+            writeI(in.dst);
+            break;
+
+        // ---- Type checks / 类型检查 ----
+        case IR_CHECKCAST: {
+            load64(RDI, in.a);
+            a.rr(0, true, {0x85}, RDI, RDI);
+            size_t isNull = a.jcc(CC_E);
+            a.movImm64(RSI, (int64_t)(intptr_t)in.imm.ref);
+            callHelper((const void*)runtime.canCast);
+            a.rr(0, false, {0x85}, RAX, RAX);
+            exitIf(CC_E, i, JIT_EXIT_CLASS_CAST);
+            a.patch(isNull, a.pos());
+            break;
+        }
+        case IR_INSTANCEOF:
+            load64(RDI, in.a);
+            a.movImm64(RSI, (int64_t)(intptr_t)in.imm.ref);
+            callHelper((const void*)runtime.isInstance);
+            writeI(in.dst);
+            break;
+
+        // ---- Fields / 字段 ----
+        case IR_GETFIELD_I: case IR_GETFIELD_J: case IR_GETFIELD_F: case IR_GETFIELD_D:
+        case IR_GETFIELD_A: case IR_GETFIELD_B: case IR_GETFIELD_C: case IR_GETFIELD_S: {
+            uint8_t kind = (uint8_t)(in.op - IR_GETFIELD_I);
+            loadRaw(kind, in.dst, fieldAddress(in, i, kind));
+            break;
+        }
+        case IR_PUTFIELD_I: case IR_PUTFIELD_J: case IR_PUTFIELD_F: case IR_PUTFIELD_D:
+        case IR_PUTFIELD_A: case IR_PUTFIELD_B: case IR_PUTFIELD_C: case IR_PUTFIELD_S: {
+            uint8_t kind = (uint8_t)(in.op - IR_PUTFIELD_I);
+            int32_t disp = fieldAddress(in, i, kind);
+            rawValue(kind, in.c);
+            if (kind == FIELD_A) encodeRef();
+            storeRaw(kind, disp);
+            if (kind == FIELD_A) markCard();
+            break;
+        }
+        case IR_GETSTATIC_I: case IR_GETSTATIC_J: case IR_GETSTATIC_F: case IR_GETSTATIC_D:
+            a.movImm64(R8, (int64_t)(intptr_t)in.imm.ref);
+            loadRaw((uint8_t)(in.op - IR_GETSTATIC_I), in.dst, 0);
+            break;
+        case IR_GETSTATIC_A:
+            // Static slots hold full pointers / 静态槽位保存完整指针
+            a.movImm64(R8, (int64_t)(intptr_t)in.imm.ref);
+            a.mem(0, true, {0x8B}, RAX, R8, 0);
+            writeA(in.dst);
+            break;
+        case IR_PUTSTATIC_I: case IR_PUTSTATIC_J: case IR_PUTSTATIC_F: case IR_PUTSTATIC_D: case IR_PUTSTATIC_A:
+            a.movImm64(R8, (int64_t)(intptr_t)in.imm.ref);
+            rawValue((uint8_t)(in.op - IR_PUTSTATIC_I), in.c);
+            a.mem(0, true, {0x89}, RAX, R8, 0);
+            break;
+
+        case IR_RETURN: case IR_RETURN_I: case IR_RETURN_J: case IR_RETURN_F: case IR_RETURN_D: case IR_RETURN_A:
+            exitNow(i, JIT_EXIT_RETURN);
+            break;
+
+        default:
+            // Unknown op: make the caller fail loudly rather than run garbage
+            // 未知指令: 交给调用者报错，而不是执行错误的代码
+            exitNow(i, JIT_EXIT_SLOW);
+            break;
+    }
+}
+
+bool Compiler::compile(std::vector<uint8_t>& out, std::vector<uint32_t>& insnOffset) {
+    const size_t n = ir.code.size();
+
+    // Budget charged by a taken branch: the insns from the start of its block
+    // 跳转扣除的预算: 从所在基本块起点到该指令的指令数
+    std::vector<uint8_t> blockStart(n + 1, 0);
+    for (const auto& label : ir.labels) blockStart[label.index] = 1;
+    cost.assign(n, 1);
+    for (size_t i = 0, start = 0; i < n; i++) {
+        if (blockStart[i]) start = i;
+        cost[i] = (uint32_t)(i - start + 1);
+    }
+
+    // Prologue: int32_t entry(JitContext*, Slot*, uint8_t*, const void* target)
+    // 序言: 保存被调用者保存寄存器，加载固定寄存器，跳到入口指令
+    a.push(RBP); a.push(RBX); a.push(R12); a.push(R13); a.push(R14); a.push(R15);
+    a.rr(0, true, {0x83}, 5, RSP); a.byte(8);                   // keep rsp 16-byte aligned for helper calls
+    a.rr(0, true, {0x8B}, CTX, RDI);
+    a.rr(0, true, {0x8B}, SLOTS, RSI);
+    a.rr(0, true, {0x8B}, TAGS, RDX);
+    a.mem(0, false, {0x8B}, BUDGET, CTX, (int32_t)offsetof(JitContext, budget));
+    a.rr(0, false, {0xFF}, 4, RCX);                             // jmp rcx
+
+    // Epilogue (exit reason in eax) / 尾声 (eax 为退出原因)
+    epilogue = a.pos();
+    a.mem(0, false, {0x89}, BUDGET, CTX, (int32_t)offsetof(JitContext, budget));
+    a.rr(0, true, {0x83}, 0, RSP); a.byte(8);
+    a.pop(R15); a.pop(R14); a.pop(R13); a.pop(R12); a.pop(RBX); a.pop(RBP);
+    a.byte(0xC3);
+
+    // Switch that ran out of budget: target label in eax / 预算用尽的 switch: 目标标签在 eax 中
+    switchBudgetExit = a.pos();
+    a.mem(0, false, {0x89}, RAX, CTX, (int32_t)offsetof(JitContext, label));
+    a.movImm32(RAX, JIT_EXIT_BUDGET);
+    a.patch(a.jmp(), epilogue);
+
+    insnOffset.assign(n + 1, 0);
+    for (uint32_t i = 0; i < n; i++) {
+        insnOffset[i] = (uint32_t)a.pos();
+        emit(ir.code[i], i);
+    }
+    // Falling off the end cannot happen for verified bytecode
+    // 校验过的字节码不会越过方法末尾
+    insnOffset[n] = (uint32_t)a.pos();
+    a.byte(0x0F); a.byte(0x0B);                                 // ud2
+
+    for (const auto& exit : exits) {
+        a.patch(exit.at, a.pos());
+        exitNow(exit.insn, exit.reason);
+    }
+    std::map<int32_t, size_t> budgetStubs;
+    for (const auto& jump : budgetJumps) {
+        auto it = budgetStubs.find(jump.second);
+        if (it == budgetStubs.end()) {
+            it = budgetStubs.emplace(jump.second, a.pos()).first;
+            a.mem(0, false, {0xC7}, 0, CTX, (int32_t)offsetof(JitContext, label)); a.imm32(jump.second);
+            a.movImm32(RAX, JIT_EXIT_BUDGET);
+            a.patch(a.jmp(), epilogue);
+        }
+        a.patch(jump.first, it->second);
+    }
+    for (const auto& jump : labelJumps) {
+        a.patch(jump.first, insnOffset[ir.labels[jump.second].index]);
+    }
+    out.swap(a.code);
+    return true;
+}
+
+} // namespace
+
+bool JitCode::supported() {
+    // The templates read std::vector's begin/end pointers directly; make sure this
+    // standard library lays them out that way
+    // 模板直接读取 std::vector 的 begin/end 指针，需确认当前标准库的布局确实如此
+    static const bool layoutOk = [] {
+        std::vector<int64_t> probe(3);
+        int64_t* words[2];
+        static_assert(sizeof(probe) >= sizeof(words), "unexpected std::vector size");
+        std::memcpy(words, &probe, sizeof(words));
+        return words[0] == probe.data() && words[1] == probe.data() + probe.size();
+    }();
+    return layoutOk;
+}
+
+std::shared_ptr<JitCode> JitCode::compile(const IRMethod& ir, const JitRuntime& runtime) {
+    if (!supported() || !runtime.isInstance || !runtime.canCast) return nullptr;
+
+    std::shared_ptr<JitCode> jit(new JitCode());
+    jit->switches = ir.switches;
+    jit->labelAddress.assign(ir.labels.size(), nullptr);
+
+    std::vector<uint8_t> code;
+    Compiler compiler(ir, runtime, jit->switches.data(), jit->labelAddress.data());
+    if (!compiler.compile(code, jit->insnOffset)) return nullptr;
+
+    // Write the code, then flip the mapping to read + execute (never writable and executable)
+    // 先写入代码，再将映射改为可读可执行 (不会同时可写可执行)
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (code.size() + page - 1) / page * page;
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return nullptr;
+    std::memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        return nullptr;
+    }
+    jit->memory = (uint8_t*)memory;
+    jit->mapped = size;
+    jit->used = code.size();
+    for (size_t l = 0; l < ir.labels.size(); l++) {
+        jit->labelAddress[l] = jit->memory + jit->insnOffset[ir.labels[l].index];
+    }
+    return jit;
+}
+
+JitCode::~JitCode() {
+    if (memory) munmap(memory, mapped);
+}
+
+int32_t JitCode::run(JitContext& context, Slot* slots, uint8_t* tags, uint32_t insn) const {
+    if (function) return function(&context, slots, tags, insn);
+    using Entry = int32_t (*)(JitContext*, Slot*, uint8_t*, const void*);
+    Entry entry = reinterpret_cast<Entry>(reinterpret_cast<void*>(memory));
+    return entry(&context, slots, tags, memory + insnOffset[insn]);
+}
+
+#else // !J2ME_JIT
+
+bool JitCode::supported() { return false; }
+
+std::shared_ptr<JitCode> JitCode::compile(const IRMethod&, const JitRuntime&) { return nullptr; }
+
+JitCode::~JitCode() {}
+
+int32_t JitCode::run(JitContext& context, Slot* slots, uint8_t* tags, uint32_t insn) const {
+    return function(&context, slots, tags, insn);
+}
+
+#endif // J2ME_JIT
+
+std::shared_ptr<JitCode> JitCode::wrap(CompiledFunction function, std::shared_ptr<void> library) {
+    std::shared_ptr<JitCode> code(new JitCode());
+    code->function = function;
+    code->library = std::move(library);
+    return code;
+}
+
+} // namespace core
+} // namespace j2me
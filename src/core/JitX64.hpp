@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "RegisterIR.hpp"
+
+// -DJ2ME_JIT=0 leaves the machine code tier out (JitCode::compile always fails)
+// 可通过 -DJ2ME_JIT=0 去掉机器码执行层 (JitCode::compile 总是失败)
+#ifndef J2ME_JIT
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__linux__) || defined(__APPLE__))
+#define J2ME_JIT 1
+#else
+#define J2ME_JIT 0
+#endif
+#endif
+
+namespace j2me {
+namespace core {
+
+// Baseline template JIT for x86-64 (System V ABI).
+//
+// Compiles the optimized register IR of a hot method (RegisterIR.hpp) into machine code,
+// one fixed template per IR instruction. The code works directly on the frame's slots
+// and tags, exactly like executeIR, so it shares the IR's entry points: it can be entered
+// at any label and it leaves through one of the JitExit reasons with the frame in
+// bytecode form. Whatever needs the runtime (calls, allocation, class initialization,
+// exceptions) is such an exit; the caller (Interpreter::executeJit) handles it and, where
+// possible, enters the code again. Generated code never calls anything that can throw.
+//
+// x86-64 (System V ABI) 基线模板 JIT。
+// 将热点方法优化后的寄存器 IR (RegisterIR.hpp) 编译为机器码，每条 IR 指令对应一个固定模板。
+// 机器码与 executeIR 一样直接读写栈帧槽位和类型标记，因此入口与 IR 相同: 可从任意标签进入，
+// 并以某个 JitExit 原因离开，离开时栈帧状态与字节码一致。需要运行时参与的操作 (调用、对象分配、
+// 类初始化、异常) 都以退出的形式交给调用者 (Interpreter::executeJit) 处理，之后尽可能再次进入机器码。
+// 生成的代码不会调用任何可能抛出异常的函数
+
+// Why the generated code returned / 机器码返回的原因
+enum JitExit : int32_t {
+    JIT_EXIT_BUDGET,          // Taken branch ran out of budget; resume at JitContext::label / 跳转时预算用尽
+    JIT_EXIT_SLOW,            // SLOW insn: run its bytecode through the instruction table / 交给指令表执行
+    JIT_EXIT_RETURN,          // RETURN* insn / 方法返回
+    JIT_EXIT_NULL_POINTER,    // NullPointerException
+    JIT_EXIT_INDEX_BOUNDS,    // ArrayIndexOutOfBoundsException
+    JIT_EXIT_DIVIDE_BY_ZERO,  // ArithmeticException: / by zero
+    JIT_EXIT_FIELD_BOUNDS,    // Field slot outside the object / 字段槽位越界
+    JIT_EXIT_CLASS_CAST       // ClassCastException
+};
+
+// State shared between the caller and the generated code
+// 调用者与机器码之间共享的状态
+struct JitContext {
+    int32_t budget = 0;  // In: instructions allowed; out: what is left / 输入: 允许执行的指令数; 输出: 剩余数
+    int32_t insn = -1;   // IR insn that caused the exit / 导致退出的 IR 指令
+    int32_t label = -1;  // Label to resume at for JIT_EXIT_BUDGET / 预算用尽时应恢复执行的标签
+};
+
+// Entry of compiled code that is a plain function: an AOT module's translation of a
+// method (AotModule.hpp). Same contract as the generated machine code.
+// 以普通函数形式存在的编译代码入口: AOT 模块中某方法的翻译结果 (AotModule.hpp)，约定与机器码相同
+using CompiledFunction = int32_t (*)(JitContext* context, Slot* slots, uint8_t* tags, uint32_t insn);
+
+// Host facts the templates need; filled in by the interpreter
+// 模板所需的宿主信息，由解释器填写
+struct JitRuntime {
+    size_t instanceSizeOffset = 0;                            // Offset of JavaClass::instanceSize / JavaClass::instanceSize 的偏移
+    uint8_t* heapBase = nullptr;                              // Base of compressed references / 压缩引用的基址
+    uint8_t* cardTable = nullptr;                             // cardTableBase (write barrier) / cardTableBase (写屏障)
+    int32_t (*isInstance)(void* object, void* cls) = nullptr; // INSTANCEOF (object may be null) / 对象可能为空
+    int32_t (*canCast)(void* object, void* cls) = nullptr;    // CHECKCAST of a non-null object / 非空对象的 CHECKCAST
+};
+
+class JitCode {
+public:
+    // Compile `ir`; nullptr if the JIT is unavailable on this host or the code cannot be mapped
+    // 编译 ir; 本机不支持 JIT 或无法分配可执行内存时返回 nullptr
+    static std::shared_ptr<JitCode> compile(const IRMethod& ir, const JitRuntime& runtime);
+
+    // Wrap a function compiled ahead of time; `library` keeps the code it lives in loaded
+    // 包装预先编译好的函数; library 保证其所在的代码库保持加载
+    static std::shared_ptr<JitCode> wrap(CompiledFunction function, std::shared_ptr<void> library);
+
+    // Whether this build and host can run generated code
+    // 当前构建与宿主是否可以运行生成的机器码
+    static bool supported();
+
+    ~JitCode();
+    JitCode(const JitCode&) = delete;
+    JitCode& operator=(const JitCode&) = delete;
+
+    // Run from IR insn `insn` (a label's first insn or a SLOW continuation) with the
+    // frame's current slot and tag arrays; returns a JitExit
+    // 从第 insn 条 IR 指令 (标签的第一条指令或 SLOW 的后继) 开始执行，使用栈帧当前的槽位和标记数组; 返回 JitExit
+    int32_t run(JitContext& context, Slot* slots, uint8_t* tags, uint32_t insn) const;
+
+    size_t codeSize() const { return used; }
+
+private:
+    JitCode() = default;
+
+    uint8_t* memory = nullptr;               // Executable mapping / 可执行内存
+    size_t mapped = 0;                       // Mapping size / 映射大小
+    CompiledFunction function = nullptr;     // AOT code instead of a mapping / AOT 代码 (无映射)
+    std::shared_ptr<void> library;           // Keeps the AOT module loaded / 保持 AOT 模块已加载
+    size_t used = 0;                         // Bytes of code / 机器码字节数
+    std::vector<uint32_t> insnOffset;        // IR insn -> code offset / IR 指令 -> 代码偏移
+    std::vector<const void*> labelAddress;   // Label -> code address (switch jump table) / 标签 -> 代码地址 (switch 跳转表)
+    std::vector<IRSwitch> switches;          // Own copy of the switch tables / switch 表的副本
+};
+
+} // namespace core
+} // namespace j2me
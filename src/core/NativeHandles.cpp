@@ -0,0 +1,79 @@
+#include "NativeHandles.hpp"
+#include "HeapManager.hpp"
+#include "RuntimeExceptions.hpp"
+
+namespace j2me {
+namespace core {
+
+uint32_t NativeHandles::create(Kind kind, void* resource, Release release, JavaObject* owner,
+                               size_t chargedBytes, uint8_t flags) {
+    uint32_t index = freeHead;
+    if (index != NO_SLOT) {
+        freeHead = entries[index].nextFree;
+    } else if (entries.size() <= INDEX_MASK) {
+        index = (uint32_t)entries.size();
+        entries.emplace_back();
+    } else {
+        if (release) release(resource);
+        HeapManager::getInstance().releaseNative(chargedBytes);
+        throw JavaThrow(RuntimeExceptionKind::OUT_OF_MEMORY);
+    }
+    Entry& entry = entries[index];
+    entry.resource = resource;
+    entry.release = release;
+    entry.owner = nullptr;
+    entry.charged = chargedBytes;
+    entry.nextFree = NO_SLOT;
+    entry.kind = kind;
+    entry.flags = flags;
+    live++;
+    uint32_t handle = (entry.generation << INDEX_BITS) | index;
+    if (owner) adopt(handle, owner);
+    return handle;
+}
+
+void NativeHandles::adopt(uint32_t handle, JavaObject* owner) {
+    uint32_t index = handle & INDEX_MASK;
+    if (!owner || index >= entries.size()) return;
+    Entry& entry = entries[index];
+    if (entry.kind == Kind::FREE || entry.generation != (handle >> INDEX_BITS) || entry.owner) return;
+    entry.owner = owner;
+    youngOwned.push_back(index);
+}
+
+void NativeHandles::charge(uint32_t handle, size_t bytes) {
+    uint32_t index = handle & INDEX_MASK;
+    if (index >= entries.size()) return;
+    Entry& entry = entries[index];
+    if (entry.kind == Kind::FREE || entry.generation != (handle >> INDEX_BITS)) return;
+    HeapManager::getInstance().reserveNative(bytes);
+    entry.charged += bytes;
+}
+
+bool NativeHandles::release(uint32_t handle) {
+    uint32_t index = handle & INDEX_MASK;
+    if (index >= entries.size()) return false;
+    const Entry& entry = entries[index];
+    if (entry.kind == Kind::FREE || entry.generation != (handle >> INDEX_BITS)) return false;
+    releaseAt(index);
+    return true;
+}
+
+void NativeHandles::releaseAt(uint32_t index) {
+    Entry& entry = entries[index];
+    if (entry.release) entry.release(entry.resource);
+    HeapManager::getInstance().releaseNative(entry.charged);
+    entry.resource = nullptr;
+    entry.release = nullptr;
+    entry.owner = nullptr;
+    entry.charged = 0;
+    entry.kind = Kind::FREE;
+    entry.flags = 0;
+    entry.generation = entry.generation == MAX_GENERATION ? 1 : entry.generation + 1;
+    entry.nextFree = freeHead;
+    freeHead = index;
+    live--;
+}
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace j2me {
+namespace core {
+
+class JavaObject;
+
+// Native state held on behalf of Java objects (decoded images, string builder contents,
+// resource streams), behind 32-bit handles that Java code stores in an int field. A handle
+// is a slot index and the slot's generation: a slot is reused from a free list once its
+// resource is released, and its generation moves on, so a stale handle finds nothing
+// instead of the slot's next resource. Lookup is one bounds check and one compare.
+//
+// A resource is released by release() (close) or by the collector once its owner, the Java
+// object holding the handle, is found unreachable: HeapManager calls sweepYoung() during
+// every minor collection and sweepOld() before every sweep. Resources created before their
+// owner exists (Image.createImage returns the handle to the constructor) get it with adopt().
+// 代表 Java 对象持有的本地状态 (解码后的图片、字符串构建器的内容、资源流)，通过 32 位句柄访问，Java 代码将句柄存放在 int 字段中。
+// 句柄由槽位下标与该槽位的代数组成: 资源释放后槽位经空闲链表复用，代数随之递增，因此过期的句柄查不到任何东西，
+// 而不会查到该槽位的下一个资源。查找只需一次边界检查与一次比较。
+// 资源在 release() (关闭) 时释放，或在其所有者 (持有该句柄的 Java 对象) 被回收器判定为不可达时释放:
+// HeapManager 在每次次要回收中调用 sweepYoung()，在每次清除前调用 sweepOld()。在所有者存在之前创建的资源
+// (Image.createImage 将句柄交给构造函数) 通过 adopt() 设置所有者
+class NativeHandles {
+public:
+    enum class Kind : uint8_t {
+        FREE,     // Unused slot / 未使用的槽位
+        IMAGE,    // SDL_Surface (ImageCommon.hpp)
+        STRING,   // std::string of a StringBuffer/StringBuilder / StringBuffer/StringBuilder 的 std::string
+        STREAM    // natives::NativeInputStream (InputStream, RandomAccessFile)
+    };
+    using Release = void (*)(void* resource);
+
+    // Per-kind bits kept with the handle / 随句柄保存的各类型标志位
+    static constexpr uint8_t IMAGE_MUTABLE = 1;
+
+    static NativeHandles& getInstance() {
+        static NativeHandles instance;
+        return instance;
+    }
+
+    // A handle for `resource`, freed with `release` (may be null). `chargedBytes` have
+    // already been reserved with HeapManager::reserveNative and are given back with it.
+    // Throws OutOfMemoryError (after releasing the resource) when every slot is taken.
+    // 为 resource 创建句柄，释放时调用 release (可为空)。chargedBytes 已通过 HeapManager::reserveNative 登记，
+    // 释放资源时一并归还。所有槽位都已占用时释放该资源并抛出 OutOfMemoryError
+    uint32_t create(Kind kind, void* resource, Release release, JavaObject* owner = nullptr,
+                    size_t chargedBytes = 0, uint8_t flags = 0);
+
+    // The resource of a live handle of that kind, nullptr otherwise (0, stale, or another kind)
+    // 指定类型的有效句柄对应的资源，否则 (0、已过期或类型不符) 返回 nullptr
+    void* get(uint32_t handle, Kind kind) const {
+        uint32_t index = handle & INDEX_MASK;
+        if (index >= entries.size()) return nullptr;
+        const Entry& entry = entries[index];
+        return (entry.generation == (handle >> INDEX_BITS) && entry.kind == kind) ? entry.resource : nullptr;
+    }
+    template <typename T>
+    T* get(uint32_t handle, Kind kind) const { return static_cast<T*>(get(handle, kind)); }
+    uint8_t flags(uint32_t handle, Kind kind) const {
+        return get(handle, kind) ? entries[handle & INDEX_MASK].flags : 0;
+    }
+
+    // Make `owner` the object whose collection releases the handle (no-op if it has one)
+    // 将 owner 设为其被回收时释放该句柄的对象 (已有所有者时不做任何事)
+    void adopt(uint32_t handle, JavaObject* owner);
+
+    // Reserve `bytes` more native memory against the heap cap for the handle's resource
+    // (may throw OutOfMemoryError); they are given back when it is released
+    // 为该句柄的资源再登记 bytes 字节本地内存 (计入堆上限，可能抛出 OutOfMemoryError)，释放时归还
+    void charge(uint32_t handle, size_t bytes);
+
+    // Release the resource now (close); false if the handle was not live
+    // 立即释放资源 (关闭); 句柄无效时返回 false
+    bool release(uint32_t handle);
+
+    // Collector hooks. sweepYoung() goes over the handles adopted since the last call:
+    // `moved(owner)` returns where the owner lives now, or nullptr if it died (which
+    // releases the handle). sweepOld() goes over every owned handle and releases those
+    // for which `live(owner)` is false, which must hold for owners still in the nursery
+    // (a nursery the old space had no room for). Both return the number of handles released.
+    // 回收器接口。sweepYoung() 处理自上次调用以来设置了所有者的句柄: moved(owner) 返回所有者的当前地址，
+    // 所有者已死亡时返回 nullptr (句柄随之释放)。sweepOld() 处理所有有所有者的句柄，释放 live(owner) 为 false 的句柄;
+    // 对仍位于新生代的所有者 (老年代没有空间容纳的新生代)，live 必须返回 true。二者均返回释放的句柄数
+    template <typename Moved>
+    size_t sweepYoung(Moved&& moved) {
+        size_t released = 0;
+        for (uint32_t index : youngOwned) {
+            Entry& entry = entries[index];
+            if (entry.kind == Kind::FREE || !entry.owner) continue;
+            entry.owner = moved(entry.owner);
+            if (!entry.owner) {
+                releaseAt(index);
+                released++;
+            }
+        }
+        youngOwned.clear();
+        return released;
+    }
+    template <typename Live>
+    size_t sweepOld(Live&& live) {
+        size_t released = 0;
+        for (uint32_t index = 0; index < entries.size(); index++) {
+            Entry& entry = entries[index];
+            if (entry.kind != Kind::FREE && entry.owner && !live(entry.owner)) {
+                releaseAt(index);
+                released++;
+            }
+        }
+        return released;
+    }
+
+    size_t liveCount() const { return live; }
+
+private:
+    NativeHandles() = default;
+
+    // 20 bits of index (a million live handles) and 11 of generation, so handles stay
+    // positive Java ints; generation 0 is never used, so no handle is 0
+    // 20 位下标 (一百万个有效句柄) 与 11 位代数，句柄因此始终是正的 Java int; 代数不使用 0，因此没有句柄为 0
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_GENERATION = (1u << 11) - 1;
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    struct Entry {
+        void* resource = nullptr;
+        Release release = nullptr;
+        JavaObject* owner = nullptr;
+        size_t charged = 0;
+        uint32_t generation = 1;
+        uint32_t nextFree = NO_SLOT;  // Free list link while FREE / 空闲时的空闲链表指针
+        Kind kind = Kind::FREE;
+        uint8_t flags = 0;
+    };
+
+    void releaseAt(uint32_t index);
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> youngOwned;  // Adopted since the last sweepYoung / 自上次 sweepYoung 以来设置了所有者的槽位
+    uint32_t freeHead = NO_SLOT;
+    size_t live = 0;
+};
+
+} // namespace core
+} // namespace j2me
@@ -1,6 +1,7 @@
 #include "NativeRegistry.hpp"
 #include "RuntimeTypes.hpp"
 #include "HeapManager.hpp"
+#include "NativeHandles.hpp"
 #include "Interpreter.hpp"
 #include "Logger.hpp"
 #include "../native/java_lang_Class.hpp"
@@ -38,6 +39,37 @@ namespace natives {
 
 namespace core {
 
+namespace {
+
+// Builder contents live in a native std::string behind a NativeHandles handle in the first
+// word of the object (HeapManager always leaves room for it), released when the builder is
+// collected; what is appended counts against the heap cap
+// 字符串构建器的内容保存在本地 std::string 中，通过对象第一个字中的 NativeHandles 句柄访问 (HeapManager 总会保留该空间)，
+// 构建器被回收时释放; 追加的内容计入堆上限
+void initBuilder(JavaObject* builder) {
+    uint32_t handle = NativeHandles::getInstance().create(
+        NativeHandles::Kind::STRING, new std::string(),
+        [](void* resource) { delete static_cast<std::string*>(resource); }, builder);
+    builder->set<int32_t>(0, (int32_t)handle);
+}
+
+std::string* builderText(JavaObject* builder) {
+    return NativeHandles::getInstance().get<std::string>(builder->get<uint32_t>(0), NativeHandles::Kind::STRING);
+}
+
+void chargeBuilder(JavaObject* builder, size_t bytes) {
+    NativeHandles::getInstance().charge(builder->get<uint32_t>(0), bytes);
+}
+
+void appendCharged(JavaObject* builder, const std::string& tail) {
+    std::string* str = builderText(builder);
+    if (!str) return;
+    chargeBuilder(builder, tail.size());
+    str->append(tail);
+}
+
+} // namespace
+
 NativeRegistry::NativeRegistry() {
     // Register natives from other files
     j2me::natives::registerClassNatives(*this);
@@ -69,13 +101,11 @@ NativeRegistry::NativeRegistry() {
 
     // java/lang/AbstractStringBuilder.<init>(I)V
     registerNative("java/lang/AbstractStringBuilder", "<init>", "(I)V", [](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame) {
-        JavaValue capacityVal = frame->pop();
+        frame->pop();
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         if (thisObj) {
-            std::string* str = new std::string();
-            if (thisObj->fields.size() < 1) thisObj->fields.resize(1);
-            thisObj->fields[0] = (int64_t)str;
+            initBuilder(thisObj);
         }
     });
 
@@ -85,15 +115,15 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 if (strVal.type == JavaValue::REFERENCE && strVal.val.ref != nullptr) {
                      JavaObject* sObj = (JavaObject*)strVal.val.ref;
                      std::string s = j2me::natives::getJavaString(sObj);
-                     str->append(s);
+                     appendCharged(thisObj, s);
                 } else if (strVal.type == JavaValue::REFERENCE && strVal.val.ref == nullptr) {
-                     str->append("null");
+                     appendCharged(thisObj, "null");
                 }
             }
         }
@@ -106,10 +136,10 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
-                str->append(std::to_string(intVal.val.i));
+                appendCharged(thisObj, std::to_string(intVal.val.i));
             }
         }
         frame->push(thisVal);
@@ -121,8 +151,8 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 std::string objStr = "null";
                 if (objVal.type == JavaValue::REFERENCE && objVal.val.ref != nullptr) {
@@ -133,7 +163,7 @@ NativeRegistry::NativeRegistry() {
                         objStr = "Object";
                     }
                 }
-                str->append(objStr);
+                appendCharged(thisObj, objStr);
             }
         }
         frame->push(thisVal);
@@ -145,12 +175,12 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str && csVal.type == JavaValue::REFERENCE && csVal.val.ref != nullptr) {
                 JavaObject* cs = (JavaObject*)csVal.val.ref;
                 if (cs && cs->cls && cs->cls->name == "java/lang/String") {
-                    str->append(j2me::natives::getJavaString(cs));
+                    appendCharged(thisObj, j2me::natives::getJavaString(cs));
                 }
             }
         }
@@ -163,14 +193,15 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str && arrVal.type == JavaValue::REFERENCE && arrVal.val.ref != nullptr) {
                 JavaObject* arr = (JavaObject*)arrVal.val.ref;
-                if (arr && !arr->fields.empty()) {
-                    size_t len = arr->fields.size();
+                if (arr && arr->arrayLength() > 0) {
+                    size_t len = arr->arrayLength();
+                    chargeBuilder(thisObj, len);
                     for (size_t i = 0; i < len; i++) {
-                        char c = (char)(arr->fields[i] & 0xFF);
+                        char c = (char)(arr->elements<uint16_t>()[i] & 0xFF);
                         str->append(1, c);
                     }
                 }
@@ -187,8 +218,8 @@ NativeRegistry::NativeRegistry() {
         result.val.i = 0;
 
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 result.val.i = (int32_t)str->length();
             }
@@ -204,8 +235,8 @@ NativeRegistry::NativeRegistry() {
         result.val.i = 2147483647; // Return max int for simplicity
         
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 result.val.i = (int32_t)str->capacity();
             }
@@ -221,8 +252,8 @@ NativeRegistry::NativeRegistry() {
         result.val.ref = nullptr;
         
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 auto interpreter = NativeRegistry::getInstance().getInterpreter();
                 if (interpreter) {
@@ -238,12 +269,9 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         if (thisObj) {
-            LOG_DEBUG("DEBUG: StringBuilder.initNative() called, fields.size() = " + std::to_string(thisObj->fields.size()));
-            std::string* str = new std::string();
-            // Store pointer in first field (ensure size)
-            if (thisObj->fields.size() < 1) thisObj->fields.resize(1);
-            thisObj->fields[0] = (int64_t)str;
-            LOG_DEBUG("DEBUG: StringBuilder.initNative() completed, fields.size() = " + std::to_string(thisObj->fields.size()));
+            LOG_DEBUG("DEBUG: StringBuilder.initNative() called");
+            initBuilder(thisObj);
+            LOG_DEBUG("DEBUG: StringBuilder.initNative() completed");
         } else {
             LOG_DEBUG("DEBUG: StringBuilder.initNative() called with null thisObj!");
         }
@@ -255,15 +283,15 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 if (strVal.type == JavaValue::REFERENCE && strVal.val.ref != nullptr) {
                      JavaObject* sObj = (JavaObject*)strVal.val.ref;
                      std::string s = j2me::natives::getJavaString(sObj);
-                     str->append(s);
+                     appendCharged(thisObj, s);
                 } else if (strVal.type == JavaValue::REFERENCE && strVal.val.ref == nullptr) {
-                     str->append("null");
+                     appendCharged(thisObj, "null");
                 }
             }
         }
@@ -276,10 +304,10 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
-                str->append(std::to_string(intVal.val.i));
+                appendCharged(thisObj, std::to_string(intVal.val.i));
             }
         }
         frame->push(thisVal);
@@ -291,10 +319,10 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
-                str->append(std::to_string(longVal.val.l));
+                appendCharged(thisObj, std::to_string(longVal.val.l));
             }
         }
         frame->push(thisVal);
@@ -306,10 +334,10 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
-                str->push_back((char)charVal.val.i);
+                appendCharged(thisObj, std::string(1, (char)charVal.val.i));
             }
         }
         frame->push(thisVal);
@@ -321,10 +349,10 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
-                str->append(boolVal.val.i ? "true" : "false");
+                appendCharged(thisObj, boolVal.val.i ? "true" : "false");
             }
         }
         frame->push(thisVal);
@@ -336,10 +364,10 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
-                str->append(std::to_string(floatVal.val.f));
+                appendCharged(thisObj, std::to_string(floatVal.val.f));
             }
         }
         frame->push(thisVal);
@@ -351,10 +379,10 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
-                str->append(std::to_string(doubleVal.val.d));
+                appendCharged(thisObj, std::to_string(doubleVal.val.d));
             }
         }
         frame->push(thisVal);
@@ -366,23 +394,24 @@ NativeRegistry::NativeRegistry() {
         JavaValue thisVal = frame->pop();
         JavaObject* thisObj = (JavaObject*)thisVal.val.ref;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 if (objVal.val.ref == nullptr) {
-                    str->append("null");
+                    appendCharged(thisObj, "null");
                 } else {
-                    // Try to use strVal hack if present (e.g. from String)
-                    if (objVal.type == JavaValue::REFERENCE && !objVal.strVal.empty()) {
-                        str->append(objVal.strVal);
+                    // Strings append their contents
+                    JavaObject* strObj = (JavaObject*)objVal.val.ref;
+                    if (strObj->cls && strObj->cls->name == "java/lang/String") {
+                        appendCharged(thisObj, j2me::natives::getJavaString(strObj));
                     } else {
                          // Default object toString
                          JavaObject* obj = (JavaObject*)objVal.val.ref;
                          if (obj) {
                              std::string name = (obj->cls) ? obj->cls->name : "Object";
-                             str->append(name + "@" + std::to_string((intptr_t)obj));
+                             appendCharged(thisObj, name + "@" + std::to_string((intptr_t)obj));
                          } else {
-                             str->append("null");
+                             appendCharged(thisObj, "null");
                          }
                     }
                 }
@@ -400,8 +429,8 @@ NativeRegistry::NativeRegistry() {
         ret.type = JavaValue::REFERENCE;
         ret.val.ref = nullptr;
         
-        if (thisObj && !thisObj->fields.empty()) {
-            std::string* str = (std::string*)thisObj->fields[0];
+        if (thisObj) {
+            std::string* str = builderText(thisObj);
             if (str) {
                 auto interpreter = NativeRegistry::getInstance().getInterpreter();
                 auto stringCls = interpreter->resolveClass("java/lang/String");
@@ -410,10 +439,9 @@ NativeRegistry::NativeRegistry() {
                     
                     auto arrayCls = interpreter->resolveClass("[C");
                     if (arrayCls) {
-                        auto arrayObj = HeapManager::getInstance().allocate(arrayCls);
-                        arrayObj->fields.resize(str->length());
+                        auto arrayObj = HeapManager::getInstance().allocateArray(arrayCls, (int32_t)str->length());
                         for (size_t i = 0; i < str->length(); i++) {
-                            arrayObj->fields[i] = (*str)[i];
+                            arrayObj->elements<uint16_t>()[i] = (uint8_t)(*str)[i];
                         }
                         
                         auto valueIt = stringCls->fieldOffsets.find("value|[C");
@@ -421,7 +449,7 @@ NativeRegistry::NativeRegistry() {
                             valueIt = stringCls->fieldOffsets.find("value");
                         }
                         if (valueIt != stringCls->fieldOffsets.end()) {
-                            stringObj->fields[valueIt->second] = (int64_t)arrayObj;
+                            stringObj->setRef(valueIt->second, arrayObj);
                         }
                         
                         auto offsetIt = stringCls->fieldOffsets.find("offset|I");
@@ -429,7 +457,7 @@ NativeRegistry::NativeRegistry() {
                             offsetIt = stringCls->fieldOffsets.find("offset");
                         }
                         if (offsetIt != stringCls->fieldOffsets.end()) {
-                            stringObj->fields[offsetIt->second] = 0;
+                            stringObj->set<int32_t>(offsetIt->second, 0);
                         }
                         
                         auto countIt = stringCls->fieldOffsets.find("count|I");
@@ -437,12 +465,11 @@ NativeRegistry::NativeRegistry() {
                             countIt = stringCls->fieldOffsets.find("count");
                         }
                         if (countIt != stringCls->fieldOffsets.end()) {
-                            stringObj->fields[countIt->second] = str->length();
+                            stringObj->set<int32_t>(countIt->second, (int32_t)str->length());
                         }
                     }
                     
                     ret.val.ref = stringObj;
-                    ret.strVal = *str;
                 }
             }
         }
@@ -454,7 +481,7 @@ NativeRegistry::NativeRegistry() {
         int val = frame->pop().val.i;
         JavaValue ret;
         ret.type = JavaValue::REFERENCE;
-        ret.strVal = std::to_string(val);
+        ret.val.ref = j2me::natives::createJavaString(NativeRegistry::getInstance().getInterpreter(), std::to_string(val));
         frame->push(ret);
     });
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
+#include <vector>
 
 namespace j2me {
 namespace core {
@@ -205,7 +207,125 @@ enum Opcode : uint8_t {
     OP_IFNONNULL    = 0xc7,
     OP_GOTO_W       = 0xc8,
     OP_JSR_W        = 0xc9,
+
+    // Quickened forms (VM internal). GETFIELD/PUTFIELD/GETSTATIC/PUTSTATIC are
+    // rewritten in place to these after their first successful execution.
+    // The suffix is the value kind: I (int/short/char/byte/boolean), J, F, D, A (reference).
+    // 快速指令 (VM 内部使用): 字段访问指令首次执行成功后原地改写为以下形式
+    // *FIELD_QUICK 的操作数为实例字段槽位; *STATIC_QUICK 的操作数为静态字段缓存索引
+    OP_GETFIELD_QUICK_I  = 0xcb,
+    OP_GETFIELD_QUICK_J  = 0xcc,
+    OP_GETFIELD_QUICK_F  = 0xcd,
+    OP_GETFIELD_QUICK_D  = 0xce,
+    OP_GETFIELD_QUICK_A  = 0xcf,
+    OP_PUTFIELD_QUICK_I  = 0xd0,
+    OP_PUTFIELD_QUICK_J  = 0xd1,
+    OP_PUTFIELD_QUICK_F  = 0xd2,
+    OP_PUTFIELD_QUICK_D  = 0xd3,
+    OP_PUTFIELD_QUICK_A  = 0xd4,
+    OP_GETSTATIC_QUICK_I = 0xd5,
+    OP_GETSTATIC_QUICK_J = 0xd6,
+    OP_GETSTATIC_QUICK_F = 0xd7,
+    OP_GETSTATIC_QUICK_D = 0xd8,
+    OP_GETSTATIC_QUICK_A = 0xd9,
+    OP_PUTSTATIC_QUICK_I = 0xda,
+    OP_PUTSTATIC_QUICK_J = 0xdb,
+    OP_PUTSTATIC_QUICK_F = 0xdc,
+    OP_PUTSTATIC_QUICK_D = 0xdd,
+    OP_PUTSTATIC_QUICK_A = 0xde,
+    // Resolved static access whose class is still running <clinit>; turns into
+    // the typed quick form once initialization has finished.
+    // 已解析但类的 <clinit> 尚未执行完毕的静态字段访问 (初始化屏障)，初始化完成后改写为快速指令
+    OP_GETSTATIC_INIT_BARRIER = 0xdf,
+    OP_PUTSTATIC_INIT_BARRIER = 0xe0,
+    // Resolved virtual/interface/special calls; the operand is an index into the interpreter's
+    // virtualCallCache. INVOKEINTERFACE_QUICK keeps the count and zero bytes.
+    // 已解析的方法调用，操作数为 virtualCallCache 的索引 (INVOKEINTERFACE_QUICK 保留 count 和 0 两个字节)
+    OP_INVOKEVIRTUAL_QUICK   = 0xe1,
+    OP_INVOKEINTERFACE_QUICK = 0xe2,
+    OP_INVOKESPECIAL_QUICK   = 0xe3,
+    // Resolved type checks; the operand is an index into the interpreter's classRefCache
+    // 已解析的类型检查，操作数为 classRefCache 的索引
+    OP_CHECKCAST_QUICK  = 0xe4,
+    OP_INSTANCEOF_QUICK = 0xe5,
+    // Superinstructions (VM internal): when a class is loaded, the first opcode of each
+    // frequent sequence listed in Superinstructions.def is rewritten to one of these. The
+    // rest of the sequence is left as it is, so branches into it and every other reader of
+    // the bytecode still see ordinary instructions (see baseOpcode).
+    // 超级指令 (VM 内部使用): 类加载时，Superinstructions.def 中所列高频指令序列的首条操作码被改写为以下形式，
+    // 序列其余部分保持不变，因此跳入序列中间的分支和其他读取字节码的代码看到的仍是普通指令 (见 baseOpcode)
+    OP_SUPERINSTRUCTION_FIRST = 0xe6,
+};
+
+enum SuperinstructionOpcode : uint8_t {
+    OP_SUPERINSTRUCTION_BEFORE_FIRST = OP_SUPERINSTRUCTION_FIRST - 1,
+#define J2ME_SUPERINSTRUCTION(name, family, first) OP_SI_##name,
+#include "Superinstructions.def"
+#undef J2ME_SUPERINSTRUCTION
+    OP_SUPERINSTRUCTION_END
 };
+// 0xfe and 0xff are reserved by the JVM specification / 0xfe 和 0xff 为 JVM 规范保留
+static_assert(OP_SUPERINSTRUCTION_END <= 0xfe, "Superinstructions.def lists more superinstructions than there are free opcodes");
+
+// The instruction a superinstruction opcode stands for at its own pc; any other opcode unchanged
+// 超级指令操作码在其所在 pc 处代表的原始指令; 其他操作码原样返回
+inline uint8_t baseOpcode(uint8_t op) {
+    static constexpr uint8_t firstOpcodes[] = {
+#define J2ME_SUPERINSTRUCTION(name, family, first) first,
+#include "Superinstructions.def"
+#undef J2ME_SUPERINSTRUCTION
+        OP_NOP
+    };
+    return (op >= OP_SUPERINSTRUCTION_FIRST && op < OP_SUPERINSTRUCTION_END) ? firstOpcodes[op - OP_SUPERINSTRUCTION_FIRST] : op;
+}
+
+// Length of the instruction at pc, or 0 for instructions this VM does not support
+// (jsr/ret/wide) and malformed switches
+// pc 处指令的长度; 本虚拟机不支持的指令 (jsr/ret/wide) 与格式错误的 switch 返回 0
+inline size_t instructionLength(const std::vector<uint8_t>& code, size_t pc) {
+    auto readS4 = [&](size_t at) {
+        return (int32_t)(((uint32_t)code[at] << 24) | ((uint32_t)code[at + 1] << 16) | ((uint32_t)code[at + 2] << 8) | code[at + 3]);
+    };
+    uint8_t op = baseOpcode(code[pc]);
+    if (op <= OP_DCONST_1) return 1;
+    switch (op) {
+        case OP_BIPUSH: case OP_LDC: case OP_NEWARRAY:
+        case OP_ILOAD: case OP_LLOAD: case OP_FLOAD: case OP_DLOAD: case OP_ALOAD:
+        case OP_ISTORE: case OP_LSTORE: case OP_FSTORE: case OP_DSTORE: case OP_ASTORE:
+            return 2;
+        case OP_SIPUSH: case OP_LDC_W: case OP_LDC2_W: case OP_IINC:
+        case OP_GETSTATIC: case OP_PUTSTATIC: case OP_GETFIELD: case OP_PUTFIELD:
+        case OP_INVOKEVIRTUAL: case OP_INVOKESPECIAL: case OP_INVOKESTATIC:
+        case OP_NEW: case OP_ANEWARRAY: case OP_CHECKCAST: case OP_INSTANCEOF:
+        case OP_IFNULL: case OP_IFNONNULL:
+            return 3;
+        case OP_MULTIANEWARRAY: return 4;
+        case OP_INVOKEINTERFACE: case OP_GOTO_W: case OP_INVOKEINTERFACE_QUICK: return 5;
+        case OP_TABLESWITCH: case OP_LOOKUPSWITCH: {
+            size_t base = (pc + 4) & ~(size_t)3;
+            if (base + 12 > code.size()) return 0;
+            if (op == OP_TABLESWITCH) {
+                int32_t low = readS4(base + 4);
+                int32_t high = readS4(base + 8);
+                if (high < low) return 0;
+                return base + 12 + 4 * ((size_t)((int64_t)high - low) + 1) - pc;
+            }
+            int32_t npairs = readS4(base + 4);
+            if (npairs < 0) return 0;
+            return base + 8 + 8 * (size_t)npairs - pc;
+        }
+        default: break;
+    }
+    if (op >= OP_ILOAD_0 && op <= OP_SALOAD) return 1;
+    if (op >= OP_ISTORE_0 && op <= OP_LXOR) return 1;
+    if (op >= OP_I2L && op <= OP_DCMPG) return 1;
+    if (op >= OP_IFEQ && op <= OP_GOTO) return 3;
+    if (op >= OP_IRETURN && op <= OP_RETURN) return 1;
+    if (op == OP_ARRAYLENGTH || op == OP_ATHROW || op == OP_MONITORENTER || op == OP_MONITOREXIT) return 1;
+    if (op >= OP_GETFIELD_QUICK_I && op <= OP_INVOKEVIRTUAL_QUICK) return 3;
+    if (op >= OP_INVOKESPECIAL_QUICK && op <= OP_INSTANCEOF_QUICK) return 3;
+    return 0;
+}
 
 } // namespace core
 } // namespace j2me
@@ -0,0 +1,529 @@
+#include "RegisterIR.hpp"
+
+namespace j2me {
+namespace core {
+
+namespace {
+
+// Operand shape of an IR op: slots read through a/b/c, slots written at dst
+// IR 指令的操作数形态: 通过 a/b/c 读取的槽位数、写入 dst 的槽位数
+struct OpShape {
+    uint8_t a = 0, b = 0, c = 0;
+    uint8_t def = 0;
+    bool pure = false;   // No side effect and cannot throw: removable once its result is dead / 无副作用且不会抛出异常
+    bool deref = false;  // Throws NullPointerException if register a is null / a 为空时抛出空指针异常
+};
+
+OpShape shapeOf(uint8_t op) {
+    OpShape s;
+    auto set = [&s](uint8_t def, uint8_t a, uint8_t b, bool pure) { s.def = def; s.a = a; s.b = b; s.pure = pure; };
+    switch (op) {
+        case IR_MOV: case IR_MOV_I: case IR_MOV_F: case IR_MOV_A: set(1, 1, 0, true); break;
+        case IR_MOV2: case IR_MOV_J: case IR_MOV_D: set(2, 2, 0, true); break;
+        case IR_CONST_I: case IR_CONST_F: case IR_CONST_A: set(1, 0, 0, true); break;
+        case IR_CONST_J: case IR_CONST_D: set(2, 0, 0, true); break;
+
+        case IR_ADD_I: case IR_SUB_I: case IR_MUL_I: case IR_AND_I: case IR_OR_I: case IR_XOR_I:
+        case IR_SHL_I: case IR_SHR_I: case IR_USHR_I:
+        case IR_ADD_F: case IR_SUB_F: case IR_MUL_F: case IR_DIV_F: case IR_REM_F:
+        case IR_CMPL_F: case IR_CMPG_F:
+            set(1, 1, 1, true); break;
+        case IR_DIV_I: case IR_REM_I: set(1, 1, 1, false); break;
+        case IR_NEG_I: case IR_NEG_F: case IR_I2F: case IR_F2I: case IR_I2B: case IR_I2C: case IR_I2S:
+        case IR_ADDK_I: case IR_MULK_I: case IR_ANDK_I: case IR_ORK_I: case IR_XORK_I:
+        case IR_SHLK_I: case IR_SHRK_I: case IR_USHRK_I:
+            set(1, 1, 0, true); break;
+
+        case IR_ADD_J: case IR_SUB_J: case IR_MUL_J: case IR_AND_J: case IR_OR_J: case IR_XOR_J:
+        case IR_ADD_D: case IR_SUB_D: case IR_MUL_D: case IR_DIV_D: case IR_REM_D:
+            set(2, 2, 2, true); break;
+        case IR_DIV_J: case IR_REM_J: set(2, 2, 2, false); break;
+        case IR_SHL_J: case IR_SHR_J: case IR_USHR_J: set(2, 2, 1, true); break;
+        case IR_NEG_J: case IR_NEG_D: case IR_L2D: case IR_D2L: set(2, 2, 0, true); break;
+        case IR_I2L: case IR_I2D: case IR_F2L: case IR_F2D: set(2, 1, 0, true); break;
+        case IR_L2I: case IR_L2F: case IR_D2I: case IR_D2F: set(1, 2, 0, true); break;
+        case IR_CMP_J: case IR_CMPL_D: case IR_CMPG_D: set(1, 2, 2, true); break;
+
+        case IR_IF_EQ: case IR_IF_NE: case IR_IF_LT: case IR_IF_GE: case IR_IF_GT: case IR_IF_LE:
+        case IR_IF_ACMPEQ: case IR_IF_ACMPNE:
+            set(0, 1, 1, false); break;
+        case IR_IFK_EQ: case IR_IFK_NE: case IR_IFK_LT: case IR_IFK_GE: case IR_IFK_GT: case IR_IFK_LE:
+        case IR_IF_NULL: case IR_IF_NONNULL: case IR_TABLESWITCH: case IR_LOOKUPSWITCH:
+            set(0, 1, 0, false); break;
+
+        case IR_ALOAD_I: case IR_ALOAD_F: case IR_ALOAD_A: case IR_ALOAD_B: case IR_ALOAD_C: case IR_ALOAD_S:
+            set(1, 1, 1, false); s.deref = true; break;
+        case IR_ALOAD_J: case IR_ALOAD_D: set(2, 1, 1, false); s.deref = true; break;
+        case IR_ASTORE_I: case IR_ASTORE_F: case IR_ASTORE_A: case IR_ASTORE_B: case IR_ASTORE_C: case IR_ASTORE_S:
+            set(0, 1, 1, false); s.c = 1; s.deref = true; break;
+        case IR_ASTORE_J: case IR_ASTORE_D: set(0, 1, 1, false); s.c = 2; s.deref = true; break;
+        case IR_ARRAYLENGTH: set(1, 1, 0, false); s.deref = true; break;
+        case IR_CHECKCAST: set(0, 1, 0, false); break;
+        case IR_INSTANCEOF: set(1, 1, 0, true); break;
+
+        case IR_GETFIELD_I: case IR_GETFIELD_F: case IR_GETFIELD_A: case IR_GETFIELD_B: case IR_GETFIELD_C: case IR_GETFIELD_S:
+            set(1, 1, 0, false); s.deref = true; break;
+        case IR_GETFIELD_J: case IR_GETFIELD_D: set(2, 1, 0, false); s.deref = true; break;
+        case IR_PUTFIELD_I: case IR_PUTFIELD_F: case IR_PUTFIELD_A: case IR_PUTFIELD_B: case IR_PUTFIELD_C: case IR_PUTFIELD_S:
+            set(0, 1, 0, false); s.c = 1; s.deref = true; break;
+        case IR_PUTFIELD_J: case IR_PUTFIELD_D: set(0, 1, 0, false); s.c = 2; s.deref = true; break;
+        // Built only from the quick form, which exists once <clinit> has run / 仅由快速形式生成, 此时 <clinit> 已执行
+        case IR_GETSTATIC_I: case IR_GETSTATIC_F: case IR_GETSTATIC_A: set(1, 0, 0, true); break;
+        case IR_GETSTATIC_J: case IR_GETSTATIC_D: set(2, 0, 0, true); break;
+        case IR_PUTSTATIC_I: case IR_PUTSTATIC_F: case IR_PUTSTATIC_A: s.c = 1; break;
+        case IR_PUTSTATIC_J: case IR_PUTSTATIC_D: s.c = 2; break;
+
+        case IR_RETURN_I: case IR_RETURN_F: case IR_RETURN_A: s.a = 1; break;
+        case IR_RETURN_J: case IR_RETURN_D: s.a = 2; break;
+        default: break; // NOP, SLOW, GOTO, RETURN
+    }
+    return s;
+}
+
+bool isConditionalBranch(uint8_t op) {
+    return (op >= IR_IF_EQ && op <= IR_IF_NONNULL);
+}
+
+// Does the insn go to IRInsn::target (a label)?
+// 指令是否跳转到 IRInsn::target 标签
+bool hasLabelTarget(uint8_t op) {
+    return isConditionalBranch(op) || op == IR_GOTO;
+}
+
+uint8_t constOpForMove(uint8_t moveOp) {
+    switch (moveOp) {
+        case IR_MOV_I: return IR_CONST_I;
+        case IR_MOV_J: return IR_CONST_J;
+        case IR_MOV_F: return IR_CONST_F;
+        case IR_MOV_D: return IR_CONST_D;
+        case IR_MOV_A: return IR_CONST_A;
+        default: return IR_NOP; // untyped: take the kind of the constant / 无类型: 沿用常量自身的类型
+    }
+}
+
+// Register-to-register and constant values known within the current block
+// 当前基本块内已知的寄存器复写关系与常量
+class BlockFacts {
+public:
+    enum Kind : uint8_t { NONE, COPY, CONST };
+    struct Fact {
+        uint8_t kind = NONE;
+        uint8_t width = 0;
+        uint8_t op = IR_NOP;  // Move / const op that produced the value / 产生该值的传送或常量指令
+        uint16_t src = 0;
+        Slot value{};
+    };
+
+    explicit BlockFacts(size_t regs) : facts(regs) {}
+
+    void clear() { for (auto& f : facts) f = Fact(); }
+
+    // A value of `width` slots at reg that is a plain copy of another register
+    // reg 处 width 个槽位的值是否为另一寄存器的副本
+    bool copyOf(uint16_t reg, uint8_t width, uint16_t& src, uint8_t& op) const {
+        const Fact& f = facts[reg];
+        if (f.kind == COPY && f.width == width) { src = f.src; op = f.op; return true; }
+        if (width == 2 && reg + 1u < facts.size()) {
+            // Two single-slot copies of consecutive registers (DUP2 of a long/double)
+            // 两个连续寄存器的单槽位副本 (例如 DUP2 复制 long/double)
+            const Fact& hi = facts[reg + 1];
+            if (f.kind == COPY && f.width == 1 && hi.kind == COPY && hi.width == 1 && hi.src == f.src + 1) {
+                src = f.src; op = IR_MOV2; return true;
+            }
+        }
+        return false;
+    }
+
+    const Fact* constOf(uint16_t reg, uint8_t width) const {
+        const Fact& f = facts[reg];
+        return (f.kind == CONST && f.width == width) ? &f : nullptr;
+    }
+
+    // Forget everything about registers [lo, lo + width) and about copies of them
+    // 清除寄存器 [lo, lo + width) 以及以它们为来源的副本信息
+    void kill(uint16_t lo, uint8_t width) {
+        size_t hi = (size_t)lo + width;
+        size_t from = lo > 0 ? lo - 1 : 0;
+        for (size_t r = from; r < hi && r < facts.size(); r++) {
+            const Fact& f = facts[r];
+            if (f.kind != NONE && r + f.width > lo) facts[r] = Fact();
+        }
+        for (auto& f : facts) {
+            if (f.kind == COPY && f.src < hi && (size_t)f.src + f.width > lo) f = Fact();
+        }
+    }
+
+    void setCopy(uint16_t dst, uint8_t width, uint16_t src, uint8_t op) {
+        Fact& f = facts[dst];
+        f.kind = COPY; f.width = width; f.src = src; f.op = op;
+    }
+
+    void setConst(uint16_t dst, uint8_t width, uint8_t op, Slot value) {
+        Fact& f = facts[dst];
+        f.kind = CONST; f.width = width; f.op = op; f.value = value;
+    }
+
+private:
+    std::vector<Fact> facts;
+};
+
+// Java int arithmetic on constants; false if the operation would throw
+// 常量的 Java int 运算; 运算会抛出异常时返回 false
+bool evalInt(uint8_t op, int32_t v1, int32_t v2, int32_t& out) {
+    switch (op) {
+        case IR_ADD_I: case IR_ADDK_I: out = (int32_t)((uint32_t)v1 + (uint32_t)v2); return true;
+        case IR_SUB_I: out = (int32_t)((uint32_t)v1 - (uint32_t)v2); return true;
+        case IR_MUL_I: case IR_MULK_I: out = (int32_t)((uint32_t)v1 * (uint32_t)v2); return true;
+        case IR_DIV_I:
+            if (v2 == 0) return false;
+            out = (v2 == -1) ? (int32_t)(0u - (uint32_t)v1) : v1 / v2; return true;
+        case IR_REM_I:
+            if (v2 == 0) return false;
+            out = (v2 == -1) ? 0 : v1 % v2; return true;
+        case IR_AND_I: case IR_ANDK_I: out = v1 & v2; return true;
+        case IR_OR_I: case IR_ORK_I: out = v1 | v2; return true;
+        case IR_XOR_I: case IR_XORK_I: out = v1 ^ v2; return true;
+        case IR_SHL_I: case IR_SHLK_I: out = (int32_t)((uint32_t)v1 << (v2 & 0x1F)); return true;
+        case IR_SHR_I: case IR_SHRK_I: out = v1 >> (v2 & 0x1F); return true;
+        case IR_USHR_I: case IR_USHRK_I: out = (int32_t)((uint32_t)v1 >> (v2 & 0x1F)); return true;
+        default: return false;
+    }
+}
+
+bool evalLong(uint8_t op, int64_t v1, int64_t v2, int64_t& out) {
+    switch (op) {
+        case IR_ADD_J: out = (int64_t)((uint64_t)v1 + (uint64_t)v2); return true;
+        case IR_SUB_J: out = (int64_t)((uint64_t)v1 - (uint64_t)v2); return true;
+        case IR_MUL_J: out = (int64_t)((uint64_t)v1 * (uint64_t)v2); return true;
+        case IR_AND_J: out = v1 & v2; return true;
+        case IR_OR_J: out = v1 | v2; return true;
+        case IR_XOR_J: out = v1 ^ v2; return true;
+        case IR_SHL_J: out = (int64_t)((uint64_t)v1 << (v2 & 0x3F)); return true;
+        case IR_SHR_J: out = v1 >> (v2 & 0x3F); return true;
+        case IR_USHR_J: out = (int64_t)((uint64_t)v1 >> (v2 & 0x3F)); return true;
+        default: return false;
+    }
+}
+
+bool evalCondition(int cond, int32_t v1, int32_t v2) {
+    switch (cond) {
+        case 0: return v1 == v2;
+        case 1: return v1 != v2;
+        case 2: return v1 < v2;
+        case 3: return v1 >= v2;
+        case 4: return v1 > v2;
+        default: return v1 <= v2;
+    }
+}
+
+// Condition with the operands swapped (a < b  <=>  b > a)
+// 交换操作数后的等价条件
+int swappedCondition(int cond) {
+    static const int swapped[6] = { 0, 1, 4, 5, 2, 3 };
+    return swapped[cond];
+}
+
+// Replace a register operand by the register it is a copy of
+// 将寄存器操作数替换为其复写来源
+void propagateCopy(const BlockFacts& facts, uint16_t& reg, uint8_t width) {
+    uint16_t src; uint8_t op;
+    if (width > 0 && facts.copyOf(reg, width, src, op)) reg = src;
+}
+
+void makeConst(IRInsn& in, uint8_t op, Slot value) {
+    in.op = op;
+    in.imm = value;
+    in.flags = 0;
+}
+
+// Turn a decided branch into GOTO or drop it
+// 将结果已确定的条件跳转改为 GOTO 或删除
+void resolveBranch(IRInsn& in, bool taken) {
+    in.op = taken ? IR_GOTO : IR_NOP;
+}
+
+void foldInsn(IRInsn& in, const BlockFacts& facts) {
+    const uint8_t op = in.op;
+    if (op >= IR_MOV && op <= IR_MOV_A) {
+        uint8_t width = shapeOf(op).a;
+        if (const auto* k = facts.constOf(in.a, width)) {
+            uint8_t constOp = constOpForMove(op);
+            makeConst(in, constOp == IR_NOP ? k->op : constOp, k->value);
+        }
+        return;
+    }
+    if ((op >= IR_ADD_I && op <= IR_USHR_I) && op != IR_NEG_I) {
+        const auto* ka = facts.constOf(in.a, 1);
+        const auto* kb = facts.constOf(in.b, 1);
+        int32_t out;
+        if (ka && kb) {
+            if (evalInt(op, ka->value.i, kb->value.i, out)) {
+                Slot v{}; v.i = out; makeConst(in, IR_CONST_I, v);
+            }
+            return;
+        }
+        bool commutative = (op == IR_ADD_I || op == IR_MUL_I || op == IR_AND_I || op == IR_OR_I || op == IR_XOR_I);
+        if (!kb && ka && commutative) {
+            std::swap(in.a, in.b);
+            std::swap(ka, kb);
+        }
+        if (!kb) return;
+        int32_t k = kb->value.i;
+        uint8_t kop = IR_NOP;
+        switch (op) {
+            case IR_ADD_I: kop = IR_ADDK_I; break;
+            case IR_SUB_I: kop = IR_ADDK_I; k = (int32_t)(0u - (uint32_t)k); break;
+            case IR_MUL_I: kop = IR_MULK_I; break;
+            case IR_AND_I: kop = IR_ANDK_I; break;
+            case IR_OR_I: kop = IR_ORK_I; break;
+            case IR_XOR_I: kop = IR_XORK_I; break;
+            case IR_SHL_I: kop = IR_SHLK_I; k &= 0x1F; break;
+            case IR_SHR_I: kop = IR_SHRK_I; k &= 0x1F; break;
+            case IR_USHR_I: kop = IR_USHRK_I; k &= 0x1F; break;
+            default: return; // DIV/REM keep their zero check / 除法和取余保留除零检查
+        }
+        in.op = kop;
+        in.imm.i = k;
+        return;
+    }
+    if (op >= IR_ADDK_I && op <= IR_USHRK_I) {
+        const auto* ka = facts.constOf(in.a, 1);
+        int32_t out;
+        if (ka && evalInt(op, ka->value.i, in.imm.i, out)) {
+            Slot v{}; v.i = out; makeConst(in, IR_CONST_I, v);
+        }
+        return;
+    }
+    if (op >= IR_ADD_J && op <= IR_USHR_J) {
+        const auto* ka = facts.constOf(in.a, 2);
+        const auto* kb = facts.constOf(in.b, shapeOf(op).b);
+        int64_t out;
+        if (ka && kb) {
+            int64_t v2 = shapeOf(op).b == 1 ? (int64_t)kb->value.i : kb->value.l;
+            if (evalLong(op, ka->value.l, v2, out)) {
+                Slot v{}; v.l = out; makeConst(in, IR_CONST_J, v);
+            }
+        }
+        return;
+    }
+    Slot v{};
+    switch (op) {
+        case IR_NEG_I:
+            if (const auto* k = facts.constOf(in.a, 1)) { v.i = (int32_t)(0u - (uint32_t)k->value.i); makeConst(in, IR_CONST_I, v); }
+            return;
+        case IR_I2B:
+            if (const auto* k = facts.constOf(in.a, 1)) { v.i = (int8_t)k->value.i; makeConst(in, IR_CONST_I, v); }
+            return;
+        case IR_I2C:
+            if (const auto* k = facts.constOf(in.a, 1)) { v.i = (uint16_t)k->value.i; makeConst(in, IR_CONST_I, v); }
+            return;
+        case IR_I2S:
+            if (const auto* k = facts.constOf(in.a, 1)) { v.i = (int16_t)k->value.i; makeConst(in, IR_CONST_I, v); }
+            return;
+        case IR_I2L:
+            if (const auto* k = facts.constOf(in.a, 1)) { v.l = (int64_t)k->value.i; makeConst(in, IR_CONST_J, v); }
+            return;
+        case IR_I2F:
+            if (const auto* k = facts.constOf(in.a, 1)) { v.f = (float)k->value.i; makeConst(in, IR_CONST_F, v); }
+            return;
+        case IR_I2D:
+            if (const auto* k = facts.constOf(in.a, 1)) { v.d = (double)k->value.i; makeConst(in, IR_CONST_D, v); }
+            return;
+        case IR_L2I:
+            if (const auto* k = facts.constOf(in.a, 2)) { v.i = (int32_t)k->value.l; makeConst(in, IR_CONST_I, v); }
+            return;
+        case IR_CMP_J: {
+            const auto* ka = facts.constOf(in.a, 2);
+            const auto* kb = facts.constOf(in.b, 2);
+            if (ka && kb) {
+                int64_t v1 = ka->value.l, v2 = kb->value.l;
+                v.i = (v1 > v2) ? 1 : ((v1 < v2) ? -1 : 0);
+                makeConst(in, IR_CONST_I, v);
+            }
+            return;
+        }
+        case IR_IF_EQ: case IR_IF_NE: case IR_IF_LT: case IR_IF_GE: case IR_IF_GT: case IR_IF_LE: {
+            int cond = op - IR_IF_EQ;
+            const auto* ka = facts.constOf(in.a, 1);
+            const auto* kb = facts.constOf(in.b, 1);
+            if (ka && kb) {
+                resolveBranch(in, evalCondition(cond, ka->value.i, kb->value.i));
+            } else if (kb) {
+                in.op = (uint8_t)(IR_IFK_EQ + cond);
+                in.imm.i = kb->value.i;
+            } else if (ka) {
+                in.op = (uint8_t)(IR_IFK_EQ + swappedCondition(cond));
+                in.imm.i = ka->value.i;
+                in.a = in.b;
+            }
+            return;
+        }
+        case IR_IFK_EQ: case IR_IFK_NE: case IR_IFK_LT: case IR_IFK_GE: case IR_IFK_GT: case IR_IFK_LE:
+            if (const auto* k = facts.constOf(in.a, 1)) resolveBranch(in, evalCondition(op - IR_IFK_EQ, k->value.i, in.imm.i));
+            return;
+        case IR_IF_NULL: case IR_IF_NONNULL:
+            if (const auto* k = facts.constOf(in.a, 1)) {
+                if (k->op == IR_CONST_A) resolveBranch(in, (k->value.ref == nullptr) == (op == IR_IF_NULL));
+            }
+            return;
+        default:
+            return;
+    }
+}
+
+// Index of the first insn of every block (labels start blocks)
+// 每个基本块第一条指令的索引 (标签处开始新的基本块)
+std::vector<uint8_t> blockStarts(const IRMethod& ir) {
+    std::vector<uint8_t> starts(ir.code.size() + 1, 0);
+    for (const auto& label : ir.labels) starts[label.index] = 1;
+    return starts;
+}
+
+// Constant folding + copy propagation, one forward walk per block
+// 常量折叠与复写传播: 每个基本块一次前向遍历
+void propagate(IRMethod& ir, const std::vector<uint8_t>& starts) {
+    BlockFacts facts(ir.maxLocals + ir.maxStack + 2);
+    for (size_t i = 0; i < ir.code.size(); i++) {
+        if (starts[i]) facts.clear();
+        IRInsn& in = ir.code[i];
+        if (in.op == IR_SLOW) {
+            // The instruction table may read and write any stack slot
+            // 指令表中的处理函数可能读写任意栈槽位
+            facts.clear();
+            continue;
+        }
+
+        OpShape shape = shapeOf(in.op);
+        if (in.op >= IR_MOV && in.op <= IR_MOV_A) {
+            // Follow a copy chain; a typed move keeps its own tag, an untyped one takes the source's
+            // 沿复写链向前替换; 有类型的传送保留自身类型标记，无类型的传送沿用来源的类型
+            uint16_t src; uint8_t srcOp;
+            if (facts.copyOf(in.a, shape.a, src, srcOp)) {
+                in.a = src;
+                if ((in.op == IR_MOV || in.op == IR_MOV2) && srcOp != IR_MOV && srcOp != IR_MOV2) in.op = srcOp;
+            }
+        } else {
+            propagateCopy(facts, in.a, shape.a);
+            propagateCopy(facts, in.b, shape.b);
+            propagateCopy(facts, in.c, shape.c);
+        }
+
+        foldInsn(in, facts);
+        shape = shapeOf(in.op);
+
+        if (in.op >= IR_MOV && in.op <= IR_MOV_A && in.a == in.dst) {
+            in.op = IR_NOP;
+            continue;
+        }
+        if (shape.def == 0) continue;
+        facts.kill(in.dst, shape.def);
+        if (in.op >= IR_MOV && in.op <= IR_MOV_A) {
+            bool overlaps = in.a < in.dst + shape.def && in.dst < in.a + shape.def;
+            if (!overlaps) facts.setCopy(in.dst, shape.def, in.a, in.op);
+        } else if (in.op >= IR_CONST_I && in.op <= IR_CONST_A) {
+            facts.setConst(in.dst, shape.def, in.op, in.imm);
+        }
+    }
+}
+
+// A register dereferenced once in a block cannot be null for the rest of it
+// 在基本块内已解引用过的寄存器，在该块剩余部分中不可能为空
+void removeNullChecks(IRMethod& ir, const std::vector<uint8_t>& starts) {
+    std::vector<uint8_t> nonNull(ir.maxLocals + ir.maxStack + 2, 0);
+    auto reset = [&]() {
+        std::fill(nonNull.begin(), nonNull.end(), 0);
+        if (ir.thisNonNull && !nonNull.empty()) nonNull[0] = 1;
+    };
+    reset();
+    for (size_t i = 0; i < ir.code.size(); i++) {
+        if (starts[i]) reset();
+        IRInsn& in = ir.code[i];
+        if (in.op == IR_SLOW) { reset(); continue; }
+        OpShape shape = shapeOf(in.op);
+        bool srcNonNull = shape.a > 0 && nonNull[in.a];
+        if (shape.deref) {
+            if (srcNonNull) in.flags |= IR_NONNULL;
+            nonNull[in.a] = 1;
+        }
+        for (uint8_t w = 0; w < shape.def; w++) nonNull[in.dst + w] = 0;
+        if ((in.op == IR_MOV || in.op == IR_MOV_A) && srcNonNull) nonNull[in.dst] = 1;
+    }
+}
+
+// Drop writes to operand stack registers that are never read before being overwritten
+// or leaving the block. Locals are never touched.
+// 删除在被覆盖或离开基本块之前从未被读取的操作数栈寄存器写入，局部变量写入始终保留
+void eliminateDeadStores(IRMethod& ir, const std::vector<uint8_t>& starts) {
+    const size_t regs = (size_t)ir.maxLocals + ir.maxStack + 2;
+    std::vector<uint8_t> live(regs, 0);
+    // Deepest label depth at each block start
+    // 每个基本块起点处标签的最大栈深度
+    std::vector<uint16_t> startDepth(ir.code.size() + 1, 0);
+    for (const auto& label : ir.labels) {
+        if (label.depth > startDepth[label.index]) startDepth[label.index] = label.depth;
+    }
+    auto markStack = [&](size_t depth) {
+        for (size_t d = 0; d < depth && ir.maxLocals + d < regs; d++) live[ir.maxLocals + d] = 1;
+    };
+
+    size_t end = ir.code.size();
+    while (end > 0) {
+        size_t begin = end - 1;
+        while (begin > 0 && !starts[begin]) begin--;
+
+        std::fill(live.begin(), live.end(), 0);
+        if (end < ir.code.size()) markStack(startDepth[end]);
+
+        for (size_t i = end; i-- > begin;) {
+            IRInsn& in = ir.code[i];
+            if (in.op == IR_NOP) continue;
+            if (in.op == IR_SLOW) { markStack(in.depth); continue; }
+            if (hasLabelTarget(in.op)) markStack(ir.labels[in.target].depth);
+            if (in.op == IR_TABLESWITCH || in.op == IR_LOOKUPSWITCH) {
+                const IRSwitch& sw = ir.switches[in.target];
+                markStack(ir.labels[sw.defaultTarget].depth);
+                for (int32_t t : sw.targets) markStack(ir.labels[t].depth);
+            }
+
+            OpShape shape = shapeOf(in.op);
+            if (shape.def > 0) {
+                bool dead = shape.pure && in.dst >= ir.maxLocals;
+                for (uint8_t w = 0; dead && w < shape.def; w++) dead = !live[in.dst + w];
+                if (dead) { in.op = IR_NOP; continue; }
+                for (uint8_t w = 0; w < shape.def; w++) live[in.dst + w] = 0;
+            }
+            for (uint8_t w = 0; w < shape.a; w++) live[in.a + w] = 1;
+            for (uint8_t w = 0; w < shape.b; w++) live[in.b + w] = 1;
+            for (uint8_t w = 0; w < shape.c; w++) live[in.c + w] = 1;
+        }
+        end = begin;
+    }
+}
+
+// Remove NOPs and point the labels at the surviving insns
+// 删除 NOP，并让标签指向保留下来的指令
+void compact(IRMethod& ir) {
+    std::vector<uint32_t> newIndex(ir.code.size() + 1);
+    std::vector<IRInsn> kept;
+    kept.reserve(ir.code.size());
+    for (size_t i = 0; i < ir.code.size(); i++) {
+        newIndex[i] = (uint32_t)kept.size();
+        if (ir.code[i].op != IR_NOP) kept.push_back(ir.code[i]);
+    }
+    newIndex[ir.code.size()] = (uint32_t)kept.size();
+    for (auto& label : ir.labels) label.index = newIndex[label.index];
+    ir.code.swap(kept);
+}
+
+} // namespace
+
+void optimizeIR(IRMethod& ir) {
+    std::vector<uint8_t> starts = blockStarts(ir);
+    propagate(ir, starts);
+    removeNullChecks(ir, starts);
+    eliminateDeadStores(ir, starts);
+    compact(ir);
+}
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "StackFrame.hpp"
+
+namespace j2me {
+namespace core {
+
+// Register IR used by the second execution tier (see Interpreter_IR.cpp).
+//
+// Registers are the frame's own slots: register i < maxLocals is local i, register
+// maxLocals + d is operand stack depth d. Every IR instruction writes the value and
+// the tag of its destination, so whenever the IR stops (a bytecode it hands to the
+// instruction table, a taken branch that runs out of budget, an exception) the frame
+// is exactly the one the bytecode interpreter expects and execution simply continues
+// there. The passes only ever drop writes to operand stack registers that nothing
+// reads any more; locals are always written back.
+//
+// 第二执行层使用的寄存器 IR (见 Interpreter_IR.cpp)。
+// 寄存器即栈帧自身的槽位: 寄存器 i < maxLocals 为局部变量 i，寄存器 maxLocals + d 为操作数栈深度 d 处的槽位。
+// 每条 IR 指令都同时写入目标槽位的值和类型标记，因此 IR 在任何位置停下 (交给指令表执行的字节码、
+// 预算用尽的跳转、异常) 时，栈帧状态都与字节码解释器期望的完全一致，可直接在字节码层继续执行。
+// 优化只会删除不再被读取的操作数栈寄存器写入，局部变量总是写回
+
+// Value kind suffixes: I int, J long, F float, D double, A reference; the array element
+// and field forms add B byte/boolean, C char, S short. The *K_I forms take their right
+// operand from `imm`. The _I.._A groups follow the order of Interpreter::QuickKind, the
+// field groups that of FieldKind.
+// 类型后缀: I int, J long, F float, D double, A 引用; 数组元素与字段另有 B byte/boolean, C char, S short。
+// *K_I 指令的右操作数为立即数 imm。_I.._A 各组的顺序与 Interpreter::QuickKind 一致，字段指令组与 FieldKind 一致
+#define J2ME_IR_OPS(X) \
+    X(NOP) X(SLOW) \
+    X(MOV) X(MOV2) X(MOV_I) X(MOV_J) X(MOV_F) X(MOV_D) X(MOV_A) \
+    X(CONST_I) X(CONST_J) X(CONST_F) X(CONST_D) X(CONST_A) \
+    X(ADD_I) X(SUB_I) X(MUL_I) X(DIV_I) X(REM_I) X(AND_I) X(OR_I) X(XOR_I) X(SHL_I) X(SHR_I) X(USHR_I) X(NEG_I) \
+    X(ADDK_I) X(MULK_I) X(ANDK_I) X(ORK_I) X(XORK_I) X(SHLK_I) X(SHRK_I) X(USHRK_I) \
+    X(ADD_J) X(SUB_J) X(MUL_J) X(DIV_J) X(REM_J) X(AND_J) X(OR_J) X(XOR_J) X(SHL_J) X(SHR_J) X(USHR_J) X(NEG_J) \
+    X(ADD_F) X(SUB_F) X(MUL_F) X(DIV_F) X(REM_F) X(NEG_F) \
+    X(ADD_D) X(SUB_D) X(MUL_D) X(DIV_D) X(REM_D) X(NEG_D) \
+    X(I2L) X(I2F) X(I2D) X(L2I) X(L2F) X(L2D) X(F2I) X(F2L) X(F2D) X(D2I) X(D2L) X(D2F) X(I2B) X(I2C) X(I2S) \
+    X(CMP_J) X(CMPL_F) X(CMPG_F) X(CMPL_D) X(CMPG_D) \
+    X(IF_EQ) X(IF_NE) X(IF_LT) X(IF_GE) X(IF_GT) X(IF_LE) \
+    X(IFK_EQ) X(IFK_NE) X(IFK_LT) X(IFK_GE) X(IFK_GT) X(IFK_LE) \
+    X(IF_ACMPEQ) X(IF_ACMPNE) X(IF_NULL) X(IF_NONNULL) X(GOTO) X(TABLESWITCH) X(LOOKUPSWITCH) \
+    X(ALOAD_I) X(ALOAD_J) X(ALOAD_F) X(ALOAD_D) X(ALOAD_A) X(ALOAD_B) X(ALOAD_C) X(ALOAD_S) \
+    X(ASTORE_I) X(ASTORE_J) X(ASTORE_F) X(ASTORE_D) X(ASTORE_A) X(ASTORE_B) X(ASTORE_C) X(ASTORE_S) \
+    X(ARRAYLENGTH) X(CHECKCAST) X(INSTANCEOF) \
+    X(GETFIELD_I) X(GETFIELD_J) X(GETFIELD_F) X(GETFIELD_D) X(GETFIELD_A) X(GETFIELD_B) X(GETFIELD_C) X(GETFIELD_S) \
+    X(PUTFIELD_I) X(PUTFIELD_J) X(PUTFIELD_F) X(PUTFIELD_D) X(PUTFIELD_A) X(PUTFIELD_B) X(PUTFIELD_C) X(PUTFIELD_S) \
+    X(GETSTATIC_I) X(GETSTATIC_J) X(GETSTATIC_F) X(GETSTATIC_D) X(GETSTATIC_A) \
+    X(PUTSTATIC_I) X(PUTSTATIC_J) X(PUTSTATIC_F) X(PUTSTATIC_D) X(PUTSTATIC_A) \
+    X(RETURN) X(RETURN_I) X(RETURN_J) X(RETURN_F) X(RETURN_D) X(RETURN_A)
+
+enum IROp : uint8_t {
+#define J2ME_IR_ENUM(name) IR_##name,
+    J2ME_IR_OPS(J2ME_IR_ENUM)
+#undef J2ME_IR_ENUM
+    IR_OP_COUNT
+};
+
+// IRInsn::flags
+constexpr uint8_t IR_NONNULL = 0x01; // Base register is known to be non-null / 基址寄存器已知非空
+
+// Operand layout:
+//   dst      destination register (values of two slots occupy dst and dst + 1)
+//   a, b     source registers; for array and field access a is the array/object and b the index
+//   c        value register of stores (ASTORE_*, PUTFIELD_*, PUTSTATIC_*)
+//   target   IRMethod::labels index of a branch, IRMethod::switches index of a switch,
+//            the continuation label of SLOW (-1 if the bytecode never falls through)
+//   imm      constant, field byte offset (imm.i), static field storage / class (imm.ref)
+//   pc/depth bytecode pc and operand stack depth of the bytecode the insn was made from
+// 操作数约定:
+//   dst 目标寄存器 (双槽位数值占用 dst 和 dst + 1); a/b 源寄存器 (数组/字段访问时 a 为数组/对象，b 为下标);
+//   c 存储指令的值寄存器; target 跳转目标标签 / switch 表索引 / SLOW 的后继标签 (-1 表示不会顺序执行);
+//   imm 常量、字段槽位 (imm.i)、静态字段存储或类 (imm.ref); pc/depth 为来源字节码的 pc 与操作数栈深度
+struct IRInsn {
+    uint8_t op = IR_NOP;
+    uint8_t flags = 0;
+    uint16_t dst = 0;
+    uint16_t a = 0;
+    uint16_t b = 0;
+    uint16_t c = 0;
+    uint16_t depth = 0;
+    uint32_t pc = 0;
+    int32_t target = -1;
+    Slot imm{};
+};
+
+// A bytecode position the IR can be entered at (and leaves through on a taken branch)
+// IR 可进入的字节码位置 (预算用尽的跳转也从这里回到字节码层)
+struct IRLabel {
+    uint32_t index; // First IR insn / 第一条 IR 指令
+    uint32_t pc;    // Bytecode pc / 字节码 pc
+    uint16_t depth; // Operand stack depth at pc / 该处的操作数栈深度
+};
+
+struct IRSwitch {
+    int32_t low = 0;                     // TABLESWITCH: first key / 第一个键值
+    std::vector<int32_t> keys;           // LOOKUPSWITCH: sorted keys / 有序键值
+    std::vector<int32_t> targets;        // Label per key (per index for TABLESWITCH) / 每个键对应的标签
+    int32_t defaultTarget = -1;          // Default label / 默认标签
+};
+
+struct IRMethod {
+    std::vector<IRInsn> code;
+    std::vector<IRLabel> labels;
+    std::vector<IRSwitch> switches;
+    std::vector<int32_t> entryLabel;     // Bytecode pc -> label, -1 if the IR cannot be entered there / 字节码 pc -> 标签
+    uint16_t maxLocals = 0;
+    uint16_t maxStack = 0;
+    bool thisNonNull = false;            // Local 0 always holds 'this' / 局部变量 0 始终为 this
+    size_t bytecodeCount = 0;            // Bytecode instructions translated / 翻译的字节码指令数
+
+    uint16_t stackReg(size_t depth) const { return (uint16_t)(maxLocals + depth); }
+};
+
+// Operands of quickened instructions are indices into interpreter caches; the translator
+// resolves them through this interface. Each lookup returns false for an unknown operand.
+// 快速化指令的操作数是解释器缓存的索引，翻译器通过此接口查询; 未知操作数返回 false
+class IRQuickening {
+public:
+    virtual ~IRQuickening() = default;
+    // Methodref constant behind an INVOKE*_QUICK / 快速调用指令对应的方法引用常量
+    virtual bool invokeRef(uint16_t operand, uint16_t& cpIndex) const = 0;
+    // Storage and QuickKind of a quickened static field / 快速静态字段的存储位置与值类型
+    virtual bool staticField(uint16_t operand, void*& slot, uint8_t& kind) const = 0;
+    // Class (JavaClass*) of CHECKCAST_QUICK / INSTANCEOF_QUICK / 类型检查指令引用的类
+    virtual bool classRef(uint16_t operand, void*& cls) const = 0;
+};
+
+// Translate the bytecode of `method` and optimize it (IRBuilder.cpp). `quick` may be null
+// for bytecode that has never run (the AOT compiler); quickened instructions then make
+// the translation fail. Returns nullptr if the method uses bytecodes the translator does
+// not handle or its stack depths cannot be determined.
+// 翻译并优化 method 的字节码 (IRBuilder.cpp)。未执行过的字节码 (AOT 编译器) 可传入空的 quick，
+// 此时遇到快速化指令即翻译失败。含不支持的字节码或无法确定栈深度时返回 nullptr
+std::shared_ptr<IRMethod> buildIR(const RuntimeMethod& method, const ClassFile& cf, const IRQuickening* quick);
+
+// Run the optimization passes over freshly translated IR: constant folding, copy
+// propagation, redundant null-check removal and dead-store elimination, then drop
+// the removed instructions. All passes are local to a basic block.
+// 对刚翻译出的 IR 运行优化: 常量折叠、复写传播、冗余空检查消除和死存储消除，最后删除被移除的指令。
+// 所有优化均在基本块内进行
+void optimizeIR(IRMethod& ir);
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace j2me {
+namespace core {
+
+// Runtime exceptions raised by the VM itself (null checks, bounds checks, the heap cap, ...).
+// Raising one costs a handler lookup and, if Java code catches it, one small allocation:
+// no C++ exception, no string matching and no stack trace unless it turns out to be
+// uncaught (see Interpreter::raiseRuntimeException).
+// 虚拟机自身抛出的运行时异常 (空指针检查、越界检查、堆上限等)。抛出时只需查找处理器，被 Java 代码捕获时
+// 再分配一个小对象: 不经过 C++ 异常、不匹配字符串，只有未被捕获时才生成栈回溯 (见 Interpreter::raiseRuntimeException)
+#define J2ME_RUNTIME_EXCEPTIONS(X) \
+    X(NULL_POINTER, "java/lang/NullPointerException") \
+    X(ARRAY_INDEX, "java/lang/ArrayIndexOutOfBoundsException") \
+    X(STRING_INDEX, "java/lang/StringIndexOutOfBoundsException") \
+    X(ARITHMETIC, "java/lang/ArithmeticException") \
+    X(CLASS_CAST, "java/lang/ClassCastException") \
+    X(NEGATIVE_ARRAY_SIZE, "java/lang/NegativeArraySizeException") \
+    X(OUT_OF_MEMORY, "java/lang/OutOfMemoryError") \
+    X(RUNTIME, "java/lang/RuntimeException")
+
+enum class RuntimeExceptionKind : uint8_t {
+#define J2ME_RUNTIME_EXCEPTION_ENUM(id, className) id,
+    J2ME_RUNTIME_EXCEPTIONS(J2ME_RUNTIME_EXCEPTION_ENUM)
+#undef J2ME_RUNTIME_EXCEPTION_ENUM
+    COUNT
+};
+
+inline const char* runtimeExceptionClass(RuntimeExceptionKind kind) {
+    switch (kind) {
+#define J2ME_RUNTIME_EXCEPTION_NAME(id, className) case RuntimeExceptionKind::id: return className;
+        J2ME_RUNTIME_EXCEPTIONS(J2ME_RUNTIME_EXCEPTION_NAME)
+#undef J2ME_RUNTIME_EXCEPTION_NAME
+        default: return "java/lang/RuntimeException";
+    }
+}
+
+// Raised from code that has to unwind through C++ frames to reach the interpreter loop
+// (instruction table handlers, natives). The loops catch it before std::exception and
+// use the kind directly.
+// 需要穿过 C++ 栈帧回到解释循环时使用 (指令表处理函数、本地方法)。解释循环先于 std::exception
+// 捕获它，直接使用其中的异常种类
+struct JavaThrow : std::runtime_error {
+    RuntimeExceptionKind kind;
+    explicit JavaThrow(RuntimeExceptionKind k, const std::string& detail = std::string())
+        : std::runtime_error(detail.empty() ? std::string(runtimeExceptionClass(k)) : detail), kind(k) {}
+};
+
+// Kind of a plain std::runtime_error by its message, for natives that still throw those
+// 根据消息判断普通 std::runtime_error 对应的异常种类，供仍抛出此类错误的本地方法使用
+inline RuntimeExceptionKind runtimeExceptionFromMessage(const std::string& msg) {
+    if (msg.find("NullPointerException") != std::string::npos) return RuntimeExceptionKind::NULL_POINTER;
+    if (msg.find("ArrayIndexOutOfBoundsException") != std::string::npos) return RuntimeExceptionKind::ARRAY_INDEX;
+    if (msg.find("StringIndexOutOfBoundsException") != std::string::npos) return RuntimeExceptionKind::STRING_INDEX;
+    if (msg.find("ArithmeticException") != std::string::npos) return RuntimeExceptionKind::ARITHMETIC;
+    if (msg.find("ClassCastException") != std::string::npos) return RuntimeExceptionKind::CLASS_CAST;
+    if (msg.find("NegativeArraySizeException") != std::string::npos) return RuntimeExceptionKind::NEGATIVE_ARRAY_SIZE;
+    if (msg.find("OutOfMemoryError") != std::string::npos || msg == "std::bad_alloc") return RuntimeExceptionKind::OUT_OF_MEMORY;
+    return RuntimeExceptionKind::RUNTIME;
+}
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,177 @@
+#include "RuntimeMethod.hpp"
+#include "../util/DataReader.hpp"
+#include <algorithm>
+
+namespace j2me {
+namespace core {
+
+RuntimeMethod::RuntimeMethod(const MethodInfo& method, const ClassFile& classFile) {
+    isStatic = (method.access_flags & 0x0008) != 0;
+
+    if (method.descriptor_index < classFile.constant_pool.size()) {
+        auto descInfo = std::dynamic_pointer_cast<ConstantUtf8>(classFile.constant_pool[method.descriptor_index]);
+        if (descInfo) argSlots = countArgSlots(descInfo->bytes);
+    }
+    if (!isStatic) argSlots++; // 'this'
+
+    // 解析 Code 属性
+    // Parse Code attribute
+    for (const auto& attr : method.attributes) {
+        if (attr.attribute_name_index >= classFile.constant_pool.size()) continue;
+        auto nameInfo = std::dynamic_pointer_cast<ConstantUtf8>(classFile.constant_pool[attr.attribute_name_index]);
+        if (!nameInfo || nameInfo->bytes != "Code") continue;
+
+        util::DataReader attrReader(attr.info);
+        maxStack = attrReader.readU2();
+        maxLocals = attrReader.readU2();
+        uint32_t codeLength = attrReader.readU4();
+        code = attrReader.readBytes(codeLength);
+
+        uint16_t exceptionTableLength = attrReader.readU2();
+        for (int i = 0; i < exceptionTableLength; i++) {
+            ExceptionTableEntry entry;
+            entry.startPc = attrReader.readU2();
+            entry.endPc = attrReader.readU2();
+            entry.handlerPc = attrReader.readU2();
+            entry.catchType = attrReader.readU2();
+            exceptionTable.push_back(entry);
+        }
+
+        // Parse sub-attributes (LineNumberTable)
+        // 解析子属性 (行号表)
+        uint16_t subAttributesCount = attrReader.readU2();
+        for (int i = 0; i < subAttributesCount; i++) {
+            uint16_t subAttrNameIndex = attrReader.readU2();
+            uint32_t subAttrLength = attrReader.readU4();
+            auto nextAttrPos = attrReader.tell() + subAttrLength;
+
+            if (subAttrNameIndex < classFile.constant_pool.size()) {
+                auto subNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(classFile.constant_pool[subAttrNameIndex]);
+                if (subNameInfo && subNameInfo->bytes == "LineNumberTable") {
+                    uint16_t lineNumberTableLength = attrReader.readU2();
+                    for (int j = 0; j < lineNumberTableLength; j++) {
+                        LineNumberTableEntry entry;
+                        entry.startPc = attrReader.readU2();
+                        entry.lineNumber = attrReader.readU2();
+                        lineNumberTable.push_back(entry);
+                    }
+                }
+            }
+            attrReader.seek(nextAttrPos);
+        }
+        break;
+    }
+
+    buildHandlerRanges();
+
+    // javac always reserves room for the arguments, but be defensive about hand-written classes
+    // javac 总会为参数预留局部变量，这里对手写的类文件做防御性处理
+    if (!code.empty() && maxLocals < argSlots) maxLocals = argSlots;
+}
+
+uint16_t RuntimeMethod::countArgSlots(const std::string& descriptor) {
+    uint16_t slots = 0;
+    size_t i = 1; // Skip '('
+    while (i < descriptor.length() && descriptor[i] != ')') {
+        char c = descriptor[i];
+        if (c == '[') {
+            // An array is one reference, whatever its element type
+            // 数组无论元素类型如何都只占一个引用槽位
+            while (i < descriptor.length() && descriptor[i] == '[') i++;
+            if (i < descriptor.length() && descriptor[i] == 'L') {
+                while (i < descriptor.length() && descriptor[i] != ';') i++;
+            }
+            slots++;
+        } else if (c == 'L') {
+            while (i < descriptor.length() && descriptor[i] != ';') i++;
+            slots++;
+        } else if (c == 'J' || c == 'D') {
+            slots += 2;
+        } else {
+            slots++;
+        }
+        i++;
+    }
+    return slots;
+}
+
+int RuntimeMethod::getLineNumber(uint32_t pc) const {
+    // The entry with the largest startPc that is <= pc (the table is not necessarily sorted)
+    // 查找 startPc <= pc 且 startPc 最大的表项 (行号表不一定有序)
+    int line = -1;
+    int bestStartPc = -1;
+    for (const auto& entry : lineNumberTable) {
+        if (entry.startPc <= pc && (int)entry.startPc > bestStartPc) {
+            bestStartPc = entry.startPc;
+            line = entry.lineNumber;
+        }
+    }
+    return line;
+}
+
+void RuntimeMethod::buildHandlerRanges() {
+    handlers.clear();
+    handlerRanges.clear();
+    handlerOrder.clear();
+    if (exceptionTable.empty()) return;
+
+    for (const auto& entry : exceptionTable) {
+        Handler handler;
+        handler.handlerPc = entry.handlerPc;
+        handler.catchType = entry.catchType;
+        if (entry.catchType == 0) handler.kind = CatchKind::ANY;
+        handlers.push_back(handler);
+    }
+
+    // Every start or end pc is a boundary; between two neighbouring boundaries the set of
+    // covering entries does not change. Nested try blocks overlap, so each piece keeps
+    // its entries in table order (the JVM takes the first match).
+    // 每个起止 pc 都是一个边界，相邻边界之间覆盖的表项不变。嵌套的 try 块会相互重叠，
+    // 因此每个区间按异常表顺序保存表项 (JVM 取第一个匹配的表项)
+    std::vector<uint16_t> bounds;
+    for (const auto& entry : exceptionTable) {
+        if (entry.startPc >= entry.endPc) continue;
+        bounds.push_back(entry.startPc);
+        bounds.push_back(entry.endPc);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    for (size_t b = 0; b + 1 < bounds.size(); b++) {
+        HandlerRange range;
+        range.startPc = bounds[b];
+        range.endPc = bounds[b + 1];
+        range.first = (uint16_t)handlerOrder.size();
+        for (size_t i = 0; i < exceptionTable.size(); i++) {
+            const auto& entry = exceptionTable[i];
+            if (entry.startPc <= range.startPc && range.endPc <= entry.endPc) handlerOrder.push_back((uint16_t)i);
+        }
+        range.count = (uint16_t)(handlerOrder.size() - range.first);
+        if (range.count == 0) continue;
+        // Neighbours with the same handlers become one range
+        // 处理器相同的相邻区间合并为一个
+        if (!handlerRanges.empty()) {
+            HandlerRange& last = handlerRanges.back();
+            if (last.endPc == range.startPc && last.count == range.count &&
+                std::equal(handlerOrder.begin() + last.first, handlerOrder.begin() + last.first + last.count,
+                           handlerOrder.begin() + range.first)) {
+                last.endPc = range.endPc;
+                handlerOrder.resize(range.first);
+                continue;
+            }
+        }
+        handlerRanges.push_back(range);
+    }
+}
+
+const RuntimeMethod::HandlerRange* RuntimeMethod::findHandlers(uint32_t pc) const {
+    // The first range ending after pc; it covers pc unless pc falls in a gap
+    // 第一个结束位置大于 pc 的区间; 除非 pc 位于空隙中，该区间即覆盖 pc
+    auto it = std::upper_bound(handlerRanges.begin(), handlerRanges.end(), pc,
+                               [](uint32_t value, const HandlerRange& range) { return value < range.endPc; });
+    if (it == handlerRanges.end() || pc < it->startPc) return nullptr;
+    return &*it;
+}
+
+} // namespace core
+} // namespace j2me
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "ClassFile.hpp"
+
+namespace j2me {
+namespace core {
+
+struct IRMethod;
+class JitCode;
+class JavaClass;
+
+// Link-time, pre-decoded form of a method body. Built once per MethodInfo when the
+// class is linked and shared by every frame of that method, so an invoke no longer
+// re-parses the Code attribute or copies the bytecode.
+// 方法体在链接期预先解码后的形式。每个 MethodInfo 在类链接时构建一次，并由该方法的所有栈帧共享，
+// 因此方法调用不再重复解析 Code 属性或复制字节码
+struct RuntimeMethod {
+    // Exception Table Entry
+    struct ExceptionTableEntry {
+        uint16_t startPc;
+        uint16_t endPc;
+        uint16_t handlerPc;
+        uint16_t catchType; // Index into constant pool
+    };
+
+    // How a handler's catch_type matches, decided on the first throw that reaches it
+    // 处理器 catch_type 的匹配方式，在第一次有异常到达该处理器时确定
+    enum class CatchKind : uint8_t {
+        UNRESOLVED,   // Not looked at yet / 尚未解析
+        ANY,          // catch_type 0 (finally) or java/lang/Throwable / finally 或 Throwable
+        CLASS,        // Subclasses of catchClass / catchClass 的子类
+        NONE          // The catch class cannot be loaded / 无法加载捕获的类
+    };
+
+    struct Handler {
+        uint16_t handlerPc;
+        uint16_t catchType;             // Index into constant pool / 常量池索引
+        CatchKind kind = CatchKind::UNRESOLVED;
+        JavaClass* catchClass = nullptr;
+    };
+
+    // Pieces of the code with the same handlers: [startPc, endPc) is covered by
+    // handlerOrder[first .. first + count), in exception table order. Sorted and disjoint.
+    // 拥有相同处理器的代码区间: [startPc, endPc) 由 handlerOrder[first .. first + count) 覆盖
+    // (按异常表顺序)。区间按 pc 排序且互不重叠
+    struct HandlerRange {
+        uint16_t startPc;
+        uint16_t endPc;
+        uint16_t first;
+        uint16_t count;
+    };
+
+    struct LineNumberTableEntry {
+        uint16_t startPc;
+        uint16_t lineNumber;
+    };
+
+    // Decode the Code attribute of `method` (an empty code array for native/abstract methods)
+    // 解码方法的 Code 属性 (native/abstract 方法的字节码为空)
+    RuntimeMethod(const MethodInfo& method, const ClassFile& classFile);
+
+    // Number of argument slots for a method descriptor, without 'this' (long/double count twice)
+    // 根据方法描述符计算参数槽位数 (不含 this，long/double 计为两个槽位)
+    static uint16_t countArgSlots(const std::string& descriptor);
+
+    // Get line number for a PC
+    int getLineNumber(uint32_t pc) const;
+
+    // The range of handlers covering pc, nullptr if there is none
+    // 覆盖 pc 的处理器区间，没有时返回 nullptr
+    const HandlerRange* findHandlers(uint32_t pc) const;
+
+    // Split the exception table into handlerRanges (done once, after decoding)
+    // 将异常表划分为 handlerRanges (解码后执行一次)
+    void buildHandlerRanges();
+
+    // Bytecode. Quickening rewrites it in place, so every frame of the method
+    // sees the rewritten instructions.
+    // 字节码。指令快速化直接原地改写，该方法的所有栈帧都能看到改写后的指令
+    std::vector<uint8_t> code;
+    std::vector<ExceptionTableEntry> exceptionTable;   // 异常处理表
+    std::vector<LineNumberTableEntry> lineNumberTable; // 行号表
+    std::vector<Handler> handlers;          // exceptionTable 中各项的处理器 (下标相同)
+    std::vector<HandlerRange> handlerRanges; // 按 pc 排序的处理器区间
+    std::vector<uint16_t> handlerOrder;     // 各区间的处理器下标
+    uint16_t maxStack = 0;                  // Code 属性中的 max_stack
+    uint16_t maxLocals = 0;                 // Code 属性中的 max_locals
+    uint16_t argSlots = 0;                  // 参数槽位数 (含实例方法的 this)
+    bool isStatic = false;                  // 是否为静态方法
+
+    // Register IR tier and baseline JIT (see Interpreter_IR.cpp, Interpreter_Jit.cpp)
+    // 寄存器 IR 层与基线 JIT (见 Interpreter_IR.cpp、Interpreter_Jit.cpp)
+    uint32_t hotness = 0;                   // 调用次数 + 向后跳转次数
+    bool irFailed = false;                  // 无法翻译为 IR，不再尝试
+    std::shared_ptr<IRMethod> ir;           // 翻译后的 IR (尚未翻译时为空)
+    bool jitFailed = false;                 // 无法编译为机器码，不再尝试
+    std::shared_ptr<JitCode> jit;           // 基线 JIT 生成的机器码 (见 JitX64.hpp)
+};
+
+} // namespace core
+} // namespace j2me
@@ -1,11 +1,18 @@
 #include "RuntimeTypes.hpp"
+#include "RuntimeMethod.hpp"
 #include "Logger.hpp"
 #include <iostream>
+#include <algorithm>
+#include <functional>
 
 namespace j2me {
 namespace core {
 
 JavaClass::JavaClass(std::shared_ptr<ClassFile> file) : rawFile(file) {
+    // Classes that are never linked (mocks) are roots of their own display
+    // 从不链接的类 (模拟类) 的父类型表只包含自身
+    primarySupers.push_back(this);
+
     // If rawFile is dummy (for Object), skip name extraction
     if (file->this_class == 0) return; 
 
@@ -17,10 +24,12 @@ JavaClass::JavaClass(std::shared_ptr<ClassFile> file) : rawFile(file) {
     }
     auto nameInfo = std::dynamic_pointer_cast<ConstantUtf8>(file->constant_pool[classInfo->name_index]);
     name = nameInfo->bytes;
+    isObjectClass = (name == "java/lang/Object");
 }
 
 void JavaClass::link(std::shared_ptr<JavaClass> parent) {
     superClass = parent;
+    if (parent) parent->subclasses.push_back(this);
     size_t offset = 0;
     
     if (parent) {
@@ -28,30 +37,203 @@ void JavaClass::link(std::shared_ptr<JavaClass> parent) {
         fieldOffsets = parent->fieldOffsets; 
     }
 
-    //std::cerr << "[JavaClass::link] Linking class: " << name << " with " << rawFile->fields.size() << " fields" << std::endl;
-    
+    // Own instance fields, largest first (stable, so declaration order within a size)
+    // 本类的实例字段，按大小降序 (稳定排序，同样大小的保持声明顺序)
+    std::vector<std::pair<size_t, std::string>> own;
     for (const auto& field : rawFile->fields) {
         auto nameInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[field.name_index]);
         auto descInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[field.descriptor_index]);
         
-        //std::cerr << "[JavaClass::link]   Field: " << nameInfo->bytes << " desc=" << descInfo->bytes << " access_flags=" << field.access_flags << std::endl;
-        
         std::string key = nameInfo->bytes + "|" + descInfo->bytes;
         
         if (field.access_flags & 0x0008) {
-            staticFields[key] = 0;
+            size_t slot = staticSlots.size();
+            staticFieldIndex[key] = slot;
+            staticSlots.push_back(0);
+            for (const auto& attr : field.attributes) {
+                if (attr.info.size() != 2 || attr.attribute_name_index >= rawFile->constant_pool.size()) continue;
+                auto attrName = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[attr.attribute_name_index]);
+                if (!attrName || attrName->bytes != "ConstantValue") continue;
+                staticConstants.push_back({slot, (uint16_t)((attr.info[0] << 8) | attr.info[1])});
+            }
         } else {
-            fieldOffsets[key] = offset++;
+            own.emplace_back(fieldSize(fieldKindOf(descInfo->bytes)), key);
+        }
+    }
+    std::stable_sort(own.begin(), own.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    // Smaller fields first fill the gap between the superclass layout and the alignment of
+    // the largest field; the rest follow in size order, which needs no further padding
+    // 较小的字段先填补父类布局末尾到最大字段对齐位置之间的空隙; 其余字段按大小依次排列，无需再填充
+    auto alignUp = [](size_t value, size_t align) { return (value + align - 1) & ~(align - 1); };
+    std::vector<bool> placed(own.size(), false);
+    if (!own.empty()) {
+        size_t aligned = alignUp(offset, own[0].first);
+        for (size_t i = 0; i < own.size(); i++) {
+            size_t at = alignUp(offset, own[i].first);
+            if (own[i].first >= own[0].first || at + own[i].first > aligned) continue;
+            fieldOffsets[own[i].second] = at;
+            offset = at + own[i].first;
+            placed[i] = true;
         }
+        offset = aligned;
+    }
+    for (size_t i = 0; i < own.size(); i++) {
+        if (placed[i]) continue;
+        offset = alignUp(offset, own[i].first);
+        fieldOffsets[own[i].second] = offset;
+        offset += own[i].first;
     }
     instanceSize = offset;
-    //std::cerr << "[JavaClass::link]   instanceSize=" << instanceSize << " fieldOffsets size=" << fieldOffsets.size() << std::endl;
+
+    // Where the references are, for the garbage collector
+    // 记录引用所在位置，供垃圾回收器使用
+    auto isReference = [](const std::string& key) {
+        return fieldKindOf(key.substr(key.find('|') + 1)) == FIELD_A;
+    };
+    referenceOffsets.clear();
+    for (const auto& field : fieldOffsets) {
+        if (isReference(field.first)) referenceOffsets.push_back((uint32_t)field.second);
+    }
+    std::sort(referenceOffsets.begin(), referenceOffsets.end());
+    staticReferenceSlots.clear();
+    for (const auto& field : staticFieldIndex) {
+        if (isReference(field.first)) staticReferenceSlots.push_back((uint32_t)field.second);
+    }
+
+    // Decode every method body once; frames share the result
+    // 每个方法体只解码一次，由所有栈帧共享
+    for (auto& method : rawFile->methods) {
+        if (!method.runtime) {
+            method.runtime = std::make_shared<RuntimeMethod>(method, *rawFile);
+        }
+    }
+
+    buildSupers(parent);
+    buildVTable(parent);
+    if (!isInterface()) buildITables(parent);
+}
+
+bool JavaClass::isSecondarySuper(const JavaClass* iface) const {
+    return std::binary_search(secondarySupers.begin(), secondarySupers.end(), iface,
+                              std::less<const JavaClass*>());
+}
+
+// Arrays of references are covariant in their component type (String[] is an Object[]);
+// a primitive array is only itself, which isAssignableTo has already checked
+// 引用数组随元素类型协变 (String[] 是 Object[]); 基本类型数组只与自身相同，isAssignableTo 已检查过
+bool JavaClass::isArrayAssignableTo(const JavaClass* target) const {
+    if (!isArray || elementKind != FIELD_A || target->elementKind != FIELD_A) return false;
+    return componentClass && target->componentClass && componentClass->isAssignableTo(target->componentClass);
+}
+
+void JavaClass::buildSupers(const std::shared_ptr<JavaClass>& parent) {
+    primarySupers.clear();
+    secondarySupers.clear();
+    if (parent) {
+        primarySupers = parent->primarySupers;
+        secondarySupers = parent->secondarySupers;
+    }
+    primarySupers.push_back(this);
+
+    for (const auto& iface : interfaces) {
+        if (!iface) continue;
+        secondarySupers.push_back(iface.get());
+        secondarySupers.insert(secondarySupers.end(), iface->secondarySupers.begin(), iface->secondarySupers.end());
+    }
+    std::sort(secondarySupers.begin(), secondarySupers.end(), std::less<JavaClass*>());
+    secondarySupers.erase(std::unique(secondarySupers.begin(), secondarySupers.end()), secondarySupers.end());
+}
+
+void JavaClass::buildVTable(const std::shared_ptr<JavaClass>& parent) {
+    vtable.clear();
+    vtableIndex.clear();
+
+    auto add = [this](const VTableEntry& entry) {
+        std::string key = entry.name + "|" + entry.descriptor;
+        auto it = vtableIndex.find(key);
+        if (it != vtableIndex.end()) {
+            vtable[it->second] = entry; // Override // 重写
+        } else if (vtable.size() < NO_METHOD) {
+            vtableIndex[key] = (uint16_t)vtable.size();
+            vtable.push_back(entry);
+        }
+    };
+
+    if (parent) {
+        vtable = parent->vtable;
+        vtableIndex = parent->vtableIndex;
+    }
+    // An interface also lists the methods of its superinterfaces, since invokeinterface
+    // names the static type of the receiver
+    // 接口同时列出父接口的方法，因为 invokeinterface 引用的是接收者的静态类型
+    if (isInterface()) {
+        for (const auto& iface : interfaces) {
+            if (!iface) continue;
+            for (const auto& entry : iface->vtable) {
+                if (vtableIndex.find(entry.name + "|" + entry.descriptor) == vtableIndex.end()) add(entry);
+            }
+        }
+    }
+
+    for (const auto& method : rawFile->methods) {
+        if (method.access_flags & (0x0008 | 0x0002)) continue; // ACC_STATIC | ACC_PRIVATE
+        auto nameInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[method.name_index]);
+        auto descInfo = std::dynamic_pointer_cast<ConstantUtf8>(rawFile->constant_pool[method.descriptor_index]);
+        if (!nameInfo || !descInfo || nameInfo->bytes.empty() || nameInfo->bytes[0] == '<') continue; // <init>, <clinit>
+        add({&method, this, nameInfo->bytes, descInfo->bytes});
+    }
+}
+
+void JavaClass::buildITables(const std::shared_ptr<JavaClass>& parent) {
+    itables.clear();
+
+    // Every interface of the superclass, then our own together with their superinterfaces
+    // 父类的所有接口，以及本类直接实现的接口及其父接口
+    std::vector<JavaClass*> all;
+    auto collect = [&all](JavaClass* iface, auto& self) -> void {
+        if (!iface || std::find(all.begin(), all.end(), iface) != all.end()) return;
+        all.push_back(iface);
+        for (const auto& super : iface->interfaces) self(super.get(), self);
+    };
+    if (parent) {
+        for (const auto& itable : parent->itables) collect(itable.iface, collect);
+    }
+    for (const auto& iface : interfaces) collect(iface.get(), collect);
+
+    for (JavaClass* iface : all) {
+        ITable itable;
+        itable.iface = iface;
+        itable.slots.reserve(iface->vtable.size());
+        for (const auto& entry : iface->vtable) {
+            auto it = vtableIndex.find(entry.name + "|" + entry.descriptor);
+            itable.slots.push_back(it != vtableIndex.end() ? it->second : NO_METHOD);
+        }
+        itables.push_back(std::move(itable));
+    }
+}
+
+bool JavaClass::isOverridden(uint16_t index) const {
+    if (index >= vtable.size()) return false;
+    const MethodInfo* method = vtable[index].method;
+    for (const JavaClass* sub : subclasses) {
+        if (index < sub->vtable.size() && sub->vtable[index].method != method) return true;
+        if (sub->isOverridden(index)) return true;
+    }
+    return false;
 }
 
-JavaObject::JavaObject(std::shared_ptr<JavaClass> cls) : cls(cls) {
-    if (cls) {
-        fields.resize(cls->instanceSize);
+uint32_t JavaObject::identityHash() {
+    // Marsaglia xor-shift, never 0 (0 marks "not assigned yet")
+    // Marsaglia xor-shift 随机数，不为 0 (0 表示尚未分配)
+    static uint32_t state = 0x2545F491u;
+    while (hash == 0) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        hash = state & 0x7FFFFFFFu;
     }
+    return hash;
 }
 
 } // namespace core
@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <cstring>
 #include "ClassFile.hpp"
 
 namespace j2me {
@@ -11,24 +12,190 @@ namespace core {
 
 class JavaObject;
 
-// Runtime representation of a Class
-// 类的运行时表示
-class JavaClass {
+// -DJ2ME_COMPRESSED_REFS=1 stores the references held inside the Java heap (instance fields
+// and array elements) as 32-bit byte offsets from the base of HeapManager's region, which
+// is then at most 4 GB. Reference fields and Object[] elements take 4 bytes instead of 8.
+// Operand stacks, locals and static slots keep full pointers; encodeRef/decodeRef convert
+// at the boundary, and offset 0 (never an object) is null.
+// 可通过 -DJ2ME_COMPRESSED_REFS=1 将 Java 堆内的引用 (实例字段、数组元素) 存为相对 HeapManager
+// 堆区起始地址的 32 位字节偏移 (堆区此时不超过 4 GB)，引用字段与 Object[] 元素由 8 字节减为 4 字节。
+// 操作数栈、局部变量与静态槽位仍保存完整指针，由 encodeRef/decodeRef 在边界处转换; 偏移 0 (不会有对象) 表示 null
+#ifndef J2ME_COMPRESSED_REFS
+#define J2ME_COMPRESSED_REFS 0
+#endif
+
+#if J2ME_COMPRESSED_REFS
+using HeapRef = uint32_t;
+// Base of the heap region, set once by HeapManager (and by the VM in every AOT module)
+// 堆区起始地址，由 HeapManager 设置一次 (虚拟机也会为每个 AOT 模块设置)
+inline uint8_t* compressedRefBase = nullptr;
+inline HeapRef encodeRef(JavaObject* obj) {
+    return obj ? (HeapRef)(reinterpret_cast<uint8_t*>(obj) - compressedRefBase) : 0;
+}
+inline JavaObject* decodeRef(HeapRef ref) {
+    return ref ? reinterpret_cast<JavaObject*>(compressedRefBase + ref) : nullptr;
+}
+#else
+using HeapRef = JavaObject*;
+inline HeapRef encodeRef(JavaObject* obj) { return obj; }
+inline JavaObject* decodeRef(HeapRef ref) { return ref; }
+#endif
+
+// Card table of HeapManager's generational collector: one byte per 2^CARD_SHIFT bytes of
+// the heap region, set whenever a reference is stored into an object whose header lies in
+// that card, so a minor collection only scans the old objects that may point into the
+// nursery. The base is biased by the region address: the card of `obj` is
+// cardTableBase[address >> CARD_SHIFT]. Set once by HeapManager (and by the VM in every
+// AOT module).
+// HeapManager 分代回收器的卡表: 堆区每 2^CARD_SHIFT 字节对应一个字节，向对象头位于该卡内的对象写入引用时置位，
+// 次要回收因此只需扫描可能指向新生代的老年代对象。基址已按堆区地址偏置: obj 的卡为 cardTableBase[地址 >> CARD_SHIFT]。
+// 由 HeapManager 设置一次 (虚拟机也会为每个 AOT 模块设置)
+constexpr unsigned CARD_SHIFT = 9;
+inline uint8_t* cardTableBase = nullptr;
+inline void markCard(const JavaObject* obj) {
+    cardTableBase[reinterpret_cast<uintptr_t>(obj) >> CARD_SHIFT] = 1;
+}
+
+// Storage kind of an instance field. Int-like fields are packed to their own size. The
+// first five follow Interpreter::QuickKind; B/C/S follow the array element forms of the
+// register IR, so one value serves the quickened opcodes, the IR and the JIT.
+// 实例字段的存储类型。int 类字段按其实际大小紧凑存放。前五项与 Interpreter::QuickKind 一致，
+// B/C/S 与寄存器 IR 的数组元素形式一致，快速指令、IR 和 JIT 使用同一套取值
+enum FieldKind : uint8_t {
+    FIELD_I, // int / 4 字节
+    FIELD_J, // long / 8 字节
+    FIELD_F, // float / 4 字节
+    FIELD_D, // double / 8 字节
+    FIELD_A, // reference / 引用，sizeof(HeapRef) 字节
+    FIELD_B, // byte, boolean / 1 字节
+    FIELD_C, // char / 2 字节，无符号
+    FIELD_S, // short / 2 字节
+};
+
+inline uint8_t fieldKindOf(const std::string& descriptor) {
+    switch (descriptor.empty() ? 'I' : descriptor[0]) {
+        case 'L': case '[': return FIELD_A;
+        case 'J': return FIELD_J;
+        case 'F': return FIELD_F;
+        case 'D': return FIELD_D;
+        case 'B': case 'Z': return FIELD_B;
+        case 'C': return FIELD_C;
+        case 'S': return FIELD_S;
+        default: return FIELD_I;
+    }
+}
+
+inline size_t fieldSize(uint8_t kind) {
+    static constexpr uint8_t sizes[] = { 4, 8, 4, 8, sizeof(HeapRef), 1, 2, 2 };
+    return sizes[kind & 7];
+}
+
+// Operand of GETFIELD_QUICK_* / PUTFIELD_QUICK_*: the field's byte offset shifted left
+// by 3, its FieldKind in the low bits (the opcode alone cannot tell byte from int)
+// GETFIELD_QUICK_* / PUTFIELD_QUICK_* 的操作数: 字段字节偏移左移 3 位，低位为 FieldKind
+// (仅凭操作码无法区分 byte 与 int 字段)
+constexpr size_t QUICK_FIELD_OFFSET_LIMIT = 0x2000;
+inline uint16_t quickFieldOperand(size_t offset, uint8_t kind) { return (uint16_t)((offset << 3) | kind); }
+inline size_t quickFieldOffset(uint16_t operand) { return operand >> 3; }
+inline uint8_t quickFieldKind(uint16_t operand) { return (uint8_t)(operand & 7); }
+
+// Runtime representation of a Class. Classes are always owned by a shared_ptr, so the
+// raw class pointer in an object header can be turned back into one.
+// 类的运行时表示。类总是由 shared_ptr 持有，因此对象头中的类指针可以还原为 shared_ptr
+class JavaClass : public std::enable_shared_from_this<JavaClass> {
 public:
     std::shared_ptr<ClassFile> rawFile; // 原始 .class 文件结构
     std::string name;                   // 类名 (例如 java/lang/String)
     std::shared_ptr<JavaClass> superClass; // 父类引用
     std::vector<std::shared_ptr<JavaClass>> interfaces; // 实现的接口列表
     
-    // Field layout map: name -> offset in object fields vector
-    // 字段布局映射: 字段名|描述符 -> 对象实例字段数组中的索引 (Offset)
-    // 用于快速查找实例字段的位置
+    // Field layout map: name|descriptor -> byte offset of the field after the object header.
+    // link() packs each class's own fields by size (largest first, smaller ones filling the
+    // alignment gap left by the superclass); the superclass layout is kept as a prefix.
+    // 字段布局映射: 字段名|描述符 -> 字段在对象头之后的字节偏移。
+    // link() 将本类字段按大小紧凑排列 (大的在前，小字段填补父类布局末尾的对齐空隙)，父类布局保持为前缀
     std::map<std::string, size_t> fieldOffsets;
-    size_t instanceSize = 0; // Number of fields (slots) // 实例字段总数 (对象所需槽位数)
+    size_t instanceSize = 0; // Bytes of instance fields after the header // 对象头之后实例字段的字节数
+
+    // Array classes ("[I", "[Ljava/lang/String;", ...): storage kind of the elements and, for
+    // arrays of references, the component class (covariant CHECKCAST/INSTANCEOF/catch)
+    // 数组类: 元素的存储类型; 引用数组另记录元素类 (用于协变的 CHECKCAST/INSTANCEOF)
+    bool isArray = false;
+    uint8_t elementKind = FIELD_A;
+    JavaClass* componentClass = nullptr;
     
-    // Static fields storage: name -> value
-    // 静态字段存储: 字段名|描述符 -> 值 (int64_t 存储所有基本类型和引用)
-    std::map<std::string, int64_t> staticFields;
+    // Static fields, laid out by link() into one slot array (int64_t holds every primitive
+    // type and references). The array is sized once, so slot addresses stay valid for
+    // quickened instructions and compiled code.
+    // 静态字段，由 link() 布局到一个连续的槽位数组中 (int64_t 存储所有基本类型和引用)。
+    // 数组只分配一次，槽位地址对快速化指令和编译代码始终有效
+    std::vector<int64_t> staticSlots;
+    std::map<std::string, size_t> staticFieldIndex; // 字段名|描述符 -> staticSlots 中的索引
+
+    // ConstantValue attributes of static fields, stored into their slots when the class
+    // is initialized
+    // 静态字段的 ConstantValue 属性，在类初始化时写入对应槽位
+    struct StaticConstant {
+        size_t slot;
+        uint16_t valueIndex; // Constant pool index / 常量池索引
+    };
+    std::vector<StaticConstant> staticConstants;
+
+    // Slot of a static field declared by this class, nullptr if it has none by that key
+    // 本类声明的静态字段的槽位，没有该字段时返回 nullptr
+    int64_t* findOwnStatic(const std::string& key) {
+        auto it = staticFieldIndex.find(key);
+        return it == staticFieldIndex.end() ? nullptr : &staticSlots[it->second];
+    }
+
+    // Virtual method table entry. Entries inherited from the superclass keep their
+    // index, overriding methods replace them in place, new methods are appended.
+    // 虚方法表项: 继承自父类的表项保持原索引，重写的方法原地替换，新方法追加在末尾
+    struct VTableEntry {
+        const MethodInfo* method = nullptr; // 方法信息 (位于 owner->rawFile->methods 中)
+        JavaClass* owner = nullptr;         // 声明该方法的类
+        std::string name;                   // 方法名
+        std::string descriptor;             // 方法描述符
+    };
+
+    // Interface method table: for each method of `iface` (in iface->vtable order),
+    // the index of the implementing method in this class's vtable, or NO_METHOD
+    // 接口方法表: 按 iface->vtable 的顺序记录每个接口方法在本类 vtable 中的索引 (未实现时为 NO_METHOD)
+    struct ITable {
+        JavaClass* iface = nullptr;
+        std::vector<uint16_t> slots;
+    };
+    static constexpr uint16_t NO_METHOD = 0xFFFF;
+
+    // Instance methods, inherited ones first. For an interface this is its method
+    // list (superinterfaces' methods first), which ITable::slots is indexed by.
+    // java/lang/Object is not linked as a superclass, so its methods are not included.
+    // 实例方法表 (继承的方法在前)。接口的 vtable 即其方法列表 (父接口的方法在前)，供 ITable::slots 索引。
+    // java/lang/Object 不作为父类参与链接，因此不包含其方法
+    std::vector<VTableEntry> vtable;
+    std::map<std::string, uint16_t> vtableIndex; // 方法名|描述符 -> vtable 索引
+    std::vector<ITable> itables; // One per interface implemented, directly or not // 每个 (直接或间接) 实现的接口一项
+
+    // Supertype display, built by link(). primarySupers[d] is the superclass at depth d,
+    // this class last; secondarySupers holds every interface, sorted for binary search.
+    // java/lang/Object is not in the display: everything is assignable to it.
+    // 父类型表 (由 link() 构建): primarySupers[d] 为深度 d 处的父类，最后一项为本类；
+    // secondarySupers 为所有接口，按地址排序以便二分查找。java/lang/Object 不在表中: 任何类都可赋值给它
+    std::vector<JavaClass*> primarySupers;
+    std::vector<JavaClass*> secondarySupers;
+    bool isObjectClass = false; // java/lang/Object
+
+    // Byte offsets of the reference instance fields (inherited ones included) and the
+    // staticSlots indices of the reference static fields, filled in by link() for the
+    // garbage collector
+    // 引用类型实例字段的字节偏移 (含继承的字段) 与引用类型静态字段在 staticSlots 中的索引，
+    // 由 link() 填写，供垃圾回收器遍历
+    std::vector<uint32_t> referenceOffsets;
+    std::vector<uint32_t> staticReferenceSlots;
+
+    // Loaded classes linked with this one as their superclass (for class hierarchy analysis)
+    // 以本类为父类链接的已加载类 (用于类层次分析)
+    std::vector<JavaClass*> subclasses;
 
     // Flag to track if static initialization has been done
     // 标志: 类是否已初始化 (<clinit> 是否已执行)
@@ -38,24 +205,132 @@ public:
     // 标志: 类是否正在初始化中 (用于防止循环初始化死锁)
     bool initializing = false;
 
+    // Set once <clinit> has returned (or right away if the class has none)
+    // 标志: <clinit> 是否已执行完毕 (没有 <clinit> 的类在初始化时立即置位)
+    bool clinitDone = false;
+
     JavaClass(std::shared_ptr<ClassFile> file);
     
-    // Resolve hierarchy and calculate field offsets
-    // 链接类: 解析继承层次结构并计算字段偏移量
+    bool isInterface() const { return (rawFile->access_flags & 0x0200) != 0; } // ACC_INTERFACE
+    bool isFinal() const { return (rawFile->access_flags & 0x0010) != 0; }     // ACC_FINAL
+
+    // Subtype check against the display (CHECKCAST, INSTANCEOF, exception matching)
+    // 基于父类型表的子类型检查 (CHECKCAST、INSTANCEOF、异常匹配)
+    bool isAssignableTo(const JavaClass* target) const {
+        if (target == this || target->isObjectClass) return true;
+        if (target->isInterface()) return isSecondarySuper(target);
+        if (target->isArray) return isArrayAssignableTo(target);
+        size_t depth = target->primarySupers.size() - 1;
+        return depth < primarySupers.size() && primarySupers[depth] == target;
+    }
+
+    // Whether any loaded subclass has a different method at vtable[index]
+    // 是否有已加载的子类在 vtable[index] 处使用了不同的方法 (即重写了该方法)
+    bool isOverridden(uint16_t index) const;
+
+    // Resolve hierarchy, calculate field offsets and build the vtable and itables.
+    // `interfaces` must be filled in before this is called.
+    // 链接类: 解析继承层次结构，计算字段偏移量并构建 vtable 和 itable (调用前需先填充 interfaces)
     void link(std::shared_ptr<JavaClass> parent);
+
+private:
+    bool isSecondarySuper(const JavaClass* iface) const;
+    bool isArrayAssignableTo(const JavaClass* target) const;
+    void buildSupers(const std::shared_ptr<JavaClass>& parent);
+    void buildVTable(const std::shared_ptr<JavaClass>& parent);
+    void buildITables(const std::shared_ptr<JavaClass>& parent);
 };
 
-// Runtime representation of an Object instance
-// 对象实例的运行时表示
+// Runtime representation of an Object instance: a 16-byte header followed, in the same
+// allocation, by the instance fields at the offsets of JavaClass::fieldOffsets. An array
+// has its length after the header, then the elements inline, each of the size of its
+// class's elementKind (1 byte for byte[]/boolean[], 2 for char[]/short[], ...). Only
+// HeapManager creates objects.
+// 对象实例的运行时表示: 16 字节的对象头，其后在同一块内存中按 JavaClass::fieldOffsets 的偏移存放实例字段。
+// 数组在对象头之后存放长度，然后紧接着存放元素，每个元素的大小由数组类的 elementKind 决定
+// (byte[]/boolean[] 为 1 字节，char[]/short[] 为 2 字节，依此类推)。对象只由 HeapManager 创建
 class JavaObject {
 public:
-    std::shared_ptr<JavaClass> cls; // 所属类的引用
-    std::vector<int64_t> fields; // Store all fields as 64-bit slots for simplicity
-                                 // 实例字段存储: 使用 int64_t 数组存储所有字段值 (包括引用和基本类型)
-                                 // 索引对应于 JavaClass::fieldOffsets 中的值
+    JavaClass* cls;  // 所属类 (类在解释器存续期间不会释放，因此不持有引用计数)
+    uint32_t hash;   // Identity hash, 0 until first asked for / 标识哈希值，首次使用前为 0
+    uint16_t lock;   // Monitor entry count (MONITORENTER/MONITOREXIT) / 监视器重入计数
+    uint16_t gcBits; // Collector state (GC_* flags), owned by HeapManager / 垃圾回收状态 (GC_* 标志)，由 HeapManager 管理
+
+    static constexpr size_t ARRAY_LENGTH_OFFSET = 16; // From the object start / 相对对象起始地址
+    static constexpr size_t ARRAY_DATA_OFFSET = 24;
+
+    static constexpr uint16_t GC_MARKED = 1;    // Reached in the current collection / 本次回收中可达
+    static constexpr uint16_t GC_FORWARDED = 2; // Nursery copy moved, new address in the first field bytes / 新生代对象已移走，新地址存于字段区开头
+
+    explicit JavaObject(JavaClass* cls) : cls(cls), hash(0), lock(0), gcBits(0) {}
+    JavaObject(const JavaObject&) = delete;
+    JavaObject& operator=(const JavaObject&) = delete;
+
+    // Instance fields, by byte offset / 按字节偏移访问实例字段
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+    const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+    template <typename T> T get(size_t offset) const { T v; std::memcpy(&v, data() + offset, sizeof(T)); return v; }
+    template <typename T> void set(size_t offset, T value) { std::memcpy(data() + offset, &value, sizeof(T)); }
+    // Every reference store into the heap goes through setRef or setRefElement, which mark
+    // the object's card (the write barrier of the generational collector)
+    // 所有写入堆内的引用都经过 setRef 或 setRefElement，二者会标记对象所在的卡 (分代回收器的写屏障)
+    JavaObject* getRef(size_t offset) const { return decodeRef(get<HeapRef>(offset)); }
+    void setRef(size_t offset, JavaObject* ref) { set(offset, encodeRef(ref)); markCard(this); }
+
+    // Bounds check only: with no verifier, it keeps a malformed class's field access inside the object
+    // 仅检查边界: 虚拟机没有校验器，此检查只保证格式错误的类的字段访问不越出对象
+    bool hasField(size_t offset, uint8_t kind) const {
+        return cls && offset + fieldSize(kind) <= cls->instanceSize;
+    }
+
+    // Field value in the interpreter's raw 64-bit form: ints and float bits sign-extended,
+    // long/double bits, reference address
+    // 以解释器的 64 位原始形式读写字段: int 与 float 位模式符号扩展，long/double 位模式，引用地址
+    int64_t loadField(size_t offset, uint8_t kind) const {
+        switch (kind) {
+            case FIELD_J: case FIELD_D: return get<int64_t>(offset);
+            case FIELD_A: return (int64_t)(intptr_t)getRef(offset);
+            case FIELD_B: return get<int8_t>(offset);
+            case FIELD_C: return get<uint16_t>(offset);
+            case FIELD_S: return get<int16_t>(offset);
+            default: return get<int32_t>(offset);
+        }
+    }
+    void storeField(size_t offset, uint8_t kind, int64_t raw) {
+        switch (kind) {
+            case FIELD_J: case FIELD_D: set<int64_t>(offset, raw); break;
+            case FIELD_A: setRef(offset, (JavaObject*)(intptr_t)raw); break;
+            case FIELD_B: set<int8_t>(offset, (int8_t)raw); break;
+            case FIELD_C: case FIELD_S: set<int16_t>(offset, (int16_t)raw); break;
+            default: set<int32_t>(offset, (int32_t)raw); break;
+        }
+    }
+
+    // Arrays. elements<T>() must match the element kind of the array class; loadElement and
+    // storeElement go by that kind for code that handles arrays of any type. Reference
+    // arrays hold HeapRef elements (see encodeRef/decodeRef).
+    // 数组。elements<T>() 的 T 必须与数组类的元素类型一致; loadElement/storeElement 按元素类型访问，
+    // 供需要处理任意类型数组的代码使用。引用数组的元素为 HeapRef (见 encodeRef/decodeRef)
+    int32_t arrayLength() const { return get<int32_t>(ARRAY_LENGTH_OFFSET - sizeof(JavaObject)); }
+    int64_t loadElement(int32_t index) const {
+        return loadField(ARRAY_DATA_OFFSET - sizeof(JavaObject) + (size_t)index * fieldSize(cls->elementKind), cls->elementKind);
+    }
+    void storeElement(int32_t index, int64_t raw) {
+        storeField(ARRAY_DATA_OFFSET - sizeof(JavaObject) + (size_t)index * fieldSize(cls->elementKind), cls->elementKind, raw);
+    }
+    void setRefElement(int32_t index, JavaObject* ref) { elements<HeapRef>()[index] = encodeRef(ref); markCard(this); }
+    template <typename T> T* elements() {
+        return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(this) + ARRAY_DATA_OFFSET);
+    }
+    template <typename T> const T* elements() const {
+        return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(this) + ARRAY_DATA_OFFSET);
+    }
 
-    JavaObject(std::shared_ptr<JavaClass> cls);
+    // Identity hash (Object.hashCode), assigned on first use so it survives the object moving
+    // 标识哈希值 (Object.hashCode)，首次使用时分配，对象移动后保持不变
+    uint32_t identityHash();
 };
+static_assert(sizeof(JavaObject) == 16, "JavaObject header must stay 16 bytes");
 
 } // namespace core
 } // namespace j2me
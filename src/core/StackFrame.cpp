@@ -2,142 +2,198 @@
 #include "../util/DataReader.hpp"
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
 namespace j2me {
 namespace core {
 
+namespace {
+
+// Frames can be created for methods whose class was never linked (e.g. copies of a
+// MethodInfo); build the pre-decoded body on first use in that case.
+// 方法所属的类未经过链接时 (例如 MethodInfo 的副本)，首次使用时构建预解码方法体
+RuntimeMethod& runtimeOf(const MethodInfo& method, const ClassFile& classFile) {
+    if (!method.runtime) {
+        method.runtime = std::make_shared<RuntimeMethod>(method, classFile);
+    }
+    return *method.runtime;
+}
+
+} // namespace
+
 StackFrame::StackFrame(const MethodInfo& method, const std::shared_ptr<ClassFile>& classFile)
-    : method(method), classFile(classFile) {
-    localVariables.resize(20);
-    operandStack.reserve(20);
-
-    // 解析 Code 属性
-    // Parse Code attribute
-    for (const auto& attr : method.attributes) {
-        if (attr.attribute_name_index < classFile->constant_pool.size()) {
-            auto nameInfo = std::dynamic_pointer_cast<ConstantUtf8>(classFile->constant_pool[attr.attribute_name_index]);
-            if (nameInfo && nameInfo->bytes == "Code") {
-                 util::DataReader attrReader(attr.info);
-                 attrReader.readU2(); // max_stack
-                 attrReader.readU2(); // max_locals
-                 uint32_t codeLength = attrReader.readU4();
-                 code = attrReader.readBytes(codeLength);
-                 
-                 uint16_t exceptionTableLength = attrReader.readU2();
-                 for (int i = 0; i < exceptionTableLength; i++) {
-                     ExceptionTableEntry entry;
-                     entry.startPc = attrReader.readU2();
-                     entry.endPc = attrReader.readU2();
-                     entry.handlerPc = attrReader.readU2();
-                     entry.catchType = attrReader.readU2();
-                     exceptionTable.push_back(entry);
-                 }
-                 
-                 // Parse sub-attributes (LineNumberTable)
-                 // if (attrReader.canRead(2)) {
-                     uint16_t subAttributesCount = attrReader.readU2();
-                     for (int i = 0; i < subAttributesCount; i++) {
-                         uint16_t subAttrNameIndex = attrReader.readU2();
-                         uint32_t subAttrLength = attrReader.readU4();
-                         auto nextAttrPos = attrReader.tell() + subAttrLength;
-                         
-                         if (subAttrNameIndex < classFile->constant_pool.size()) {
-                             auto subNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(classFile->constant_pool[subAttrNameIndex]);
-                             if (subNameInfo && subNameInfo->bytes == "LineNumberTable") {
-                                 uint16_t lineNumberTableLength = attrReader.readU2();
-                                 for (int j = 0; j < lineNumberTableLength; j++) {
-                                     LineNumberTableEntry entry;
-                                     entry.startPc = attrReader.readU2();
-                                     entry.lineNumber = attrReader.readU2();
-                                     lineNumberTable.push_back(entry);
-                                 }
-                             }
-                         }
-                         attrReader.seek(nextAttrPos);
-                     }
-                 // }
-                 break;
-            }
-        }
+    : method(method), classFile(classFile),
+      runtime(&runtimeOf(method, *classFile)),
+      code(runtime->code),
+      exceptionTable(runtime->exceptionTable),
+      lineNumberTable(runtime->lineNumberTable),
+      maxStack(runtime->maxStack),
+      maxLocals(runtime->maxLocals),
+      localCount(runtime->maxLocals) {
+    // Invocation counter for the register IR tier / 寄存器 IR 层的调用计数
+    runtime->hotness++;
+}
+
+static inline bool isWide(JavaValue::Type type) {
+    return type == JavaValue::LONG || type == JavaValue::DOUBLE;
+}
+
+JavaValue StackFrame::readSlot(size_t at) const {
+    JavaValue v;
+    uint8_t tag = tags[at];
+    v.type = (tag == SLOT_TOP) ? JavaValue::INT : (JavaValue::Type)tag;
+    v.val = slots[at];
+    return v;
+}
+
+void StackFrame::writeSlot(size_t at, const JavaValue& value) {
+    slots[at] = value.val;
+    tags[at] = (uint8_t)value.type;
+    if (isWide(value.type)) {
+        slots[at + 1].l = 0;
+        tags[at + 1] = SLOT_TOP;
     }
 }
 
-int StackFrame::getLineNumber(uint32_t pc) const {
-    int line = -1;
-    // Find the entry with the largest startPc that is <= pc
-    for (const auto& entry : lineNumberTable) {
-        if (entry.startPc <= pc) {
-            // Since we don't know if it's sorted, we check if this entry is "closer" or "better"
-            // Actually, usually we just want the one that starts most recently.
-            // If the table is sorted, we can just iterate.
-            // If not sorted, we need to find max(startPc) <= pc.
-            
-            // Simple approach: assume unsorted, find best match.
-            // But wait, line numbers can jump around (loops).
-            // But startPc mapping is unique for a given instruction range?
-            // "The value of the start_pc item must indicate the index into the code array at which the code for a new line in the original source file begins."
-            
-            // So if we have entries (0, 10), (5, 11).
-            // PC 6 -> Line 11.
-            // PC 2 -> Line 10.
-            
-            // So we want the entry with startPc <= pc that has the MAX startPc.
-            // If line variable is initialized to -1, we update it if we find a better match.
-            // But we need to keep track of "best startPc".
-            // Since we iterate, we can't easily compare with "current best".
-            // Wait, we CAN.
+void StackFrame::relocate(size_t needed) {
+    size_t used = localCount + stackTop;
+    if (slots != nullptr && slots == heapSlots.data()) {
+        heapSlots.resize(needed);
+        heapTags.resize(needed, JavaValue::INT);
+    } else {
+        std::vector<Slot> newSlots(needed);
+        std::vector<uint8_t> newTags(needed, JavaValue::INT);
+        if (slots) {
+            std::memcpy(newSlots.data(), slots, used * sizeof(Slot));
+            std::memcpy(newTags.data(), tags, used);
         }
+        heapSlots.swap(newSlots);
+        heapTags.swap(newTags);
     }
-    
-    int bestStartPc = -1;
-    for (const auto& entry : lineNumberTable) {
-        if (entry.startPc <= pc) {
-            if ((int)entry.startPc > bestStartPc) {
-                bestStartPc = entry.startPc;
-                line = entry.lineNumber;
-            }
-        }
+    slots = heapSlots.data();
+    tags = heapTags.data();
+    capacity = needed;
+}
+
+void StackFrame::bindStorage(Slot* arenaSlots, uint8_t* arenaTags, size_t arenaCapacity, size_t mark) {
+    size_t used = 0;
+    if (slots) {
+        used = localCount + stackTop;
+        std::memcpy(arenaSlots, slots, used * sizeof(Slot));
+        std::memcpy(arenaTags, tags, used);
+    }
+    // Arena memory is recycled: clear the locals that were not written yet so no stale
+    // reference tag survives from an earlier frame
+    // 栈区内存会被复用: 清零尚未写入的局部变量，避免残留之前栈帧的引用标记
+    if (used < localCount) {
+        std::memset(arenaSlots + used, 0, (localCount - used) * sizeof(Slot));
+        std::memset(arenaTags + used, JavaValue::INT, localCount - used);
     }
-    return line;
+    slots = arenaSlots;
+    tags = arenaTags;
+    capacity = arenaCapacity;
+    arenaMark = mark;
+    inArena = true;
+    std::vector<Slot>().swap(heapSlots);
+    std::vector<uint8_t>().swap(heapTags);
+}
+
+void StackFrame::unbindStorage() {
+    // Only the arena block is dropped; frames that moved to the heap keep their storage
+    // 仅解除栈区块的绑定；已迁移到堆上的栈帧保留其存储
+    if (slots != heapSlots.data()) {
+        slots = nullptr;
+        tags = nullptr;
+        capacity = 0;
+        stackTop = 0;
+    }
+    inArena = false;
+}
+
+void StackFrame::growLocals(size_t count) {
+    size_t extra = count - localCount;
+    size_t needed = count + stackTop;
+    if (needed > capacity) relocate(needed);
+    std::memmove(slots + count, slots + localCount, stackTop * sizeof(Slot));
+    std::memmove(tags + count, tags + localCount, stackTop);
+    std::memset(slots + localCount, 0, extra * sizeof(Slot));
+    std::memset(tags + localCount, JavaValue::INT, extra);
+    localCount = count;
 }
 
 void StackFrame::push(JavaValue value) {
-    operandStack.push_back(value);
+    size_t width = isWide(value.type) ? 2 : 1;
+    reserveStack(width);
+    writeSlot(localCount + stackTop, value);
+    stackTop += width;
 }
 
 JavaValue StackFrame::pop() {
-    if (operandStack.empty()) {
+    if (stackTop == 0) {
         throw std::runtime_error("Stack underflow");
     }
-    JavaValue val = operandStack.back();
-    operandStack.pop_back();
-    return val;
+    // The upper half of a long/double sits on top: pop both slots
+    // 栈顶是 long/double 的高位槽位时一次弹出两个槽位
+    if (tags[localCount + stackTop - 1] == SLOT_TOP && stackTop >= 2) {
+        stackTop -= 2;
+    } else {
+        stackTop -= 1;
+    }
+    return readSlot(localCount + stackTop);
+}
+
+JavaValue StackFrame::peekAt(size_t depth) const {
+    if (depth >= stackTop) {
+        throw std::runtime_error("Stack underflow");
+    }
+    return readSlot(localCount + stackTop - 1 - depth);
 }
 
 JavaValue StackFrame::peek() {
-    if (operandStack.empty()) {
+    if (stackTop == 0) {
         throw std::runtime_error("Stack underflow");
     }
-    return operandStack.back();
+    size_t top = localCount + stackTop - 1;
+    if (tags[top] == SLOT_TOP && stackTop >= 2) top--;
+    return readSlot(top);
 }
 
 void StackFrame::setLocal(uint16_t index, JavaValue value) {
-    if (index >= localVariables.size()) {
-        localVariables.resize(index + 1);
+    size_t needed = (size_t)index + (isWide(value.type) ? 2 : 1);
+    if (!slots) {
+        // Not pushed yet: keep the values on the heap until bindStorage()
+        // 尚未压栈: 在 bindStorage() 之前先把值存放在堆上
+        relocate(footprint());
+    }
+    if (needed > localCount) {
+        growLocals(needed);
+    }
+    writeSlot(index, value);
+}
+
+void StackFrame::takeArguments(StackFrame& caller, size_t count) {
+    if (caller.stackTop < count) {
+        throw std::runtime_error("Stack underflow");
     }
-    localVariables[index] = value;
+    if (!slots) relocate(footprint());
+    if (count > localCount) growLocals(count);
+    size_t from = caller.localCount + caller.stackTop - count;
+    std::memcpy(slots, caller.slots + from, count * sizeof(Slot));
+    std::memcpy(tags, caller.tags + from, count);
+    caller.stackTop -= count;
 }
 
 JavaValue StackFrame::getLocal(uint16_t index) {
-    if (index >= localVariables.size()) {
+    if (index >= localCount || !slots) {
         // 返回默认值 0/null
         // Return default 0/null
         JavaValue v;
         v.type = JavaValue::INT;
-        v.val.i = 0;
+        v.val.l = 0;
         return v;
     }
-    return localVariables[index];
+    return readSlot(index);
 }
 
 } // namespace core
@@ -2,15 +2,32 @@
 
 #include <vector>
 #include <cstdint>
-#include <variant>
 #include <string>
 #include "ClassFile.hpp"
+#include "RuntimeMethod.hpp"
 
 namespace j2me {
 namespace core {
 
-// Simple value type for stack and locals
-// 用于操作数栈和局部变量表的简单数值类型
+class JavaClass;
+class JavaObject;
+
+// Raw 8-byte storage unit of the operand stack and the local variable table.
+// long and double occupy two consecutive slots, exactly as counted by max_stack /
+// max_locals in the Code attribute; the value lives in the lower slot.
+// 操作数栈和局部变量表的原始 8 字节槽位。long/double 与 Code 属性中的 max_stack/max_locals
+// 计数方式一致，占用两个连续槽位，值存放在低位槽位中
+union Slot {
+    int32_t i;  // 32位整数
+    int64_t l;  // 64位长整数
+    float f;    // 32位浮点数
+    double d;   // 64位双精度浮点数
+    void* ref;  // 对象引用 (JavaObject*)
+};
+static_assert(sizeof(Slot) == 8, "Slot must stay 8 bytes");
+
+// Simple value type used to pass values in and out of frames (natives, handlers)
+// 用于在栈帧与本地方法/指令处理函数之间传递数值的简单类型
 // In a real VM, this would be a more complex object model (JavaObject*)
 // 在真实的虚拟机中，这会是一个更复杂的对象模型
 struct JavaValue {
@@ -22,68 +39,139 @@ struct JavaValue {
         REFERENCE   // 对象引用
     } type; // 数据类型
 
-    union {
-        int32_t i;  // 32位整数
-        int64_t l;  // 64位长整数
-        float f;    // 32位浮点数
-        double d;   // 64位双精度浮点数
-        // For now, reference is just a raw pointer or ID. 
-        // 目前引用只是一个原始指针，用于 Phase 1 的简化实现
-        void* ref; 
-    } val; // 存储的具体数值
-    
-    // Hack for HelloWorld string
-    // 用于 HelloWorld 的临时字符串 hack
-    std::string strVal; 
+    Slot val; // 存储的具体数值
 };
 
+// Per-slot tag: a JavaValue::Type, or SLOT_TOP for the upper half of a long/double.
+// Tags let pop()/getLocal() rebuild a JavaValue and tell references apart from primitives.
+// 每个槽位的类型标记: JavaValue::Type，或表示 long/double 高位槽位的 SLOT_TOP
+constexpr uint8_t SLOT_TOP = JavaValue::REFERENCE + 1;
+
 class StackFrame {
 public:
     // 构造函数: 初始化方法的执行栈帧
+    // Slot storage is bound when the frame is pushed on a thread (see JavaThread::pushFrame);
+    // until then setLocal() keeps the values in a small heap buffer.
+    // 槽位存储在栈帧压入线程时绑定 (见 JavaThread::pushFrame)；此前 setLocal() 的值暂存在堆缓冲区中
     StackFrame(const MethodInfo& method, const std::shared_ptr<ClassFile>& classFile);
 
     // 操作数栈操作: 压入、弹出、查看栈顶
     void push(JavaValue value);
     JavaValue pop();
     JavaValue peek();
+
+    // Value `depth` slots below the top of the operand stack (0 = top)
+    // 查看栈顶向下第 depth 个槽位的值 (0 表示栈顶)
+    JavaValue peekAt(size_t depth) const;
     
-    // 调试辅助: 获取当前操作数栈的大小
-    size_t size() const { return operandStack.size(); }
-
-    // Exception Table Entry
-    struct ExceptionTableEntry {
-        uint16_t startPc;
-        uint16_t endPc;
-        uint16_t handlerPc;
-        uint16_t catchType; // Index into constant pool
-    };
-
-    struct LineNumberTableEntry {
-        uint16_t startPc;
-        uint16_t lineNumber;
-    };
+    // 调试辅助: 获取当前操作数栈已用的槽位数
+    size_t size() const { return stackTop; }
+
+    using ExceptionTableEntry = RuntimeMethod::ExceptionTableEntry;
+    using LineNumberTableEntry = RuntimeMethod::LineNumberTableEntry;
 
     // 局部变量表操作: 设置、获取指定索引的局部变量
     void setLocal(uint16_t index, JavaValue value);
     JavaValue getLocal(uint16_t index);
+
+    // Move the top `count` slots of the caller's operand stack into locals [0, count)
+    // 将调用者操作数栈顶的 count 个槽位整体移入本栈帧的局部变量 [0, count)
+    void takeArguments(StackFrame& caller, size_t count);
     
     // Get line number for current PC
-    int getLineNumber(uint32_t pc) const;
+    int getLineNumber(uint32_t pc) const { return runtime->getLineNumber(pc); }
+
+    // 操作数栈大小 (槽位数) 和判空
+    size_t stackSize() const { return stackTop; }
+    bool isStackEmpty() const { return stackTop == 0; }
 
-    // 操作数栈大小和判空
-    size_t stackSize() const { return operandStack.size(); }
-    bool isStackEmpty() const { return operandStack.empty(); }
+    // Make sure at least `headroom` more slots can be pushed without reallocating.
+    // 确保操作数栈还能再压入 headroom 个槽位而不发生重新分配
+    void reserveStack(size_t headroom) {
+        size_t needed = localCount + stackTop + headroom;
+        if (needed > capacity) relocate(needed);
+    }
+
+    // max_stack bounds the operand stack depth, so this is enough for any push sequence
+    // of the method. The threaded interpreter caches raw pointers into the slot array,
+    // so it calls this whenever it (re)loads a frame.
+    // max_stack 是操作数栈深度的上界，保证该方法任意的压栈序列都不会溢出 (供快速解释器缓存裸指针使用)
+    void reserveMaxStack() {
+        size_t depth = stackTop > maxStack ? stackTop : maxStack;
+        size_t needed = localCount + depth + 1;
+        if (needed > capacity) relocate(needed);
+    }
+
+    // Slots this frame wants when it is placed in a thread's arena
+    // 栈帧放入线程栈区时需要的槽位数
+    size_t footprint() const {
+        size_t depth = stackTop > maxStack ? stackTop : maxStack;
+        return localCount + depth + 1;
+    }
+
+    // Call visit(JavaObject*) for every local and operand stack slot tagged as a reference
+    // (garbage collector roots) and store back what it returns: the object's address after
+    // a collection that moved it
+    // 对每个标记为引用的局部变量与操作数栈槽位调用 visit(JavaObject*) (垃圾回收的根)，
+    // 并写回其返回值: 回收移动对象后对象的新地址
+    template <typename Visit>
+    void visitReferences(Visit&& visit) {
+        if (!slots) return;
+        size_t used = localCount + stackTop;
+        for (size_t i = 0; i < used; i++) {
+            if (tags[i] == JavaValue::REFERENCE) slots[i].ref = visit(static_cast<JavaObject*>(slots[i].ref));
+        }
+    }
+
+    // Attach arena storage (copying anything stored before the frame was pushed) / detach it on pop
+    // 绑定栈区存储 (复制压栈前已写入的内容) / 出栈时解除绑定
+    void bindStorage(Slot* arenaSlots, uint8_t* arenaTags, size_t arenaCapacity, size_t mark);
+    void unbindStorage();
 
     const MethodInfo& method;               // 当前执行的方法信息
     std::shared_ptr<ClassFile> classFile;   // 该方法所属的类文件
+    RuntimeMethod* runtime;                 // 预解码的方法体 (由所有同方法栈帧共享)
     uint32_t pc = 0;                        // 程序计数器 (Program Counter)，记录当前执行的字节码位置
-    std::vector<uint8_t> code;              // 缓存的方法字节码数据
-    std::vector<ExceptionTableEntry> exceptionTable; // 异常处理表
-    std::vector<LineNumberTableEntry> lineNumberTable; // 行号表
+    std::vector<uint8_t>& code;             // 方法字节码 (共享，快速化时原地改写)
+    const std::vector<ExceptionTableEntry>& exceptionTable; // 异常处理表
+    const std::vector<LineNumberTableEntry>& lineNumberTable; // 行号表
+    uint16_t maxStack = 0;                  // Code 属性中的 max_stack
+    uint16_t maxLocals = 0;                 // Code 属性中的 max_locals
+    JavaClass* initializingClass = nullptr; // 若为 <clinit> 栈帧，指向正在初始化的类
+    size_t arenaMark = 0;                   // 出栈时线程栈区回退到的位置
+    bool inArena = false;                   // 槽位是否位于线程栈区中
 
 private:
-    std::vector<JavaValue> operandStack;    // 操作数栈 (LIFO)
-    std::vector<JavaValue> localVariables;  // 局部变量表
+    // The threaded interpreter works on these arrays through raw pointers
+    // 快速解释器通过裸指针直接访问以下数组
+    friend class Interpreter;
+
+    // Grow the local variable area to `count` slots, moving the operand stack up
+    // 将局部变量区扩展到 count 个槽位 (操作数栈随之上移)
+    void growLocals(size_t count);
+
+    // Move the slots to heap storage of at least `needed` slots. Used when a frame outgrows
+    // its arena block (or before it has one); the frames above it own the arena space next to it.
+    // 将槽位迁移到至少 needed 个槽位的堆存储中。用于栈帧超出其栈区块 (或尚未绑定) 的情况
+    void relocate(size_t needed);
+
+    // Read / write one value starting at slot `at`
+    // 读写从槽位 at 开始的一个数值
+    JavaValue readSlot(size_t at) const;
+    void writeSlot(size_t at, const JavaValue& value);
+
+    // One contiguous array: [0, localCount) locals, then the operand stack.
+    // Lives in the owning thread's FrameArena while the frame is on the thread,
+    // otherwise in heapSlots/heapTags.
+    // 连续槽位数组: 前 localCount 个为局部变量，其后为操作数栈。
+    // 栈帧位于线程上时存放在线程的 FrameArena 中，否则存放在 heapSlots/heapTags 中
+    Slot* slots = nullptr;
+    uint8_t* tags = nullptr;                // 与 slots 一一对应的类型标记
+    size_t capacity = 0;                    // 当前存储的槽位容量
+    size_t localCount = 0;                  // 局部变量槽位数
+    size_t stackTop = 0;                    // 操作数栈已用槽位数
+    std::vector<Slot> heapSlots;            // 堆上的后备存储
+    std::vector<uint8_t> heapTags;
 };
 
 } // namespace core
@@ -101,6 +101,19 @@ public:
         });
     }
 
+    // Garbage collector roots of every thread (see JavaThread::visitReferences)
+    // 所有线程的垃圾回收根 (见 JavaThread::visitReferences)
+    template <typename Visit>
+    void visitReferences(Visit&& visit) {
+        for (const auto& thread : threads) {
+            if (thread) thread->visitReferences(visit);
+        }
+        // Rekeyed, since the Thread objects may have moved / 线程对象可能已移动，因此重建映射
+        std::map<void*, std::shared_ptr<JavaThread>> moved;
+        for (auto& entry : threadMap) moved.emplace(visit(static_cast<JavaObject*>(entry.first)), std::move(entry.second));
+        threadMap.swap(moved);
+    }
+
     bool hasThreads() const {
         return !threads.empty();
     }
@@ -37,6 +37,13 @@ public:
         tasks.push_back(entry);
     }
 
+    // Scheduled tasks stay reachable until they have run for the last time
+    // 已调度的任务在最后一次执行之前保持可达 (垃圾回收的根)
+    template <typename Visit>
+    void visitReferences(Visit&& visit) {
+        for (auto& entry : tasks) entry.task = visit(entry.task);
+    }
+
     void tick(Interpreter* interpreter) {
         using namespace std::chrono;
         auto now = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
@@ -97,7 +104,7 @@ private:
                 }
             }
             if (found) break;
-            currentCls = currentCls->superClass;
+            currentCls = currentCls->superClass.get();
         }
     }
 };
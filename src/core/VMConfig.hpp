@@ -26,6 +26,22 @@ struct VMConfig {
     int64_t autoKeyBetweenKeysMs = 200;
     bool guiInitialized = false; // GUI是否已初始化
     std::vector<std::string> mainMethodArgs; // main方法参数
+    bool useDispatchTable = false; // 使用旧的 std::function 分派表 (--interp table)，用于性能对比
+    uint32_t tier2Threshold = 500; // 方法进入寄存器 IR 层的热度阈值 (--tier2-threshold)，0 表示禁用
+    static constexpr uint32_t DEFAULT_JIT_THRESHOLD = 2000; // --jit=on 使用的阈值
+    uint32_t jitThreshold = 0; // 方法编译为机器码的热度阈值 (--jit)，0 表示关闭
+    bool aotEnabled = true; // 使用 j2me-aot 为该 JAR 生成的模块 (--aot=off 关闭)
+    std::string aotModulePath; // AOT 模块路径 (--aot=module=PATH)，为空时在 JAR 旁按哈希查找
+    bool superinstructions = true; // 加载时把高频指令序列融合为超级指令 (--superinstructions=off 关闭)
+    std::string opcodeProfilePath; // 统计候选超级指令的执行次数并在退出时写入该文件 (--profile-opcodes)，供 scripts/gen_superinstructions.py 使用
+    std::string peepholePasses = "all"; // 加载时启用的窥孔优化 (--peephole=LIST，见 BytecodeOptimizer.hpp)
+    size_t heapMaxBytes = 0; // 堆上限 (--heap-max，如 2M、512K)，计入对象、数组以及 StringBuffer 内容和解码图片等本地内存，0 表示不限制
+    bool heapDumpOnExit = false; // 退出时写出堆转储 (--heap-dump-on-exit)，见 docs/HEAP_DUMP.md
+    std::string heapDumpPrefix = "heap"; // 堆转储文件名前缀 (--heap-dump-prefix)，文件为 <前缀>-<序号>.j2heap
+    size_t heapDumpThreshold = 0; // 回收后存活量第一次超过该值时写出堆转储 (--heap-dump-threshold SIZE)，0 表示不触发
+    uint32_t allocSampleInterval = 0; // 分配点采样: 每 N 次分配采样一次 (--alloc-profile N)，退出时输出分配最多的位置，0 表示关闭
+    std::string allocProfilePath; // 分配点采样结果写入该文件 (--alloc-profile-out FILE)，包含全部分配点
+    uint32_t gcBudgetUs = 1000; // 每帧用于增量垃圾回收的时间 (--gc-budget-us，微秒)，0 表示主要回收保持暂停式
 };
 
 }
@@ -37,7 +37,9 @@ void Interpreter::initConstants() {
     // Default handler (can be kept in initInstructionTable or here if we want)
     // Here we only set constants.
 
-    instructionTable[OP_NOP] = instructionTable[OP_ACONST_NULL] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+    instructionTable[OP_NOP] = [](std::shared_ptr<JavaThread>, std::shared_ptr<StackFrame>, util::DataReader&, uint8_t) -> bool { return true; };
+
+    instructionTable[OP_ACONST_NULL] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
         do {
             JavaValue v; v.type = JavaValue::REFERENCE; v.val.ref = nullptr;
             frame->push(v);
@@ -97,7 +99,6 @@ void Interpreter::initConstants() {
                 auto strVal = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[utf8->string_index]);
                 JavaValue val;
                 val.type = JavaValue::REFERENCE; 
-                val.strVal = strVal->bytes;
                 
                 auto stringCls = resolveClass("java/lang/String");
                 if (stringCls) {
@@ -110,24 +111,23 @@ void Interpreter::initConstants() {
                         if (!arrayCls) arrayCls = resolveClass("[B"); // Fallback to [B
                     
                         if (arrayCls) {
-                            auto arrayObj = HeapManager::getInstance().allocate(arrayCls);
                             std::vector<uint16_t> utf16 = utf8ToUtf16(strVal->bytes);
-                            arrayObj->fields.resize(utf16.size());
+                            auto arrayObj = HeapManager::getInstance().allocateArray(arrayCls, (int32_t)utf16.size());
                             for (size_t i = 0; i < utf16.size(); i++) {
-                                arrayObj->fields[i] = utf16[i];
+                                arrayObj->storeElement((int32_t)i, utf16[i]);
                             }
-                            stringObj->fields[valueIt->second] = (int64_t)arrayObj;
+                            stringObj->setRef(valueIt->second, arrayObj);
                             
                             auto countIt = stringCls->fieldOffsets.find("count|I");
                             if (countIt != stringCls->fieldOffsets.end()) {
-                                stringObj->fields[countIt->second] = utf16.size();
+                                stringObj->set<int32_t>(countIt->second, (int32_t)utf16.size());
                             }
                         }
                     }
                     
                     auto offsetIt = stringCls->fieldOffsets.find("offset|I");
                     if (offsetIt != stringCls->fieldOffsets.end()) {
-                        stringObj->fields[offsetIt->second] = 0;
+                        stringObj->set<int32_t>(offsetIt->second, 0);
                     }
                     
                     val.val.ref = stringObj;
@@ -172,7 +172,6 @@ void Interpreter::initConstants() {
                 auto strVal = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[utf8->string_index]);
                 JavaValue val;
                 val.type = JavaValue::REFERENCE; 
-                val.strVal = strVal->bytes;
                 
                 auto stringCls = resolveClass("java/lang/String");
                 if (stringCls) {
@@ -184,24 +183,23 @@ void Interpreter::initConstants() {
                         if (!arrayCls) arrayCls = resolveClass("[B"); // Fallback
                         
                         if (arrayCls) {
-                            auto arrayObj = HeapManager::getInstance().allocate(arrayCls);
                             std::vector<uint16_t> utf16 = utf8ToUtf16(strVal->bytes);
-                            arrayObj->fields.resize(utf16.size());
+                            auto arrayObj = HeapManager::getInstance().allocateArray(arrayCls, (int32_t)utf16.size());
                             for (size_t i = 0; i < utf16.size(); i++) {
-                                arrayObj->fields[i] = utf16[i];
+                                arrayObj->storeElement((int32_t)i, utf16[i]);
                             }
-                            stringObj->fields[valueIt->second] = (int64_t)arrayObj;
+                            stringObj->setRef(valueIt->second, arrayObj);
                             
                             auto countIt = stringCls->fieldOffsets.find("count|I");
                             if (countIt != stringCls->fieldOffsets.end()) {
-                                stringObj->fields[countIt->second] = utf16.size();
+                                stringObj->set<int32_t>(countIt->second, (int32_t)utf16.size());
                             }
                         }
                     }
                     
                     auto offsetIt = stringCls->fieldOffsets.find("offset|I");
                     if (offsetIt != stringCls->fieldOffsets.end()) {
-                        stringObj->fields[offsetIt->second] = 0;
+                        stringObj->set<int32_t>(offsetIt->second, 0);
                     }
                     
                     val.val.ref = stringObj;
@@ -59,14 +59,20 @@ void Interpreter::initControl() {
 
             int32_t key = frame->pop().val.i;
             int32_t targetOffset = defaultOffset;
-            
-            for (int i = 0; i < npairs; i++) {
+
+            // Keys are sorted (JVMS 6.5; the load-time switch pass also sorts them), so binary search
+            // 键值已排序 (JVMS 6.5; 加载时的 switch 优化也会排序)，因此二分查找
+            size_t pairs = codeReader.tell();
+            int32_t lo = 0, hi = npairs - 1;
+            while (lo <= hi) {
+                int32_t mid = lo + (hi - lo) / 2;
+                codeReader.seek(pairs + (size_t)mid * 8);
                 int32_t match = (int32_t)codeReader.readU4();
-                int32_t offset = (int32_t)codeReader.readU4();
                 if (match == key) {
-                    targetOffset = offset;
+                    targetOffset = (int32_t)codeReader.readU4();
                     break;
                 }
+                if (match < key) lo = mid + 1; else hi = mid - 1;
             }
             codeReader.seek(pc + targetOffset);
             break;
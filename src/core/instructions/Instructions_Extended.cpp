@@ -39,6 +39,9 @@ void Interpreter::initExtended() {
         do {
             uint16_t index = codeReader.readU2();
             uint8_t dimensions = codeReader.readU1();
+            auto classRef = std::dynamic_pointer_cast<ConstantClass>(frame->classFile->constant_pool[index]);
+            auto classNameInfo = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[classRef->name_index]);
+            const std::string& arrayName = classNameInfo->bytes;
             
             std::vector<int32_t> counts;
             for (int i = 0; i < dimensions; i++) {
@@ -52,15 +55,16 @@ void Interpreter::initExtended() {
                 if (dimIndex >= dimensions) return nullptr;
                 
                 int32_t count = counts[dimIndex];
-                if (count < 0) throw std::runtime_error("NegativeArraySizeException");
+                if (count < 0) throw JavaThrow(RuntimeExceptionKind::NEGATIVE_ARRAY_SIZE);
                 
-                auto arrayObj = HeapManager::getInstance().allocate(nullptr);
-                arrayObj->fields.resize(count, 0);
+                // Dimension dimIndex has the class named by the descriptor without its first dimIndex '['
+                // 第 dimIndex 维的数组类为描述符去掉前 dimIndex 个 '[' 后的类
+                auto arrayObj = HeapManager::getInstance().allocateArray(resolveClass(arrayName.substr(dimIndex)), count);
                 
                 if (dimIndex < dimensions - 1) {
                     for (int i = 0; i < count; i++) {
                          JavaObject* subArray = createArray(dimIndex + 1);
-                         arrayObj->fields[i] = (int64_t)subArray;
+                         arrayObj->setRefElement(i, subArray);
                     }
                 }
                 
@@ -85,28 +89,16 @@ void Interpreter::initExtended() {
             JavaObject* obj = reinterpret_cast<JavaObject*>(objVal.val.ref);
             
             if (obj == nullptr) {
-                throw std::runtime_error("NullPointerException");
+                throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             }
             
-            // Get or create mutex for this object
-            auto it = objectMonitors.find(obj);
-            if (it == objectMonitors.end()) {
-                objectMonitors[obj] = std::make_unique<std::recursive_mutex>();
-                monitorCounts[obj] = 0;
-                monitorOwners[obj] = nullptr;
-            }
-            
-            // Check if this thread already owns the monitor
-            if (monitorOwners[obj] != thread) {
-                // Different thread, need to acquire the lock
-                objectMonitors[obj]->lock();
-                monitorOwners[obj] = thread;  // Record the owner
-            }
-            
-            // Increment monitor count (for reentrant locking)
-            monitorCounts[obj]++;
+            // The entry count lives in the object header; green threads all run on one OS
+            // thread, so taking the monitor only records the new owner
+            // 重入计数保存在对象头中; 所有绿色线程运行在同一个系统线程上，获取监视器只需记录新的持有者
+            monitorOwners[obj] = thread;
+            obj->lock++;
             
-            LOG_DEBUG("[MONITORENTER] Acquired monitor for object: " + std::to_string((long long)obj) + " count: " + std::to_string(monitorCounts[obj]));
+            LOG_DEBUG("[MONITORENTER] Acquired monitor for object: " + std::to_string((long long)obj) + " count: " + std::to_string(obj->lock));
             
             break;
         } while(0);
@@ -120,7 +112,7 @@ void Interpreter::initExtended() {
             JavaObject* obj = reinterpret_cast<JavaObject*>(objVal.val.ref);
             
             if (obj == nullptr) {
-                throw std::runtime_error("NullPointerException");
+                throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             }
             
             // Check if monitor is owned by this thread
@@ -130,16 +122,15 @@ void Interpreter::initExtended() {
             }
             
             // Decrement monitor count
-            if (monitorCounts.find(obj) != monitorCounts.end() && monitorCounts[obj] > 0) {
-                monitorCounts[obj]--;
+            if (obj->lock > 0) {
+                obj->lock--;
                 
                 // If count reaches 0, release the lock completely
-                if (monitorCounts[obj] == 0) {
-                    monitorOwners[obj] = nullptr;  // Clear the owner
-                    objectMonitors[obj]->unlock();
+                if (obj->lock == 0) {
+                    monitorOwners.erase(obj);
                     LOG_DEBUG("[MONITOREXIT] Released monitor for object: " + std::to_string((long long)obj));
                 } else {
-                    LOG_DEBUG("[MONITOREXIT] Monitor count decremented for object: " + std::to_string((long long)obj) + " count: " + std::to_string(monitorCounts[obj]));
+                    LOG_DEBUG("[MONITOREXIT] Monitor count decremented for object: " + std::to_string((long long)obj) + " count: " + std::to_string(obj->lock));
                 }
             } else {
                 // Monitor not held by this thread
@@ -119,14 +119,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::INT;
-            val.val.i = (int32_t)arr->fields[index];
+            val.val.i = arr->elements<int32_t>()[index];
             frame->push(val);
             break;
         } while(0);
@@ -137,14 +137,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::LONG;
-            val.val.l = arr->fields[index];
+            val.val.l = arr->elements<int64_t>()[index];
             frame->push(val);
             break;
         } while(0);
@@ -155,14 +155,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::FLOAT;
-            int32_t bits = (int32_t)arr->fields[index];
+            int32_t bits = arr->elements<int32_t>()[index];
             memcpy(&val.val.f, &bits, sizeof(float));
             frame->push(val);
             break;
@@ -174,14 +174,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::DOUBLE;
-            int64_t bits = arr->fields[index];
+            int64_t bits = arr->elements<int64_t>()[index];
             memcpy(&val.val.d, &bits, sizeof(double));
             frame->push(val);
             break;
@@ -193,14 +193,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::REFERENCE;
-            val.val.ref = (void*)arr->fields[index];
+            val.val.ref = decodeRef(arr->elements<HeapRef>()[index]);
             frame->push(val);
             break;
         } while(0);
@@ -211,14 +211,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::INT;
-            val.val.i = (int8_t)arr->fields[index]; // Sign extend for byte
+            val.val.i = arr->elements<int8_t>()[index]; // Sign extend for byte
             frame->push(val);
             break;
         } while(0);
@@ -229,14 +229,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::INT;
-            val.val.i = (uint16_t)arr->fields[index]; // Zero extend for char
+            val.val.i = arr->elements<uint16_t>()[index]; // Zero extend for char
             frame->push(val);
             break;
         } while(0);
@@ -247,14 +247,14 @@ void Interpreter::initLoads() {
         do {
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             JavaValue val;
             val.type = JavaValue::INT;
-            val.val.i = (int16_t)arr->fields[index]; // Sign extend for short
+            val.val.i = arr->elements<int16_t>()[index]; // Sign extend for short
             frame->push(val);
             break;
         } while(0);
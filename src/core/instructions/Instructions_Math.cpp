@@ -143,8 +143,9 @@ void Interpreter::initMath() {
         do {
             int32_t v2 = frame->pop().val.i;
             int32_t v1 = frame->pop().val.i;
-            if (v2 == 0) throw std::runtime_error("ArithmeticException: / by zero");
-            JavaValue res; res.type = JavaValue::INT; res.val.i = v1 / v2;
+            if (v2 == 0) throw JavaThrow(RuntimeExceptionKind::ARITHMETIC, "ArithmeticException: / by zero");
+            // INT_MIN / -1 overflows in C++ but is defined as INT_MIN in Java
+            JavaValue res; res.type = JavaValue::INT; res.val.i = (v2 == -1) ? (int32_t)(0u - (uint32_t)v1) : v1 / v2;
             frame->push(res);
             break;
         } while(0);
@@ -155,8 +156,8 @@ void Interpreter::initMath() {
         do {
             int64_t v2 = frame->pop().val.l;
             int64_t v1 = frame->pop().val.l;
-            if (v2 == 0) throw std::runtime_error("ArithmeticException: / by zero");
-            JavaValue res; res.type = JavaValue::LONG; res.val.l = v1 / v2;
+            if (v2 == 0) throw JavaThrow(RuntimeExceptionKind::ARITHMETIC, "ArithmeticException: / by zero");
+            JavaValue res; res.type = JavaValue::LONG; res.val.l = (v2 == -1) ? (int64_t)(0ull - (uint64_t)v1) : v1 / v2;
             frame->push(res);
             break;
         } while(0);
@@ -189,8 +190,8 @@ void Interpreter::initMath() {
         do {
             int32_t v2 = frame->pop().val.i;
             int32_t v1 = frame->pop().val.i;
-            if (v2 == 0) throw std::runtime_error("ArithmeticException: / by zero");
-            JavaValue res; res.type = JavaValue::INT; res.val.i = v1 % v2;
+            if (v2 == 0) throw JavaThrow(RuntimeExceptionKind::ARITHMETIC, "ArithmeticException: / by zero");
+            JavaValue res; res.type = JavaValue::INT; res.val.i = (v2 == -1) ? 0 : v1 % v2;
             frame->push(res);
             break;
         } while(0);
@@ -201,8 +202,8 @@ void Interpreter::initMath() {
         do {
             int64_t v2 = frame->pop().val.l;
             int64_t v1 = frame->pop().val.l;
-            if (v2 == 0) throw std::runtime_error("ArithmeticException: / by zero");
-            JavaValue res; res.type = JavaValue::LONG; res.val.l = v1 % v2;
+            if (v2 == 0) throw JavaThrow(RuntimeExceptionKind::ARITHMETIC, "ArithmeticException: / by zero");
+            JavaValue res; res.type = JavaValue::LONG; res.val.l = (v2 == -1) ? 0 : v1 % v2;
             frame->push(res);
             break;
         } while(0);
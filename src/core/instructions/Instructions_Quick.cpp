@@ -0,0 +1,418 @@
+#include "../Interpreter.hpp"
+#include "../Opcodes.hpp"
+#include "../Logger.hpp"
+#include "../RuntimeMethod.hpp"
+#include <cstring>
+
+namespace j2me {
+namespace core {
+
+// 快速化 (quickening) 的字段访问与方法调用指令
+// GETFIELD/PUTFIELD/GETSTATIC/PUTSTATIC 首次执行时完成常量池解析，然后把指令原地改写为
+// *_QUICK 形式: 实例字段的操作数直接是对象内的字节偏移与存储类型，静态字段的操作数是 staticFieldCache 的索引，
+// 值类型编码在操作码中。之后的执行不再访问常量池或查找字符串 map。
+// INVOKEVIRTUAL/INVOKEINTERFACE 改写后的操作数是 virtualCallCache 的索引，分派通过接收者类的 vtable/itable 完成。
+// CHECKCAST/INSTANCEOF 改写后的操作数是 classRefCache 的索引，类型检查使用类链接时构建的父类型表。
+// These handlers are used by the table loop; the threaded loop executes the same opcodes inline.
+
+uint8_t Interpreter::quickKindOf(const std::string& descriptor) {
+    char typeChar = descriptor.empty() ? 'I' : descriptor[0];
+    switch (typeChar) {
+        case 'L': case '[': return QUICK_A;
+        case 'J': return QUICK_J;
+        case 'F': return QUICK_F;
+        case 'D': return QUICK_D;
+        default: return QUICK_I; // Int, Short, Byte, Char, Boolean
+    }
+}
+
+void Interpreter::quickenInstruction(StackFrame& frame, size_t pc, uint8_t opcode, uint16_t operand) {
+    if (pc + 2 >= frame.code.size()) return;
+    // Operand first, opcode last, so the instruction is never seen half-rewritten
+    // 先写操作数再写操作码，避免出现改写了一半的指令
+    frame.code[pc + 1] = (uint8_t)(operand >> 8);
+    frame.code[pc + 2] = (uint8_t)(operand & 0xFF);
+    frame.code[pc] = opcode;
+}
+
+void Interpreter::quickenFieldAccess(StackFrame& frame, size_t pc, uint8_t quickBase, uint16_t classIndex,
+                                     const JavaClass* objCls, const std::string& key,
+                                     size_t offset, uint8_t fieldKind) {
+    if (offset >= QUICK_FIELD_OFFSET_LIMIT || classIndex >= frame.classFile->constant_pool.size()) return;
+    auto classRef = std::dynamic_pointer_cast<ConstantClass>(frame.classFile->constant_pool[classIndex]);
+    if (!classRef) return;
+    auto className = std::dynamic_pointer_cast<ConstantUtf8>(frame.classFile->constant_pool[classRef->name_index]);
+    if (!className) return;
+
+    // Field layouts are prefix-consistent along the superclass chain, so an offset taken
+    // from the referenced class is valid for every receiver that can reach this site.
+    // byte/char/short fields use the _I opcode; the operand tells their width.
+    // 字段布局沿父类链保持前缀一致，因此引用类中的偏移对所有可能的接收者都有效。
+    // byte/char/short 字段使用 _I 操作码，由操作数区分宽度
+    for (const JavaClass* c = objCls; c; c = c->superClass.get()) {
+        if (c->name != className->bytes) continue;
+        auto it = c->fieldOffsets.find(key);
+        if (it != c->fieldOffsets.end() && it->second == offset) {
+            uint8_t kind = fieldKind >= FIELD_B ? (uint8_t)QUICK_I : fieldKind;
+            quickenInstruction(frame, pc, quickBase + kind, quickFieldOperand(offset, fieldKind));
+        }
+        return;
+    }
+}
+
+int64_t* Interpreter::findStaticField(const std::shared_ptr<JavaClass>& cls, const std::string& key) {
+    if (!cls) return nullptr;
+    if (int64_t* slot = cls->findOwnStatic(key)) return slot;
+    for (auto& iface : cls->interfaces) {
+        if (int64_t* slot = findStaticField(iface, key)) return slot;
+    }
+    return findStaticField(cls->superClass, key);
+}
+
+int Interpreter::registerStaticField(int64_t* slot, JavaClass* cls, uint8_t kind) {
+    auto it = staticFieldCacheIndex.find(slot);
+    if (it != staticFieldCacheIndex.end()) return it->second;
+    if (staticFieldCache.size() > 0xFFFF) return -1;
+    uint16_t index = (uint16_t)staticFieldCache.size();
+    staticFieldCache.push_back({slot, cls, kind});
+    staticFieldCacheIndex[slot] = index;
+    return index;
+}
+
+int Interpreter::registerClassRef(JavaClass* cls) {
+    auto it = classRefCacheIndex.find(cls);
+    if (it != classRefCacheIndex.end()) return it->second;
+    if (classRefCache.size() > 0xFFFF) return -1;
+    uint16_t index = (uint16_t)classRefCache.size();
+    classRefCache.push_back(cls);
+    classRefCacheIndex[cls] = index;
+    return index;
+}
+
+bool Interpreter::quickenInvoke(StackFrame& frame, size_t pc, uint8_t quickOpcode, uint16_t cpIndex,
+                                const std::string& className, const std::string& key, uint16_t argSlots,
+                                JavaObject* receiver) {
+    // Classes are linked without java/lang/Object as their superclass, so its methods
+    // have no common vtable index; those sites keep the generic lookup
+    // 类链接时不以 java/lang/Object 为父类，其方法没有统一的 vtable 索引，此类调用点保持通用查找
+    if (className == "java/lang/Object") return false;
+    // A subclass of the referenced class has loaded it while linking, so no loading here
+    // 接收者的类在链接时已加载了被引用的类，因此这里不触发类加载
+    auto clsIt = loadedClasses.find(className);
+    if (clsIt == loadedClasses.end() || !clsIt->second) return false;
+    JavaClass* cls = clsIt->second.get();
+    bool isInterface = (quickOpcode == OP_INVOKEINTERFACE_QUICK);
+    if (cls->isInterface() != isInterface) return false;
+    auto it = cls->vtableIndex.find(key);
+    if (it == cls->vtableIndex.end()) return false;
+
+    VirtualCallEntry entry;
+    entry.cls = cls;
+    entry.index = it->second;
+    entry.argSlots = argSlots;
+    entry.cpIndex = cpIndex;
+    if (!selectVirtual(receiver, entry, isInterface)) return false;
+
+    // Class hierarchy analysis: a virtual call is direct if the method is final, its
+    // class is final, or no loaded subclass overrides it
+    // 类层次分析: 方法或其所属类为 final，或没有已加载的子类重写该方法时，虚调用可直接调用
+    if (!isInterface) {
+        const JavaClass::VTableEntry& target = cls->vtable[entry.index];
+        bool abstract = !target.method || (target.method->access_flags & 0x0400) != 0; // ACC_ABSTRACT
+        if (!abstract) {
+            if ((target.method->access_flags & 0x0010) || cls->isFinal()) { // ACC_FINAL
+                entry.devirtualized = true;
+            } else if (!cls->isOverridden(entry.index)) {
+                entry.devirtualized = true;
+                entry.assumesNoOverride = true;
+            }
+            if (entry.devirtualized) entry.direct = target;
+        }
+    }
+
+    int index = registerCallSite(frame.classFile.get(), cpIndex, entry);
+    if (index < 0) return false;
+    quickenInstruction(frame, pc, quickOpcode, (uint16_t)index);
+    return true;
+}
+
+void Interpreter::quickenInvokeSpecial(StackFrame& frame, size_t pc, uint16_t cpIndex, JavaClass* cls,
+                                       const MethodInfo& method, const std::string& name, const std::string& descriptor) {
+    VirtualCallEntry entry;
+    entry.cls = cls;
+    entry.argSlots = method.runtime ? method.runtime->argSlots - 1 : RuntimeMethod::countArgSlots(descriptor);
+    entry.cpIndex = cpIndex;
+    entry.devirtualized = true;
+    entry.direct = {&method, cls, name, descriptor};
+    int index = registerCallSite(frame.classFile.get(), cpIndex, entry);
+    if (index >= 0) quickenInstruction(frame, pc, OP_INVOKESPECIAL_QUICK, (uint16_t)index);
+}
+
+int Interpreter::registerCallSite(const ClassFile* classFile, uint16_t cpIndex, const VirtualCallEntry& entry) {
+    // Sites sharing a constant pool entry share the cache entry (and its inline cache)
+    // 引用同一常量池项的调用点共享同一缓存项 (及其内联缓存)
+    auto siteKey = std::make_pair(classFile, cpIndex);
+    auto it = virtualCallCacheIndex.find(siteKey);
+    if (it != virtualCallCacheIndex.end()) return it->second;
+    if (virtualCallCache.size() > 0xFFFF) return -1;
+    uint16_t index = (uint16_t)virtualCallCache.size();
+    virtualCallCache.push_back(entry);
+    virtualCallCacheIndex[siteKey] = index;
+    return index;
+}
+
+void Interpreter::invalidateDevirtualizedCalls(const JavaClass* cls) {
+    if (!cls || !cls->superClass) return;
+    for (auto& entry : virtualCallCache) {
+        if (!entry.devirtualized || !entry.assumesNoOverride) continue;
+        for (const JavaClass* c = cls->superClass.get(); c; c = c->superClass.get()) {
+            if (c != entry.cls) continue;
+            if (entry.index < cls->vtable.size() && cls->vtable[entry.index].method != entry.direct.method) {
+                LOG_DEBUG("[Interpreter] " + cls->name + " overrides " + entry.direct.owner->name + "." +
+                          entry.direct.name + ", call site is dispatched again");
+                entry.devirtualized = false;
+            }
+            break;
+        }
+    }
+}
+
+const JavaClass::VTableEntry* Interpreter::selectVirtual(JavaObject* receiver, const VirtualCallEntry& entry, bool isInterface) {
+    JavaClass* cls = receiver->cls;
+    if (!cls) return nullptr;
+    uint16_t slot = entry.index;
+    if (isInterface) {
+        slot = JavaClass::NO_METHOD;
+        for (const auto& itable : cls->itables) {
+            if (itable.iface == entry.cls) {
+                slot = itable.slots[entry.index];
+                break;
+            }
+        }
+    }
+    // vtables are prefix-consistent along the superclass chain, so the index taken from
+    // the referenced class is valid for every subclass
+    // vtable 沿父类链保持前缀一致，因此引用类中的索引对其所有子类都有效
+    if (slot >= cls->vtable.size()) return nullptr;
+    const JavaClass::VTableEntry& target = cls->vtable[slot];
+    if (!target.method || (target.method->access_flags & 0x0400)) return nullptr; // ACC_ABSTRACT
+    return &target;
+}
+
+void Interpreter::invokeSelected(std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame,
+                                 const JavaClass::VTableEntry& target, uint16_t argSlots) {
+    if (target.method->access_flags & 0x0100) { // ACC_NATIVE
+        auto nativeFunc = NativeRegistry::getInstance().getNative(target.owner->name, target.name, target.descriptor);
+        if (nativeFunc) {
+            nativeFunc(thread, frame);
+        } else {
+            LOG_ERROR("UnsatisfiedLinkError (virtual): " + target.owner->name + "." + target.name + target.descriptor);
+        }
+    } else {
+        auto newFrame = std::make_shared<StackFrame>(*target.method, target.owner->rawFile);
+        thread->pushFrame(newFrame);
+        newFrame->takeArguments(*frame, argSlots + 1); // this + args
+    }
+}
+
+namespace {
+
+JavaValue quickLoad(int64_t raw, uint8_t kind) {
+    JavaValue val;
+    switch (kind) {
+        case 4: // QUICK_A
+            val.type = JavaValue::REFERENCE;
+            val.val.ref = (void*)raw;
+            break;
+        case 1: // QUICK_J
+            val.type = JavaValue::LONG;
+            val.val.l = raw;
+            break;
+        case 2: { // QUICK_F
+            val.type = JavaValue::FLOAT;
+            int32_t bits = (int32_t)raw;
+            memcpy(&val.val.f, &bits, sizeof(float));
+            break;
+        }
+        case 3: // QUICK_D
+            val.type = JavaValue::DOUBLE;
+            memcpy(&val.val.d, &raw, sizeof(double));
+            break;
+        default:
+            val.type = JavaValue::INT;
+            val.val.i = (int32_t)raw;
+            break;
+    }
+    return val;
+}
+
+int64_t quickStore(const JavaValue& val, uint8_t kind) {
+    switch (kind) {
+        case 4: return (int64_t)val.val.ref;
+        case 1: return val.val.l;
+        case 2: {
+            int32_t bits;
+            memcpy(&bits, &val.val.f, sizeof(float));
+            return (int64_t)bits;
+        }
+        case 3: {
+            int64_t bits;
+            memcpy(&bits, &val.val.d, sizeof(double));
+            return bits;
+        }
+        default: return (int64_t)val.val.i;
+    }
+}
+
+} // namespace
+
+void Interpreter::initQuick() {
+    for (int kind = QUICK_I; kind <= QUICK_A; kind++) {
+        instructionTable[OP_GETFIELD_QUICK_I + kind] = [this, kind](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+            do {
+                uint16_t operand = codeReader.readU2();
+                size_t offset = quickFieldOffset(operand);
+                uint8_t fieldKind = quickFieldKind(operand);
+                JavaObject* obj = static_cast<JavaObject*>(frame->pop().val.ref);
+                if (!obj) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
+                if (!obj->hasField(offset, fieldKind)) throw std::runtime_error("Field offset out of bounds");
+                frame->push(quickLoad(obj->loadField(offset, fieldKind), (uint8_t)kind));
+                break;
+            } while(0);
+            return true;
+        };
+
+        instructionTable[OP_PUTFIELD_QUICK_I + kind] = [this, kind](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+            do {
+                uint16_t operand = codeReader.readU2();
+                size_t offset = quickFieldOffset(operand);
+                uint8_t fieldKind = quickFieldKind(operand);
+                JavaValue val = frame->pop();
+                JavaObject* obj = static_cast<JavaObject*>(frame->pop().val.ref);
+                if (!obj) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
+                if (!obj->hasField(offset, fieldKind)) throw std::runtime_error("Field offset out of bounds");
+                obj->storeField(offset, fieldKind, quickStore(val, (uint8_t)kind));
+                break;
+            } while(0);
+            return true;
+        };
+
+        instructionTable[OP_GETSTATIC_QUICK_I + kind] = [this, kind](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+            uint16_t index = codeReader.readU2();
+            frame->push(quickLoad(*staticFieldCache[index].slot, (uint8_t)kind));
+            return true;
+        };
+
+        instructionTable[OP_PUTSTATIC_QUICK_I + kind] = [this, kind](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+            uint16_t index = codeReader.readU2();
+            *staticFieldCache[index].slot = quickStore(frame->pop(), (uint8_t)kind);
+            return true;
+        };
+    }
+
+    // Initialization barrier: the field is resolved but its class was still running
+    // <clinit> when the site was first executed. Once <clinit> has finished the
+    // barrier rewrites itself to the plain quick form.
+    // 初始化屏障: 字段已解析，但首次执行时类的 <clinit> 尚未结束；<clinit> 完成后改写为普通快速指令
+    instructionTable[OP_GETSTATIC_INIT_BARRIER] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+        uint16_t index = codeReader.readU2();
+        const StaticFieldEntry& entry = staticFieldCache[index];
+        if (entry.cls->clinitDone) {
+            quickenInstruction(*frame, codeReader.tell() - 3, OP_GETSTATIC_QUICK_I + entry.kind, index);
+        }
+        frame->push(quickLoad(*entry.slot, entry.kind));
+        return true;
+    };
+
+    instructionTable[OP_PUTSTATIC_INIT_BARRIER] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+        uint16_t index = codeReader.readU2();
+        const StaticFieldEntry& entry = staticFieldCache[index];
+        if (entry.cls->clinitDone) {
+            quickenInstruction(*frame, codeReader.tell() - 3, OP_PUTSTATIC_QUICK_I + entry.kind, index);
+        }
+        *entry.slot = quickStore(frame->pop(), entry.kind);
+        return true;
+    };
+
+    // Resolved virtual and interface calls: direct call if devirtualized, otherwise the
+    // inline cache, then the vtable/itable. A receiver the tables cannot dispatch (e.g.
+    // an instance of a mock class) turns the site back into the generic instruction,
+    // which then runs again from the same pc.
+    // 已解析的虚方法/接口调用: 已去虚化时直接调用，否则先查内联缓存，再查 vtable/itable。
+    // 若接收者无法通过方法表分派 (例如模拟类的实例)，则把调用点恢复为通用指令，并从同一 pc 重新执行
+    instructionTable[OP_INVOKEVIRTUAL_QUICK] = instructionTable[OP_INVOKEINTERFACE_QUICK] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+        size_t pc = codeReader.tell() - 1;
+        uint16_t index = codeReader.readU2();
+        bool isInterface = (opcode == OP_INVOKEINTERFACE_QUICK);
+        if (isInterface) {
+            codeReader.readU1(); // count
+            codeReader.readU1(); // 0
+        }
+        VirtualCallEntry& entry = virtualCallCache[index];
+        JavaObject* receiver = static_cast<JavaObject*>(frame->peekAt(entry.argSlots).val.ref);
+        if (!receiver) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
+
+        if (entry.devirtualized) {
+            invokeSelected(thread, frame, entry.direct, entry.argSlots);
+            return true;
+        }
+
+        JavaClass* cls = receiver->cls;
+        const JavaClass::VTableEntry* target = nullptr;
+        for (int i = 0; i < entry.cachedCount; i++) {
+            if (entry.cachedClass[i] == cls) {
+                target = entry.cachedTarget[i];
+                break;
+            }
+        }
+        if (!target) {
+            target = selectVirtual(receiver, entry, isInterface);
+            if (!target) {
+                quickenInstruction(*frame, pc, isInterface ? OP_INVOKEINTERFACE : OP_INVOKEVIRTUAL, entry.cpIndex);
+                codeReader.seek(pc);
+                return true;
+            }
+            // Megamorphic sites keep using the tables once the cache is full
+            // 缓存已满的多态调用点之后直接查表
+            if (entry.cachedCount < INLINE_CACHE_SIZE) {
+                entry.cachedClass[entry.cachedCount] = cls;
+                entry.cachedTarget[entry.cachedCount] = target;
+                entry.cachedCount++;
+            }
+        }
+        invokeSelected(thread, frame, *target, entry.argSlots);
+        return true;
+    };
+
+    // Type checks against a resolved class
+    // 针对已解析类的类型检查
+    instructionTable[OP_CHECKCAST_QUICK] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+        JavaClass* target = classRefCache[codeReader.readU2()];
+        JavaObject* obj = static_cast<JavaObject*>(frame->peek().val.ref);
+        if (obj && obj->cls && !obj->cls->isAssignableTo(target)) {
+            LOG_ERROR("ClassCastException: " + obj->cls->name + " cannot be cast to " + target->name);
+            throw JavaThrow(RuntimeExceptionKind::CLASS_CAST, "ClassCastException: " + obj->cls->name + " to " + target->name);
+        }
+        return true;
+    };
+
+    instructionTable[OP_INSTANCEOF_QUICK] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+        JavaClass* target = classRefCache[codeReader.readU2()];
+        JavaObject* obj = static_cast<JavaObject*>(frame->pop().val.ref);
+        bool isInstance = obj && (obj->cls ? obj->cls->isAssignableTo(target) : target->isObjectClass);
+        frame->push(JavaValue{JavaValue::INT, {.i = isInstance ? 1 : 0}});
+        return true;
+    };
+
+    // Constructor, private method or super call resolved to its target
+    // 已解析到目标方法的构造方法、私有方法或 super 调用
+    instructionTable[OP_INVOKESPECIAL_QUICK] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
+        uint16_t index = codeReader.readU2();
+        const VirtualCallEntry& entry = virtualCallCache[index];
+        invokeSelected(thread, frame, entry.direct, entry.argSlots);
+        return true;
+    };
+}
+
+}
+}
@@ -12,15 +12,32 @@
 namespace j2me {
 namespace core {
 
+JavaClass* Interpreter::primitiveArrayClass(uint8_t atype) {
+    static const char* const names[12] = { nullptr, nullptr, nullptr, nullptr,
+                                           "[Z", "[C", "[F", "[D", "[B", "[S", "[I", "[J" };
+    if (atype >= 12 || !names[atype]) throw std::runtime_error("Invalid NEWARRAY type " + std::to_string(atype));
+    if (!primitiveArrayClasses[atype]) primitiveArrayClasses[atype] = resolveClass(names[atype]).get();
+    return primitiveArrayClasses[atype];
+}
+
+JavaClass* Interpreter::typeCheckTarget(const std::string& className) {
+    // An object can only be an instance of a loaded class, so there is nothing to load here,
+    // except for array classes: a String[] is an Object[] even if no Object[] was created yet
+    // 对象只可能是已加载类的实例，因此这里无需加载类; 数组类除外: 即使尚未创建过 Object[]，String[] 也是 Object[]
+    auto it = loadedClasses.find(className);
+    if (it != loadedClasses.end()) return it->second.get();
+    if (className.empty() || className[0] != '[') return nullptr;
+    return resolveClass(className).get();
+}
+
 void Interpreter::initReferences() {
     instructionTable[OP_NEWARRAY] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
         do {
             uint8_t atype = codeReader.readU1();
             int32_t count = frame->pop().val.i;
-            if (count < 0) throw std::runtime_error("NegativeArraySizeException");
+            if (count < 0) throw JavaThrow(RuntimeExceptionKind::NEGATIVE_ARRAY_SIZE);
             
-            JavaObject* obj = new JavaObject(nullptr);
-            obj->fields.resize(count);
+            JavaObject* obj = HeapManager::getInstance().allocateArray(primitiveArrayClass(atype), count);
             
             JavaValue val;
             val.type = JavaValue::REFERENCE;
@@ -38,10 +55,13 @@ void Interpreter::initReferences() {
             auto className = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[classRef->name_index]);
             
             int32_t count = frame->pop().val.i;
-            if (count < 0) throw std::runtime_error("NegativeArraySizeException");
+            if (count < 0) throw JavaThrow(RuntimeExceptionKind::NEGATIVE_ARRAY_SIZE);
             
-            JavaObject* obj = new JavaObject(nullptr);
-            obj->fields.resize(count);
+            // Array class of the component: "[Lname;" for a class, "[" + descriptor for an array
+            // 以元素类构造数组类名: 类为 "[Lname;"，数组为 "[" + 描述符
+            const std::string& component = className->bytes;
+            auto arrayCls = resolveClass(component[0] == '[' ? "[" + component : "[L" + component + ";");
+            JavaObject* obj = HeapManager::getInstance().allocateArray(arrayCls, count);
             
             JavaValue val;
             val.type = JavaValue::REFERENCE;
@@ -55,12 +75,12 @@ void Interpreter::initReferences() {
     instructionTable[OP_ARRAYLENGTH] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
         do {
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
             JavaValue val;
             val.type = JavaValue::INT;
-            val.val.i = arr->fields.size();
+            val.val.i = arr->arrayLength();
             frame->push(val);
             break;
         } while(0);
@@ -98,74 +118,25 @@ void Interpreter::initReferences() {
     };
 
     instructionTable[OP_ATHROW] = [this](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t opcode) -> bool {
-        do {
-            JavaValue exceptionVal = frame->pop();
-            if (exceptionVal.val.ref == nullptr) {
-                // Throw NullPointerException
-                // TODO: Create NPE object properly
-                // For now, print error and throw runtime error to stop VM
-                LOG_ERROR("Error: ATHROW with null exception object (NullPointerException)");
-                throw std::runtime_error("NullPointerException in ATHROW");
-            }
-            
-            JavaObject* exObj = (JavaObject*)exceptionVal.val.ref;
-            
-            // Log exception details before handling
-            std::string exClass = "Unknown";
-            if (exObj->cls) {
-                exClass = exObj->cls->name;
-                std::string fieldKey = "detailMessage|Ljava/lang/String;";
-                if (exObj->cls->fieldOffsets.find(fieldKey) != exObj->cls->fieldOffsets.end()) {
-                     size_t offset = exObj->cls->fieldOffsets[fieldKey];
-                     if (offset < exObj->fields.size()) {
-                         int64_t msgRef = exObj->fields[offset];
-                         if (msgRef != 0) {
-                             JavaObject* msgObj = (JavaObject*)msgRef;
-                             std::string msg = j2me::natives::getJavaString(msgObj);
-                             exClass += " (" + msg + ")";
-                         }
-                     }
-                }
-            }
-            // LOG_DEBUG("ATHROW: " + exClass);
-
-            if (handleException(thread, exObj)) {
-                // Exception handled, PC updated in handleException
-                // We need to update codeReader to new PC
-                // But codeReader is local to executeInstruction.
-                // execute() loop updates frame->pc from codeReader.tell().
-                // So we need to sync codeReader to frame->pc.
-                
-                // However, handleException might have popped frames!
-                // So 'frame' variable might be invalid or stale if we popped it.
-                // 'thread->currentFrame()' is the new frame.
-                
-                auto newFrame = thread->currentFrame();
-                if (newFrame != frame) {
-                    // Frame changed (popped), we return true to continue loop.
-                    // But wait, execute() loop uses 'frame' variable which is the old frame?
-                    // No, execute() loop gets currentFrame() at start of loop.
-                    // But executeInstruction takes 'frame' as argument.
-                    // And execute() updates 'frame->pc = codeReader.tell()'.
-                    
-                    // If we popped the frame, 'frame' is now removed from stack.
-                    // Updating 'frame->pc' is pointless but harmless (shared_ptr keeps it alive).
-                    // The main loop will start next iteration, get new currentFrame(), and continue.
-                    // So we just need to return true.
-                    return true; 
-                } else {
-                    // Same frame (handler found in same method)
-                    // We need to update codeReader to jump to handler
-                    codeReader.seek(frame->pc);
-                    return true;
-                }
-            } else {
-                // Unhandled exception
-                throw std::runtime_error("Unhandled Java Exception: " + exClass);
-            }
-            
-            break;
-        } while(0);
+        JavaValue exceptionVal = frame->pop();
+        if (exceptionVal.val.ref == nullptr) {
+            // throw null raises NullPointerException at the ATHROW itself
+            // throw null 在 ATHROW 处抛出 NullPointerException
+            throw JavaThrow(RuntimeExceptionKind::NULL_POINTER, "NullPointerException in ATHROW");
+        }
+
+        JavaObject* exObj = (JavaObject*)exceptionVal.val.ref;
+        if (!throwJavaException(thread, exObj)) {
+            // Uncaught: the thread has been terminated
+            // 未被捕获: 线程已终止
+            return false;
+        }
+        // handleException may have popped frames; if the handler is in this frame, the
+        // loop takes the pc from codeReader, so move it to the handler
+        // handleException 可能已弹出栈帧; 若处理器在当前栈帧中，循环从 codeReader 取 pc，因此需跳转到处理器
+        if (thread->currentFrame() == frame) {
+            codeReader.seek(frame->pc);
+        }
         return true;
     };
 
@@ -182,30 +153,25 @@ void Interpreter::initReferences() {
             
             JavaObject* obj = static_cast<JavaObject*>(objVal.val.ref);
             if (!obj->cls) {
-                 if (className->bytes == "java/lang/Object") break;
                  break; 
             }
             
+            // Once the class is known the site is rewritten to CHECKCAST_QUICK
+            // 类已知后将该指令改写为 CHECKCAST_QUICK
             bool found = false;
-            
-            std::function<bool(std::shared_ptr<JavaClass>, const std::string&)> isAssignable = 
-                [&](std::shared_ptr<JavaClass> sub, const std::string& target) -> bool {
-                    if (!sub) return false;
-                    if (sub->name == target) return true;
-                    if (isAssignable(sub->superClass, target)) return true;
-                    for (auto& iface : sub->interfaces) {
-                         if (isAssignable(iface, target)) return true;
-                    }
-                    return false;
-                };
-
-            if (isAssignable(obj->cls, className->bytes)) {
-                found = true;
+            if (JavaClass* target = typeCheckTarget(className->bytes)) {
+                int cacheIndex = registerClassRef(target);
+                if (cacheIndex >= 0) {
+                    quickenInstruction(*frame, codeReader.tell() - 3, OP_CHECKCAST_QUICK, (uint16_t)cacheIndex);
+                }
+                found = obj->cls->isAssignableTo(target);
+            } else {
+                found = (className->bytes == "java/lang/Object");
             }
             
             if (!found) {
                 LOG_ERROR("ClassCastException: " + obj->cls->name + " cannot be cast to " + className->bytes);
-                throw std::runtime_error("ClassCastException: " + obj->cls->name + " to " + className->bytes);
+                throw JavaThrow(RuntimeExceptionKind::CLASS_CAST, "ClassCastException: " + obj->cls->name + " to " + className->bytes);
             }
             break;
         } while(0);
@@ -227,23 +193,16 @@ void Interpreter::initReferences() {
             JavaObject* obj = static_cast<JavaObject*>(objVal.val.ref);
             bool isInstance = false;
             
-            if (!obj->cls) {
-                 if (className->bytes == "java/lang/Object") isInstance = true;
+            // Same as CHECKCAST: rewritten to INSTANCEOF_QUICK once the class is known
+            // 与 CHECKCAST 相同: 类已知后改写为 INSTANCEOF_QUICK
+            if (JavaClass* target = typeCheckTarget(className->bytes)) {
+                int cacheIndex = registerClassRef(target);
+                if (cacheIndex >= 0) {
+                    quickenInstruction(*frame, codeReader.tell() - 3, OP_INSTANCEOF_QUICK, (uint16_t)cacheIndex);
+                }
+                isInstance = obj->cls ? obj->cls->isAssignableTo(target) : target->isObjectClass;
             } else {
-                 std::function<bool(std::shared_ptr<JavaClass>, const std::string&)> isAssignable = 
-                     [&](std::shared_ptr<JavaClass> sub, const std::string& target) -> bool {
-                         if (!sub) return false;
-                         if (sub->name == target) return true;
-                         if (isAssignable(sub->superClass, target)) return true;
-                         for (auto& iface : sub->interfaces) {
-                              if (isAssignable(iface, target)) return true;
-                         }
-                         return false;
-                     };
-
-                 if (isAssignable(obj->cls, className->bytes)) {
-                     isInstance = true;
-                 }
+                isInstance = (className->bytes == "java/lang/Object");
             }
             frame->push(JavaValue{JavaValue::INT, {.i = isInstance ? 1 : 0}});
             break;
@@ -272,13 +231,13 @@ void Interpreter::initReferences() {
             
             JavaObject* obj = static_cast<JavaObject*>(objVal.val.ref);
             
-            if (!obj) throw std::runtime_error("Object is null (checked)");
+            if (!obj) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             if (!obj->cls) {
                  // Check if it's array length
                  if (name->bytes == "length") {
                     JavaValue fieldVal;
                     fieldVal.type = JavaValue::INT;
-                    fieldVal.val.i = obj->fields.size();
+                    fieldVal.val.i = obj->arrayLength();
                     frame->push(fieldVal);
                     break;
                  }
@@ -292,26 +251,28 @@ void Interpreter::initReferences() {
             }
             
             JavaValue fieldVal;
-            char typeChar = descriptor->bytes[0];
-            if (typeChar == 'L' || typeChar == '[') {
+            uint8_t fieldKind = fieldKindOf(descriptor->bytes);
+            int64_t raw = obj->loadField(it->second, fieldKind);
+            if (fieldKind == FIELD_A) {
                 fieldVal.type = JavaValue::REFERENCE;
-                fieldVal.val.ref = (void*)obj->fields[it->second];
-            } else if (typeChar == 'J') {
+                fieldVal.val.ref = (void*)raw;
+            } else if (fieldKind == FIELD_J) {
                 fieldVal.type = JavaValue::LONG;
-                fieldVal.val.l = obj->fields[it->second];
-            } else if (typeChar == 'D') {
+                fieldVal.val.l = raw;
+            } else if (fieldKind == FIELD_D) {
                 fieldVal.type = JavaValue::DOUBLE;
-                int64_t bits = obj->fields[it->second];
-                memcpy(&fieldVal.val.d, &bits, sizeof(double));
-            } else if (typeChar == 'F') {
+                memcpy(&fieldVal.val.d, &raw, sizeof(double));
+            } else if (fieldKind == FIELD_F) {
                  fieldVal.type = JavaValue::FLOAT;
-                 int32_t bits = (int32_t)obj->fields[it->second];
+                 int32_t bits = (int32_t)raw;
                  memcpy(&fieldVal.val.f, &bits, sizeof(float));
             } else {
                  fieldVal.type = JavaValue::INT;
-                 fieldVal.val.i = (int32_t)obj->fields[it->second];
+                 fieldVal.val.i = (int32_t)raw;
             }
             frame->push(fieldVal);
+            quickenFieldAccess(*frame, codeReader.tell() - 3, OP_GETFIELD_QUICK_I, fieldRef->class_index,
+                               obj->cls, key, it->second, fieldKind);
             break;
         } while(0);
         return true;
@@ -333,7 +294,7 @@ void Interpreter::initReferences() {
             JavaValue val = frame->pop();
             JavaValue objVal = frame->pop();
             
-            if (objVal.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (objVal.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* obj = static_cast<JavaObject*>(objVal.val.ref);
             
@@ -351,26 +312,28 @@ void Interpreter::initReferences() {
                 throw std::runtime_error("Field not found: " + key);
             }
             
-            if (it->second >= obj->fields.size()) {
+            uint8_t fieldKind = fieldKindOf(descriptor->bytes);
+            if (!obj->hasField(it->second, fieldKind)) {
                  throw std::runtime_error("Field offset out of bounds");
             }
             
-            char typeChar = descriptor->bytes[0];
-            if (typeChar == 'L' || typeChar == '[') {
-                obj->fields[it->second] = (int64_t)val.val.ref;
-            } else if (typeChar == 'J') {
-                obj->fields[it->second] = val.val.l;
-            } else if (typeChar == 'D') {
-                int64_t bits;
-                memcpy(&bits, &val.val.d, sizeof(double));
-                obj->fields[it->second] = bits;
-            } else if (typeChar == 'F') {
+            int64_t raw;
+            if (fieldKind == FIELD_A) {
+                raw = (int64_t)val.val.ref;
+            } else if (fieldKind == FIELD_J) {
+                raw = val.val.l;
+            } else if (fieldKind == FIELD_D) {
+                memcpy(&raw, &val.val.d, sizeof(double));
+            } else if (fieldKind == FIELD_F) {
                 int32_t bits;
                 memcpy(&bits, &val.val.f, sizeof(float));
-                obj->fields[it->second] = (int64_t)bits;
+                raw = bits;
             } else {
-                obj->fields[it->second] = val.val.i;
+                raw = val.val.i;
             }
+            obj->storeField(it->second, fieldKind, raw);
+            quickenFieldAccess(*frame, codeReader.tell() - 3, OP_PUTFIELD_QUICK_I, fieldRef->class_index,
+                               obj->cls, key, it->second, fieldKind);
             break;
         } while(0);
         return true;
@@ -400,50 +363,41 @@ void Interpreter::initReferences() {
                  }
                  
                  auto descriptor = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[nameAndType->descriptor_index]);
-                 auto it = cls->staticFields.find(name->bytes + "|" + descriptor->bytes);
-                 
-                 char typeChar = descriptor ? descriptor->bytes[0] : 'I';
-                 
-                 if (it == cls->staticFields.end()) {
-                     JavaValue val;
-                     if (typeChar == 'L' || typeChar == '[') {
-                         val.type = JavaValue::REFERENCE;
-                         val.val.ref = nullptr;
-                     } else if (typeChar == 'J') {
-                         val.type = JavaValue::LONG;
-                         val.val.l = 0;
-                     } else if (typeChar == 'D') {
-                         val.type = JavaValue::DOUBLE;
-                         val.val.d = 0.0;
-                     } else if (typeChar == 'F') {
-                         val.type = JavaValue::FLOAT;
-                         val.val.f = 0.0f;
-                     } else {
-                         val.type = JavaValue::INT;
-                         val.val.i = 0;
-                     }
-                     frame->push(val);
+                 std::string key = name->bytes + "|" + descriptor->bytes;
+
+                 // Inherited statics live in the declaring class
+                 // 继承的静态字段存放在声明它的类中
+                 int64_t* slot = findStaticField(cls, key);
+                 if (!slot) throw std::runtime_error("Static field not found: " + className->bytes + "." + key);
+
+                 char typeChar = descriptor->bytes[0];
+                 JavaValue val;
+                 if (typeChar == 'L' || typeChar == '[') {
+                     val.type = JavaValue::REFERENCE;
+                     val.val.ref = (void*)*slot;
+                 } else if (typeChar == 'J') {
+                     val.type = JavaValue::LONG;
+                     val.val.l = *slot;
+                 } else if (typeChar == 'D') {
+                     val.type = JavaValue::DOUBLE;
+                     int64_t bits = *slot;
+                     memcpy(&val.val.d, &bits, sizeof(double));
+                 } else if (typeChar == 'F') {
+                     val.type = JavaValue::FLOAT;
+                     int32_t bits = (int32_t)*slot;
+                     memcpy(&val.val.f, &bits, sizeof(float));
                  } else {
-                     JavaValue val;
-                     if (typeChar == 'L' || typeChar == '[') {
-                         val.type = JavaValue::REFERENCE;
-                         val.val.ref = (void*)it->second;
-                     } else if (typeChar == 'J') {
-                         val.type = JavaValue::LONG;
-                         val.val.l = it->second;
-                     } else if (typeChar == 'D') {
-                         val.type = JavaValue::DOUBLE;
-                         int64_t bits = it->second;
-                         memcpy(&val.val.d, &bits, sizeof(double));
-                     } else if (typeChar == 'F') {
-                         val.type = JavaValue::FLOAT;
-                         int32_t bits = (int32_t)it->second;
-                         memcpy(&val.val.f, &bits, sizeof(float));
-                     } else {
-                         val.type = JavaValue::INT;
-                         val.val.i = (int32_t)it->second;
-                     }
-                     frame->push(val);
+                     val.type = JavaValue::INT;
+                     val.val.i = (int32_t)*slot;
+                 }
+                 frame->push(val);
+
+                 uint8_t kind = quickKindOf(descriptor->bytes);
+                 int cacheIndex = registerStaticField(slot, cls.get(), kind);
+                 if (cacheIndex >= 0) {
+                     quickenInstruction(*frame, codeReader.tell() - 3,
+                                        cls->clinitDone ? OP_GETSTATIC_QUICK_I + kind : OP_GETSTATIC_INIT_BARRIER,
+                                        (uint16_t)cacheIndex);
                  }
                  break;
             }
@@ -476,28 +430,38 @@ void Interpreter::initReferences() {
                      return true;
                  }
                  
-                 JavaValue val = frame->pop();
                  std::string key = name->bytes + "|" + descriptor->bytes;
-                 
+                 int64_t* slot = findStaticField(cls, key);
+                 if (!slot) throw std::runtime_error("Static field not found: " + className->bytes + "." + key);
+                 JavaValue val = frame->pop();
+
                  if (val.type == JavaValue::REFERENCE) {
-                     cls->staticFields[key] = (int64_t)val.val.ref;
+                     *slot = (int64_t)val.val.ref;
                  } else {
                      char typeChar = descriptor->bytes[0];
                      if (typeChar == 'J') {
-                         cls->staticFields[key] = val.val.l;
+                         *slot = val.val.l;
                      } else if (typeChar == 'D') {
                          int64_t bits;
                          memcpy(&bits, &val.val.d, sizeof(double));
-                         cls->staticFields[key] = bits;
+                         *slot = bits;
                      } else if (typeChar == 'F') {
                          int32_t bits;
                          memcpy(&bits, &val.val.f, sizeof(float));
-                         cls->staticFields[key] = (int64_t)bits;
+                         *slot = (int64_t)bits;
                      } else {
                          // Int, Short, Byte, Char, Boolean
-                         cls->staticFields[key] = (int64_t)val.val.i;
+                         *slot = (int64_t)val.val.i;
                      }
                  }
+
+                 uint8_t kind = quickKindOf(descriptor->bytes);
+                 int cacheIndex = registerStaticField(slot, cls.get(), kind);
+                 if (cacheIndex >= 0) {
+                     quickenInstruction(*frame, codeReader.tell() - 3,
+                                        cls->clinitDone ? OP_PUTSTATIC_QUICK_I + kind : OP_PUTSTATIC_INIT_BARRIER,
+                                        (uint16_t)cacheIndex);
+                 }
                  break;
             }
             LOG_ERROR("Unsupported PUTSTATIC index: " + std::to_string(index));
@@ -523,40 +487,6 @@ void Interpreter::initReferences() {
 
              bool isStatic = (opcode == OP_INVOKESTATIC);
 
-             int argCount = 0;
-             bool inArgs = false;
-             size_t i = 0;
-             while (i < descriptor->bytes.length()) {
-                 char c = descriptor->bytes[i];
-                 if (c == '(') {
-                     inArgs = true;
-                     i++;
-                     continue;
-                 }
-                 if (c == ')') {
-                     break;
-                 }
-                 if (inArgs) {
-                     if (c == 'L') {
-                         argCount++;
-                         i++;
-                         while (i < descriptor->bytes.length() && descriptor->bytes[i] != ';') {
-                             i++;
-                         }
-                         i++;
-                     } else if (c == '[') {
-                         i++;
-                     } else {
-                         argCount++;
-                         i++;
-                     }
-                 } else {
-                     i++;
-                 }
-             }
-             
-             if (!isStatic) argCount++; // 'this'
-
              auto cls = resolveClass(className->bytes);
              if (!cls) throw std::runtime_error("Class not found: " + className->bytes);
              
@@ -623,7 +553,13 @@ void Interpreter::initReferences() {
                  auto mDesc = std::dynamic_pointer_cast<ConstantUtf8>(cls->rawFile->constant_pool[m.descriptor_index]);
                  
                  if (mName->bytes == name->bytes && mDesc->bytes == descriptor->bytes) {
-                     if (m.access_flags & 0x0100) { // ACC_NATIVE
+                     bool isNative = (m.access_flags & 0x0100) != 0; // ACC_NATIVE
+                     // INVOKESPECIAL always calls this very method: turn the site into a direct call
+                     // INVOKESPECIAL 总是调用同一个方法: 将调用点改写为直接调用
+                     if (!isStatic && (!isNative || NativeRegistry::getInstance().getNative(className->bytes, name->bytes, descriptor->bytes))) {
+                         quickenInvokeSpecial(*frame, codeReader.tell() - 3, index, cls.get(), m, name->bytes, descriptor->bytes);
+                     }
+                     if (isNative) {
                          auto nativeFunc = NativeRegistry::getInstance().getNative(className->bytes, name->bytes, descriptor->bytes);
                         if (nativeFunc) {
                             nativeFunc(thread, frame);
@@ -635,24 +571,12 @@ void Interpreter::initReferences() {
                          // Object的构造方法只是简单返回，不需要特殊处理
                          // 让正常的构造方法处理逻辑执行
                          
+                         // Push first so the frame gets its slots from the thread's arena,
+                         // then move the argument slots over in one go
+                         // 先压栈以便从线程栈区分配槽位，再一次性搬移参数槽位
                          auto newFrame = std::make_shared<StackFrame>(m, cls->rawFile);
-                         
-                         std::vector<JavaValue> args;
-                         for (int i = 0; i < argCount; i++) {
-                             args.push_back(frame->pop());
-                         }
-                         
-                        int localIndex = 0;
-                        for (int i = 0; i < argCount; i++) {
-                            JavaValue& val = args[argCount - 1 - i];
-                            newFrame->setLocal(localIndex, val);
-                            localIndex++;
-                            if (val.type == JavaValue::LONG || val.type == JavaValue::DOUBLE) {
-                                localIndex++;
-                            }
-                        }
-                        
-                        thread->pushFrame(newFrame);
+                         thread->pushFrame(newFrame);
+                         newFrame->takeArguments(*frame, newFrame->runtime->argSlots);
                     }
                     found = true;
                     break;
@@ -683,23 +607,9 @@ void Interpreter::initReferences() {
             auto name = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[nameAndType->name_index]);
             auto descriptor = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[nameAndType->descriptor_index]);
             
-            int argCount = 0;
-            bool parsingObj = false;
-            for (size_t i = 1; i < descriptor->bytes.length(); ++i) { // Skip '('
-                char c = descriptor->bytes[i];
-                if (c == ')') break;
-                if (parsingObj) {
-                    if (c == ';') parsingObj = false;
-                    continue;
-                }
-                if (c == 'L') {
-                    parsingObj = true;
-                    argCount++;
-                } else if (c == '[') {
-                } else {
-                    argCount++;
-                }
-            }
+            // Arguments stay on the caller's stack; the receiver sits right below them
+            // 参数保留在调用者的操作数栈上，接收者位于参数之下
+            uint16_t argSlots = RuntimeMethod::countArgSlots(descriptor->bytes);
 
             auto classRef = std::dynamic_pointer_cast<ConstantClass>(frame->classFile->constant_pool[methodRef->class_index]);
             auto className = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[classRef->name_index]);
@@ -708,30 +618,39 @@ void Interpreter::initReferences() {
                 throw std::runtime_error("Invalid class name in INVOKEVIRTUAL: " + className->bytes);
             }
             
-            std::vector<JavaValue> args;
-            for(int i=0; i<argCount; ++i) args.push_back(frame->pop());
-            
-            JavaValue obj = frame->pop();
+            JavaValue obj = frame->peekAt(argSlots);
             
             if (obj.val.ref == (void*)0xDEADBEEF) {
+                std::vector<JavaValue> args;
+                size_t receiverDepth = frame->stackSize() - argSlots - 1;
+                while (frame->stackSize() > receiverDepth + 1) args.push_back(frame->pop());
+                frame->pop();
                 if (name->bytes == "println" && !args.empty()) {
-                    auto& arg = args[argCount-1]; 
-                    if (arg.type == JavaValue::REFERENCE && !arg.strVal.empty()) {
-                        LOG_INFO("JVM OUTPUT: " + arg.strVal);
+                    auto& arg = args.back(); 
+                    if (arg.type == JavaValue::REFERENCE && arg.val.ref != nullptr) {
+                        LOG_INFO("JVM OUTPUT: " + j2me::natives::getJavaString(static_cast<JavaObject*>(arg.val.ref)));
                     } else if (arg.type == JavaValue::INT) {
                          LOG_INFO("JVM OUTPUT: " + std::to_string(arg.val.i));
                     }
                 } else if (name->bytes == "toString") {
                     JavaValue ret;
                     ret.type = JavaValue::REFERENCE;
-                    ret.strVal = "System.out";
+                    ret.val.ref = j2me::natives::createJavaString(this, "System.out");
                     frame->push(ret);
                 }
             } else {
-                 if (obj.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+                 if (obj.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
                  
                  JavaObject* javaObj = static_cast<JavaObject*>(obj.val.ref);
-                 auto cls = javaObj->cls;
+                 auto cls = javaObj->cls ? javaObj->cls->shared_from_this() : nullptr;
+
+                 // Resolve the site to a vtable index once and run it as INVOKEVIRTUAL_QUICK
+                 // 调用点只解析一次 vtable 索引，之后以 INVOKEVIRTUAL_QUICK 执行
+                 if (quickenInvoke(*frame, codeReader.tell() - 3, OP_INVOKEVIRTUAL_QUICK, index,
+                                   className->bytes, name->bytes + "|" + descriptor->bytes, argSlots, javaObj)) {
+                     codeReader.seek(codeReader.tell() - 3);
+                     break;
+                 }
                  
                  bool found = false;
                  
@@ -745,27 +664,13 @@ void Interpreter::initReferences() {
                  std::shared_ptr<MethodInfo> method;
                  bool isNative = false;
                  
+                 // The key is the receiver's own class, so a hit needs no further checks
+                 // 缓存键是接收者的实际类，命中即可直接使用
                  if (cacheIt != methodCache.end()) {
                      methodClass = cacheIt->second.cls;
                      method = cacheIt->second.method;
                      isNative = cacheIt->second.isNative;
-                     
-                     // Verify the method exists in the class hierarchy
-                     // 验证方法在类层次结构中是否存在
-                     std::shared_ptr<JavaClass> currentClass = cls;
-                     while (currentClass != nullptr) {
-                         if (currentClass->name == methodClass->name) {
-                             found = true;
-                             break;
-                         }
-                         if (currentClass->rawFile->super_class == 0) {
-                             currentClass = nullptr;
-                         } else {
-                             auto superClassRef = std::dynamic_pointer_cast<ConstantClass>(currentClass->rawFile->constant_pool[currentClass->rawFile->super_class]);
-                             auto superClassName = std::dynamic_pointer_cast<ConstantUtf8>(currentClass->rawFile->constant_pool[superClassRef->name_index]);
-                             currentClass = resolveClass(superClassName->bytes);
-                         }
-                     }
+                     found = true;
                  }
                  
                  if (!found) {
@@ -810,11 +715,6 @@ void Interpreter::initReferences() {
                 // Execute the method
                 // 执行方法
                 if (isNative) {
-                    frame->push(obj);
-                    for (int i = argCount - 1; i >= 0; i--) {
-                        frame->push(args[i]);
-                    }
-                    
                     auto nativeFunc = NativeRegistry::getInstance().getNative(methodClass->name, name->bytes, descriptor->bytes);
                     if (nativeFunc) {
                        nativeFunc(thread, frame);
@@ -823,19 +723,8 @@ void Interpreter::initReferences() {
                     }
                 } else {
                     auto newFrame = std::make_shared<StackFrame>(*method, methodClass->rawFile);
-                    newFrame->setLocal(0, obj); // this
-                    
-                    int localIndex = 1;
-                    for(int i=0; i<argCount; ++i) {
-                        JavaValue& val = args[argCount - 1 - i];
-                        newFrame->setLocal(localIndex, val);
-                        localIndex++;
-                        if (val.type == JavaValue::LONG || val.type == JavaValue::DOUBLE) {
-                            localIndex++;
-                        }
-                    }
-                    
                     thread->pushFrame(newFrame);
+                    newFrame->takeArguments(*frame, argSlots + 1); // this + args
                 }
             }
             break;
@@ -854,28 +743,9 @@ void Interpreter::initReferences() {
             auto name = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[nameAndType->name_index]);
             auto descriptor = std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[nameAndType->descriptor_index]);
             
-            int argCount = 0;
-            bool parsingObj = false;
-            for (size_t i = 1; i < descriptor->bytes.length(); ++i) { // Skip '('
-                char c = descriptor->bytes[i];
-                if (c == ')') break;
-                if (parsingObj) {
-                    if (c == ';') parsingObj = false;
-                    continue;
-                }
-                if (c == 'L') {
-                    parsingObj = true;
-                    argCount++;
-                } else if (c == '[') {
-                } else {
-                    argCount++;
-                }
-            }
-
-            std::vector<JavaValue> args;
-            for(int i=0; i<argCount; ++i) args.push_back(frame->pop());
+            uint16_t argSlots = RuntimeMethod::countArgSlots(descriptor->bytes);
             
-            JavaValue obj = frame->pop();
+            JavaValue obj = frame->peekAt(argSlots);
             if (obj.val.ref == nullptr) {
                 // Determine Interface Name for logging
                 std::string interfaceName = "Unknown";
@@ -889,11 +759,21 @@ void Interpreter::initReferences() {
                 
                 LOG_ERROR("[ERROR] NullPointerException in INVOKEINTERFACE: " + interfaceName + "." + name->bytes + descriptor->bytes);
                           
-                throw std::runtime_error("NullPointerException");
+                throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             }
             
             JavaObject* javaObj = static_cast<JavaObject*>(obj.val.ref);
-            auto cls = javaObj->cls;
+            auto cls = javaObj->cls ? javaObj->cls->shared_from_this() : nullptr;
+
+            // Resolve the site to an interface method index once and run it as INVOKEINTERFACE_QUICK
+            // 调用点只解析一次接口方法索引，之后以 INVOKEINTERFACE_QUICK 执行
+            auto classRef = std::dynamic_pointer_cast<ConstantClass>(frame->classFile->constant_pool[methodRef->class_index]);
+            auto className = classRef ? std::dynamic_pointer_cast<ConstantUtf8>(frame->classFile->constant_pool[classRef->name_index]) : nullptr;
+            if (className && quickenInvoke(*frame, codeReader.tell() - 5, OP_INVOKEINTERFACE_QUICK, index,
+                                           className->bytes, name->bytes + "|" + descriptor->bytes, argSlots, javaObj)) {
+                codeReader.seek(codeReader.tell() - 5);
+                break;
+            }
             
              bool found = false;
              std::shared_ptr<JavaClass> currentClass = cls;
@@ -905,11 +785,6 @@ void Interpreter::initReferences() {
                      
                      if (mName->bytes == name->bytes && mDesc->bytes == descriptor->bytes) {
                         if (m.access_flags & 0x0100) { // ACC_NATIVE
-                             frame->push(obj);
-                             for (int i = argCount - 1; i >= 0; i--) {
-                                 frame->push(args[i]);
-                             }
-                             
                              auto nativeFunc = NativeRegistry::getInstance().getNative(currentClass->name, name->bytes, descriptor->bytes);
                              if (nativeFunc) {
                                  nativeFunc(thread, frame);
@@ -918,19 +793,8 @@ void Interpreter::initReferences() {
                              }
                         } else {
                             auto newFrame = std::make_shared<StackFrame>(m, currentClass->rawFile);
-                            newFrame->setLocal(0, obj); // this
-                            
-                            int localIndex = 1;
-                            for(int i=0; i<argCount; ++i) {
-                                JavaValue& val = args[argCount - 1 - i];
-                                newFrame->setLocal(localIndex, val);
-                                localIndex++;
-                                if (val.type == JavaValue::LONG || val.type == JavaValue::DOUBLE) {
-                                    localIndex++;
-                                }
-                            }
-                            
                             thread->pushFrame(newFrame);
+                            newFrame->takeArguments(*frame, argSlots + 1); // this + args
                         }
                          found = true;
                          break;
@@ -120,12 +120,12 @@ void Interpreter::initStores() {
             int32_t val = frame->pop().val.i;
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
-            arr->fields[index] = val;
+            arr->elements<int32_t>()[index] = val;
             break;
         } while(0);
         return true;
@@ -136,12 +136,12 @@ void Interpreter::initStores() {
             int64_t val = frame->pop().val.l;
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
-            arr->fields[index] = val;
+            arr->elements<int64_t>()[index] = val;
             break;
         } while(0);
         return true;
@@ -152,14 +152,14 @@ void Interpreter::initStores() {
             float val = frame->pop().val.f;
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             int32_t bits;
             memcpy(&bits, &val, sizeof(float));
-            arr->fields[index] = (int64_t)bits;
+            arr->elements<int32_t>()[index] = bits;
             break;
         } while(0);
         return true;
@@ -170,14 +170,14 @@ void Interpreter::initStores() {
             double val = frame->pop().val.d;
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             int64_t bits;
             memcpy(&bits, &val, sizeof(double));
-            arr->fields[index] = bits;
+            arr->elements<int64_t>()[index] = bits;
             break;
         } while(0);
         return true;
@@ -188,13 +188,13 @@ void Interpreter::initStores() {
             JavaValue val = frame->pop();
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
             // Should check array store exception (type mismatch) here, but skipping for now
-            arr->fields[index] = (int64_t)val.val.ref;
+            arr->setRefElement(index, (JavaObject*)val.val.ref);
             break;
         } while(0);
         return true;
@@ -205,12 +205,12 @@ void Interpreter::initStores() {
             int32_t val = frame->pop().val.i;
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
-            arr->fields[index] = (int8_t)val;
+            arr->elements<int8_t>()[index] = (int8_t)val;
             break;
         } while(0);
         return true;
@@ -221,12 +221,12 @@ void Interpreter::initStores() {
             int32_t val = frame->pop().val.i;
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
-            arr->fields[index] = (uint16_t)val;
+            arr->elements<uint16_t>()[index] = (uint16_t)val;
             break;
         } while(0);
         return true;
@@ -237,12 +237,12 @@ void Interpreter::initStores() {
             int32_t val = frame->pop().val.i;
             int32_t index = frame->pop().val.i;
             JavaValue arrRef = frame->pop();
-            if (arrRef.val.ref == nullptr) throw std::runtime_error("NullPointerException");
+            if (arrRef.val.ref == nullptr) throw JavaThrow(RuntimeExceptionKind::NULL_POINTER);
             
             JavaObject* arr = (JavaObject*)arrRef.val.ref;
-            if (index < 0 || index >= arr->fields.size()) throw std::runtime_error("ArrayIndexOutOfBoundsException");
+            if (index < 0 || index >= arr->arrayLength()) throw JavaThrow(RuntimeExceptionKind::ARRAY_INDEX);
             
-            arr->fields[index] = (int16_t)val;
+            arr->elements<int16_t>()[index] = (int16_t)val;
             break;
         } while(0);
         return true;
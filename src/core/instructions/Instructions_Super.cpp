@@ -0,0 +1,230 @@
+#include "../Interpreter.hpp"
+#include "../Opcodes.hpp"
+#include "../Logger.hpp"
+#include "../RuntimeMethod.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace j2me {
+namespace core {
+
+// 超级指令 (Superinstructions)
+// 类加载时扫描每个方法的字节码，把 Superinstructions.def 中所列的高频指令序列 (例如 ALOAD_0; GETFIELD、
+// ILOAD; BIPUSH; IF_ICMPxx、IINC; GOTO) 的首条操作码改写为超级指令操作码。线索化循环用一个处理函数执行整个序列，
+// 省去序列内部的分派; 序列的其余字节保持不变，跳转到序列中间仍然落在普通指令上。
+// 表中的序列由 scripts/gen_superinstructions.py 根据 --profile-opcodes 统计的候选序列执行次数选出。
+// 指令表 (--interp table) 中的超级指令只执行首条指令本身，与改写前完全一致。
+//
+// When a class is loaded, the first opcode of every occurrence of a sequence listed in
+// Superinstructions.def is rewritten to that sequence's superinstruction; the threaded
+// loop runs the whole sequence in one handler. The remaining bytes are left alone, so a
+// branch into the sequence still lands on an ordinary instruction. The table is chosen by
+// scripts/gen_superinstructions.py from the candidate sequences counted by --profile-opcodes.
+// In the instruction table a superinstruction just runs the instruction it replaced.
+
+namespace {
+
+// Shapes of the fused sequences; each entry of Superinstructions.def is one family with
+// a concrete first opcode. The threaded loop has a FUSED_<family> handler for each.
+// 融合序列的形态; Superinstructions.def 的每一项为一个族加上具体的首条操作码，线索化循环中对应 FUSED_<族> 处理函数
+enum class SuperFamily : uint8_t {
+    LOAD_GETFIELD,      // xLOAD ref; GETFIELD (fused once it is quickened to an int or reference field)
+    ILOAD_ILOAD_IBIN,   // ILOAD; ILOAD; IADD/ISUB/IMUL/IAND/IOR/IXOR/ISHL/ISHR/IUSHR
+    ILOAD_ILOAD_ICMP,   // ILOAD; ILOAD; IF_ICMPxx
+    ILOAD_CONST_IBIN,   // ILOAD; ICONST/BIPUSH/SIPUSH; int binary op
+    ILOAD_CONST_ICMP,   // ILOAD; ICONST/BIPUSH/SIPUSH; IF_ICMPxx
+    ILOAD_IFZ,          // ILOAD; IFxx
+    ALOAD_ILOAD_XALOAD, // ALOAD; ILOAD; IALOAD/AALOAD/BALOAD/CALOAD/SALOAD
+    IBIN_ISTORE,        // int binary op; ISTORE
+    IINC_GOTO,          // IINC; GOTO
+};
+
+// In the order of SuperFamily, as written by --profile-opcodes / 与 SuperFamily 顺序一致，用于 --profile-opcodes 输出
+const char* const FAMILY_NAMES[] = {
+    "LOAD_GETFIELD", "ILOAD_ILOAD_IBIN", "ILOAD_ILOAD_ICMP", "ILOAD_CONST_IBIN", "ILOAD_CONST_ICMP",
+    "ILOAD_IFZ", "ALOAD_ILOAD_XALOAD", "IBIN_ISTORE", "IINC_GOTO",
+};
+constexpr size_t FAMILY_COUNT = sizeof(FAMILY_NAMES) / sizeof(FAMILY_NAMES[0]);
+
+struct Superinstruction {
+    uint8_t opcode;
+    SuperFamily family;
+    uint8_t first;
+};
+
+const Superinstruction SUPERINSTRUCTIONS[] = {
+#define J2ME_SUPERINSTRUCTION(name, family, first) { OP_SI_##name, SuperFamily::family, first },
+#include "../Superinstructions.def"
+#undef J2ME_SUPERINSTRUCTION
+};
+
+bool isRefLoad(uint8_t op) { return op == OP_ALOAD || (op >= OP_ALOAD_0 && op <= OP_ALOAD_3); }
+bool isIntLoad(uint8_t op) { return op == OP_ILOAD || (op >= OP_ILOAD_0 && op <= OP_ILOAD_3); }
+bool isIntStore(uint8_t op) { return op == OP_ISTORE || (op >= OP_ISTORE_0 && op <= OP_ISTORE_3); }
+bool isIntConst(uint8_t op) { return (op >= OP_ICONST_M1 && op <= OP_ICONST_5) || op == OP_BIPUSH || op == OP_SIPUSH; }
+bool isIntCompare(uint8_t op) { return op >= OP_IF_ICMPEQ && op <= OP_IF_ICMPLE; }
+bool isZeroCompare(uint8_t op) { return op >= OP_IFEQ && op <= OP_IFLE; }
+bool isGetField(uint8_t op) { return op == OP_GETFIELD || (op >= OP_GETFIELD_QUICK_I && op <= OP_GETFIELD_QUICK_A); }
+
+// Int operations that cannot throw (IDIV/IREM stay separate instructions)
+// 不会抛出异常的 int 运算 (IDIV/IREM 不参与融合)
+bool isIntBinary(uint8_t op) {
+    switch (op) {
+        case OP_IADD: case OP_ISUB: case OP_IMUL: case OP_IAND: case OP_IOR: case OP_IXOR:
+        case OP_ISHL: case OP_ISHR: case OP_IUSHR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isElementLoad(uint8_t op) {
+    return op == OP_IALOAD || op == OP_AALOAD || op == OP_BALOAD || op == OP_CALOAD || op == OP_SALOAD;
+}
+
+// Whether op can start a sequence of family / op 能否作为该族序列的首条指令
+bool startsFamily(SuperFamily family, uint8_t op) {
+    switch (family) {
+        case SuperFamily::LOAD_GETFIELD: case SuperFamily::ALOAD_ILOAD_XALOAD: return isRefLoad(op);
+        case SuperFamily::IBIN_ISTORE: return isIntBinary(op);
+        case SuperFamily::IINC_GOTO: return op == OP_IINC;
+        default: return isIntLoad(op);
+    }
+}
+
+// Length of the instructions following the first one of `family` at pc, 0 if the code
+// there does not have that shape
+// pc 处序列中首条指令之后各指令的总长度; 该处代码不符合族的形态时返回 0
+size_t matchTail(SuperFamily family, const std::vector<uint8_t>& code, size_t pc) {
+    size_t at = pc;
+    auto step = [&](bool (*matches)(uint8_t)) {
+        size_t len = at < code.size() ? instructionLength(code, at) : 0;
+        if (len == 0 || at + len > code.size() || !matches(code[at])) return false;
+        at += len;
+        return true;
+    };
+    auto isGoto = [](uint8_t op) { return op == OP_GOTO; };
+    at += instructionLength(code, pc);
+    bool matched = false;
+    switch (family) {
+        case SuperFamily::LOAD_GETFIELD: matched = step(isGetField); break;
+        case SuperFamily::ILOAD_ILOAD_IBIN: matched = step(isIntLoad) && step(isIntBinary); break;
+        case SuperFamily::ILOAD_ILOAD_ICMP: matched = step(isIntLoad) && step(isIntCompare); break;
+        case SuperFamily::ILOAD_CONST_IBIN: matched = step(isIntConst) && step(isIntBinary); break;
+        case SuperFamily::ILOAD_CONST_ICMP: matched = step(isIntConst) && step(isIntCompare); break;
+        case SuperFamily::ILOAD_IFZ: matched = step(isZeroCompare); break;
+        case SuperFamily::ALOAD_ILOAD_XALOAD: matched = step(isIntLoad) && step(isElementLoad); break;
+        case SuperFamily::IBIN_ISTORE: matched = step(isIntStore); break;
+        case SuperFamily::IINC_GOTO: matched = step(isGoto); break;
+    }
+    return matched ? at - pc : 0;
+}
+
+const Superinstruction* superinstructionOf(uint8_t opcode) {
+    if (opcode < OP_SUPERINSTRUCTION_FIRST || opcode >= OP_SUPERINSTRUCTION_END) return nullptr;
+    return &SUPERINSTRUCTIONS[opcode - OP_SUPERINSTRUCTION_FIRST];
+}
+
+// Rewrite the sequences of one method, left to right without overlaps (an instruction
+// inside a fused sequence never starts another one). Returns the number of sites.
+// 从左到右改写一个方法中的序列，互不重叠 (已融合序列内部的指令不会再作为另一个序列的开头)。返回改写的位置数
+size_t fuseMethod(std::vector<uint8_t>& code) {
+    size_t fused = 0;
+    size_t pc = 0;
+    while (pc < code.size()) {
+        size_t len = instructionLength(code, pc);
+        // wide/jsr/ret or a malformed switch: the rest of the method cannot be walked
+        // wide/jsr/ret 或格式错误的 switch: 无法继续遍历该方法的剩余部分
+        if (len == 0) break;
+        if (const Superinstruction* existing = superinstructionOf(code[pc])) {
+            // Already fused (the class was registered again)
+            // 已融合 (类被重复注册)
+            size_t seq = matchTail(existing->family, code, pc);
+            if (seq > len) len = seq;
+        } else {
+            for (const Superinstruction& si : SUPERINSTRUCTIONS) {
+                if (si.first != code[pc]) continue;
+                size_t seq = matchTail(si.family, code, pc);
+                if (seq == 0) continue;
+                code[pc] = si.opcode;
+                len = seq;
+                fused++;
+                break;
+            }
+        }
+        pc += len;
+    }
+    return fused;
+}
+
+} // namespace
+
+void Interpreter::initSuperinstructions() {
+    // The table loop runs the replaced instruction on its own (after the other groups,
+    // whose handlers it reuses)
+    // 指令表循环只执行被替换的那条指令 (需在其他指令组之后初始化，以复用它们的处理函数)
+    for (const Superinstruction& si : SUPERINSTRUCTIONS) {
+        InstructionHandler replaced = instructionTable[si.first];
+        uint8_t first = si.first;
+        instructionTable[si.opcode] = [replaced, first](std::shared_ptr<JavaThread> thread, std::shared_ptr<StackFrame> frame, util::DataReader& codeReader, uint8_t) -> bool {
+            return replaced(thread, frame, codeReader, first);
+        };
+    }
+}
+
+void Interpreter::fuseSuperinstructions(const JavaClass& cls) {
+    if (!superinstructionsEnabled || !cls.rawFile) return;
+    size_t fused = 0;
+    for (const auto& method : cls.rawFile->methods) {
+        if (method.runtime) fused += fuseMethod(method.runtime->code);
+    }
+    if (fused > 0) {
+        LOG_DEBUG("[Super] Fused " + std::to_string(fused) + " sequences in " + cls.name);
+    }
+}
+
+void Interpreter::setOpcodeProfiling(bool enabled) {
+    if (enabled) sequenceCounts.assign(FAMILY_COUNT * 256, 0);
+    else sequenceCounts.clear();
+    profiledInstructions = 0;
+}
+
+void Interpreter::countSequences(const StackFrame& frame, size_t pc) {
+    // Fusion is off while profiling, so the code is the original bytecode (quickened)
+    // 统计时不进行融合，因此代码即原始字节码 (可能已快速化)
+    profiledInstructions++;
+    uint8_t first = frame.code[pc];
+    for (size_t family = 0; family < FAMILY_COUNT; family++) {
+        if (startsFamily((SuperFamily)family, first) && matchTail((SuperFamily)family, frame.code, pc) > 0) {
+            sequenceCounts[family * 256 + first]++;
+        }
+    }
+}
+
+bool Interpreter::writeOpcodeProfile(const std::string& path) const {
+    std::vector<std::pair<uint64_t, uint32_t>> candidates;
+    for (uint32_t i = 0; i < sequenceCounts.size(); i++) {
+        if (sequenceCounts[i] > 0) candidates.emplace_back(sequenceCounts[i], i);
+    }
+    std::sort(candidates.rbegin(), candidates.rend());
+
+    std::ofstream out(path);
+    if (!out) {
+        LOG_ERROR("[Super] Cannot write opcode profile " + path);
+        return false;
+    }
+    out << "# <count> <family> <first opcode>, input of scripts/gen_superinstructions.py\n";
+    out << "# instructions " << profiledInstructions << "\n";
+    char line[64];
+    for (const auto& candidate : candidates) {
+        std::snprintf(line, sizeof(line), "%llu %s 0x%02x\n", (unsigned long long)candidate.first,
+                      FAMILY_NAMES[candidate.second >> 8], (unsigned)(candidate.second & 0xFF));
+        out << line;
+    }
+    LOG_INFO("[Super] Wrote " + std::to_string(candidates.size()) + " candidate sequences to " + path);
+    return true;
+}
+
+} // namespace core
+} // namespace j2me
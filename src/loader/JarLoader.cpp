@@ -54,6 +54,13 @@ void JarLoader::close() {
     }
 }
 
+std::vector<std::string> JarLoader::listFiles() const {
+    std::vector<std::string> names;
+    names.reserve(fileMap.size());
+    for (const auto& entry : fileMap) names.push_back(entry.first);
+    return names;
+}
+
 bool JarLoader::hasFile(const std::string& filename) {
     if (!archive) return false;
     return fileMap.find(filename) != fileMap.end();
@@ -24,6 +24,9 @@ public:
 
     // Check if file exists
     bool hasFile(const std::string& filename);
+
+    // Names of all entries in the JAR
+    std::vector<std::string> listFiles() const;
     
     // Get Manifest content as string
     std::optional<std::string> getManifest();
@@ -60,6 +60,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 #include "core/Logger.hpp"
 #include "core/EventLoop.hpp"
 #include "core/ClassParser.hpp"
+#include "core/BytecodeOptimizer.hpp"
+#include "core/HeapManager.hpp"
 #include "platform/GraphicsContext.hpp"
 #include "util/FileUtils.hpp"
 
@@ -208,14 +210,40 @@ static int parseAutoKeyToken(const std::string& t) {
     return 0;
 }
 
+// Byte count with an optional K or M suffix (--heap-max 2M); 0 when malformed
+static size_t parseByteSize(const std::string& s) {
+    size_t used = 0;
+    long long value = 0;
+    try {
+        value = std::stoll(s, &used);
+    } catch (const std::exception&) {
+        return 0;
+    }
+    if (value <= 0) return 0;
+    std::string suffix = s.substr(used);
+    if (suffix == "k" || suffix == "K") return (size_t)value << 10;
+    if (suffix == "m" || suffix == "M") return (size_t)value << 20;
+    return suffix.empty() ? (size_t)value : 0;
+}
+
 int main(int argc, char* argv[]) {
 #ifndef __SWITCH__
     if (argc < 2) {
-        LOG_INFO("Usage: j2me-vm [--debug] [--log-level LEVEL] [--timeout-ms MS] [--auto-key [SEQ]] [--no-auto-key] [--auto-key-delay-ms MS] <path_to_jar_or_class>");
+        LOG_INFO("Usage: j2me-vm [--debug] [--log-level LEVEL] [--timeout-ms MS] [--auto-key [SEQ]] [--no-auto-key] [--auto-key-delay-ms MS] [--interp MODE] [--tier2-threshold N] [--jit=off|on|threshold=N] [--aot=off|on|module=PATH] [--superinstructions=off|on] [--profile-opcodes FILE] [--peephole=LIST] [--gc-budget-us US] [--heap-max SIZE] [--heap-dump-on-exit] [--heap-dump-prefix PREFIX] [--heap-dump-threshold SIZE] [--alloc-profile N] [--alloc-profile-out FILE] <path_to_jar_or_class>");
         LOG_INFO("  --debug: Enable debug mode (equivalent to --log-level debug)");
         LOG_INFO("  LEVEL: debug, info, error, none (default: info)");
         LOG_INFO("  MS: auto exit after MS milliseconds (0 disables, minimum: 15000)");
         LOG_INFO("  SEQ: comma-separated keys, e.g. soft1,fire or fire (default: soft1,fire when enabled)");
+        LOG_INFO("  MODE: threaded (default) or table (legacy dispatch table, for comparison)");
+        LOG_INFO("  N: invocations + loop iterations before a method runs on the register IR tier (default: 500, 0 disables)");
+        LOG_INFO("  --jit: compile hot methods to x86-64 machine code (default: off; on uses a threshold of 2000)");
+        LOG_INFO("  --aot: run methods compiled by j2me-aot from the module next to the JAR (default: on), or from PATH");
+        LOG_INFO("  --superinstructions: fuse frequent bytecode sequences when classes are loaded (default: on)");
+        LOG_INFO("  FILE: count how often each candidate superinstruction would run and write the counts to FILE on exit, for scripts/gen_superinstructions.py");
+        LOG_INFO("  LIST: load-time peephole passes, all (default), none, or some of constants,checkcasts,dup-pop,branches,switches");
+        LOG_INFO("  US: microseconds of incremental garbage collection per frame (default: 1000, 0 collects stop-the-world)");
+        LOG_INFO("  SIZE: heap cap in bytes, K or M (e.g. 2M), counting objects, arrays, StringBuffer contents and decoded images; past it OutOfMemoryError is thrown");
+        LOG_INFO("  --heap-dump-*: write a class histogram to the log and a heap dump to PREFIX-N.j2heap on exit, on SIGUSR1, or once SIZE stays live after a collection");
         return 1;
     }
 #endif
@@ -279,6 +307,89 @@ int main(int argc, char* argv[]) {
         } else if (arg == "--auto-key-delay-ms" && i + 1 < argc) {
             config.autoKeyDelayMs = std::stoll(argv[++i]);
             if (config.autoKeyDelayMs < 0) config.autoKeyDelayMs = 0;
+        } else if (arg == "--interp" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "table") {
+                config.useDispatchTable = true;
+            } else if (mode == "threaded") {
+                config.useDispatchTable = false;
+            } else {
+                LOG_ERROR("Invalid interpreter mode: " + mode);
+                return 1;
+            }
+        } else if (arg == "--tier2-threshold" && i + 1 < argc) {
+            long long threshold = std::stoll(argv[++i]);
+            config.tier2Threshold = threshold < 0 ? 0 : (uint32_t)threshold;
+        } else if (arg.rfind("--jit=", 0) == 0) {
+            std::string mode = arg.substr(6);
+            if (mode == "off") {
+                config.jitThreshold = 0;
+            } else if (mode == "on") {
+                config.jitThreshold = j2me::core::VMConfig::DEFAULT_JIT_THRESHOLD;
+            } else if (mode.rfind("threshold=", 0) == 0) {
+                long long threshold = std::stoll(mode.substr(10));
+                config.jitThreshold = threshold <= 0 ? 0 : (uint32_t)threshold;
+            } else {
+                LOG_ERROR("Invalid JIT mode: " + mode);
+                return 1;
+            }
+        } else if (arg.rfind("--aot=", 0) == 0) {
+            std::string mode = arg.substr(6);
+            if (mode == "off") {
+                config.aotEnabled = false;
+            } else if (mode == "on") {
+                config.aotEnabled = true;
+            } else if (mode.rfind("module=", 0) == 0 && mode.size() > 7) {
+                config.aotEnabled = true;
+                config.aotModulePath = mode.substr(7);
+            } else {
+                LOG_ERROR("Invalid AOT mode: " + mode);
+                return 1;
+            }
+        } else if (arg.rfind("--superinstructions=", 0) == 0) {
+            std::string mode = arg.substr(20);
+            if (mode == "off") {
+                config.superinstructions = false;
+            } else if (mode == "on") {
+                config.superinstructions = true;
+            } else {
+                LOG_ERROR("Invalid superinstructions mode: " + mode);
+                return 1;
+            }
+        } else if (arg == "--profile-opcodes" && i + 1 < argc) {
+            config.opcodeProfilePath = argv[++i];
+        } else if (arg.rfind("--peephole=", 0) == 0) {
+            config.peepholePasses = arg.substr(11);
+            if (!j2me::core::BytecodeOptimizer::getInstance().setPasses(config.peepholePasses)) {
+                LOG_ERROR("Invalid peephole passes: " + config.peepholePasses);
+                return 1;
+            }
+        } else if (arg == "--gc-budget-us" && i + 1 < argc) {
+            long long budget = std::stoll(argv[++i]);
+            config.gcBudgetUs = budget < 0 ? 0 : (uint32_t)budget;
+        } else if (arg == "--heap-max" && i + 1 < argc) {
+            std::string sizeStr = argv[++i];
+            config.heapMaxBytes = parseByteSize(sizeStr);
+            if (config.heapMaxBytes == 0) {
+                LOG_ERROR("Invalid heap size: " + sizeStr);
+                return 1;
+            }
+        } else if (arg == "--heap-dump-on-exit") {
+            config.heapDumpOnExit = true;
+        } else if (arg == "--heap-dump-prefix" && i + 1 < argc) {
+            config.heapDumpPrefix = argv[++i];
+        } else if (arg == "--heap-dump-threshold" && i + 1 < argc) {
+            std::string sizeStr = argv[++i];
+            config.heapDumpThreshold = parseByteSize(sizeStr);
+            if (config.heapDumpThreshold == 0) {
+                LOG_ERROR("Invalid heap size: " + sizeStr);
+                return 1;
+            }
+        } else if (arg == "--alloc-profile" && i + 1 < argc) {
+            long long interval = std::stoll(argv[++i]);
+            config.allocSampleInterval = interval < 0 ? 0 : (uint32_t)interval;
+        } else if (arg == "--alloc-profile-out" && i + 1 < argc) {
+            config.allocProfilePath = argv[++i];
         } else if (arg[0] != '-') {
             if (config.filePath.empty()) {
                 config.filePath = arg;
@@ -315,6 +426,12 @@ int main(int argc, char* argv[]) {
     std::signal(SIGTERM, [](int) {
         j2me::core::EventLoop::getInstance().requestExit("manual: SIGTERM");
     });
+#ifdef SIGUSR1
+    // Heap dump at the next safepoint (see HeapManager::requestDump)
+    std::signal(SIGUSR1, [](int) {
+        j2me::core::HeapManager::getInstance().requestDump();
+    });
+#endif
     
     // 检查是否为 .class 文件
     // Check if it's a .class file
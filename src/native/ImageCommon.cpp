@@ -1,11 +1,22 @@
 #include "ImageCommon.hpp"
+#include "../core/HeapManager.hpp"
 
 namespace j2me {
 namespace natives {
 
-std::map<int32_t, SDL_Surface*> imageMap;
-std::set<int32_t> mutableImages;
-int32_t nextImageId = 1;
+int32_t registerImage(SDL_Surface* surface, bool isMutable) {
+    size_t bytes = (size_t)surface->pitch * surface->h;
+    try {
+        j2me::core::HeapManager::getInstance().reserveNative(bytes);
+    } catch (...) {
+        SDL_FreeSurface(surface);
+        throw;
+    }
+    return (int32_t)core::NativeHandles::getInstance().create(
+        core::NativeHandles::Kind::IMAGE, surface,
+        [](void* resource) { SDL_FreeSurface(static_cast<SDL_Surface*>(resource)); }, nullptr, bytes,
+        isMutable ? core::NativeHandles::IMAGE_MUTABLE : 0);
+}
 
 } // namespace natives
 } // namespace j2me
@@ -1,15 +1,30 @@
 #pragma once
 
-#include <map>
-#include <set>
+#include <cstdint>
 #include <SDL2/SDL.h>
+#include "../core/NativeHandles.hpp"
 
 namespace j2me {
 namespace natives {
 
-extern std::map<int32_t, SDL_Surface*> imageMap;
-extern std::set<int32_t> mutableImages;
-extern int32_t nextImageId;
+// Decoded images live in core::NativeHandles; Image.nativePtr (field 0) holds the handle
+// and the surface is freed once the Image that adopted it is collected. Its pixels count
+// against the heap cap; when they do not fit the surface is freed and the
+// OutOfMemoryError propagates.
+// 解码后的图片保存在 core::NativeHandles 中，Image.nativePtr (字段 0) 保存其句柄，接管该句柄的 Image 被回收后释放 surface。
+// 像素内存计入堆上限; 超出上限时释放该 surface 并继续抛出 OutOfMemoryError
+int32_t registerImage(SDL_Surface* surface, bool isMutable = false);
+
+// The surface of an image handle, nullptr for 0 or a released image
+// 图片句柄对应的 surface，句柄为 0 或图片已释放时返回 nullptr
+inline SDL_Surface* lookupImage(int32_t handle) {
+    return core::NativeHandles::getInstance().get<SDL_Surface>((uint32_t)handle, core::NativeHandles::Kind::IMAGE);
+}
+
+inline bool isMutableImage(int32_t handle) {
+    return core::NativeHandles::getInstance().flags((uint32_t)handle, core::NativeHandles::Kind::IMAGE) &
+           core::NativeHandles::IMAGE_MUTABLE;
+}
 
 } // namespace natives
 } // namespace j2me
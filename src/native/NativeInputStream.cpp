@@ -1,4 +1,6 @@
 #include "NativeInputStream.hpp"
+#include "../core/HeapManager.hpp"
+#include "../core/NativeHandles.hpp"
 #include <cstring>
 #include <algorithm>
 #include <iostream>
@@ -19,6 +21,23 @@ NativeInputStream::NativeInputStream(const uint8_t* dataPtr, size_t size)
     }
 }
 
+int32_t NativeInputStream::open(const uint8_t* data, size_t size, core::JavaObject* owner, const std::string& path) {
+    core::HeapManager::getInstance().reserveNative(size);
+    auto stream = new NativeInputStream(data, size);
+    if (!path.empty()) stream->setFilePath(path);
+    return (int32_t)core::NativeHandles::getInstance().create(
+        core::NativeHandles::Kind::STREAM, stream,
+        [](void* resource) { delete static_cast<NativeInputStream*>(resource); }, owner, size);
+}
+
+NativeInputStream* NativeInputStream::fromHandle(int32_t handle) {
+    return core::NativeHandles::getInstance().get<NativeInputStream>((uint32_t)handle, core::NativeHandles::Kind::STREAM);
+}
+
+void NativeInputStream::release(int32_t handle) {
+    core::NativeHandles::getInstance().release((uint32_t)handle);
+}
+
 int NativeInputStream::read() {
     // std::cout << "[NativeInputStream] read() BEFORE - id: " << this << " path: " << filePath << " size: " << data.size() << " position: " << position << " available: " << (data.size() - position) << std::endl;
     
@@ -5,11 +5,21 @@
 #include <string>
 
 namespace j2me {
+namespace core { class JavaObject; }
 namespace natives {
 
 class NativeInputStream {
 public:
     NativeInputStream(const uint8_t* data, size_t size);
+
+    // Streams opened for Java code live in core::NativeHandles, owned by the InputStream or
+    // RandomAccessFile that stores the handle and released when it is collected or closed.
+    // The copied data counts against the heap cap.
+    // 为 Java 代码打开的流保存在 core::NativeHandles 中，其所有者为保存该句柄的 InputStream 或 RandomAccessFile，
+    // 在所有者被回收或流被关闭时释放。复制的数据计入堆上限
+    static int32_t open(const uint8_t* data, size_t size, core::JavaObject* owner, const std::string& path = std::string());
+    static NativeInputStream* fromHandle(int32_t handle);
+    static void release(int32_t handle);
     
     int read();
     int read(uint8_t* buffer, int len);
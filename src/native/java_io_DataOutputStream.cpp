@@ -27,13 +27,13 @@ void registerDataOutputStreamNatives(j2me::core::NativeRegistry& registry) {
                 
                 LOG_DEBUG("[DataOutputStream.size()I] BEFORE - object: " + std::to_string((intptr_t)dataOutputStreamObj));
                 
-                // Assuming field index 1 is the 'written' field (based on the Java class definition)
-                // Field layout: out(OutputStream) at index 0, written(int) at index 1
-                if (dataOutputStreamObj->fields.size() > 1) {
-                    result.val.i = (int)dataOutputStreamObj->fields[1];
+                // The 'written' counter of the Java class; its offset depends on the field layout
+                auto writtenIt = dataOutputStreamObj->cls->fieldOffsets.find("written|I");
+                if (writtenIt != dataOutputStreamObj->cls->fieldOffsets.end()) {
+                    result.val.i = dataOutputStreamObj->get<int32_t>(writtenIt->second);
                     LOG_DEBUG("[DataOutputStream.size()I] AFTER - object: " + std::to_string((intptr_t)dataOutputStreamObj) + " size: " + std::to_string(result.val.i));
                 } else {
-                    LOG_ERROR("[DataOutputStream.size()I] ERROR - object has insufficient fields");
+                    LOG_ERROR("[DataOutputStream.size()I] ERROR - object has no written field");
                 }
             } else {
                 LOG_ERROR("[DataOutputStream.size()I] ERROR - Invalid this object");
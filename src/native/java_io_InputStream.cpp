@@ -27,9 +27,9 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                 
                 if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                     j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                    if (inputStreamObj->fields.size() > 0) {
-                             int streamId = (int)inputStreamObj->fields[0];
-                             auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                    if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                             int streamId = inputStreamObj->get<int32_t>(0);
+                             auto stream = NativeInputStream::fromHandle(streamId);
                              
                              if (stream) {
                                  result.val.i = stream->read();
@@ -37,7 +37,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                                  LOG_ERROR("[InputStream.read()I] ERROR - stream not found for id: " + std::to_string(streamId));
                              }
                          } else {
-                        LOG_ERROR("[InputStream.read()I] ERROR - inputStreamObj has no fields");
+                        LOG_ERROR("[InputStream.read()I] ERROR - inputStreamObj has no stream handle");
                     }
                 } else {
                     LOG_ERROR("[InputStream.read()I] ERROR - Invalid this object");
@@ -63,16 +63,16 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
-                    int streamId = (int)inputStreamObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                    int streamId = inputStreamObj->get<int32_t>(0);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     
                     j2me::core::JavaObject* arrayObj = nullptr;
                     size_t arrayLength = 0;
                     
                     if (arrayVal.type == j2me::core::JavaValue::REFERENCE && arrayVal.val.ref != nullptr) {
                         arrayObj = (j2me::core::JavaObject*)arrayVal.val.ref;
-                        arrayLength = arrayObj->fields.size();
+                        arrayLength = arrayObj->arrayLength();
                     }
                     
                     if (stream && arrayObj != nullptr) {
@@ -83,7 +83,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                             
                             if (bytesRead > 0) {
                                 for (size_t i = 0; i < (size_t)bytesRead; i++) {
-                                    arrayObj->fields[i] = (int64_t)buffer[i];
+                                    arrayObj->elements<int8_t>()[i] = (int8_t)buffer[i];
                                 }
                                 result.val.i = bytesRead;
                             }
@@ -97,7 +97,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                         LOG_ERROR("[InputStream.read([B)I] ERROR - stream or array object not found - stream: " + std::string(stream ? "valid" : "null") + " arrayObj: " + std::string(arrayObj ? "valid" : "null"));
                     }
                 } else {
-                    LOG_ERROR("[InputStream.read([B)I] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.read([B)I] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.read([B)I] ERROR - Invalid this or array object");
@@ -121,16 +121,16 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
 
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
-                    int streamId = (int)inputStreamObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                    int streamId = inputStreamObj->get<int32_t>(0);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     
                     j2me::core::JavaObject* arrayObj = nullptr;
                     size_t arrayLen = 0;
                     
                     if (arrayVal.type == j2me::core::JavaValue::REFERENCE && arrayVal.val.ref != nullptr) {
                         arrayObj = (j2me::core::JavaObject*)arrayVal.val.ref;
-                        arrayLen = arrayObj->fields.size();
+                        arrayLen = arrayObj->arrayLength();
                     }
 
                     LOG_DEBUG("[InputStream.read([BII)I] BEFORE - streamId: " + std::to_string(streamId) + " path: " + stream->getFilePath() + " method: read([BII)I offset: " + std::to_string(off) + " len: " + std::to_string(len) + " arrayLen: " + std::to_string(arrayLen));
@@ -149,7 +149,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                             
                             if (bytesRead > 0) {
                                 for (int i = 0; i < bytesRead; i++) {
-                                    arrayObj->fields[off + i] = (int64_t)buffer[i];
+                                    arrayObj->elements<int8_t>()[off + i] = (int8_t)buffer[i];
                                 }
                                 result.val.i = bytesRead;
                             }
@@ -160,7 +160,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                         LOG_ERROR("[InputStream.read([BII)I] ERROR - stream or array object not found - stream: " + std::string(stream ? "valid" : "null") + " arrayObj: " + std::string(arrayObj ? "valid" : "null"));
                     }
                 } else {
-                    LOG_ERROR("[InputStream.read([BII)I] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.read([BII)I] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.read([BII)I] ERROR - Invalid this or array object");
@@ -176,13 +176,13 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
-                    int streamId = (int)inputStreamObj->fields[0];
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                    int streamId = inputStreamObj->get<int32_t>(0);
                     LOG_DEBUG("[InputStream.close()V] BEFORE - streamId: " + std::to_string(streamId) + " method: close()V");
-                    j2me::core::HeapManager::getInstance().removeStream(streamId);
+                    NativeInputStream::release(streamId);
                     LOG_DEBUG("[InputStream.close()V] AFTER - streamId: " + std::to_string(streamId) + " stream removed");
                 } else {
-                    LOG_ERROR("[InputStream.close()V] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.close()V] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.close()V] ERROR - Invalid this object");
@@ -200,9 +200,9 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
-                    int streamId = (int)inputStreamObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                    int streamId = inputStreamObj->get<int32_t>(0);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     
                     if (stream) {
                         result.val.i = stream->available();
@@ -210,7 +210,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                         LOG_ERROR("[InputStream.available()I] ERROR - stream not found for id: " + std::to_string(streamId));
                     }
                 } else {
-                    LOG_ERROR("[InputStream.available()I] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.available()I] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.available()I] ERROR - Invalid this object");
@@ -230,9 +230,9 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
-                    int streamId = (int)inputStreamObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                    int streamId = inputStreamObj->get<int32_t>(0);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     
                     if (stream) {
                         result.val.l = stream->skip(n);
@@ -240,7 +240,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                         LOG_ERROR("[InputStream.skip(J)J] ERROR - stream not found for id: " + std::to_string(streamId));
                     }
                 } else {
-                    LOG_ERROR("[InputStream.skip(J)J] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.skip(J)J] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.skip(J)J] ERROR - Invalid this object");
@@ -257,11 +257,11 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
             bool supported = false;
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
                      // Check if it's our NativeInputStream
                      // Ideally we should check class type, but for now we assume if it has handle it is ours.
-                     int streamId = (int)inputStreamObj->fields[0];
-                     auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                     int streamId = inputStreamObj->get<int32_t>(0);
+                     auto stream = NativeInputStream::fromHandle(streamId);
                      
                      if (stream) {
                          supported = stream->markSupported();
@@ -269,7 +269,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                          LOG_ERROR("[InputStream.markSupported()Z] ERROR - stream not found for id: " + std::to_string(streamId));
                      }
                 } else {
-                    LOG_ERROR("[InputStream.markSupported()Z] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.markSupported()Z] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.markSupported()Z] ERROR - Invalid this object");
@@ -290,9 +290,9 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
-                    int streamId = (int)inputStreamObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                    int streamId = inputStreamObj->get<int32_t>(0);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     
                     if (stream) {
                         stream->mark(readlimit);
@@ -300,7 +300,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                         LOG_ERROR("[InputStream.mark(I)V] ERROR - stream not found for id: " + std::to_string(streamId));
                     }
                 } else {
-                    LOG_ERROR("[InputStream.mark(I)V] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.mark(I)V] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.mark(I)V] ERROR - Invalid this object");
@@ -315,9 +315,9 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* inputStreamObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (inputStreamObj->fields.size() > 0) {
-                    int streamId = (int)inputStreamObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                if (inputStreamObj->hasField(0, j2me::core::FIELD_I)) {
+                    int streamId = inputStreamObj->get<int32_t>(0);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     
                     if (stream) {
                         stream->reset();
@@ -325,7 +325,7 @@ void registerInputStreamNatives(j2me::core::NativeRegistry& registry) {
                         LOG_ERROR("[InputStream.reset()V] ERROR - stream not found for id: " + std::to_string(streamId));
                     }
                 } else {
-                    LOG_ERROR("[InputStream.reset()V] ERROR - inputStreamObj has no fields");
+                    LOG_ERROR("[InputStream.reset()V] ERROR - inputStreamObj has no stream handle");
                 }
             } else {
                 LOG_ERROR("[InputStream.reset()V] ERROR - Invalid this object");
@@ -42,9 +42,7 @@ void registerPrintStreamNatives(j2me::core::NativeRegistry& registry) {
             frame->pop(); // this
             
             if (strVal.type == j2me::core::JavaValue::REFERENCE) {
-                if (!strVal.strVal.empty()) {
-                    LOG_INFO(strVal.strVal);
-                } else if (strVal.val.ref != nullptr) {
+                if (strVal.val.ref != nullptr) {
                     auto strObj = static_cast<j2me::core::JavaObject*>(strVal.val.ref);
                     if (strObj && strObj->cls) {
                         std::string str = getJavaString(strObj);
@@ -13,13 +13,24 @@
 namespace j2me {
 namespace natives {
 
+// Offset of the streamId field. Fields are laid out by size (filePointer is a long and
+// comes first), so it is looked up by name.
+// streamId 字段的偏移。字段按大小排列 (long 类型的 filePointer 在最前)，因此按名称查找
+static bool streamIdOffset(const j2me::core::JavaObject* obj, size_t& offset) {
+    if (!obj->cls) return false;
+    auto it = obj->cls->fieldOffsets.find("streamId|I");
+    if (it == obj->cls->fieldOffsets.end()) return false;
+    offset = it->second;
+    return true;
+}
+
 void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
     
     registry.registerNative("java/io/RandomAccessFile", "openNative", "(Ljava/lang/String;Ljava/lang/String;)V", 
         [&registry](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
             LOG_DEBUG("[RandomAccessFile] openNative called");
             
-            j2me::core::JavaValue modeVal = frame->pop();
+            frame->pop();
             j2me::core::JavaValue nameVal = frame->pop();
             j2me::core::JavaValue thisVal = frame->pop();
             
@@ -33,12 +44,13 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
                 if (loader && loader->hasFile(name)) {
                     auto data = loader->getFile(name);
                     if (data) {
-                        int streamId = j2me::core::HeapManager::getInstance().allocateStreamWithPath(data->data(), data->size(), name);
+                        auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
+                        int streamId = NativeInputStream::open(data->data(), data->size(), thisObj, name);
                         
-                        if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
-                            auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                            if (thisObj->fields.size() > 0) {
-                                thisObj->fields[0] = streamId;
+                        if (thisObj) {
+                            size_t streamIdAt = 0;
+                            if (streamIdOffset(thisObj, streamIdAt)) {
+                                thisObj->set<int32_t>(streamIdAt, streamId);
                             }
                         }
                         
@@ -63,10 +75,11 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int streamId = thisObj->fields[0];
-                    j2me::core::HeapManager::getInstance().removeStream(streamId);
-                    thisObj->fields[0] = 0;
+                size_t streamIdAt = 0;
+                if (streamIdOffset(thisObj, streamIdAt)) {
+                    int streamId = thisObj->get<int32_t>(streamIdAt);
+                    NativeInputStream::release(streamId);
+                    thisObj->set<int32_t>(streamIdAt, 0);
                 }
             }
         }
@@ -82,9 +95,10 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int streamId = thisObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                size_t streamIdAt = 0;
+                if (streamIdOffset(thisObj, streamIdAt)) {
+                    int streamId = thisObj->get<int32_t>(streamIdAt);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     if (stream) {
                         result.val.i = stream->read();
                     }
@@ -111,11 +125,13 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
                 auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
                 auto bufObj = (j2me::core::JavaObject*)bufVal.val.ref;
                 
-                if (thisObj->fields.size() > 0) {
-                    int streamId = thisObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
-                    if (stream && bufObj->fields.size() > 0) {
-                        size_t arrayLen = bufObj->fields.size();
+                size_t streamIdAt = 0;
+                
+                if (streamIdOffset(thisObj, streamIdAt)) {
+                    int streamId = thisObj->get<int32_t>(streamIdAt);
+                    auto stream = NativeInputStream::fromHandle(streamId);
+                    if (stream && bufObj->arrayLength() > 0) {
+                        size_t arrayLen = bufObj->arrayLength();
                         int off = offVal.val.i;
                         int len = lenVal.val.i;
                         
@@ -128,7 +144,7 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
                                 
                                 if (bytesRead > 0) {
                                     for (int i = 0; i < bytesRead; i++) {
-                                        bufObj->fields[off + i] = (int64_t)buffer[i];
+                                        bufObj->elements<int8_t>()[off + i] = (int8_t)buffer[i];
                                     }
                                     result.val.i = bytesRead;
                                 }
@@ -144,8 +160,8 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
     
     registry.registerNative("java/io/RandomAccessFile", "writeNative", "(I)V", 
         [&registry](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
-            j2me::core::JavaValue bVal = frame->pop();
-            j2me::core::JavaValue thisVal = frame->pop();
+            frame->pop();
+            frame->pop();
             
             LOG_DEBUG("[RandomAccessFile] writeNative called (write not supported for JAR resources)");
         }
@@ -153,10 +169,10 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
     
     registry.registerNative("java/io/RandomAccessFile", "writeNative", "([BII)V", 
         [&registry](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
-            j2me::core::JavaValue lenVal = frame->pop();
-            j2me::core::JavaValue offVal = frame->pop();
-            j2me::core::JavaValue bufVal = frame->pop();
-            j2me::core::JavaValue thisVal = frame->pop();
+            frame->pop();
+            frame->pop();
+            frame->pop();
+            frame->pop();
             
             LOG_DEBUG("[RandomAccessFile] writeNative called (write not supported for JAR resources)");
         }
@@ -171,9 +187,10 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int streamId = thisObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                size_t streamIdAt = 0;
+                if (streamIdOffset(thisObj, streamIdAt)) {
+                    int streamId = thisObj->get<int32_t>(streamIdAt);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     if (stream) {
                         stream->seek(posVal.val.l);
                     }
@@ -192,9 +209,10 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int streamId = thisObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                size_t streamIdAt = 0;
+                if (streamIdOffset(thisObj, streamIdAt)) {
+                    int streamId = thisObj->get<int32_t>(streamIdAt);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     if (stream) {
                         result.val.l = stream->getPosition();
                     }
@@ -215,9 +233,10 @@ void registerRandomAccessFileNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 auto thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int streamId = thisObj->fields[0];
-                    auto stream = j2me::core::HeapManager::getInstance().getStream(streamId);
+                size_t streamIdAt = 0;
+                if (streamIdOffset(thisObj, streamIdAt)) {
+                    int streamId = thisObj->get<int32_t>(streamIdAt);
+                    auto stream = NativeInputStream::fromHandle(streamId);
                     if (stream) {
                         result.val.l = stream->getSize();
                     }
@@ -7,6 +7,7 @@
 #include "../core/Logger.hpp"
 #include "../loader/JarLoader.hpp"
 #include "java_lang_String.hpp"
+#include "NativeInputStream.hpp"
 #include <string>
 
 namespace j2me {
@@ -42,15 +43,15 @@ void registerClassNatives(j2me::core::NativeRegistry& registry) {
                 if (loader && loader->hasFile(resName)) {
                     auto data = loader->getFile(resName);
                     if (data) {
-                        // Create NativeInputStream via HeapManager
-                        int streamId = j2me::core::HeapManager::getInstance().allocateStream(data->data(), data->size());
-                        
+                        // The InputStream object owns the NativeInputStream, so it comes first
+                        // InputStream 对象是 NativeInputStream 的所有者，因此先分配它
                         auto inputStreamCls = registry.getInterpreter()->resolveClass("java/io/InputStream");
                         auto streamObj = j2me::core::HeapManager::getInstance().allocate(inputStreamCls);
-                        if (streamObj->fields.size() > 0) {
-                            streamObj->fields[0] = streamId;
+                        int streamId = NativeInputStream::open(data->data(), data->size(), streamObj);
+                        if (streamObj->hasField(0, j2me::core::FIELD_I)) {
+                            streamObj->set<int32_t>(0, streamId);
                         } else {
-                            LOG_ERROR("[Class] WARNING: InputStream object has 0 fields! Cannot store streamId.");
+                            LOG_ERROR("[Class] WARNING: InputStream object has no stream handle field! Cannot store streamId.");
                         }
                         
                         result.val.ref = streamObj;
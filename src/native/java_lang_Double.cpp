@@ -1,6 +1,7 @@
 #include "java_lang_Double.hpp"
 #include "../core/NativeRegistry.hpp"
 #include "../core/StackFrame.hpp"
+#include "java_lang_String.hpp"
 #include <cstring>
 #include <cmath>
 #include <sstream>
@@ -40,8 +41,7 @@ void registerDoubleNatives(j2me::core::NativeRegistry& registry) {
             
             j2me::core::JavaValue result;
             result.type = j2me::core::JavaValue::REFERENCE;
-            result.strVal = str;
-            result.val.ref = nullptr;
+            result.val.ref = createJavaString(j2me::core::NativeRegistry::getInstance().getInterpreter(), str);
             frame->push(result);
         });
 }
@@ -49,7 +49,7 @@ void registerObjectNatives(j2me::core::NativeRegistry& registry) {
                             nameIt = classCls->fieldOffsets.find("name");
                         }
                         if (nameIt != classCls->fieldOffsets.end()) {
-                            classObj->fields[nameIt->second] = (int64_t)stringObj;
+                            classObj->setRef(nameIt->second, stringObj);
                         }
                         
                         ret.val.ref = classObj;
@@ -70,8 +70,10 @@ void registerObjectNatives(j2me::core::NativeRegistry& registry) {
             
             j2me::core::JavaValue ret;
             ret.type = j2me::core::JavaValue::INT;
-            // Use pointer address as hash code
-            ret.val.i = (int32_t)(intptr_t)objVal.val.ref;
+            // Identity hash kept in the object header, stable even if the object moves
+            // 对象头中的标识哈希值，对象被移动后保持不变
+            auto obj = static_cast<j2me::core::JavaObject*>(objVal.val.ref);
+            ret.val.i = obj ? (int32_t)obj->identityHash() : 0;
             frame->push(ret);
         }
     );
@@ -110,29 +110,28 @@ j2me::core::JavaObject* createJavaString(j2me::core::Interpreter* interpreter, c
     if (!arrayCls) arrayCls = interpreter->resolveClass("[B");
     
     if (arrayCls) {
-        auto arrayObj = j2me::core::HeapManager::getInstance().allocate(arrayCls);
         std::vector<uint8_t> bytes(str.begin(), str.end());
         std::vector<uint16_t> u16 = decodeBytesGuessCharset(bytes);
-        arrayObj->fields.resize(u16.size());
-        for (size_t i = 0; i < u16.size(); i++) arrayObj->fields[i] = u16[i];
+        auto arrayObj = j2me::core::HeapManager::getInstance().allocateArray(arrayCls, (int32_t)u16.size());
+        for (size_t i = 0; i < u16.size(); i++) arrayObj->storeElement((int32_t)i, u16[i]);
         
         // Set value field
         auto valueIt = stringCls->fieldOffsets.find("value|[C");
         if (valueIt == stringCls->fieldOffsets.end()) valueIt = stringCls->fieldOffsets.find("value|[B");
         if (valueIt != stringCls->fieldOffsets.end()) {
-            stringObj->fields[valueIt->second] = (int64_t)arrayObj;
+            stringObj->setRef(valueIt->second, arrayObj);
         }
         
         // Set count field (if exists)
         auto countIt = stringCls->fieldOffsets.find("count|I");
         if (countIt != stringCls->fieldOffsets.end()) {
-             stringObj->fields[countIt->second] = (int64_t)u16.size();
+             stringObj->set<int32_t>(countIt->second, (int32_t)u16.size());
         }
         
         // Set offset field (if exists)
         auto offsetIt = stringCls->fieldOffsets.find("offset|I");
         if (offsetIt != stringCls->fieldOffsets.end()) {
-             stringObj->fields[offsetIt->second] = 0;
+             stringObj->set<int32_t>(offsetIt->second, 0);
         }
     }
     
@@ -162,7 +161,7 @@ std::string getJavaString(j2me::core::JavaObject* strObj) {
     }
     
     if (valueIt != strObj->cls->fieldOffsets.end()) {
-        int64_t arrayRef = strObj->fields[valueIt->second];
+        int64_t arrayRef = (int64_t)strObj->getRef(valueIt->second);
         // std::cout << "value arrayRef: " << arrayRef << std::endl;
         if (arrayRef != 0) {
             auto arrayObj = (j2me::core::JavaObject*)arrayRef;
@@ -170,23 +169,23 @@ std::string getJavaString(j2me::core::JavaObject* strObj) {
             
             // Handle offset and count if they exist
             size_t offset = 0;
-            size_t count = arrayObj->fields.size();
+            size_t count = (size_t)arrayObj->arrayLength();
             
             auto offsetIt = strObj->cls->fieldOffsets.find("offset|I");
             if (offsetIt == strObj->cls->fieldOffsets.end()) offsetIt = strObj->cls->fieldOffsets.find("offset");
 
             if (offsetIt != strObj->cls->fieldOffsets.end()) {
-                offset = (size_t)strObj->fields[offsetIt->second];
+                offset = (size_t)strObj->get<int32_t>(offsetIt->second);
             }
             
             auto countIt = strObj->cls->fieldOffsets.find("count|I");
             if (countIt == strObj->cls->fieldOffsets.end()) countIt = strObj->cls->fieldOffsets.find("count");
             
             if (countIt != strObj->cls->fieldOffsets.end()) {
-                count = (size_t)strObj->fields[countIt->second];
+                count = (size_t)strObj->get<int32_t>(countIt->second);
             }
             
-            // std::cout << "getJavaString: arraySize=" << arrayObj->fields.size() 
+            // std::cout << "getJavaString: arraySize=" << (size_t)arrayObj->arrayLength() 
             //           << ", offset=" << offset 
             //           << ", count=" << count << std::endl;
             
@@ -195,12 +194,12 @@ std::string getJavaString(j2me::core::JavaObject* strObj) {
             // it's likely a GBK byte stream interpreted as ISO-8859-1.
             // We try to convert it back to UTF-8 using GBK decoding.
             // 由于没有iconv库，我们暂时跳过这个功能
-            if (offset < arrayObj->fields.size()) {
-                size_t actualCount = std::min(count, arrayObj->fields.size() - offset);
+            if (offset < (size_t)arrayObj->arrayLength()) {
+                size_t actualCount = std::min(count, (size_t)arrayObj->arrayLength() - offset);
                 
                 bool hasNonLatin1 = false;
                 for (size_t i = 0; i < actualCount; i++) {
-                    uint16_t ch = (uint16_t)arrayObj->fields[offset + i];
+                    uint16_t ch = (uint16_t)arrayObj->loadElement((int32_t)(offset + i));
                     if (ch > 0xFF) {
                         hasNonLatin1 = true;
                         break;
@@ -213,7 +212,7 @@ std::string getJavaString(j2me::core::JavaObject* strObj) {
                     std::string res;
                     res.reserve(actualCount);
                     for (size_t i = 0; i < actualCount; i++) {
-                        uint16_t ch = (uint16_t)arrayObj->fields[offset + i];
+                        uint16_t ch = (uint16_t)arrayObj->loadElement((int32_t)(offset + i));
                         res += (char)ch;
                     }
                     return res;
@@ -221,13 +220,13 @@ std::string getJavaString(j2me::core::JavaObject* strObj) {
             }
 
             std::string res;
-            if (offset < arrayObj->fields.size()) {
-                size_t actualCount = std::min(count, arrayObj->fields.size() - offset);
+            if (offset < (size_t)arrayObj->arrayLength()) {
+                size_t actualCount = std::min(count, (size_t)arrayObj->arrayLength() - offset);
                 // Reserve enough space (assuming worst case 3 bytes per char for BMP)
                 res.reserve(actualCount * 3);
                 
                 for (size_t i = 0; i < actualCount; i++) {
-                    uint16_t ch = (uint16_t)arrayObj->fields[offset + i];
+                    uint16_t ch = (uint16_t)arrayObj->loadElement((int32_t)(offset + i));
                     
                     if (ch < 0x80) {
                         res += (char)ch;
@@ -264,8 +263,7 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
             auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
             auto arrayCls = interpreter->resolveClass("[B");
             if (arrayCls) {
-                auto arrayObj = j2me::core::HeapManager::getInstance().allocate(arrayCls);
-                arrayObj->fields.clear();
+                std::vector<uint8_t> bytes;
 
                 if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                     auto strObj = static_cast<j2me::core::JavaObject*>(thisVal.val.ref);
@@ -281,36 +279,36 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                         }
 
                         if (valueIt != strObj->cls->fieldOffsets.end()) {
-                            int64_t arrayRef = strObj->fields[valueIt->second];
+                            int64_t arrayRef = (int64_t)strObj->getRef(valueIt->second);
                             if (arrayRef != 0) {
                                 auto backingArray = reinterpret_cast<j2me::core::JavaObject*>(arrayRef);
                                 if (backingArray) {
                                     size_t offset = 0;
-                                    size_t count = backingArray->fields.size();
+                                    size_t count = (size_t)backingArray->arrayLength();
 
                                     auto offsetIt = strObj->cls->fieldOffsets.find("offset|I");
                                     if (offsetIt == strObj->cls->fieldOffsets.end()) offsetIt = strObj->cls->fieldOffsets.find("offset");
                                     if (offsetIt != strObj->cls->fieldOffsets.end()) {
-                                        offset = (size_t)strObj->fields[offsetIt->second];
+                                        offset = (size_t)strObj->get<int32_t>(offsetIt->second);
                                     }
 
                                     auto countIt = strObj->cls->fieldOffsets.find("count|I");
                                     if (countIt == strObj->cls->fieldOffsets.end()) countIt = strObj->cls->fieldOffsets.find("count");
                                     if (countIt != strObj->cls->fieldOffsets.end()) {
-                                        count = (size_t)strObj->fields[countIt->second];
+                                        count = (size_t)strObj->get<int32_t>(countIt->second);
                                     }
 
-                                    if (offset < backingArray->fields.size()) {
-                                        size_t actualCount = std::min(count, backingArray->fields.size() - offset);
-                                        arrayObj->fields.resize(actualCount);
+                                    if (offset < (size_t)backingArray->arrayLength()) {
+                                        size_t actualCount = std::min(count, (size_t)backingArray->arrayLength() - offset);
+                                        bytes.resize(actualCount);
                                         for (size_t i = 0; i < actualCount; i++) {
                                             uint8_t b = 0;
                                             if (isCharArray) {
-                                                b = (uint8_t)((uint16_t)backingArray->fields[offset + i] & 0xFF);
+                                                b = (uint8_t)(backingArray->elements<uint16_t>()[offset + i] & 0xFF);
                                             } else {
-                                                b = (uint8_t)(backingArray->fields[offset + i] & 0xFF);
+                                                b = (uint8_t)backingArray->elements<int8_t>()[offset + i];
                                             }
-                                            arrayObj->fields[i] = b;
+                                            bytes[i] = b;
                                         }
                                     }
                                 }
@@ -319,6 +317,8 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                     }
                 }
 
+                auto arrayObj = j2me::core::HeapManager::getInstance().allocateArray(arrayCls, (int32_t)bytes.size());
+                for (size_t i = 0; i < bytes.size(); i++) arrayObj->elements<int8_t>()[i] = (int8_t)bytes[i];
                 result.val.ref = arrayObj;
             }
             
@@ -337,12 +337,7 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
             
             int value = intVal.val.i;
             auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
-            auto stringCls = interpreter->resolveClass("java/lang/String");
-            if (stringCls) {
-                auto stringObj = j2me::core::HeapManager::getInstance().allocate(stringCls);
-                result.val.ref = stringObj;
-                result.strVal = std::to_string(value);
-            }
+            result.val.ref = createJavaString(interpreter, std::to_string(value));
             
             frame->push(result);
         }
@@ -359,12 +354,7 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
             
             long value = longVal.val.l;
             auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
-            auto stringCls = interpreter->resolveClass("java/lang/String");
-            if (stringCls) {
-                auto stringObj = j2me::core::HeapManager::getInstance().allocate(stringCls);
-                result.val.ref = stringObj;
-                result.strVal = std::to_string(value);
-            }
+            result.val.ref = createJavaString(interpreter, std::to_string(value));
             
             frame->push(result);
         }
@@ -383,32 +373,31 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                     auto charArrayCls = interpreter ? interpreter->resolveClass("[C") : nullptr;
                     if (!charArrayCls) return;
 
-                    auto charArrayObj = j2me::core::HeapManager::getInstance().allocate(charArrayCls);
-                    charArrayObj->fields.clear();
-
+                    std::vector<uint16_t> u16;
                     if (byteArrayVal.type == j2me::core::JavaValue::REFERENCE && byteArrayVal.val.ref != nullptr) {
                         auto byteArrayObj = static_cast<j2me::core::JavaObject*>(byteArrayVal.val.ref);
                         if (byteArrayObj) {
                             std::vector<uint8_t> bytes;
-                            bytes.reserve(byteArrayObj->fields.size());
-                            for (auto v : byteArrayObj->fields) bytes.push_back((uint8_t)v);
-                            std::vector<uint16_t> u16 = decodeBytesGuessCharset(bytes);
-                            charArrayObj->fields.resize(u16.size());
-                            for (size_t i = 0; i < u16.size(); i++) charArrayObj->fields[i] = u16[i];
+                            bytes.reserve(byteArrayObj->arrayLength());
+                            for (int32_t i = 0; i < byteArrayObj->arrayLength(); i++) bytes.push_back((uint8_t)byteArrayObj->elements<int8_t>()[i]);
+                            u16 = decodeBytesGuessCharset(bytes);
                         }
                     }
 
+                    auto charArrayObj = j2me::core::HeapManager::getInstance().allocateArray(charArrayCls, (int32_t)u16.size());
+                    for (size_t i = 0; i < u16.size(); i++) charArrayObj->elements<uint16_t>()[i] = u16[i];
+
                     auto valueIt = thisObj->cls->fieldOffsets.find("value|[C");
                     if (valueIt == thisObj->cls->fieldOffsets.end()) valueIt = thisObj->cls->fieldOffsets.find("value|[B");
                     if (valueIt != thisObj->cls->fieldOffsets.end()) {
-                        thisObj->fields[valueIt->second] = reinterpret_cast<intptr_t>(charArrayObj);
+                        thisObj->setRef(valueIt->second, charArrayObj);
                     }
 
                     auto countIt = thisObj->cls->fieldOffsets.find("count|I");
-                    if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[countIt->second] = charArrayObj->fields.size();
+                    if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(countIt->second, charArrayObj->arrayLength());
 
                     auto offsetIt = thisObj->cls->fieldOffsets.find("offset|I");
-                    if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[offsetIt->second] = 0;
+                    if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(offsetIt->second, 0);
                 }
             }
         }
@@ -432,35 +421,34 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                     auto charArrayCls = interpreter ? interpreter->resolveClass("[C") : nullptr;
                     if (!charArrayCls) return;
 
-                    auto charArrayObj = j2me::core::HeapManager::getInstance().allocate(charArrayCls);
-                    charArrayObj->fields.clear();
-
+                    std::vector<uint16_t> u16;
                     if (byteArrayVal.type == j2me::core::JavaValue::REFERENCE && byteArrayVal.val.ref != nullptr) {
                         auto byteArrayObj = static_cast<j2me::core::JavaObject*>(byteArrayVal.val.ref);
                         if (byteArrayObj) {
-                            if (offset < 0 || length < 0 || offset + length > (int)byteArrayObj->fields.size()) {
-                                throw std::runtime_error("StringIndexOutOfBoundsException");
+                            if (offset < 0 || length < 0 || offset + length > (int)byteArrayObj->arrayLength()) {
+                                throw j2me::core::JavaThrow(j2me::core::RuntimeExceptionKind::STRING_INDEX);
                             }
                             std::vector<uint8_t> bytes;
                             bytes.reserve(length);
-                            for (int i = 0; i < length; i++) bytes.push_back((uint8_t)byteArrayObj->fields[offset + i]);
-                            std::vector<uint16_t> u16 = decodeBytesGuessCharset(bytes);
-                            charArrayObj->fields.resize(u16.size());
-                            for (size_t i = 0; i < u16.size(); i++) charArrayObj->fields[i] = u16[i];
+                            for (int i = 0; i < length; i++) bytes.push_back((uint8_t)byteArrayObj->elements<int8_t>()[offset + i]);
+                            u16 = decodeBytesGuessCharset(bytes);
                         }
                     }
 
+                    auto charArrayObj = j2me::core::HeapManager::getInstance().allocateArray(charArrayCls, (int32_t)u16.size());
+                    for (size_t i = 0; i < u16.size(); i++) charArrayObj->elements<uint16_t>()[i] = u16[i];
+
                     auto valueIt = thisObj->cls->fieldOffsets.find("value|[C");
                     if (valueIt == thisObj->cls->fieldOffsets.end()) valueIt = thisObj->cls->fieldOffsets.find("value|[B");
                     if (valueIt != thisObj->cls->fieldOffsets.end()) {
-                        thisObj->fields[valueIt->second] = reinterpret_cast<intptr_t>(charArrayObj);
+                        thisObj->setRef(valueIt->second, charArrayObj);
                     }
 
                     auto countIt = thisObj->cls->fieldOffsets.find("count|I");
-                    if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[countIt->second] = charArrayObj->fields.size();
+                    if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(countIt->second, charArrayObj->arrayLength());
 
                     auto offsetIt = thisObj->cls->fieldOffsets.find("offset|I");
-                    if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[offsetIt->second] = 0;
+                    if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(offsetIt->second, 0);
                 }
             }
         }
@@ -486,8 +474,8 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                     if (byteArrayVal.type == j2me::core::JavaValue::REFERENCE && byteArrayVal.val.ref != nullptr) {
                         auto byteArrayObj = static_cast<j2me::core::JavaObject*>(byteArrayVal.val.ref);
                         std::vector<uint8_t> bytes;
-                        bytes.reserve(byteArrayObj->fields.size());
-                        for (auto v : byteArrayObj->fields) bytes.push_back((uint8_t)v);
+                        bytes.reserve(byteArrayObj->arrayLength());
+                        for (int32_t i = 0; i < byteArrayObj->arrayLength(); i++) bytes.push_back((uint8_t)byteArrayObj->elements<int8_t>()[i]);
 
                         std::vector<uint16_t> u16;
                         bool converted = iconvToUtf16LE(bytes, charsetName, u16);
@@ -496,21 +484,20 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                         auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
                         auto charArrayCls = interpreter->resolveClass("[C");
                         if (!charArrayCls) return;
-                        auto charArrayObj = j2me::core::HeapManager::getInstance().allocate(charArrayCls);
-                        charArrayObj->fields.resize(u16.size());
-                        for (size_t i = 0; i < u16.size(); i++) charArrayObj->fields[i] = u16[i];
+                        auto charArrayObj = j2me::core::HeapManager::getInstance().allocateArray(charArrayCls, (int32_t)u16.size());
+                        for (size_t i = 0; i < u16.size(); i++) charArrayObj->elements<uint16_t>()[i] = u16[i];
 
                         auto valueIt = thisObj->cls->fieldOffsets.find("value|[C");
                         if (valueIt == thisObj->cls->fieldOffsets.end()) valueIt = thisObj->cls->fieldOffsets.find("value|[B");
                         if (valueIt != thisObj->cls->fieldOffsets.end()) {
-                            thisObj->fields[valueIt->second] = reinterpret_cast<intptr_t>(charArrayObj);
+                            thisObj->setRef(valueIt->second, charArrayObj);
                         }
 
                         auto countIt = thisObj->cls->fieldOffsets.find("count|I");
-                        if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[countIt->second] = (int64_t)u16.size();
+                        if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(countIt->second, (int32_t)u16.size());
 
                         auto offsetIt = thisObj->cls->fieldOffsets.find("offset|I");
-                        if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[offsetIt->second] = 0;
+                        if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(offsetIt->second, 0);
                     }
                 }
             }
@@ -534,8 +521,8 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                         int offset = offsetVal.val.i;
                         int length = lengthVal.val.i;
                         
-                        if (offset < 0 || length < 0 || offset + length > (int)charArrayObj->fields.size()) {
-                            throw std::runtime_error("StringIndexOutOfBoundsException");
+                        if (offset < 0 || length < 0 || offset + length > (int)(size_t)charArrayObj->arrayLength()) {
+                            throw j2me::core::JavaThrow(j2me::core::RuntimeExceptionKind::STRING_INDEX);
                         }
                         
                         bool converted = false;
@@ -544,7 +531,7 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                         // 由于没有iconv库，我们暂时跳过这个功能
                         bool allLatin1 = true;
                         for(int i=0; i<length; i++) {
-                            uint16_t c = charArrayObj->fields[offset+i];
+                            uint16_t c = charArrayObj->elements<uint16_t>()[offset+i];
                             if (c > 0xFF) {
                                 allLatin1 = false;
                                 break;
@@ -558,24 +545,23 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                             auto newCharArrayCls = interpreter->resolveClass("[C");
                             
                             if (newCharArrayCls) {
-                                auto newCharArrayObj = j2me::core::HeapManager::getInstance().allocate(newCharArrayCls);
-                                newCharArrayObj->fields.resize(length);
+                                auto newCharArrayObj = j2me::core::HeapManager::getInstance().allocateArray(newCharArrayCls, length);
                                 
                                 for (int i = 0; i < length; i++) {
-                                    newCharArrayObj->fields[i] = charArrayObj->fields[offset+i];
+                                    newCharArrayObj->elements<uint16_t>()[i] = charArrayObj->elements<uint16_t>()[offset+i];
                                 }
                                 
                                 auto valueIt = thisObj->cls->fieldOffsets.find("value|[C");
                                 if (valueIt == thisObj->cls->fieldOffsets.end()) valueIt = thisObj->cls->fieldOffsets.find("value|[B");
                                 if (valueIt != thisObj->cls->fieldOffsets.end()) {
-                                    thisObj->fields[valueIt->second] = reinterpret_cast<intptr_t>(newCharArrayObj);
+                                    thisObj->setRef(valueIt->second, newCharArrayObj);
                                 }
                                 
                                 auto countIt = thisObj->cls->fieldOffsets.find("count|I");
-                                if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[countIt->second] = length;
+                                if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(countIt->second, (int32_t)length);
                                 
                                 auto offsetIt = thisObj->cls->fieldOffsets.find("offset|I");
-                                if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[offsetIt->second] = 0;
+                                if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(offsetIt->second, 0);
                                 
                                 converted = true;
                                 //std::cout << "[String.<init>([CII)] Using original Latin1 chars" << std::endl;
@@ -587,23 +573,22 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                              auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
                              auto newCharArrayCls = interpreter->resolveClass("[C");
                              if (newCharArrayCls) {
-                                 auto newCharArrayObj = j2me::core::HeapManager::getInstance().allocate(newCharArrayCls);
-                                 newCharArrayObj->fields.resize(length);
+                                 auto newCharArrayObj = j2me::core::HeapManager::getInstance().allocateArray(newCharArrayCls, length);
                                  for(int i=0; i<length; i++) {
-                                     newCharArrayObj->fields[i] = charArrayObj->fields[offset+i];
+                                     newCharArrayObj->elements<uint16_t>()[i] = charArrayObj->elements<uint16_t>()[offset+i];
                                  }
                                  
                                  auto valueIt = thisObj->cls->fieldOffsets.find("value|[C");
                                  if (valueIt == thisObj->cls->fieldOffsets.end()) valueIt = thisObj->cls->fieldOffsets.find("value|[B");
                                  if (valueIt != thisObj->cls->fieldOffsets.end()) {
-                                     thisObj->fields[valueIt->second] = reinterpret_cast<intptr_t>(newCharArrayObj);
+                                     thisObj->setRef(valueIt->second, newCharArrayObj);
                                  }
                                  
                                  auto countIt = thisObj->cls->fieldOffsets.find("count|I");
-                                 if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[countIt->second] = length;
+                                 if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(countIt->second, (int32_t)length);
                                  
                                  auto offsetIt = thisObj->cls->fieldOffsets.find("offset|I");
-                                 if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[offsetIt->second] = 0;
+                                 if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(offsetIt->second, 0);
                                  
                                  // std::cout << "[String.<init>([CII)] Standard copy" << std::endl;
                              }
@@ -626,29 +611,28 @@ void registerStringNatives(j2me::core::NativeRegistry& registry) {
                     if (charArrayVal.type == j2me::core::JavaValue::REFERENCE && charArrayVal.val.ref != nullptr) {
                         auto charArrayObj = static_cast<j2me::core::JavaObject*>(charArrayVal.val.ref);
                         
-                        int length = charArrayObj->fields.size();
+                        int length = (size_t)charArrayObj->arrayLength();
                         
                         // Normal copy
                         auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
                         auto newCharArrayCls = interpreter->resolveClass("[C");
                         if (newCharArrayCls) {
-                            auto newCharArrayObj = j2me::core::HeapManager::getInstance().allocate(newCharArrayCls);
-                            newCharArrayObj->fields.resize(length);
+                            auto newCharArrayObj = j2me::core::HeapManager::getInstance().allocateArray(newCharArrayCls, length);
                             for(int i=0; i<length; i++) {
-                                newCharArrayObj->fields[i] = charArrayObj->fields[i];
+                                newCharArrayObj->elements<uint16_t>()[i] = charArrayObj->elements<uint16_t>()[i];
                             }
                             
                             auto valueIt = thisObj->cls->fieldOffsets.find("value|[C");
                             if (valueIt == thisObj->cls->fieldOffsets.end()) valueIt = thisObj->cls->fieldOffsets.find("value|[B");
                             if (valueIt != thisObj->cls->fieldOffsets.end()) {
-                                thisObj->fields[valueIt->second] = reinterpret_cast<intptr_t>(newCharArrayObj);
+                                thisObj->setRef(valueIt->second, newCharArrayObj);
                             }
                             
                             auto countIt = thisObj->cls->fieldOffsets.find("count|I");
-                            if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[countIt->second] = length;
+                            if (countIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(countIt->second, (int32_t)length);
                             
                             auto offsetIt = thisObj->cls->fieldOffsets.find("offset|I");
-                            if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->fields[offsetIt->second] = 0;
+                            if (offsetIt != thisObj->cls->fieldOffsets.end()) thisObj->set<int32_t>(offsetIt->second, 0);
                         }
                     }
                 }
@@ -4,18 +4,38 @@
 #include "../core/StackFrame.hpp"
 #include "../core/HeapManager.hpp"
 #include "../core/Interpreter.hpp"
+#include "../core/NativeHandles.hpp"
 #include <iostream>
-#include <map>
 #include <string>
 
 namespace j2me {
 namespace natives {
 
-// Global map to store StringBuffer content
-// Key: StringBuffer ID (stored in the object's first field)
-// Value: std::string content
-static std::map<int32_t, std::string> stringBufferMap;
-static int32_t nextStringBufferId = 1;
+// The content lives in a native std::string behind a NativeHandles handle, stored in the
+// first word of the object (which HeapManager reserves even though the class declares no
+// fields); the string is released when the StringBuffer is collected
+// 内容保存在本地 std::string 中，通过 NativeHandles 句柄访问，句柄存放在对象的第一个字 (即使类没有声明字段，
+// HeapManager 也会保留该空间); StringBuffer 被回收时释放该字符串
+static void initBuffer(j2me::core::JavaObject* thisObj) {
+    uint32_t handle = j2me::core::NativeHandles::getInstance().create(
+        j2me::core::NativeHandles::Kind::STRING, new std::string(),
+        [](void* resource) { delete static_cast<std::string*>(resource); }, thisObj);
+    thisObj->set<int32_t>(0, (int32_t)handle);
+}
+
+static std::string* bufferOf(j2me::core::JavaObject* thisObj) {
+    return j2me::core::NativeHandles::getInstance().get<std::string>(thisObj->get<uint32_t>(0),
+                                                                    j2me::core::NativeHandles::Kind::STRING);
+}
+
+// Appended contents are native memory, counted against the heap cap
+// 追加的内容属于本地内存，计入堆上限
+static void appendCharged(j2me::core::JavaObject* thisObj, const std::string& tail) {
+    std::string* str = bufferOf(thisObj);
+    if (!str) return;
+    j2me::core::NativeHandles::getInstance().charge(thisObj->get<uint32_t>(0), tail.size());
+    str->append(tail);
+}
 
 void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
     // registry passed as argument
@@ -28,14 +48,7 @@ void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
                 
-                int32_t id = nextStringBufferId++;
-                stringBufferMap[id] = "";
-                
-                // Ensure we have space for the ID
-                if (thisObj->fields.size() < 1) {
-                    thisObj->fields.resize(1);
-                }
-                thisObj->fields[0] = id;
+                initBuffer(thisObj);
             }
         }
     );
@@ -48,18 +61,15 @@ void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int32_t id = (int32_t)thisObj->fields[0];
-                    
-                    std::string appendStr = "null";
-                    if (strVal.type == j2me::core::JavaValue::REFERENCE && strVal.val.ref != nullptr) {
-                        appendStr = getJavaString((j2me::core::JavaObject*)strVal.val.ref);
-                    } else if (strVal.type == j2me::core::JavaValue::REFERENCE && strVal.val.ref == nullptr) {
-                        appendStr = "null";
-                    }
-                    
-                    stringBufferMap[id] += appendStr;
+                
+                std::string appendStr = "null";
+                if (strVal.type == j2me::core::JavaValue::REFERENCE && strVal.val.ref != nullptr) {
+                    appendStr = getJavaString((j2me::core::JavaObject*)strVal.val.ref);
+                } else if (strVal.type == j2me::core::JavaValue::REFERENCE && strVal.val.ref == nullptr) {
+                    appendStr = "null";
                 }
+                
+                appendCharged(thisObj, appendStr);
             }
             
             frame->push(thisVal); // Return this
@@ -74,10 +84,7 @@ void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int32_t id = (int32_t)thisObj->fields[0];
-                    stringBufferMap[id] += std::to_string(val);
-                }
+                appendCharged(thisObj, std::to_string(val));
             }
             
             frame->push(thisVal);
@@ -92,23 +99,20 @@ void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int32_t id = (int32_t)thisObj->fields[0];
-                    
-                    std::string str = "null";
-                    if (objVal.type == j2me::core::JavaValue::REFERENCE && objVal.val.ref != nullptr) {
-                        // Ideally call toString(). For now, simple logic.
-                        // Check if it's a String (simple case)
-                        j2me::core::JavaObject* obj = (j2me::core::JavaObject*)objVal.val.ref;
-                        // We can't easily check type without class name, and getting class name is hard here without loading it.
-                        // But we can check if it has "value" field compatible with String? No.
-                        // Just use "Object"
-                        str = "Object"; 
-                        // Note: If we had access to interpreter, we could resolve java/lang/String and check instanceof.
-                    }
-                    
-                    stringBufferMap[id] += str;
+                
+                std::string str = "null";
+                if (objVal.type == j2me::core::JavaValue::REFERENCE && objVal.val.ref != nullptr) {
+                    // Ideally call toString(). For now, simple logic.
+                    // Check if it's a String (simple case)
+                    j2me::core::JavaObject* obj = (j2me::core::JavaObject*)objVal.val.ref;
+                    // We can't easily check type without class name, and getting class name is hard here without loading it.
+                    // But we can check if it has "value" field compatible with String? No.
+                    // Just use "Object"
+                    str = "Object"; 
+                    // Note: If we had access to interpreter, we could resolve java/lang/String and check instanceof.
                 }
+                
+                appendCharged(thisObj, str);
             }
             
             frame->push(thisVal);
@@ -126,14 +130,11 @@ void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int32_t id = (int32_t)thisObj->fields[0];
-                    std::string str = stringBufferMap[id];
-                    
-                    auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
-                    if (interpreter) {
-                        result.val.ref = createJavaString(interpreter, str);
-                    }
+                std::string* str = bufferOf(thisObj);
+                
+                auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
+                if (interpreter && str) {
+                    result.val.ref = createJavaString(interpreter, *str);
                 }
             }
             frame->push(result);
@@ -151,11 +152,8 @@ void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (thisObj->fields.size() > 0) {
-                    int32_t id = (int32_t)thisObj->fields[0];
-                    std::string str = stringBufferMap[id];
-                    result.val.i = (int32_t)str.length();
-                }
+                std::string* str = bufferOf(thisObj);
+                if (str) result.val.i = (int32_t)str->length();
             }
             frame->push(result);
         }
@@ -168,13 +166,7 @@ void registerStringBufferNatives(j2me::core::NativeRegistry& registry) {
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* thisObj = (j2me::core::JavaObject*)thisVal.val.ref;
                 
-                int32_t id = nextStringBufferId++;
-                stringBufferMap[id] = "";
-                
-                if (thisObj->fields.size() < 1) {
-                    thisObj->fields.resize(1);
-                }
-                thisObj->fields[0] = id;
+                initBuffer(thisObj);
             }
         }
     );
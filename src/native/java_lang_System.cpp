@@ -4,6 +4,7 @@
 #include "../core/HeapManager.hpp"
 #include "../core/Logger.hpp"
 #include "java_lang_String.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 
@@ -28,8 +29,37 @@ void registerSystemNatives(j2me::core::NativeRegistry& registry) {
     // java/lang/System.gc()V
     registry.registerNative("java/lang/System", "gc", "()V",
         [](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
-            LOG_DEBUG("[System] gc() called - triggering garbage collection");
-            // j2me::core::HeapManager::getInstance().collect(); // If implemented
+            // Natives run in the middle of a time slice; the collection runs before the next one
+            // 本地方法在时间片中途执行; 回收在下一个时间片开始前进行
+            LOG_DEBUG("[System] gc() called - collection requested");
+            j2me::core::HeapManager::getInstance().requestCollection();
+        }
+    );
+
+    // java/lang/Runtime.freeMemory()J / totalMemory()J: the heap cap (--heap-max) or else the
+    // heap region's capacity, and how much of it is not taken by objects the last collection
+    // found live (or allocated since) and by native memory counted against the cap
+    // 堆上限 (--heap-max，未设置时为堆区容量)，以及其中未被占用的部分 (对象指上次回收后存活的及此后分配的，另计入堆上限的本地内存)
+    registry.registerNative("java/lang/Runtime", "freeMemory", "()J",
+        [](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
+            frame->pop(); // this
+            auto& heap = j2me::core::HeapManager::getInstance();
+            j2me::core::JavaValue ret;
+            ret.type = j2me::core::JavaValue::LONG;
+            size_t total = heap.getHeapLimit() ? heap.getHeapLimit() : heap.capacityBytes();
+            ret.val.l = (int64_t)(total - std::min(total, heap.accountedBytes()));
+            frame->push(ret);
+        }
+    );
+
+    registry.registerNative("java/lang/Runtime", "totalMemory", "()J",
+        [](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
+            frame->pop(); // this
+            j2me::core::JavaValue ret;
+            ret.type = j2me::core::JavaValue::LONG;
+            auto& heap = j2me::core::HeapManager::getInstance();
+            ret.val.l = (int64_t)(heap.getHeapLimit() ? heap.getHeapLimit() : heap.capacityBytes());
+            frame->push(ret);
         }
     );
     
@@ -80,48 +110,50 @@ void registerSystemNatives(j2me::core::NativeRegistry& registry) {
                  return;
             }
             
-            if (srcPos + length > (int)srcObj->fields.size()) {
-                length = (int)srcObj->fields.size() - srcPos;
+            if (srcPos + length > srcObj->arrayLength()) {
+                length = srcObj->arrayLength() - srcPos;
                 clipped = true;
             }
             
-            if (dstPos + length > (int)dstObj->fields.size()) {
-                length = (int)dstObj->fields.size() - dstPos;
+            if (dstPos + length > dstObj->arrayLength()) {
+                length = dstObj->arrayLength() - dstPos;
                 clipped = true;
             }
             
             if (clipped) {
-                LOG_DEBUG("[System] arraycopy clipped length from " + std::to_string(originalLength) + " to " + std::to_string(length) + " srcLen=" + std::to_string(srcObj->fields.size()) + " dstLen=" + std::to_string(dstObj->fields.size()));
+                LOG_DEBUG("[System] arraycopy clipped length from " + std::to_string(originalLength) + " to " + std::to_string(length) + " srcLen=" + std::to_string(srcObj->arrayLength()) + " dstLen=" + std::to_string(dstObj->arrayLength()));
             }
             
             /*
             if (srcPos < 0 || dstPos < 0 || length < 0 || 
-                srcPos + length > (int)srcObj->fields.size() || 
-                dstPos + length > (int)dstObj->fields.size()) {
-                LOG_ERROR("IndexOutOfBoundsException: srcPos=" + std::to_string(srcPos) + " dstPos=" + std::to_string(dstPos) + " length=" + std::to_string(length) + " srcLen=" + std::to_string(srcObj->fields.size()) + " dstLen=" + std::to_string(dstObj->fields.size()));
+                srcPos + length > srcObj->arrayLength() || 
+                dstPos + length > dstObj->arrayLength()) {
+                LOG_ERROR("IndexOutOfBoundsException: srcPos=" + std::to_string(srcPos) + " dstPos=" + std::to_string(dstPos) + " length=" + std::to_string(length) + " srcLen=" + std::to_string(srcObj->arrayLength()) + " dstLen=" + std::to_string(dstObj->arrayLength()));
                 return; // Should throw exception
             }
             */
             
             // Perform copy
-            // Since fields are vector<int64_t>, we can just copy
-            // BUT must handle overlapping buffers (memmove semantics)
+            // Both arrays must hold the same element kind (int[] into byte[] would be an
+            // ArrayStoreException); then a plain move of the inline elements works
+            // (memmove semantics for overlapping ranges of the same array)
+            // 两个数组的元素类型必须一致，之后直接移动内联存储的元素即可 (同一数组的重叠区间按 memmove 语义处理)
+            if (srcObj->cls && dstObj->cls && srcObj->cls->elementKind != dstObj->cls->elementKind) {
+                LOG_ERROR("[System] arraycopy between " + srcObj->cls->name + " and " + dstObj->cls->name);
+                return;
+            }
             
             // Debugging for ByteArrayInputStream crash
             LOG_DEBUG("[System] arraycopy: src=" + std::to_string((uintptr_t)srcObj) + " dst=" + std::to_string((uintptr_t)dstObj) + " srcPos=" + std::to_string(srcPos) + " dstPos=" + std::to_string(dstPos) + " len=" + std::to_string(length));
-            if (srcObj) LOG_DEBUG("  src.fields.size=" + std::to_string(srcObj->fields.size()));
-            if (dstObj) LOG_DEBUG("  dst.fields.size=" + std::to_string(dstObj->fields.size()));
+            if (srcObj) LOG_DEBUG("  src.length=" + std::to_string(srcObj->arrayLength()));
+            if (dstObj) LOG_DEBUG("  dst.length=" + std::to_string(dstObj->arrayLength()));
 
-            if (srcObj == dstObj && dstPos > srcPos) {
-                // Copy backwards
-                for (int i = length - 1; i >= 0; i--) {
-                    dstObj->fields[dstPos + i] = srcObj->fields[srcPos + i];
-                }
-            } else {
-                // Copy forwards
-                for (int i = 0; i < length; i++) {
-                    dstObj->fields[dstPos + i] = srcObj->fields[srcPos + i];
-                }
+            if (length > 0) {
+                size_t elementSize = j2me::core::fieldSize(srcObj->cls ? srcObj->cls->elementKind : j2me::core::FIELD_A);
+                std::memmove(dstObj->elements<uint8_t>() + (size_t)dstPos * elementSize,
+                             srcObj->elements<uint8_t>() + (size_t)srcPos * elementSize,
+                             (size_t)length * elementSize);
+                if (dstObj->cls && dstObj->cls->elementKind == j2me::core::FIELD_A) j2me::core::markCard(dstObj);
             }
         }
     );
@@ -136,21 +168,6 @@ void registerSystemNatives(j2me::core::NativeRegistry& registry) {
     );
     
     // java/lang/System.printNative(Ljava/lang/String;)V
-    auto printImpl = [](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
-             j2me::core::JavaValue strVal = frame->pop();
-             if (frame->method.name_index > 0) { // Check if it's static or virtual
-                 // System.printNative is static (no this)
-                 // PrintStream.printNative is instance (has this)
-                 // But wait, lambda doesn't know.
-                 // We need to know signature.
-                 // Actually, if we register same lambda for both, we need to handle 'this' if present.
-             }
-             // However, simpler: define separate lambdas or pop 'this' if needed.
-             // System.printNative is static.
-             // PrintStream.printNative is instance (private native).
-             // If it's instance method, 'this' is on stack below arguments.
-    };
-
     registry.registerNative("java/lang/System", "printNative", "(Ljava/lang/String;)V", 
         [](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
              j2me::core::JavaValue strVal = frame->pop();
@@ -33,7 +33,7 @@ void registerThreadNatives(j2me::core::NativeRegistry& registry) {
              std::shared_ptr<j2me::core::ClassFile> methodClassFile;
              
              // Virtual lookup for run()
-             std::shared_ptr<j2me::core::JavaClass> current = cls;
+             std::shared_ptr<j2me::core::JavaClass> current = cls ? cls->shared_from_this() : nullptr;
              while (current) {
                  for (const auto& method : current->rawFile->methods) {
                      auto name = std::dynamic_pointer_cast<j2me::core::ConstantUtf8>(current->rawFile->constant_pool[method.name_index]);
@@ -26,9 +26,7 @@ void registerConnectorNatives(j2me::core::NativeRegistry& registry) {
 
             std::string name;
             if (nameVal.type == j2me::core::JavaValue::REFERENCE) {
-                if (!nameVal.strVal.empty()) {
-                    name = nameVal.strVal;
-                } else if (nameVal.val.ref != nullptr) {
+                if (nameVal.val.ref != nullptr) {
                     name = j2me::natives::getJavaString(static_cast<j2me::core::JavaObject*>(nameVal.val.ref));
                 }
             }
@@ -50,7 +48,7 @@ void registerConnectorNatives(j2me::core::NativeRegistry& registry) {
                 auto addrField = connCls->fieldOffsets.find("address|Ljava/lang/String;");
                 if (addrField == connCls->fieldOffsets.end()) addrField = connCls->fieldOffsets.find("address");
                 if (addrField != connCls->fieldOffsets.end()) {
-                    connObj->fields[addrField->second] = (int64_t)addrStrObj;
+                    connObj->setRef(addrField->second, addrStrObj);
                 }
 
                 result.val.ref = connObj;
@@ -1,5 +1,6 @@
 #include "javax_microedition_lcdui_Display.hpp"
 #include "../core/NativeRegistry.hpp"
+#include "../core/HeapManager.hpp"
 #include "../core/Logger.hpp"
 
 namespace j2me {
@@ -14,6 +15,10 @@ j2me::core::JavaObject* getCurrentDisplayable() {
 void registerDisplayNatives(j2me::core::NativeRegistry& registry) {
     // registry passed as argument
 
+    // The current Displayable stays alive while it is shown, whoever else refers to it
+    // 当前显示的 Displayable 在显示期间始终保持可达
+    j2me::core::HeapManager::getInstance().addRoot(&g_currentDisplayable);
+
     // javax/microedition/lcdui/Display.getDisplay(Ljavax/microedition/midlet/MIDlet;)Ljavax/microedition/lcdui/Display;
 
     // javax/microedition/lcdui/Canvas.setFullScreenMode(Z)V
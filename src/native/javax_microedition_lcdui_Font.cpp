@@ -16,7 +16,7 @@ static int getFontSizeTag(j2me::core::JavaValue thisVal) {
     auto it = fontObj->cls->fieldOffsets.find("size|I");
     if (it == fontObj->cls->fieldOffsets.end()) it = fontObj->cls->fieldOffsets.find("size");
     if (it == fontObj->cls->fieldOffsets.end()) return 0;
-    return (int)fontObj->fields[it->second];
+    return fontObj->get<int32_t>(it->second);
 }
 
 void registerFontNatives(j2me::core::NativeRegistry& registry) {
@@ -44,9 +44,7 @@ void registerFontNatives(j2me::core::NativeRegistry& registry) {
             int width = 0;
             std::string text;
             if (strVal.type == j2me::core::JavaValue::REFERENCE) {
-                if (!strVal.strVal.empty()) {
-                    text = strVal.strVal;
-                } else if (strVal.val.ref != nullptr) {
+                if (strVal.val.ref != nullptr) {
                     auto strObj = static_cast<j2me::core::JavaObject*>(strVal.val.ref);
                     text = j2me::natives::getJavaString(strObj);
                 }
@@ -19,7 +19,7 @@ static int32_t getGraphicsNativePtr(j2me::core::JavaObject* graphicsObj) {
         it = graphicsObj->cls->fieldOffsets.find("nativePtr");
     }
     if (it != graphicsObj->cls->fieldOffsets.end()) {
-        return (int32_t)graphicsObj->fields[it->second];
+        return graphicsObj->get<int32_t>(it->second);
     }
     return 0;
 }
@@ -31,11 +31,7 @@ static SDL_Surface* getTargetSurface(j2me::core::JavaObject* graphicsObj, bool&
         return nullptr; // Screen handled by GraphicsContext
     }
     isScreen = false;
-    auto it = imageMap.find(ptr);
-    if (it != imageMap.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return lookupImage(ptr);
 }
 
 static uint32_t getGraphicsColor(j2me::core::JavaObject* graphicsObj) {
@@ -45,7 +41,7 @@ static uint32_t getGraphicsColor(j2me::core::JavaObject* graphicsObj) {
         it = graphicsObj->cls->fieldOffsets.find("color");
     }
     if (it != graphicsObj->cls->fieldOffsets.end()) {
-        return (uint32_t)graphicsObj->fields[it->second];
+        return (uint32_t)graphicsObj->get<int32_t>(it->second);
     }
     return 0;
 }
@@ -78,16 +74,12 @@ void registerGraphicsNatives(j2me::core::NativeRegistry& registry) {
                 // Get nativePtr field
                 j2me::core::JavaObject* imgObj = (j2me::core::JavaObject*)imgVal.val.ref;
                 
-                if (imgObj->fields.size() > 0) {
-                     int32_t imgId = (int32_t)imgObj->fields[0];
+                if (imgObj->hasField(0, j2me::core::FIELD_I)) {
+                     int32_t imgId = imgObj->get<int32_t>(0);
                      if (imgId != 0) {
-                         auto it = imageMap.find(imgId);
-                         if (it != imageMap.end()) {
-                             SDL_Surface* srcSurface = it->second;
-                             
-                             if (!srcSurface) {
-                                 LOG_ERROR("[Graphics] drawImage: Source surface is NULL for ID " + std::to_string(imgId));
-                             } else if (isScreen) {
+                         SDL_Surface* srcSurface = lookupImage(imgId);
+                         if (srcSurface) {
+                             if (isScreen) {
                                  j2me::platform::GraphicsContext::getInstance().drawImage(srcSurface, x, y, anchor);
                              } else if (target) {
                                  j2me::platform::GraphicsContext::getInstance().drawImage(srcSurface, x, y, anchor, target);
@@ -97,7 +89,7 @@ void registerGraphicsNatives(j2me::core::NativeRegistry& registry) {
                          }
                      }
                 } else {
-                    LOG_ERROR("[Graphics] drawImage: Image object has no fields!");
+                    LOG_ERROR("[Graphics] drawImage: Image object has no nativePtr field!");
                 }
             }
         }
@@ -187,8 +179,6 @@ void registerGraphicsNatives(j2me::core::NativeRegistry& registry) {
                 if (strVal.val.ref != nullptr) {
                     j2me::core::JavaObject* strObj = (j2me::core::JavaObject*)strVal.val.ref;
                     text = j2me::natives::getJavaString(strObj);
-                } else if (!strVal.strVal.empty()) {
-                    text = strVal.strVal;
                 }
             }
 
@@ -215,7 +205,7 @@ void registerGraphicsNatives(j2me::core::NativeRegistry& registry) {
                 if (fontObj && fontObj->cls) {
                     auto it = fontObj->cls->fieldOffsets.find("size|I");
                     if (it == fontObj->cls->fieldOffsets.end()) it = fontObj->cls->fieldOffsets.find("size");
-                    if (it != fontObj->cls->fieldOffsets.end()) sizeTag = (int)fontObj->fields[it->second];
+                    if (it != fontObj->cls->fieldOffsets.end()) sizeTag = fontObj->get<int32_t>(it->second);
                 }
             }
             j2me::platform::GraphicsContext::getInstance().setCurrentFontSizeTag(sizeTag);
@@ -387,12 +377,11 @@ void registerGraphicsNatives(j2me::core::NativeRegistry& registry) {
             
             if (imgVal.val.ref != nullptr) {
                 j2me::core::JavaObject* imgObj = (j2me::core::JavaObject*)imgVal.val.ref;
-                if (imgObj->fields.size() > 0) {
-                     int32_t imgId = (int32_t)imgObj->fields[0];
+                if (imgObj->hasField(0, j2me::core::FIELD_I)) {
+                     int32_t imgId = imgObj->get<int32_t>(0);
                      if (imgId != 0) {
-                         auto it = imageMap.find(imgId);
-                         if (it != imageMap.end()) {
-                             SDL_Surface* srcSurface = it->second;
+                         SDL_Surface* srcSurface = lookupImage(imgId);
+                         if (srcSurface) {
                             if (isScreen) {
                                 // std::cout << "[Graphics] drawRegion to Screen: src=" << imgId << " pos=" << x_dest << "," << y_dest << " size=" << width << "x" << height << " trans=" << transform << std::endl;
                                 j2me::platform::GraphicsContext::getInstance().drawRegion(srcSurface, x_src, y_src, width, height, transform, x_dest, y_dest, anchor);
@@ -474,8 +463,8 @@ void registerGraphicsNatives(j2me::core::NativeRegistry& registry) {
 
             if (rgbDataVal.val.ref != nullptr) {
                 auto rgbArray = static_cast<j2me::core::JavaObject*>(rgbDataVal.val.ref);
-                if (rgbArray->fields.size() > 0) {
-                     int64_t* rgbData = rgbArray->fields.data();
+                if (rgbArray->arrayLength() > 0) {
+                     const int32_t* rgbData = rgbArray->elements<int32_t>();
                      if (isScreen) {
                          // std::cout << "[Graphics] drawRGB to Screen: pos=" << x << "," << y << " size=" << width << "x" << height << " alpha=" << processAlpha << std::endl;
                          j2me::platform::GraphicsContext::getInstance().drawRGB(rgbData, offset, scanlength, x, y, width, height, processAlpha != 0);
@@ -38,8 +38,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                         LOG_DEBUG("[Image] File found. Size: " + std::to_string(data->size()) + " bytes.");
                         SDL_Surface* surface = j2me::platform::GraphicsContext::getInstance().createImage(data->data(), data->size());
                         if (surface) {
-                            imgId = nextImageId++;
-                            imageMap[imgId] = surface;
+                            imgId = registerImage(surface);
                             LOG_DEBUG("[Image] Loaded successfully, ID: " + std::to_string(imgId) + " Size: " + std::to_string(surface->w) + "x" + std::to_string(surface->h));
                         } else {
                             LOG_ERROR("[Image] Failed to decode image: " + resName);
@@ -81,11 +80,10 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* imgObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (imgObj->fields.size() > 0) {
-                    int32_t imgId = (int32_t)imgObj->fields[0];
-                    auto it = imageMap.find(imgId);
-                    if (it != imageMap.end()) {
-                        SDL_Surface* surface = it->second;
+                if (imgObj->hasField(0, j2me::core::FIELD_I)) {
+                    int32_t imgId = imgObj->get<int32_t>(0);
+                    SDL_Surface* surface = lookupImage(imgId);
+                    if (surface) {
                         result.val.i = surface->w;
                     } else {
                         LOG_ERROR("[Image] getWidth: Invalid Image ID " + std::to_string(imgId));
@@ -108,11 +106,10 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
             
             if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
                 j2me::core::JavaObject* imgObj = (j2me::core::JavaObject*)thisVal.val.ref;
-                if (imgObj->fields.size() > 0) {
-                    int32_t imgId = (int32_t)imgObj->fields[0];
-                    auto it = imageMap.find(imgId);
-                    if (it != imageMap.end()) {
-                        SDL_Surface* surface = it->second;
+                if (imgObj->hasField(0, j2me::core::FIELD_I)) {
+                    int32_t imgId = imgObj->get<int32_t>(0);
+                    SDL_Surface* surface = lookupImage(imgId);
+                    if (surface) {
                         result.val.i = surface->h;
                     } else {
                         LOG_ERROR("[Image] getHeight: Invalid Image ID " + std::to_string(imgId));
@@ -142,16 +139,15 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
             }
             j2me::core::JavaObject* imgObj = (j2me::core::JavaObject*)thisVal.val.ref;
             int32_t imgId = 0;
-            if (imgObj->fields.size() > 0) {
-                imgId = (int32_t)imgObj->fields[0];
+            if (imgObj->hasField(0, j2me::core::FIELD_I)) {
+                imgId = imgObj->get<int32_t>(0);
             }
             
             if (rgbDataVal.type == j2me::core::JavaValue::REFERENCE && rgbDataVal.val.ref != nullptr) {
                 auto rgbArray = static_cast<j2me::core::JavaObject*>(rgbDataVal.val.ref);
                 
-                auto it = imageMap.find(imgId);
-                if (it != imageMap.end()) {
-                    SDL_Surface* surface = it->second;
+                SDL_Surface* surface = lookupImage(imgId);
+                if (surface) {
                     SDL_LockSurface(surface);
                     uint32_t* pixels = (uint32_t*)surface->pixels;
                     
@@ -164,8 +160,8 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                                 uint32_t argb = ((uint32_t)pa << 24) | ((uint32_t)pr << 16) | ((uint32_t)pg << 8) | (uint32_t)pb;
                                 
                                 int targetIndex = offset + r * scanlength + c;
-                                if (targetIndex >= 0 && targetIndex < (int)rgbArray->fields.size()) {
-                                    rgbArray->fields[targetIndex] = argb;
+                                if (targetIndex >= 0 && targetIndex < rgbArray->arrayLength()) {
+                                    rgbArray->elements<int32_t>()[targetIndex] = (int32_t)argb;
                                 }
                             }
                         }
@@ -197,9 +193,8 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
             if (rgbDataVal.type == j2me::core::JavaValue::REFERENCE && rgbDataVal.val.ref != nullptr) {
                 auto rgbArray = static_cast<j2me::core::JavaObject*>(rgbDataVal.val.ref);
                 
-                auto it = imageMap.find(imgId);
-                if (it != imageMap.end()) {
-                    SDL_Surface* surface = it->second;
+                SDL_Surface* surface = lookupImage(imgId);
+                if (surface) {
                     SDL_LockSurface(surface);
                     uint32_t* pixels = (uint32_t*)surface->pixels;
                     
@@ -212,8 +207,8 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                                 uint32_t argb = ((uint32_t)pa << 24) | ((uint32_t)pr << 16) | ((uint32_t)pg << 8) | (uint32_t)pb;
                                 
                                 int targetIndex = offset + r * scanlength + c;
-                                if (targetIndex >= 0 && targetIndex < (int)rgbArray->fields.size()) {
-                                    rgbArray->fields[targetIndex] = argb;
+                                if (targetIndex >= 0 && targetIndex < rgbArray->arrayLength()) {
+                                    rgbArray->elements<int32_t>()[targetIndex] = (int32_t)argb;
                                 }
                             }
                         }
@@ -247,7 +242,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                 auto rgbArray = static_cast<j2me::core::JavaObject*>(rgbDataVal.val.ref);
                 
                 // Validate array size
-                if (rgbArray->fields.size() < (size_t)(width * height)) {
+                if (rgbArray->arrayLength() < width * height) {
                      LOG_ERROR("ArrayIndexOutOfBoundsException in createRGBImageNative");
                      frame->push(result);
                      return;
@@ -260,7 +255,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                     uint32_t* targetPixels = (uint32_t*)surface->pixels;
                     
                     for (int i = 0; i < width * height; i++) {
-                        uint32_t argb = (uint32_t)rgbArray->fields[i];
+                        uint32_t argb = (uint32_t)rgbArray->elements<int32_t>()[i];
                         uint8_t a = (argb >> 24) & 0xFF;
                         uint8_t r = (argb >> 16) & 0xFF;
                         uint8_t g = (argb >> 8) & 0xFF;
@@ -271,8 +266,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                     
                     SDL_UnlockSurface(surface);
                     
-                    int32_t imgId = nextImageId++;
-                    imageMap[imgId] = surface;
+                    int32_t imgId = registerImage(surface);
                     result.val.i = imgId;
                     
                     LOG_DEBUG("[Image] Created RGB Image, ID: " + std::to_string(imgId) + " Size: " + std::to_string(width) + "x" + std::to_string(height));
@@ -303,9 +297,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                 SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
                 SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 255, 255, 255, 255));
                 
-                int32_t imgId = nextImageId++;
-                imageMap[imgId] = surface;
-                mutableImages.insert(imgId);
+                int32_t imgId = registerImage(surface, true);
                 
                 j2me::core::JavaValue result;
                 result.type = j2me::core::JavaValue::INT;
@@ -316,8 +308,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
             } else {
                 LOG_ERROR("[Image] Failed to create mutable image: " + std::string(SDL_GetError()));
                 // Return -1 or 0? 0 is probably safer as it might be checked.
-                // Assuming ID 0 is reserved or invalid if nextImageId starts at 1.
-                // Let's verify nextImageId init.
+                // No image handle is 0
                 j2me::core::JavaValue result;
                 result.type = j2me::core::JavaValue::INT;
                 result.val.i = 0; 
@@ -333,7 +324,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
             
             j2me::core::JavaValue result;
             result.type = j2me::core::JavaValue::INT;
-            result.val.i = (mutableImages.find(imgId) != mutableImages.end()) ? 1 : 0;
+            result.val.i = isMutableImage(imgId) ? 1 : 0;
             
             frame->push(result);
         }
@@ -354,7 +345,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                 auto dataObj = static_cast<j2me::core::JavaObject*>(dataVal.val.ref);
                 
                 // Validate bounds
-                if (offset < 0 || length < 0 || offset + length > (int)dataObj->fields.size()) {
+                if (offset < 0 || length < 0 || offset + length > dataObj->arrayLength()) {
                      LOG_ERROR("IndexOutOfBoundsException in createImageFromData");
                      frame->push(result);
                      return;
@@ -363,7 +354,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                 // Extract data to a temporary buffer
                 std::vector<unsigned char> buffer(length);
                 for (int i = 0; i < length; i++) {
-                    buffer[i] = (unsigned char)dataObj->fields[offset + i];
+                    buffer[i] = (unsigned char)dataObj->elements<int8_t>()[offset + i];
                 }
                 
                 // Debug: Print header
@@ -401,9 +392,10 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                         }
                         
                         SDL_UnlockSurface(surface);
+                        stbi_image_free(pixels);
+                        pixels = nullptr;
                         
-                        int32_t imgId = nextImageId++;
-                        imageMap[imgId] = surface;
+                        int32_t imgId = registerImage(surface);
                         
                         result.val.i = imgId;
                         LOG_DEBUG("[Image] Created Immutable Image (from data), ID: " + std::to_string(imgId) + " Size: " + std::to_string(w) + "x" + std::to_string(h));
@@ -411,7 +403,7 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
                          LOG_ERROR("Failed to create SDL surface: " + std::string(SDL_GetError()));
                     }
                     
-                    stbi_image_free(pixels);
+                    if (pixels) stbi_image_free(pixels);
                 } else {
                     LOG_ERROR("Failed to decode image data");
                     std::string headerHex;
@@ -429,6 +421,20 @@ void registerImageNatives(j2me::core::NativeRegistry& registry) {
         }
     );
 
+    // javax/microedition/lcdui/Image.adoptNative(I)V
+    // The constructor hands the new Image the handle created for it; from then on the
+    // surface is released when the Image is collected
+    // 构造函数将为其创建的句柄交给新的 Image 对象; 此后该 Image 被回收时释放 surface
+    registry.registerNative("javax/microedition/lcdui/Image", "adoptNative", "(I)V", 
+        [](std::shared_ptr<j2me::core::JavaThread>, std::shared_ptr<j2me::core::StackFrame> frame) {
+            int32_t imgId = frame->pop().val.i;
+            j2me::core::JavaValue thisVal = frame->pop();
+            if (thisVal.type == j2me::core::JavaValue::REFERENCE && thisVal.val.ref != nullptr) {
+                j2me::core::NativeHandles::getInstance().adopt((uint32_t)imgId, (j2me::core::JavaObject*)thisVal.val.ref);
+            }
+        }
+    );
+
     // javax/microedition/lcdui/Image.getGraphicsNative(I)I
     registry.registerNative("javax/microedition/lcdui/Image", "getGraphicsNative", "(I)I", 
         [](std::shared_ptr<j2me::core::JavaThread>, std::shared_ptr<j2me::core::StackFrame> frame) {
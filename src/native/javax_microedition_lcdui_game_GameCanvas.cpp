@@ -41,11 +41,10 @@ void registerGameCanvasNatives(j2me::core::NativeRegistry& registry) {
             
             if (imgVal.val.ref != nullptr) {
                 j2me::core::JavaObject* imgObj = (j2me::core::JavaObject*)imgVal.val.ref;
-                if (imgObj->fields.size() > 0) {
-                     int32_t imgId = (int32_t)imgObj->fields[0];
-                     auto it = imageMap.find(imgId);
-                     if (it != imageMap.end()) {
-                         SDL_Surface* srcSurface = it->second;
+                if (imgObj->hasField(0, j2me::core::FIELD_I)) {
+                     int32_t imgId = imgObj->get<int32_t>(0);
+                     SDL_Surface* srcSurface = lookupImage(imgId);
+                     if (srcSurface) {
                          
                          // Draw srcSurface to Screen
                          // Note: x, y, w, h are region on SCREEN to update?
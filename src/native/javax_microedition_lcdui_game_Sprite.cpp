@@ -52,15 +52,15 @@ void registerSpriteNatives(j2me::core::NativeRegistry& registry) {
                 return;
             }
             
-            int thisX = (int)thisSprite->fields[thisXIt->second];
-            int thisY = (int)thisSprite->fields[thisYIt->second];
-            int thisW = (int)thisSprite->fields[thisWIt->second];
-            int thisH = (int)thisSprite->fields[thisHIt->second];
+            int thisX = thisSprite->get<int32_t>(thisXIt->second);
+            int thisY = thisSprite->get<int32_t>(thisYIt->second);
+            int thisW = thisSprite->get<int32_t>(thisWIt->second);
+            int thisH = thisSprite->get<int32_t>(thisHIt->second);
             
-            int otherX = (int)otherSprite->fields[otherXIt->second];
-            int otherY = (int)otherSprite->fields[otherYIt->second];
-            int otherW = (int)otherSprite->fields[otherWIt->second];
-            int otherH = (int)otherSprite->fields[otherHIt->second];
+            int otherX = otherSprite->get<int32_t>(otherXIt->second);
+            int otherY = otherSprite->get<int32_t>(otherYIt->second);
+            int otherW = otherSprite->get<int32_t>(otherWIt->second);
+            int otherH = otherSprite->get<int32_t>(otherHIt->second);
             
             // AABB collision detection
             bool collision = (thisX < otherX + otherW) && (thisX + thisW > otherX) &&
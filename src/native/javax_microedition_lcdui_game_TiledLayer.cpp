@@ -12,7 +12,7 @@ void registerTiledLayerNatives(j2me::core::NativeRegistry& registry) {
     // TiledLayer.collidesWith(Sprite s, boolean pixelLevel)Z
     registry.registerNative("javax/microedition/lcdui/game/TiledLayer", "collidesWith", "(Ljavax/microedition/lcdui/game/Sprite;Z)Z", 
         [](std::shared_ptr<j2me::core::JavaThread> thread, std::shared_ptr<j2me::core::StackFrame> frame) {
-            j2me::core::JavaValue pixelLevelVal = frame->pop();
+            frame->pop();
             j2me::core::JavaValue spriteVal = frame->pop();
             j2me::core::JavaValue thisVal = frame->pop();
             
@@ -54,15 +54,15 @@ void registerTiledLayerNatives(j2me::core::NativeRegistry& registry) {
                 return;
             }
             
-            int thisX = (int)thisLayer->fields[thisXIt->second];
-            int thisY = (int)thisLayer->fields[thisYIt->second];
-            int thisW = (int)thisLayer->fields[thisWIt->second];
-            int thisH = (int)thisLayer->fields[thisHIt->second];
+            int thisX = thisLayer->get<int32_t>(thisXIt->second);
+            int thisY = thisLayer->get<int32_t>(thisYIt->second);
+            int thisW = thisLayer->get<int32_t>(thisWIt->second);
+            int thisH = thisLayer->get<int32_t>(thisHIt->second);
             
-            int spriteX = (int)sprite->fields[spriteXIt->second];
-            int spriteY = (int)sprite->fields[spriteYIt->second];
-            int spriteW = (int)sprite->fields[spriteWIt->second];
-            int spriteH = (int)sprite->fields[spriteHIt->second];
+            int spriteX = sprite->get<int32_t>(spriteXIt->second);
+            int spriteY = sprite->get<int32_t>(spriteYIt->second);
+            int spriteW = sprite->get<int32_t>(spriteWIt->second);
+            int spriteH = sprite->get<int32_t>(spriteHIt->second);
             
             // AABB collision detection
             bool collision = (thisX < spriteX + spriteW) && (thisX + thisW > spriteX) &&
@@ -31,9 +31,7 @@ static std::string g_rmsDir = "rms_data";
 // Helper function to extract string from Java String object
 std::string getStringFromJavaObject(j2me::core::JavaValue& value) {
     if (value.type == j2me::core::JavaValue::REFERENCE) {
-        if (!value.strVal.empty()) {
-            return value.strVal;
-        } else if (value.val.ref != nullptr) {
+        if (value.val.ref != nullptr) {
             return j2me::natives::getJavaString(static_cast<j2me::core::JavaObject*>(value.val.ref));
         }
     }
@@ -172,7 +170,7 @@ void registerRecordStoreNatives(j2me::core::NativeRegistry& registry) {
             j2me::core::JavaValue nameVal = frame->pop();
             
             LOG_DEBUG("[RMS] addRecordNative called:");
-            LOG_DEBUG("[RMS]   nameVal type=" + std::to_string(nameVal.type) + " ref=" + std::to_string(reinterpret_cast<uintptr_t>(nameVal.val.ref)) + " strVal=" + nameVal.strVal);
+            LOG_DEBUG("[RMS]   nameVal type=" + std::to_string(nameVal.type) + " ref=" + std::to_string(reinterpret_cast<uintptr_t>(nameVal.val.ref)));
             LOG_DEBUG("[RMS]   dataVal type=" + std::to_string(dataVal.type) + " ref=" + std::to_string(reinterpret_cast<uintptr_t>(dataVal.val.ref)));
             LOG_DEBUG("[RMS]   offset=" + std::to_string(offsetVal.val.i) + " numBytes=" + std::to_string(numBytesVal.val.i));
             
@@ -190,11 +188,11 @@ void registerRecordStoreNatives(j2me::core::NativeRegistry& registry) {
                     int offset = offsetVal.val.i;
                     int numBytes = numBytesVal.val.i;
                     
-                    LOG_DEBUG("[RMS]   dataObj fields size=" + std::to_string(dataObj->fields.size()));
+                    LOG_DEBUG("[RMS]   dataObj length=" + std::to_string(dataObj->arrayLength()));
                     
                     std::vector<uint8_t> data;
-                    for (int i = offset; i < offset + numBytes && i < (int)dataObj->fields.size(); i++) {
-                        data.push_back(static_cast<uint8_t>(dataObj->fields[i]));
+                    for (int i = offset; i < offset + numBytes && i < dataObj->arrayLength(); i++) {
+                        data.push_back(static_cast<uint8_t>(dataObj->elements<int8_t>()[i]));
                     }
                     
                     auto it = g_recordStores.find(name);
@@ -237,8 +235,8 @@ void registerRecordStoreNatives(j2me::core::NativeRegistry& registry) {
             if (dataVal.type == j2me::core::JavaValue::REFERENCE && dataVal.val.ref != nullptr) {
                 auto dataObj = static_cast<j2me::core::JavaObject*>(dataVal.val.ref);
                 if (dataObj) {
-                    for (int i = offset; i < offset + numBytes && i < (int)dataObj->fields.size(); i++) {
-                        data.push_back(static_cast<uint8_t>(dataObj->fields[i]));
+                    for (int i = offset; i < offset + numBytes && i < dataObj->arrayLength(); i++) {
+                        data.push_back(static_cast<uint8_t>(dataObj->elements<int8_t>()[i]));
                     }
                 }
             }
@@ -305,11 +303,10 @@ void registerRecordStoreNatives(j2me::core::NativeRegistry& registry) {
                 auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
                 auto arrayCls = interpreter->resolveClass("[I");
                 if (arrayCls) {
-                    auto arrayObj = j2me::core::HeapManager::getInstance().allocate(arrayCls);
-                    arrayObj->fields.resize(it->second.records.size());
+                    auto arrayObj = j2me::core::HeapManager::getInstance().allocateArray(arrayCls, (int32_t)it->second.records.size());
                     size_t idx = 0;
                     for (const auto& rec : it->second.records) {
-                        arrayObj->fields[idx++] = (int64_t)rec.first;
+                        arrayObj->elements<int32_t>()[idx++] = (int32_t)rec.first;
                     }
                     result.val.ref = arrayObj;
                 }
@@ -372,10 +369,9 @@ void registerRecordStoreNatives(j2me::core::NativeRegistry& registry) {
                         auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
                         auto arrayCls = interpreter->resolveClass("[B");
                         if (arrayCls) {
-                            auto arrayObj = j2me::core::HeapManager::getInstance().allocate(arrayCls);
-                            arrayObj->fields.resize(data.size());
+                            auto arrayObj = j2me::core::HeapManager::getInstance().allocateArray(arrayCls, (int32_t)data.size());
                             for (size_t i = 0; i < data.size(); i++) {
-                                arrayObj->fields[i] = data[i];
+                                arrayObj->elements<int8_t>()[i] = (int8_t)data[i];
                             }
                             result.val.ref = arrayObj;
                             LOG_DEBUG("[RMS] Retrieved record " + std::to_string(recordId) + " from " + name + " (size: " + std::to_string(data.size()) + ")");
@@ -528,43 +524,13 @@ void registerRecordStoreNatives(j2me::core::NativeRegistry& registry) {
                 auto interpreter = j2me::core::NativeRegistry::getInstance().getInterpreter();
                 auto arrayCls = interpreter->resolveClass("[Ljava/lang/String;");
                 if (arrayCls) {
-                    auto arrayObj = j2me::core::HeapManager::getInstance().allocate(arrayCls);
-                    arrayObj->fields.resize(g_recordStores.size());
+                    auto arrayObj = j2me::core::HeapManager::getInstance().allocateArray(arrayCls, (int32_t)g_recordStores.size());
                     
                     int index = 0;
                     for (const auto& entry : g_recordStores) {
-                        auto stringCls = interpreter->resolveClass("java/lang/String");
-                        if (stringCls) {
-                            auto stringObj = j2me::core::HeapManager::getInstance().allocate(stringCls);
-                            
-                            auto byteArrayCls = interpreter->resolveClass("[B");
-                            if (byteArrayCls) {
-                                auto byteArrayObj = j2me::core::HeapManager::getInstance().allocate(byteArrayCls);
-                                byteArrayObj->fields.resize(entry.first.size());
-                                for (size_t i = 0; i < entry.first.size(); i++) {
-                                    byteArrayObj->fields[i] = entry.first[i];
-                                }
-                                
-                                auto valueIt = stringObj->cls->fieldOffsets.find("value");
-                                if (valueIt != stringObj->cls->fieldOffsets.end()) {
-                                    stringObj->fields[valueIt->second] = reinterpret_cast<intptr_t>(byteArrayObj);
-                                }
-                                
-                                auto offsetIt = stringObj->cls->fieldOffsets.find("offset");
-                                if (offsetIt != stringObj->cls->fieldOffsets.end()) {
-                                    stringObj->fields[offsetIt->second] = 0;
-                                }
-                                
-                                auto countIt = stringObj->cls->fieldOffsets.find("count");
-                                if (countIt != stringObj->cls->fieldOffsets.end()) {
-                                    stringObj->fields[countIt->second] = entry.first.size();
-                                }
-                            }
-                            
-                            arrayObj->fields[index] = reinterpret_cast<intptr_t>(stringObj);
-                            LOG_DEBUG("[RMS]   Record store: " + entry.first);
-                            index++;
-                        }
+                        arrayObj->setRefElement(index, createJavaString(interpreter, entry.first));
+                        LOG_DEBUG("[RMS]   Record store: " + entry.first);
+                        index++;
                     }
                     
                     result.val.ref = arrayObj;
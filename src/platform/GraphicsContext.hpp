@@ -317,7 +317,7 @@ public:
         SDL_UnlockSurface(target);
     }
 
-    void drawRGB(int64_t* rgbData, int offset, int scanlength, int x, int y, int width, int height, bool processAlpha, SDL_Surface* target = nullptr) {
+    void drawRGB(const int32_t* rgbData, int offset, int scanlength, int x, int y, int width, int height, bool processAlpha, SDL_Surface* target = nullptr) {
         std::lock_guard<std::mutex> lock(surfaceMutex);
         if (!target) target = surface;
         if (!target) return;
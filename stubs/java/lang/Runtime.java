@@ -0,0 +1,23 @@
+package java.lang;
+
+public class Runtime {
+    private static Runtime currentRuntime = new Runtime();
+
+    private Runtime() {}
+
+    public static Runtime getRuntime() {
+        return currentRuntime;
+    }
+
+    public void exit(int status) {
+        System.exit(status);
+    }
+
+    public native long freeMemory();
+
+    public native long totalMemory();
+
+    public void gc() {
+        System.gc();
+    }
+}
@@ -8,6 +8,8 @@ public class Image {
 
     private Image(int ptr) {
         this.nativePtr = ptr;
+        // The native surface is released when this Image is collected
+        adoptNative(ptr);
     }
 
     public static Image createImage(int width, int height) {
@@ -80,6 +82,7 @@ public class Image {
     private static native int createImmutableCopyNative(int srcPtr);
     private static native int createImageFromDataNative(byte[] data, int offset, int length);
     private static native int createRGBImageNative(int[] rgb, int width, int height, boolean processAlpha);
+    private native void adoptNative(int ptr);
     private native boolean isMutableNative(int ptr);
     private native int getGraphicsNative(int imgPtr);
     private native void getRGBNative(int ptr, int[] rgbData, int offset, int scanlength, int x, int y, int width, int height);
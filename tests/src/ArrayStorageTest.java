@@ -0,0 +1,218 @@
+public class ArrayStorageTest {
+    // Enough calls for every method here to reach the register IR tier at its default threshold too
+    static final int ITERATIONS = 2000;
+    // Enough garbage per churn() to fill the nursery (2 MB by default) more than once
+    static final int CHURN_BYTES = 6 * 1024 * 1024;
+
+    int value;
+
+    static Object sink;
+
+    public static void main(String[] args) {
+        System.out.println("=== Array Storage Test ===");
+
+        testExtension();
+        testNeighbours();
+        testOverlappingCopy();
+        testCopyIntoOldArray();
+
+        System.out.println("=== All Array Storage Tests Completed ===");
+    }
+
+    static int storeLoadByte(byte[] array, int index, int value) {
+        array[index] = (byte) value;
+        return array[index];
+    }
+
+    static int storeLoadChar(char[] array, int index, int value) {
+        array[index] = (char) value;
+        return array[index];
+    }
+
+    static int storeLoadShort(short[] array, int index, int value) {
+        array[index] = (short) value;
+        return array[index];
+    }
+
+    static boolean storeLoadBoolean(boolean[] array, int index, boolean value) {
+        array[index] = value;
+        return array[index];
+    }
+
+    // byte and short elements are sign-extended when loaded, char elements zero-extended
+    static void testExtension() {
+        System.out.println("\n--- Sign And Zero Extension ---");
+
+        byte[] bytes = new byte[3];
+        char[] chars = new char[3];
+        short[] shorts = new short[3];
+        boolean[] booleans = new boolean[3];
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            int v = i * 131 - 70000;
+            if (storeLoadByte(bytes, i % 3, v) == (byte) v && storeLoadByte(bytes, 1, 200) == -56 && (bytes[1] & 0xFF) == 200
+                    && storeLoadByte(bytes, 2, 0x7F) == 127 && storeLoadByte(bytes, 0, 0x80) == -128
+                    && storeLoadChar(chars, i % 3, v) == (char) v && storeLoadChar(chars, 1, -1) == 65535
+                    && storeLoadChar(chars, 2, 0x8000) == 32768
+                    && storeLoadShort(shorts, i % 3, v) == (short) v && storeLoadShort(shorts, 1, 40000) == -25536
+                    && storeLoadShort(shorts, 2, -1) == -1
+                    && storeLoadBoolean(booleans, i % 3, (i & 1) == 0) == ((i & 1) == 0)) {
+                ok++;
+            }
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("byte, char, short and boolean elements: PASSED");
+        } else {
+            System.out.println("byte, char, short and boolean elements (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    static void fillBytes(byte[] array, int index) {
+        array[index] = -1;
+    }
+
+    static void fillShorts(short[] array, int index) {
+        array[index] = -1;
+    }
+
+    static void fillInts(int[] array, int index) {
+        array[index] = -1;
+    }
+
+    static void fillLongs(long[] array, int index) {
+        array[index] = -1L;
+    }
+
+    static void fillDoubles(double[] array, int index) {
+        array[index] = -1.5;
+    }
+
+    // A store of one element leaves the elements on both sides as they were
+    static void testNeighbours() {
+        System.out.println("\n--- Neighbouring Elements ---");
+
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            int n = 3 + (i & 7);
+            int at = 1 + i % (n - 2);
+            byte[] bytes = new byte[n];
+            short[] shorts = new short[n];
+            int[] ints = new int[n];
+            long[] longs = new long[n];
+            double[] doubles = new double[n];
+            fillBytes(bytes, at);
+            fillShorts(shorts, at);
+            fillInts(ints, at);
+            fillLongs(longs, at);
+            fillDoubles(doubles, at);
+            boolean intact = true;
+            for (int k = 0; k < n; k++) {
+                boolean filled = k == at;
+                intact &= bytes[k] == (filled ? -1 : 0) && shorts[k] == (filled ? -1 : 0) && ints[k] == (filled ? -1 : 0)
+                        && longs[k] == (filled ? -1L : 0L) && doubles[k] == (filled ? -1.5 : 0.0);
+            }
+            if (intact) ok++;
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Stores leave neighbouring elements alone: PASSED");
+        } else {
+            System.out.println("Stores leave neighbouring elements alone (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // System.arraycopy within one array behaves as if through a temporary copy
+    static void testOverlappingCopy() {
+        System.out.println("\n--- Overlapping arraycopy ---");
+
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            int n = 8 + (i & 7);
+            int shift = 1 + (i % 3);
+            boolean up = (i & 8) == 0;
+            int srcPos = up ? 0 : shift;
+            int dstPos = up ? shift : 0;
+            int length = n - shift;
+
+            byte[] bytes = new byte[n];
+            char[] chars = new char[n];
+            int[] ints = new int[n];
+            long[] longs = new long[n];
+            Object[] refs = new Object[n];
+            Integer[] boxes = new Integer[n];
+            for (int k = 0; k < n; k++) {
+                bytes[k] = (byte) (k - 4);
+                chars[k] = (char) (0xFFF0 + k);
+                ints[k] = k * 1000003;
+                longs[k] = (long) k << 40;
+                boxes[k] = new Integer(k);
+                refs[k] = boxes[k];
+            }
+            System.arraycopy(bytes, srcPos, bytes, dstPos, length);
+            System.arraycopy(chars, srcPos, chars, dstPos, length);
+            System.arraycopy(ints, srcPos, ints, dstPos, length);
+            System.arraycopy(longs, srcPos, longs, dstPos, length);
+            System.arraycopy(refs, srcPos, refs, dstPos, length);
+
+            boolean same = true;
+            for (int k = 0; k < n; k++) {
+                // Element k now holds the original element k - dstPos + srcPos, if it was a destination
+                int from = k >= dstPos && k < dstPos + length ? k - dstPos + srcPos : k;
+                same &= bytes[k] == (byte) (from - 4) && chars[k] == (char) (0xFFF0 + from) && ints[k] == from * 1000003
+                        && longs[k] == (long) from << 40 && refs[k] == boxes[from];
+            }
+            if (same) ok++;
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Overlapping ranges in both directions: PASSED");
+        } else {
+            System.out.println("Overlapping ranges in both directions (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // Allocates and drops int arrays until the nursery has been collected a few times
+    static void churn() {
+        for (int i = 0; i < CHURN_BYTES / 1024; i++) {
+            sink = new int[256 - 6];
+        }
+        sink = null;
+    }
+
+    static ArrayStorageTest node(int value) {
+        ArrayStorageTest node = new ArrayStorageTest();
+        node.value = value;
+        return node;
+    }
+
+    // Young objects copied into an array that is already old must survive the next
+    // minor collection: the copy has to dirty the destination's card
+    static void testCopyIntoOldArray() {
+        System.out.println("\n--- arraycopy Into An Old Array ---");
+
+        int n = 64;
+        Object[] old = new Object[n];
+        churn();
+        System.gc();
+        churn();
+
+        Object[] young = new Object[n];
+        for (int k = 0; k < n; k++) young[k] = node(k);
+        System.arraycopy(young, 0, old, 0, n);
+        // Then within the old array, onto itself
+        System.arraycopy(old, 0, old, n / 2, n / 2);
+        young = null;
+        churn();
+        System.gc();
+        churn();
+
+        int intact = 0;
+        for (int k = 0; k < n; k++) {
+            ArrayStorageTest element = (ArrayStorageTest) old[k];
+            if (element != null && element.value == (k < n / 2 ? k : k - n / 2)) intact++;
+        }
+        if (intact == n) {
+            System.out.println("Young objects copied into an old array intact: PASSED");
+        } else {
+            System.out.println("Young objects copied into an old array intact (" + intact + "/" + n + "): FAILED");
+        }
+    }
+}
@@ -0,0 +1,81 @@
+public class DispatchBenchmark {
+    // Short bytecodes in tight loops, so that the time goes into instruction dispatch
+    static final int REPEAT = 5;
+
+    int counter;
+
+    public static void main(String[] args) {
+        System.out.println("=== Dispatch Benchmark ===");
+
+        long total = 0;
+        for (int round = 0; round < REPEAT; round++) {
+            long start = System.currentTimeMillis();
+            int checksum = arithmetic(2000000) ^ sieve(200000) ^ calls(500000) ^ fields(1000000) ^ switches(1000000);
+            long elapsed = System.currentTimeMillis() - start;
+            total += elapsed;
+            System.out.println("Round " + round + ": checksum " + checksum + ", " + elapsed + " ms");
+        }
+        System.out.println("Average: " + (total / REPEAT) + " ms");
+
+        System.out.println("=== Dispatch Benchmark Completed ===");
+    }
+
+    // Locals, constants and integer arithmetic only
+    static int arithmetic(int n) {
+        int a = 1;
+        int b = 0;
+        for (int i = 0; i < n; i++) {
+            a = a * 31 + i;
+            b += (a >>> 7) ^ (i & 15);
+            if ((a & 1) == 0) b--;
+        }
+        return a + b;
+    }
+
+    // Array loads and stores
+    static int sieve(int n) {
+        boolean[] composite = new boolean[n + 1];
+        int primes = 0;
+        for (int i = 2; i <= n; i++) {
+            if (composite[i]) continue;
+            primes++;
+            for (int j = i + i; j <= n; j += i) composite[j] = true;
+        }
+        return primes;
+    }
+
+    static int add(int a, int b) {
+        return a + b;
+    }
+
+    // Static calls and returns
+    static int calls(int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) sum = add(sum, i);
+        return sum;
+    }
+
+    // Field loads and stores on one object
+    static int fields(int n) {
+        DispatchBenchmark obj = new DispatchBenchmark();
+        for (int i = 0; i < n; i++) obj.counter += i & 7;
+        return obj.counter;
+    }
+
+    // tableswitch in a loop
+    static int switches(int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            switch (i & 7) {
+                case 0: sum += 3; break;
+                case 1: sum ^= i; break;
+                case 2: sum -= 1; break;
+                case 3: sum += i >> 3; break;
+                case 4: sum = sum * 3; break;
+                case 5: sum |= 1; break;
+                default: sum++; break;
+            }
+        }
+        return sum;
+    }
+}
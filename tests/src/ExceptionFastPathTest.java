@@ -0,0 +1,253 @@
+public class ExceptionFastPathTest {
+    // Enough iterations for the loops to reach the register IR tier as well
+    static final int ITERATIONS = 2000;
+
+    int field;
+
+    public static void main(String[] args) {
+        System.out.println("=== Exception Fast Path Test ===");
+
+        testHandlerInSameMethod();
+        testHandlerInCaller();
+        testExceptionType();
+        testStateAfterCatch();
+        testDistinctInstances();
+
+        System.out.println("=== All Exception Fast Path Tests Completed ===");
+    }
+
+    static void testHandlerInSameMethod() {
+        System.out.println("\n--- Handler In Same Method ---");
+
+        int[] array = new int[4];
+        ExceptionFastPathTest obj = null;
+        int zero = 0;
+        int aioobe = 0;
+        int npe = 0;
+        int arithmetic = 0;
+        int resumed = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            try {
+                array[4 + (i & 3)] = i;
+            } catch (ArrayIndexOutOfBoundsException e) {
+                aioobe++;
+            }
+            try {
+                obj.field = i;
+            } catch (NullPointerException e) {
+                npe++;
+            }
+            try {
+                resumed += i / zero;
+            } catch (ArithmeticException e) {
+                arithmetic++;
+            }
+            resumed++;
+        }
+
+        if (aioobe == ITERATIONS) {
+            System.out.println("ArrayIndexOutOfBoundsException caught " + aioobe + " times: PASSED");
+        } else {
+            System.out.println("ArrayIndexOutOfBoundsException caught " + aioobe + " times: FAILED");
+        }
+        if (npe == ITERATIONS) {
+            System.out.println("NullPointerException caught " + npe + " times: PASSED");
+        } else {
+            System.out.println("NullPointerException caught " + npe + " times: FAILED");
+        }
+        if (arithmetic == ITERATIONS) {
+            System.out.println("ArithmeticException caught " + arithmetic + " times: PASSED");
+        } else {
+            System.out.println("ArithmeticException caught " + arithmetic + " times: FAILED");
+        }
+        if (resumed == ITERATIONS) {
+            System.out.println("Loop resumed after every handler: PASSED");
+        } else {
+            System.out.println("Loop resumed after every handler: FAILED");
+        }
+    }
+
+    static int load(int[] array, int index) {
+        return array[index];
+    }
+
+    static int readField(ExceptionFastPathTest obj) {
+        return obj.field;
+    }
+
+    static int divide(int a, int b) {
+        return a / b;
+    }
+
+    // Throws from `depth` frames below the caller: 0 AIOOBE, 1 NPE, 2 ArithmeticException
+    static int throwFrom(int depth, int kind) {
+        if (depth > 0) return throwFrom(depth - 1, kind) + 1;
+        if (kind == 0) return load(new int[2], 2);
+        if (kind == 1) return readField(null);
+        return divide(kind, 0);
+    }
+
+    static void testHandlerInCaller() {
+        System.out.println("\n--- Handler In Caller ---");
+
+        int[] array = new int[8];
+        int aioobe = 0;
+        int npe = 0;
+        int arithmetic = 0;
+        int unwound = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            try {
+                load(array, -1 - (i & 7));
+            } catch (ArrayIndexOutOfBoundsException e) {
+                aioobe++;
+            }
+            try {
+                readField(null);
+            } catch (NullPointerException e) {
+                npe++;
+            }
+            try {
+                divide(i, 0);
+            } catch (ArithmeticException e) {
+                arithmetic++;
+            }
+            try {
+                throwFrom(i & 3, i % 3);
+            } catch (RuntimeException e) {
+                unwound++;
+            }
+        }
+
+        if (aioobe == ITERATIONS) {
+            System.out.println("ArrayIndexOutOfBoundsException from callee caught " + aioobe + " times: PASSED");
+        } else {
+            System.out.println("ArrayIndexOutOfBoundsException from callee caught " + aioobe + " times: FAILED");
+        }
+        if (npe == ITERATIONS) {
+            System.out.println("NullPointerException from callee caught " + npe + " times: PASSED");
+        } else {
+            System.out.println("NullPointerException from callee caught " + npe + " times: FAILED");
+        }
+        if (arithmetic == ITERATIONS) {
+            System.out.println("ArithmeticException from callee caught " + arithmetic + " times: PASSED");
+        } else {
+            System.out.println("ArithmeticException from callee caught " + arithmetic + " times: FAILED");
+        }
+        if (unwound == ITERATIONS) {
+            System.out.println("Exceptions unwound through nested frames " + unwound + " times: PASSED");
+        } else {
+            System.out.println("Exceptions unwound through nested frames " + unwound + " times: FAILED");
+        }
+    }
+
+    static int kindOf(RuntimeException e) {
+        if (e instanceof ArrayIndexOutOfBoundsException) return 0;
+        if (e instanceof NullPointerException) return 1;
+        if (e instanceof ArithmeticException) return 2;
+        return -1;
+    }
+
+    static void testExceptionType() {
+        System.out.println("\n--- Exception Type ---");
+
+        int matched = 0;
+        int wrongHandler = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            int kind = i % 3;
+            try {
+                throwFrom(i & 1, kind);
+            } catch (ArithmeticException e) {
+                // A handler for another kind must be skipped
+                if (kind != 2) wrongHandler++;
+                else matched++;
+            } catch (RuntimeException e) {
+                if (kindOf(e) == kind) matched++;
+                else wrongHandler++;
+            }
+        }
+
+        if (matched == ITERATIONS) {
+            System.out.println("Exception type matched " + matched + " times: PASSED");
+        } else {
+            System.out.println("Exception type matched " + matched + " times: FAILED");
+        }
+        if (wrongHandler == 0) {
+            System.out.println("No exception reached the wrong handler: PASSED");
+        } else {
+            System.out.println("No exception reached the wrong handler: FAILED");
+        }
+    }
+
+    static int loadOrDefault(int[] array, int index) {
+        try {
+            return array[index];
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -1;
+        }
+    }
+
+    static void testStateAfterCatch() {
+        System.out.println("\n--- State After Catch ---");
+
+        int[] array = { 10, 20, 30, 40 };
+        long sum = 0;
+        int handled = 0;
+        int finallyCount = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            // The operand stack holds the partial sum when the exception is raised
+            sum = sum + loadOrDefault(array, i & 7);
+            try {
+                sum = sum + array[i & 7];
+            } catch (ArrayIndexOutOfBoundsException e) {
+                handled++;
+            } finally {
+                finallyCount++;
+            }
+        }
+
+        // Half of the indexes are in bounds: each pass adds 100 twice and -4 once
+        long expected = (long) (ITERATIONS / 8) * (100 + 100 - 4);
+        if (sum == expected && handled == ITERATIONS / 2) {
+            System.out.println("Sum after " + handled + " handled exceptions is " + sum + ": PASSED");
+        } else {
+            System.out.println("Sum after " + handled + " handled exceptions is " + sum + ": FAILED");
+        }
+        if (finallyCount == ITERATIONS) {
+            System.out.println("Finally ran every iteration: PASSED");
+        } else {
+            System.out.println("Finally ran every iteration: FAILED");
+        }
+    }
+
+    static void testDistinctInstances() {
+        System.out.println("\n--- Distinct Instances ---");
+
+        // Every caught exception is a new object, so a handler may keep the one it got
+        RuntimeException[] caught = new RuntimeException[ITERATIONS];
+        for (int i = 0; i < ITERATIONS; i++) {
+            try {
+                throwFrom(i & 1, i % 3);
+            } catch (RuntimeException e) {
+                caught[i] = e;
+            }
+        }
+
+        int same = 0;
+        int kept = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            // i - 3 threw the same kind
+            if (i >= 3 && caught[i] == caught[i - 3]) same++;
+            if (kindOf(caught[i]) == i % 3) kept++;
+        }
+        if (same == 0) {
+            System.out.println("Each handler got its own instance: PASSED");
+        } else {
+            System.out.println("Each handler got its own instance (" + same + " repeats): FAILED");
+        }
+        if (kept == ITERATIONS) {
+            System.out.println("Kept exceptions keep their type: PASSED");
+        } else {
+            System.out.println("Kept exceptions keep their type (" + kept + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+}
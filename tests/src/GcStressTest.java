@@ -0,0 +1,195 @@
+public class GcStressTest {
+    // Enough garbage per churn() to fill the nursery (2 MB by default) more than once
+    static final int CHURN_BYTES = 6 * 1024 * 1024;
+    static final int LIST_LENGTH = 500;
+    static final int ROUNDS = 60;
+
+    // Node of the linked structures: the test class is its own node type
+    GcStressTest next;
+    int value;
+
+    static Object sink;
+    static GcStressTest[] survivors = new GcStressTest[ROUNDS];
+    static Object[][] survivorArrays = new Object[ROUNDS][];
+
+    public static void main(String[] args) {
+        System.out.println("=== GC Stress Test ===");
+
+        testLinkedLists();
+        testReferenceArrays();
+        testOldToYoungStores();
+
+        System.out.println("=== All GC Stress Tests Completed ===");
+    }
+
+    // Allocates and drops int arrays until the nursery has been collected a few times
+    static void churn() {
+        for (int i = 0; i < CHURN_BYTES / 1024; i++) {
+            sink = new int[256 - 6];
+        }
+        sink = null;
+    }
+
+    static GcStressTest buildList(int seed, int length) {
+        GcStressTest head = null;
+        for (int i = length - 1; i >= 0; i--) {
+            GcStressTest node = new GcStressTest();
+            node.value = seed * 10000 + i;
+            node.next = head;
+            head = node;
+        }
+        return head;
+    }
+
+    // Whether the list holds seed*10000 + 0 .. length-1, in order
+    static boolean checkList(GcStressTest head, int seed, int length) {
+        int i = 0;
+        for (GcStressTest node = head; node != null; node = node.next) {
+            if (node.value != seed * 10000 + i) return false;
+            i++;
+        }
+        return i == length;
+    }
+
+    static Object[] buildArray(int seed, int length) {
+        Object[] array = new Object[length];
+        for (int i = 0; i < length; i++) {
+            if ((i & 1) == 0) {
+                int[] data = new int[4];
+                data[0] = seed;
+                data[3] = i;
+                array[i] = data;
+            } else {
+                array[i] = buildList(seed + i, 3);
+            }
+        }
+        return array;
+    }
+
+    static boolean checkArray(Object[] array, int seed, int length) {
+        if (array == null || array.length != length) return false;
+        for (int i = 0; i < length; i++) {
+            if ((i & 1) == 0) {
+                if (!(array[i] instanceof int[])) return false;
+                int[] data = (int[]) array[i];
+                if (data[0] != seed || data[3] != i) return false;
+            } else {
+                if (!(array[i] instanceof GcStressTest)) return false;
+                if (!checkList((GcStressTest) array[i], seed + i, 3)) return false;
+            }
+        }
+        return true;
+    }
+
+    static void testLinkedLists() {
+        System.out.println("\n--- Linked Lists ---");
+
+        boolean dropped = true;
+        for (int round = 0; round < ROUNDS; round++) {
+            // Every third list survives; the others die young or after a few collections
+            GcStressTest list = buildList(round, LIST_LENGTH);
+            if (round % 3 == 0) survivors[round] = list;
+            if (!checkList(list, round, LIST_LENGTH)) dropped = false;
+            if (round % 10 == 9) {
+                churn();
+                System.gc();
+            }
+        }
+        churn();
+        System.gc();
+        churn();
+
+        int intact = 0;
+        int expected = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            if (round % 3 != 0) continue;
+            expected++;
+            if (checkList(survivors[round], round, LIST_LENGTH)) intact++;
+        }
+        if (dropped) {
+            System.out.println("Lists intact while built: PASSED");
+        } else {
+            System.out.println("Lists intact while built: FAILED");
+        }
+        if (intact == expected) {
+            System.out.println("Surviving lists intact after collections (" + intact + "/" + expected + "): PASSED");
+        } else {
+            System.out.println("Surviving lists intact after collections (" + intact + "/" + expected + "): FAILED");
+        }
+    }
+
+    static void testReferenceArrays() {
+        System.out.println("\n--- Reference Arrays ---");
+
+        for (int round = 0; round < ROUNDS; round++) {
+            Object[] array = buildArray(round, 64);
+            if (round % 2 == 0) survivorArrays[round] = array;
+            if (round % 8 == 7) churn();
+        }
+        System.gc();
+        churn();
+
+        int intact = 0;
+        int expected = 0;
+        for (int round = 0; round < ROUNDS; round += 2) {
+            expected++;
+            if (checkArray(survivorArrays[round], round, 64)) intact++;
+        }
+        if (intact == expected) {
+            System.out.println("Surviving reference arrays intact after collections (" + intact + "/" + expected + "): PASSED");
+        } else {
+            System.out.println("Surviving reference arrays intact after collections (" + intact + "/" + expected + "): FAILED");
+        }
+    }
+
+    static void testOldToYoungStores() {
+        System.out.println("\n--- Old-To-Young Stores ---");
+
+        // Holders promoted to the old space before anything young is stored into them
+        GcStressTest[] holders = new GcStressTest[ROUNDS];
+        Object[][] holderArrays = new Object[ROUNDS][];
+        for (int round = 0; round < ROUNDS; round++) {
+            holders[round] = new GcStressTest();
+            holders[round].value = round;
+            holderArrays[round] = new Object[32];
+        }
+        churn();
+        System.gc();
+        churn();
+
+        // Two passes: the second overwrites what the first stored (promoted by then) with
+        // young structures again
+        for (int pass = 1; pass <= 2; pass++) {
+            for (int round = 0; round < ROUNDS; round++) {
+                int seed = pass * 1000 + round;
+                // Field store into an old object
+                holders[round].next = buildList(seed, 20);
+                // System.arraycopy of young references into an old array
+                Object[] young = buildArray(seed, 32);
+                System.arraycopy(young, 0, holderArrays[round], 0, 32);
+                if (round % 8 == 7) churn();
+            }
+            churn();
+        }
+        System.gc();
+        churn();
+
+        int fieldsIntact = 0;
+        int arraysIntact = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            int seed = 2 * 1000 + round;
+            if (holders[round].value == round && checkList(holders[round].next, seed, 20)) fieldsIntact++;
+            if (checkArray(holderArrays[round], seed, 32)) arraysIntact++;
+        }
+        if (fieldsIntact == ROUNDS) {
+            System.out.println("Young lists stored into old fields intact (" + fieldsIntact + "/" + ROUNDS + "): PASSED");
+        } else {
+            System.out.println("Young lists stored into old fields intact (" + fieldsIntact + "/" + ROUNDS + "): FAILED");
+        }
+        if (arraysIntact == ROUNDS) {
+            System.out.println("Young references copied into old arrays intact (" + arraysIntact + "/" + ROUNDS + "): PASSED");
+        } else {
+            System.out.println("Young references copied into old arrays intact (" + arraysIntact + "/" + ROUNDS + "): FAILED");
+        }
+    }
+}
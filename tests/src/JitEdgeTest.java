@@ -0,0 +1,250 @@
+public class JitEdgeTest {
+    // Enough calls for every method here to reach the JIT at its default threshold too
+    static final int ITERATIONS = 2000;
+    // Enough garbage per churn() to fill the nursery (2 MB by default) more than once
+    static final int CHURN_BYTES = 6 * 1024 * 1024;
+    static final int HOLDERS = 64;
+
+    JitEdgeTest next;
+    int value;
+
+    static Object sink;
+
+    public static void main(String[] args) {
+        System.out.println("=== JIT Edge Case Test ===");
+
+        testIntegerDivide();
+        testFloatCompare();
+        testArrayIndexes();
+        testOldObjectStores();
+
+        System.out.println("=== All JIT Edge Case Tests Completed ===");
+    }
+
+    static int divide(int a, int b) {
+        return a / b;
+    }
+
+    static int remainder(int a, int b) {
+        return a % b;
+    }
+
+    static long divideLong(long a, long b) {
+        return a / b;
+    }
+
+    static long remainderLong(long a, long b) {
+        return a % b;
+    }
+
+    static void testIntegerDivide() {
+        System.out.println("\n--- Integer Divide ---");
+
+        // MIN_VALUE / -1 overflows back to MIN_VALUE (idiv would trap on x86)
+        int intOk = 0;
+        int longOk = 0;
+        int byZero = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            int minusOne = -1 - (i & 0);
+            if (divide(Integer.MIN_VALUE, minusOne) == Integer.MIN_VALUE && remainder(Integer.MIN_VALUE, minusOne) == 0
+                    && divide(-7, 2) == -3 && remainder(-7, 2) == -1) {
+                intOk++;
+            }
+            if (divideLong(Long.MIN_VALUE, minusOne) == Long.MIN_VALUE && remainderLong(Long.MIN_VALUE, minusOne) == 0
+                    && divideLong(-7L, 2L) == -3L && remainderLong(-7L, 2L) == -1L) {
+                longOk++;
+            }
+            try {
+                divide(i, 0);
+            } catch (ArithmeticException e) {
+                byZero++;
+            }
+        }
+
+        if (intOk == ITERATIONS) {
+            System.out.println("int MIN_VALUE / -1 and truncation: PASSED");
+        } else {
+            System.out.println("int MIN_VALUE / -1 and truncation (" + intOk + "/" + ITERATIONS + "): FAILED");
+        }
+        if (longOk == ITERATIONS) {
+            System.out.println("long MIN_VALUE / -1 and truncation: PASSED");
+        } else {
+            System.out.println("long MIN_VALUE / -1 and truncation (" + longOk + "/" + ITERATIONS + "): FAILED");
+        }
+        if (byZero == ITERATIONS) {
+            System.out.println("Divide by zero throws: PASSED");
+        } else {
+            System.out.println("Divide by zero throws (" + byZero + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // javac compiles < and <= to fcmpg and > and >= to fcmpl, so that NaN fails every test
+    static int compareFloats(float a, float b) {
+        int bits = 0;
+        if (a < b) bits |= 1;
+        if (a <= b) bits |= 2;
+        if (a > b) bits |= 4;
+        if (a >= b) bits |= 8;
+        if (a == b) bits |= 16;
+        if (a != b) bits |= 32;
+        return bits;
+    }
+
+    static int compareDoubles(double a, double b) {
+        int bits = 0;
+        if (a < b) bits |= 1;
+        if (a <= b) bits |= 2;
+        if (a > b) bits |= 4;
+        if (a >= b) bits |= 8;
+        if (a == b) bits |= 16;
+        if (a != b) bits |= 32;
+        return bits;
+    }
+
+    static void testFloatCompare() {
+        System.out.println("\n--- Float Compare ---");
+
+        float nan = 0.0f / 0.0f;
+        double dnan = 0.0 / 0.0;
+        int nanOk = 0;
+        int orderedOk = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            float f = i;
+            double d = i;
+            // Only != holds with a NaN on either side
+            if (compareFloats(nan, f) == 32 && compareFloats(f, nan) == 32 && compareFloats(nan, nan) == 32
+                    && compareDoubles(dnan, d) == 32 && compareDoubles(d, dnan) == 32 && compareDoubles(dnan, dnan) == 32) {
+                nanOk++;
+            }
+            if (compareFloats(f, f + 1) == (1 | 2 | 32) && compareFloats(f, f) == (2 | 8 | 16)
+                    && compareDoubles(d + 1, d) == (4 | 8 | 32)) {
+                orderedOk++;
+            }
+        }
+
+        if (nanOk == ITERATIONS) {
+            System.out.println("Comparisons with NaN are all false: PASSED");
+        } else {
+            System.out.println("Comparisons with NaN are all false (" + nanOk + "/" + ITERATIONS + "): FAILED");
+        }
+        if (orderedOk == ITERATIONS) {
+            System.out.println("Ordered comparisons: PASSED");
+        } else {
+            System.out.println("Ordered comparisons (" + orderedOk + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    static int load(int[] array, int index) {
+        return array[index];
+    }
+
+    static void store(Object[] array, int index, Object value) {
+        array[index] = value;
+    }
+
+    static void testArrayIndexes() {
+        System.out.println("\n--- Array Indexes ---");
+
+        int[] ints = new int[8];
+        Object[] refs = new Object[8];
+        for (int i = 0; i < ints.length; i++) ints[i] = i * 3;
+        int inBounds = 0;
+        int negative = 0;
+        int pastEnd = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            if (load(ints, i & 7) == (i & 7) * 3) inBounds++;
+            // -1 and MIN_VALUE: a negative index must not pass an unsigned-less-than check
+            // by wrapping, nor a signed one by being small
+            try {
+                load(ints, (i & 1) == 0 ? -1 : Integer.MIN_VALUE);
+            } catch (ArrayIndexOutOfBoundsException e) {
+                negative++;
+            }
+            try {
+                store(refs, 8 + (i & 3) * 1000000, refs);
+            } catch (ArrayIndexOutOfBoundsException e) {
+                pastEnd++;
+            }
+        }
+
+        if (inBounds == ITERATIONS) {
+            System.out.println("In-bounds loads: PASSED");
+        } else {
+            System.out.println("In-bounds loads (" + inBounds + "/" + ITERATIONS + "): FAILED");
+        }
+        if (negative == ITERATIONS) {
+            System.out.println("Negative indexes throw: PASSED");
+        } else {
+            System.out.println("Negative indexes throw (" + negative + "/" + ITERATIONS + "): FAILED");
+        }
+        if (pastEnd == ITERATIONS) {
+            System.out.println("Indexes past the end throw: PASSED");
+        } else {
+            System.out.println("Indexes past the end throw (" + pastEnd + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // Allocates and drops int arrays until the nursery has been collected a few times
+    static void churn() {
+        for (int i = 0; i < CHURN_BYTES / 1024; i++) {
+            sink = new int[256 - 6];
+        }
+        sink = null;
+    }
+
+    static void storeField(JitEdgeTest holder, JitEdgeTest value) {
+        holder.next = value;
+    }
+
+    static JitEdgeTest node(int value) {
+        JitEdgeTest node = new JitEdgeTest();
+        node.value = value;
+        return node;
+    }
+
+    static void testOldObjectStores() {
+        System.out.println("\n--- Stores Into Old Objects ---");
+
+        // Promoted to the old space before anything young is stored into them
+        JitEdgeTest[] holders = new JitEdgeTest[HOLDERS];
+        Object[][] holderArrays = new Object[HOLDERS][];
+        for (int i = 0; i < HOLDERS; i++) {
+            holders[i] = node(i);
+            holderArrays[i] = new Object[4];
+        }
+        churn();
+        System.gc();
+        churn();
+
+        // Young nodes stored by compiled putfield and aastore: if the card stays clean, the
+        // next minor collection leaves these references pointing into the emptied nursery
+        for (int round = 0; round < ITERATIONS / HOLDERS; round++) {
+            for (int i = 0; i < HOLDERS; i++) {
+                storeField(holders[i], node(round * 1000 + i));
+                store(holderArrays[i], round & 3, node(round * 1000 + i + 500));
+            }
+        }
+        int last = ITERATIONS / HOLDERS - 1;
+        churn();
+        System.gc();
+        churn();
+
+        int fieldsIntact = 0;
+        int elementsIntact = 0;
+        for (int i = 0; i < HOLDERS; i++) {
+            if (holders[i].value == i && holders[i].next != null && holders[i].next.value == last * 1000 + i) fieldsIntact++;
+            JitEdgeTest element = (JitEdgeTest) holderArrays[i][last & 3];
+            if (element != null && element.value == last * 1000 + i + 500) elementsIntact++;
+        }
+        if (fieldsIntact == HOLDERS) {
+            System.out.println("Young objects stored into old fields intact: PASSED");
+        } else {
+            System.out.println("Young objects stored into old fields intact (" + fieldsIntact + "/" + HOLDERS + "): FAILED");
+        }
+        if (elementsIntact == HOLDERS) {
+            System.out.println("Young objects stored into old arrays intact: PASSED");
+        } else {
+            System.out.println("Young objects stored into old arrays intact (" + elementsIntact + "/" + HOLDERS + "): FAILED");
+        }
+    }
+}
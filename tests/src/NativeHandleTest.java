@@ -0,0 +1,166 @@
+import java.io.InputStream;
+import javax.microedition.lcdui.Image;
+
+public class NativeHandleTest {
+    // Enough garbage per churn() to fill the nursery (2 MB by default) more than once
+    static final int CHURN_BYTES = 6 * 1024 * 1024;
+    static final int ROUNDS = 40;
+    static final int PER_ROUND = 20;
+    // Images of 64x64 RGBA pixels: 16 KB of native memory each
+    static final int IMAGE_SIZE = 64;
+    static final int BUFFER_LENGTH = 4096;
+    // Handles kept alive across the rounds while the others are released around them
+    static final int KEPT = 4;
+    // How far free memory may stay below where it started: the kept resources and some
+    // room for what the test itself still holds
+    static final long SLACK = 512 * 1024;
+
+    static Object sink;
+
+    public static void main(String[] args) {
+        System.out.println("=== Native Handle Test ===");
+
+        testImages();
+        testStreams();
+        testStringBuffers();
+
+        System.out.println("=== All Native Handle Tests Completed ===");
+    }
+
+    // Allocates and drops int arrays until the nursery has been collected a few times
+    static void churn() {
+        for (int i = 0; i < CHURN_BYTES / 1024; i++) {
+            sink = new int[256 - 6];
+        }
+        sink = null;
+    }
+
+    // Free memory once everything dropped so far has been collected, young and old;
+    // native memory still held by live handles counts as used. The collection System.gc()
+    // asks for runs before the next time slice, which the sleep starts.
+    static long settledFreeMemory() {
+        churn();
+        System.gc();
+        try {
+            Thread.sleep(1);
+        } catch (InterruptedException e) {
+        }
+        return Runtime.getRuntime().freeMemory();
+    }
+
+    static void report(String name, long before, long after, long allocated, boolean keptIntact) {
+        if (before - after <= SLACK && allocated > 4 * SLACK && keptIntact) {
+            System.out.println(name + ": PASSED");
+        } else {
+            System.out.println(name + " (" + (before - after) / 1024 + " KB not returned of " + allocated / 1024
+                    + " KB, kept intact " + keptIntact + "): FAILED");
+        }
+    }
+
+    // Every round drops most of its images, some while still young and some after they
+    // were promoted; the kept ones must still resolve once their neighbours' slots have
+    // been reused
+    static void testImages() {
+        System.out.println("\n--- Images ---");
+
+        long before = settledFreeMemory();
+        Image[] kept = new Image[KEPT];
+        Image[] promoted = new Image[PER_ROUND];
+        long allocated = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (int i = 0; i < PER_ROUND; i++) {
+                Image image = Image.createImage(IMAGE_SIZE, IMAGE_SIZE + (i & 3));
+                allocated += IMAGE_SIZE * (IMAGE_SIZE + (i & 3)) * 4;
+                if ((i & 1) == 0) promoted[i] = image;
+            }
+            kept[round % KEPT] = promoted[2 * (round % (PER_ROUND / 2))];
+            churn();
+            for (int i = 0; i < PER_ROUND; i++) promoted[i] = null;
+        }
+
+        boolean intact = true;
+        for (int k = 0; k < KEPT; k++) {
+            intact &= kept[k].getWidth() == IMAGE_SIZE && kept[k].getHeight() >= IMAGE_SIZE && kept[k].isMutable();
+        }
+        report("Images released once collected", before, settledFreeMemory(), allocated, intact);
+    }
+
+    // Streams that are never closed are released with their InputStream, young or
+    // promoted; closed ones at once
+    static void testStreams() {
+        System.out.println("\n--- Streams ---");
+
+        Class cls = new NativeHandleTest().getClass();
+        long before = settledFreeMemory();
+        InputStream[] kept = new InputStream[KEPT];
+        InputStream[] promoted = new InputStream[PER_ROUND];
+        long allocated = 0;
+        try {
+            for (int round = 0; round < ROUNDS; round++) {
+                for (int i = 0; i < PER_ROUND; i++) {
+                    InputStream in = cls.getResourceAsStream("/NativeHandleTest.class");
+                    allocated += in.available();
+                    if (i == 0) {
+                        kept[round % KEPT] = in;
+                    } else if ((i & 3) == 2) {
+                        in.close();
+                    } else if ((i & 1) == 0) {
+                        promoted[i] = in;
+                    }
+                }
+                churn();
+                for (int i = 0; i < PER_ROUND; i++) promoted[i] = null;
+            }
+
+            // Each kept stream still reads the class file's magic number
+            boolean intact = true;
+            for (int k = 0; k < KEPT; k++) {
+                intact &= kept[k].read() == 0xCA && kept[k].read() == 0xFE;
+            }
+            report("Streams released once collected or closed", before, settledFreeMemory(), allocated, intact);
+        } catch (Exception e) {
+            System.out.println("Streams released once collected or closed: FAILED - " + e);
+        }
+    }
+
+    static StringBuffer fill(int seed) {
+        StringBuffer buffer = new StringBuffer();
+        for (int i = 0; i < BUFFER_LENGTH / 8; i++) {
+            buffer.append((char) ('a' + (seed + i) % 26)).append("1234567");
+        }
+        return buffer;
+    }
+
+    static void testStringBuffers() {
+        System.out.println("\n--- StringBuffers ---");
+
+        long before = settledFreeMemory();
+        StringBuffer[] kept = new StringBuffer[KEPT];
+        StringBuffer[] promoted = new StringBuffer[PER_ROUND];
+        int[] keptSeeds = new int[KEPT];
+        long allocated = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (int i = 0; i < PER_ROUND; i++) {
+                int seed = round * PER_ROUND + i;
+                StringBuffer buffer = fill(seed);
+                allocated += buffer.length();
+                if (i == 0) {
+                    kept[round % KEPT] = buffer;
+                    keptSeeds[round % KEPT] = seed;
+                } else if ((i & 1) == 0) {
+                    promoted[i] = buffer;
+                }
+            }
+            churn();
+            for (int i = 0; i < PER_ROUND; i++) promoted[i] = null;
+        }
+
+        boolean intact = true;
+        for (int k = 0; k < KEPT; k++) {
+            String s = kept[k].toString();
+            intact &= s.length() == BUFFER_LENGTH && s.charAt(0) == (char) ('a' + keptSeeds[k] % 26)
+                    && s.charAt(BUFFER_LENGTH - 8) == (char) ('a' + (keptSeeds[k] + BUFFER_LENGTH / 8 - 1) % 26);
+        }
+        report("StringBuffers released once collected", before, settledFreeMemory(), allocated, intact);
+    }
+}
@@ -0,0 +1,184 @@
+public class PeepholeTest {
+    // Enough calls for every method here to reach the register IR tier at its default threshold too
+    static final int ITERATIONS = 2000;
+
+    public static void main(String[] args) {
+        System.out.println("=== Peephole Test ===");
+
+        testTryRanges();
+        testBranchTargets();
+        testSwitches();
+
+        System.out.println("=== All Peephole Tests Completed ===");
+    }
+
+    // `if (flag) {}` is a branch to the next instruction, which the branches pass turns
+    // into a POP two bytes shorter; `(String) null` loses its CHECKCAST. Either moves the
+    // pcs of everything after it, including the bounds of the try ranges around it.
+
+    // The two rewrites in front of the range move its start past the load, unless remapped
+    static int rangeAfterRewrites(int[] array, int index, boolean flag) {
+        if (flag) {
+        }
+        if (flag) {
+        }
+        try {
+            return array[index];
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -1;
+        }
+    }
+
+    // The four rewrites inside the inner range move its end over the load in its own
+    // handler, unless remapped. That load throws again for an index two past the end,
+    // which only the outer range may catch.
+    static int rangeBeforeHandler(int[] array, int index, boolean flag) {
+        try {
+            try {
+                if (flag) {
+                }
+                if (flag) {
+                }
+                if (flag) {
+                }
+                if (flag) {
+                }
+                return array[index];
+            } catch (ArrayIndexOutOfBoundsException e) {
+                index--;
+                return array[index];
+            }
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -2;
+        }
+    }
+
+    // The condition of the rewritten branch is what throws
+    static int loadInEmptyIf(int[] array, int index) {
+        try {
+            if (array[index] > 0) {
+            }
+            return 1;
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -1;
+        }
+    }
+
+    static int castThenStore(Object[] array, int index) {
+        try {
+            String s = (String) null;
+            array[index] = s;
+            return 1;
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -1;
+        }
+    }
+
+    static void testTryRanges() {
+        System.out.println("\n--- Try Ranges ---");
+
+        int[] ints = { 10, 11, 12, 13 };
+        Object[] refs = new Object[4];
+        int inside = 0;
+        int bounds = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            boolean flag = (i & 1) == 0;
+            int index = i % 6;
+            try {
+                if (rangeAfterRewrites(ints, index, flag) == (index < 4 ? ints[index] : -1)
+                        && loadInEmptyIf(ints, index) == (index < 4 ? 1 : -1) && castThenStore(refs, index) == (index < 4 ? 1 : -1)) {
+                    inside++;
+                }
+                if (rangeBeforeHandler(ints, index, flag) == (index < 4 ? ints[index] : index == 4 ? ints[3] : -2)) bounds++;
+            } catch (ArrayIndexOutOfBoundsException e) {
+                // Escaped the range that should have caught it
+            }
+        }
+
+        if (inside == ITERATIONS) {
+            System.out.println("Throws inside rewritten try ranges caught: PASSED");
+        } else {
+            System.out.println("Throws inside rewritten try ranges caught (" + inside + "/" + ITERATIONS + "): FAILED");
+        }
+        if (bounds == ITERATIONS) {
+            System.out.println("Handler code after a rewritten try range not covered by it: PASSED");
+        } else {
+            System.out.println("Handler code after a rewritten try range not covered by it (" + bounds + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // The back edge of the loop lands on the `if (flag) {}` window, and both loops jump
+    // backwards over code that got shorter
+    static int doWhileIntoWindow(int n, boolean flag) {
+        int i = 0;
+        int sum = 0;
+        do {
+            if (flag) {
+            }
+            String s = (String) null;
+            sum += s == null ? i : -1000;
+            i++;
+        } while (i < n);
+        return sum;
+    }
+
+    static int conditionalCast(boolean flag, String s) {
+        String picked = flag ? s : (String) null;
+        return picked == null ? 0 : picked.length();
+    }
+
+    static void testBranchTargets() {
+        System.out.println("\n--- Branch Targets ---");
+
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            boolean flag = (i & 1) == 0;
+            int n = i & 15;
+            int expected = n * (n - 1) / 2;
+            if (doWhileIntoWindow(n, flag) == expected && conditionalCast(flag, "abc") == (flag ? 3 : 0)) ok++;
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Branches into rewritten code: PASSED");
+        } else {
+            System.out.println("Branches into rewritten code (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // Three keys over a range of six: javac emits a LOOKUPSWITCH, the switches pass a
+    // TABLESWITCH of a different size, inside a try range and a loop
+    static int denseSwitch(int[] array, int n) {
+        int sum = 0;
+        try {
+            for (int i = 0; i < n; i++) {
+                switch (i % 7) {
+                    case 0: sum += 1; break;
+                    case 2: sum += 10; break;
+                    case 5: sum += array[i]; break;
+                    default: sum += 100; break;
+                }
+            }
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -sum;
+        }
+        return sum;
+    }
+
+    static void testSwitches() {
+        System.out.println("\n--- Switches ---");
+
+        int[] array = new int[8];
+        for (int i = 0; i < array.length; i++) array[i] = 1000;
+        // i % 7 = 0..6 once, then 0..4 before array[12] is past the end
+        int once = 1 + 100 + 10 + 100 + 100 + 1000 + 100;
+        int beforeThrow = once + 1 + 100 + 10 + 100 + 100;
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            if (denseSwitch(array, 7) == once && denseSwitch(array, 13) == -beforeThrow) ok++;
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Dense lookupswitch in a loop and a try range: PASSED");
+        } else {
+            System.out.println("Dense lookupswitch in a loop and a try range (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+}
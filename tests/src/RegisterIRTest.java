@@ -0,0 +1,343 @@
+public class RegisterIRTest {
+    // Enough calls for every method here to reach the register IR tier at its default threshold too
+    static final int ITERATIONS = 2000;
+
+    // The first side effects of readStatics() and the <clinit> methods below, in the order they ran
+    static int[] events = new int[16];
+    static int eventCount;
+
+    public static void main(String[] args) {
+        System.out.println("=== Register IR Test ===");
+
+        testIntFolding();
+        testLongFolding();
+        testNoFoldingOfThrows();
+        testCopies();
+        testStackAcrossBlocks();
+        testStaticInitOrder();
+
+        System.out.println("=== All Register IR Tests Completed ===");
+    }
+
+    static int record(int event) {
+        if (eventCount < events.length) events[eventCount] = event;
+        eventCount++;
+        return event;
+    }
+
+    // The operands of each method are constants in locals of one block, so the IR folds them
+
+    static int addOverflow() {
+        int a = 2147483647;
+        int b = 1;
+        return a + b;
+    }
+
+    static int mulOverflow() {
+        int a = 65536;
+        return a * a;
+    }
+
+    static int subOverflow() {
+        int a = -2147483648;
+        int b = 1;
+        return a - b;
+    }
+
+    // Shift counts are masked to 5 bits
+    static int shiftLeft33() {
+        int a = 1;
+        int s = 33;
+        return a << s;
+    }
+
+    static int shiftRight34() {
+        int a = -8;
+        int s = 34;
+        return a >> s;
+    }
+
+    static int shiftUnsigned60() {
+        int a = -1;
+        int s = 60;
+        return a >>> s;
+    }
+
+    static int shiftNegative() {
+        int a = 1;
+        int s = -1;
+        return a << s;
+    }
+
+    static int minDivMinusOne() {
+        int a = -2147483648;
+        int b = -1;
+        return a / b;
+    }
+
+    static int minRemMinusOne() {
+        int a = -2147483648;
+        int b = -1;
+        return a % b;
+    }
+
+    static int narrow() {
+        int a = 200;
+        int b = -1;
+        int c = 40000;
+        return (byte) a + (char) b + (short) c;
+    }
+
+    static void testIntFolding() {
+        System.out.println("\n--- Int Folding ---");
+
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            if (addOverflow() == -2147483648 && mulOverflow() == 0 && subOverflow() == 2147483647
+                    && shiftLeft33() == 2 && shiftRight34() == -2 && shiftUnsigned60() == 15
+                    && shiftNegative() == -2147483648 && minDivMinusOne() == -2147483648 && minRemMinusOne() == 0
+                    && narrow() == -56 + 65535 - 25536) {
+                ok++;
+            }
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Overflow, shift counts and narrowing: PASSED");
+        } else {
+            System.out.println("Overflow, shift counts and narrowing (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    static long longAddOverflow() {
+        long a = 9223372036854775807L;
+        long b = 1L;
+        return a + b;
+    }
+
+    static long longMulOverflow() {
+        long a = 4294967296L;
+        return a * a;
+    }
+
+    // Shift counts are masked to 6 bits
+    static long longShiftLeft65() {
+        long a = 1L;
+        int s = 65;
+        return a << s;
+    }
+
+    static long longShiftUnsigned127() {
+        long a = -1L;
+        int s = 127;
+        return a >>> s;
+    }
+
+    static long longShiftRight32() {
+        long a = -4294967296L;
+        int s = 32;
+        return a >> s;
+    }
+
+    static int longCompare() {
+        long a = -1L;
+        long b = 1L;
+        return (a < b ? 1 : 0) + (a == b ? 10 : 0);
+    }
+
+    static void testLongFolding() {
+        System.out.println("\n--- Long Folding ---");
+
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            if (longAddOverflow() == -9223372036854775808L && longMulOverflow() == 0L && longShiftLeft65() == 2L
+                    && longShiftUnsigned127() == 1L && longShiftRight32() == -1L && longCompare() == 1) {
+                ok++;
+            }
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Overflow and shift counts: PASSED");
+        } else {
+            System.out.println("Overflow and shift counts (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // A constant divide by zero must stay a divide that throws, even with its result unused
+    static int divideByZero() {
+        int a = 7;
+        int b = 0;
+        int unused = a / b;
+        return 1;
+    }
+
+    static int remainderByZero() {
+        int a = 7;
+        int b = 0;
+        return a % b;
+    }
+
+    static long longDivideByZero() {
+        long a = 7L;
+        long b = 0L;
+        return a / b;
+    }
+
+    static long longRemainderByZero() {
+        long a = 7L;
+        long b = 0L;
+        return a % b;
+    }
+
+    static int arrayLengthOfNull() {
+        int[] array = null;
+        int unused = array.length;
+        return 1;
+    }
+
+    static void testNoFoldingOfThrows() {
+        System.out.println("\n--- Divide By Constant Zero ---");
+
+        int thrown = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            try {
+                divideByZero();
+            } catch (ArithmeticException e) {
+                thrown++;
+            }
+            try {
+                remainderByZero();
+            } catch (ArithmeticException e) {
+                thrown++;
+            }
+            try {
+                longDivideByZero();
+            } catch (ArithmeticException e) {
+                thrown++;
+            }
+            try {
+                longRemainderByZero();
+            } catch (ArithmeticException e) {
+                thrown++;
+            }
+            try {
+                arrayLengthOfNull();
+            } catch (NullPointerException e) {
+                thrown++;
+            }
+        }
+        if (thrown == ITERATIONS * 5) {
+            System.out.println("Unused results that throw are kept: PASSED");
+        } else {
+            System.out.println("Unused results that throw are kept (" + thrown + "/" + (ITERATIONS * 5) + "): FAILED");
+        }
+    }
+
+    // The copy t = a must not follow a once a is overwritten
+    static int swap(int a, int b) {
+        int t = a;
+        a = b;
+        b = t;
+        return a * 10 + b;
+    }
+
+    static long swapLong(long a, long b) {
+        long t = a;
+        a = b;
+        b = t;
+        return a * 10 + b;
+    }
+
+    // x = y = ... chains and a local read after it is incremented
+    static int chain(int v) {
+        int x;
+        int y;
+        x = y = v + 1;
+        y++;
+        int z = x;
+        x = 0;
+        return x + y * 100 + z * 10000;
+    }
+
+    static void testCopies() {
+        System.out.println("\n--- Copy Propagation ---");
+
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            int a = i & 7;
+            if (swap(a, 9) == 90 + a && swapLong(a, 9L) == 90L + a && chain(a) == (a + 2) * 100 + (a + 1) * 10000) ok++;
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Copies killed by later stores: PASSED");
+        } else {
+            System.out.println("Copies killed by later stores (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // `base` stays on the operand stack across the blocks of the conditional expression
+    static int pending(int base, boolean flag, int a, int b) {
+        return base + (flag ? a * b : a - b) * 2;
+    }
+
+    static long pendingLong(long base, int i) {
+        return base * 3 + ((i & 1) == 0 ? base : -base) + (i > 100 ? 1L : 0L);
+    }
+
+    static void testStackAcrossBlocks() {
+        System.out.println("\n--- Stack Across Blocks ---");
+
+        int ok = 0;
+        for (int i = 0; i < ITERATIONS; i++) {
+            boolean flag = (i & 1) == 0;
+            int expected = 1000 + (flag ? i * 3 : i - 3) * 2;
+            long expectedLong = (long) i * 3 + (flag ? (long) i : (long) -i) + (i > 100 ? 1L : 0L);
+            if (pending(1000, flag, i, 3) == expected && pendingLong(i, i) == expectedLong) ok++;
+        }
+        if (ok == ITERATIONS) {
+            System.out.println("Stack values live across branches: PASSED");
+        } else {
+            System.out.println("Stack values live across branches (" + ok + "/" + ITERATIONS + "): FAILED");
+        }
+    }
+
+    // Compiled on its first call, before any of the classes it reads is initialized
+    static int readStatics() {
+        record(10);
+        int unused = RegisterIRInitA.value;
+        record(20);
+        return RegisterIRInitB.value + RegisterIRInitC.value;
+    }
+
+    static void testStaticInitOrder() {
+        System.out.println("\n--- Static Initialization Order ---");
+
+        int sum = 0;
+        for (int i = 0; i < ITERATIONS; i++) sum += readStatics();
+
+        // 10, A's <clinit>, 20, B's, C's, then 10, 20 on every later call
+        int[] expected = { 10, 1, 20, 2, 3, 10, 20, 10, 20 };
+        int matched = 0;
+        for (int i = 0; i < expected.length && i < eventCount; i++) {
+            if (events[i] == expected[i]) matched++;
+        }
+        if (matched == expected.length) {
+            System.out.println("<clinit> side effects in program order: PASSED");
+        } else {
+            System.out.println("<clinit> side effects in program order (" + matched + "/" + expected.length + "): FAILED");
+        }
+        if (sum == ITERATIONS * 5) {
+            System.out.println("Static values after initialization: PASSED");
+        } else {
+            System.out.println("Static values after initialization (" + sum + "): FAILED");
+        }
+    }
+}
+
+class RegisterIRInitA {
+    static int value = RegisterIRTest.record(1);
+}
+
+class RegisterIRInitB {
+    static int value = RegisterIRTest.record(2);
+}
+
+class RegisterIRInitC {
+    static int value = RegisterIRTest.record(3);
+}